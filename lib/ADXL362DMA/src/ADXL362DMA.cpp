@@ -182,19 +182,30 @@ void ADXL362DMA::readFifoAsync(ADXL362DataBase *data) {
 	data->sampleSizeInBytes = getSampleSizeInBytes();
 
 
-	data->numSamplesRead = readNumFifoEntries() / (data->sampleSizeInBytes / 2);
+	size_t fifoEntries = readNumFifoEntries();
+
+	// Entries only accumulate between reads, so a FIFO that is not full has not overrun since
+	// the last read. If it is full the oldest entries may have been dropped and the bytes
+	// carried over no longer continue with what is at the front of the FIFO.
+	if (fifoEntries >= FIFO_MAX_ENTRIES) {
+		partialSampleBytesCount = 0;
+	}
+
+	// The bytes carried over count towards the samples read, otherwise the reads would stay
+	// one sample behind the FIFO
+	data->numSamplesRead = (partialSampleBytesCount + fifoEntries * 2) / data->sampleSizeInBytes;
 
 	if (data->numSamplesRead < 1) {
 		// Leave buffer in free state
 		return;
 	}
 
-	size_t maxFullSamples = (data->bufSize - partialSampleBytesCount) / data->sampleSizeInBytes;
+	size_t maxFullSamples = data->bufSize / data->sampleSizeInBytes;
 	if (data->numSamplesRead > maxFullSamples) {
 		data->numSamplesRead = maxFullSamples;
 	}
 
-	data->bytesRead = data->numSamplesRead * data->sampleSizeInBytes;
+	data->bytesRead = data->numSamplesRead * data->sampleSizeInBytes - partialSampleBytesCount;
 	data->state = STATE_READING_FIFO;
 	data->storeTemp = storeTemp;
 
@@ -217,11 +228,23 @@ void ADXL362DMA::readFifoCallbackInternal(void) {
 }
 
 void ADXL362DMA::cleanBuffer(ADXL362DataBase *data) {
-	data->bytesRead += partialSampleBytesCount;
+	size_t carriedOver = partialSampleBytesCount;
+	data->bytesRead += carriedOver;
 	partialSampleBytesCount = 0;
 
-	for(data->startOffset = 0; data->startOffset < data->bytesRead; data->startOffset += 2) {
-		uint8_t dataType = (data->buf[data->startOffset] >> 6) & 0x3;
+	// FIFO entries are 16 bits, least significant byte first, the axis is in the top two bits.
+	// The bytes carried over from the last read are the start of a sample, they only belong to
+	// the first new entry if that is the next axis. Otherwise the FIFO overran in between.
+	data->startOffset = 0;
+	if (carriedOver > 0 && carriedOver < data->bytesRead) {
+		uint8_t nextType = (data->buf[carriedOver + 1] >> 6) & 0x3;
+		if (nextType != carriedOver / 2) {
+			data->startOffset = carriedOver;
+		}
+	}
+
+	for(; data->startOffset < data->bytesRead; data->startOffset += 2) {
+		uint8_t dataType = (data->buf[data->startOffset + 1] >> 6) & 0x3;
 		if (dataType == 0x0) { // x-axis
 			break;
 		}
@@ -229,7 +252,9 @@ void ADXL362DMA::cleanBuffer(ADXL362DataBase *data) {
 
 	data->numSamplesRead = (data->bytesRead - data->startOffset) / data->sampleSizeInBytes;
 
-	partialSampleBytesCount = data->bytesRead - data->numSamplesRead * data->sampleSizeInBytes;
+	// Only the bytes after the last full sample are carried over, the bytes skipped
+	// before startOffset are dropped. Otherwise this could overflow partialSampleBytes.
+	partialSampleBytesCount = data->bytesRead - data->startOffset - data->numSamplesRead * data->sampleSizeInBytes;
 	if (partialSampleBytesCount > 0) {
 		memcpy(partialSampleBytes, &data->buf[data->bytesRead - partialSampleBytesCount], partialSampleBytesCount);
 	}
@@ -298,6 +323,9 @@ void ADXL362DMA::writeFifoControlAndSamples(uint16_t samples, bool storeTemp, ui
 
 	this->storeTemp = storeTemp;
 
+	// Changing the FIFO mode clears the FIFO, so leftover bytes from a previous read no longer line up
+	partialSampleBytesCount = 0;
+
 	if (samples >= 0x100) {
 		value |= 0x08; // AH bit
 	}
@@ -497,13 +525,14 @@ It is recommended that an even number of bytes be read (using a multibyte transa
 
 
 int16_t ADXL362DataBase::readSigned14(const uint8_t *pValue) const {
-	uint8_t msb = pValue[0] & 0x3f;
+	// least significant byte first (see above), the top two bits of the MSB are the axis
+	uint8_t msb = pValue[1] & 0x3f;
 	if (msb & 0x20) {
 		// Add in sign extension
 		msb |= 0xc0;
 	}
 
-	return ((int16_t) pValue[1] | (msb << 8));
+	return (int16_t)(pValue[0] | (msb << 8));
 }
 
 int16_t ADXL362DataBase::readX(size_t index) const {
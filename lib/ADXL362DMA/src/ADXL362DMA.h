@@ -189,7 +189,12 @@ public:
 	/**
 	 * @brief Reads entries from the FIFO asynchronously using SPI DMA
 	 * 
-	 * Warning: This API appears to be returning incorrect data. Use the readXYZ() instead.
+	 * data->state is set to STATE_READING_FIFO while the transfer is running and to
+	 * STATE_READ_COMPLETE once the samples can be read with readX(), readY() etc.
+	 * If the FIFO is empty the state is left unchanged.
+	 *
+	 * Bytes of an incomplete sample at the end of the transfer are kept and prepended
+	 * to the next read, and the start of the buffer is resynchronized to the next X entry.
 	 */
 	void readFifoAsync(ADXL362DataBase *data);
 
@@ -567,6 +572,7 @@ public:
 	static const uint8_t REG_POWER_CTL = 0x2d;			//!< Power control register
 	static const uint8_t REG_SELF_TEST = 0x2e;			//!< Self test register
 
+	static const size_t FIFO_MAX_ENTRIES = 512;			//!< FIFO size in 16-bit entries
 
 	// Status bits in status register
 	static const uint8_t STATUS_ERR_USER_REGS = 0x80;	//!< SEU error detect
@@ -721,7 +727,7 @@ public:
 	/**
 	 * @brief Read an signed 14-bit value out of the buffer
 	 * 
-	 * @param pValue The pointer to the first of two bytes from the FIFO 
+	 * @param pValue The pointer to the first of two bytes from the FIFO (LSB, then MSB with the axis bits)
 	 * 
 	 * @return int16_t 
 	 */
@@ -10,6 +10,16 @@ CFLAGS+= -D__STATIC_FORCEINLINE="__attribute__((always_inline)) static inline"
 CFLAGS+= -DEI_PORTING_PARTICLE=1
 CFLAGS+= -DEIDSP_LOAD_CMSIS_DSP_SOURCES=1
 
+# Per-operator profiler: compiled in so AT+OPPROFILE=1 can switch it on, it only records
+# from boot in debug builds. Build with EI_OP_PROFILER=n to leave it out.
+EI_OP_PROFILER ?= y
+ifeq ($(EI_OP_PROFILER),y)
+CFLAGS+= -DEI_CLASSIFIER_OP_PROFILER=1
+ifeq ($(DEBUG_BUILD),y)
+CFLAGS+= -DEI_CLASSIFIER_OP_PROFILER_ENABLED_AT_BOOT=1
+endif
+endif
+
 # add C and CPP files - if USRSRC is not empty, then add a slash
 CPPSRC += $(call target_files,$(USRSRC_SLASH),*.cpp)
 CSRC += $(call target_files,$(USRSRC_SLASH),*.c)
\ No newline at end of file
@@ -40,9 +40,13 @@
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "firmware-sdk/ei_device_info_lib.h"
 #include "firmware-sdk/ei_device_lib.h"
+#include "firmware-sdk/ei_device_interface.h"
 #include "firmware-sdk/at-server/ei_at_command_set.h"
+#include "firmware-sdk/at-server/ei_at_binary_transfer.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 
 #include "ei_run_impulse.h"
+#include "inference/ei_result_stream.h"
 
 #define TRANSFER_BUF_LEN 32
 
@@ -261,7 +265,13 @@ bool at_run_impulse_static_data(const char **argv, const int argc)
     bool debug = (argv[0][0] == 'y');
     size_t length = (size_t)atoi(argv[1]);
 
-    bool res = run_impulse_static_data(debug, length, TRANSFER_BUF_LEN);
+    bool res;
+    if (ei_at_binary_transfer_enabled()) {
+        res = run_impulse_static_data_binary(debug, length);
+    }
+    else {
+        res = run_impulse_static_data(debug, length, TRANSFER_BUF_LEN);
+    }
 
     return res;
 }
@@ -290,7 +300,12 @@ bool at_read_buffer(const char **argv, const int argc)
         ei_sleep(100);
     }
 
-    success = read_encode_send_sample_buffer(start, length);
+    if (ei_at_binary_transfer_enabled()) {
+        success = read_send_sample_buffer_binary(start, length);
+    }
+    else {
+        success = read_encode_send_sample_buffer(start, length);
+    }
 
     if (use_max_baudrate) {
         ei_printf("\nOK\n");
@@ -320,6 +335,13 @@ bool at_read_raw(const char **argv, const int argc)
     size_t start = (size_t)atoi(argv[0]);
     size_t length = (size_t)atoi(argv[1]);
 
+    if (ei_at_binary_transfer_enabled()) {
+        if (!read_send_sample_buffer_binary(start, length)) {
+            ei_printf("ERR: Failed to read from buffer\n");
+        }
+        return true;
+    }
+
     uint8_t buffer[32];
 
     int count = 0;
@@ -423,6 +445,142 @@ bool at_run_impulse_debug(const char **argv, const int argc)
     return false;
 }
 
+bool at_get_transfer_mode(void)
+{
+    if (ei_at_binary_transfer_enabled()) {
+        ei_printf("BINARY,%s\n", ei_at_binary_transfer_format() == EI_AT_TRANSFER_FORMAT_I16 ? "I16" : "F32");
+    }
+    else {
+        ei_printf("TEXT\n");
+    }
+
+    return true;
+}
+
+bool at_set_transfer_mode(const char **argv, const int argc)
+{
+    if (argc < 1) {
+        ei_printf("Missing argument! Required: " AT_TRANSFERMODE_ARGS "\n");
+        return true;
+    }
+
+    if (strcmp(argv[0], "TEXT") == 0) {
+        ei_at_binary_transfer_set_mode(false, EI_AT_TRANSFER_FORMAT_F32);
+        ei_printf("OK\n");
+        return true;
+    }
+
+    if (strcmp(argv[0], "BINARY") != 0) {
+        ei_printf("ERR: Unknown transfer mode %s\n", argv[0]);
+        return true;
+    }
+
+    ei_at_transfer_format_t format = EI_AT_TRANSFER_FORMAT_F32;
+    if (argc >= 2 && strcmp(argv[1], "I16") == 0) {
+        format = EI_AT_TRANSFER_FORMAT_I16;
+    }
+    else if (argc >= 2 && strcmp(argv[1], "F32") != 0) {
+        ei_printf("ERR: Unknown data format %s\n", argv[1]);
+        return true;
+    }
+
+    if (ei_read_string(nullptr, 0) < 0) {
+        ei_printf("ERR: Binary transfer not supported on this target\n");
+        return true;
+    }
+
+    ei_at_binary_transfer_set_mode(true, format);
+    ei_printf("OK BINARY MTU=%d WINDOW=%d\n", EI_AT_BINARY_MTU, EI_AT_BINARY_WINDOW);
+
+    return true;
+}
+
+bool at_get_result_mode(void)
+{
+    if (ei_result_stream_get_mode() == EI_RESULT_MODE_BINARY) {
+        ei_printf("BINARY,%u\n", (unsigned)ei_result_stream_get_batch());
+    }
+    else {
+        ei_printf("TEXT\n");
+    }
+
+    return true;
+}
+
+bool at_set_result_mode(const char **argv, const int argc)
+{
+    if (argc < 1) {
+        ei_printf("Missing argument! Required: " AT_RESULTMODE_ARGS "\n");
+        return true;
+    }
+
+    if (strcmp(argv[0], "TEXT") == 0) {
+        ei_result_stream_set_mode(EI_RESULT_MODE_TEXT, ei_result_stream_get_batch());
+        ei_printf("OK\n");
+        return true;
+    }
+
+    if (strcmp(argv[0], "BINARY") != 0) {
+        ei_printf("ERR: Unknown result mode %s\n", argv[0]);
+        return true;
+    }
+
+    int batch = EI_RESULT_STREAM_DEFAULT_BATCH;
+    if (argc >= 2) {
+        batch = atoi(argv[1]);
+        if (batch < 1 || batch > 0xffff) {
+            ei_printf("ERR: Invalid batch size %s\n", argv[1]);
+            return true;
+        }
+    }
+
+    ei_result_stream_set_mode(EI_RESULT_MODE_BINARY, (uint16_t)batch);
+    ei_printf("OK BINARY BATCH=%d VERSION=%d\n", batch, EI_RESULT_RECORD_VERSION);
+
+    return true;
+}
+
+#if EI_CLASSIFIER_OP_PROFILER == 1
+bool at_get_op_profile(void)
+{
+    ei_impulse_result_op_profile_t profile;
+    ei_op_profiler_get_events(&profile);
+
+    ei_printf("Enabled: %d\n", ei_op_profiler_is_enabled() ? 1 : 0);
+    ei_printf("invoke,op,name,time_us,cycles,bytes,scratch_bytes\n");
+    for (uint16_t ix = 0; ix < profile.count; ix++) {
+        const ei_op_profile_event_t *event = &profile.ring[(profile.first + ix) % profile.ring_size];
+        ei_printf("%u,%u,%s,%lu,%lu,%lu,%lu\n",
+            (unsigned)event->invoke_id,
+            (unsigned)event->op_index,
+            event->op_name ? event->op_name : "",
+            (unsigned long)event->time_us,
+            (unsigned long)event->cycles,
+            (unsigned long)event->bytes,
+            (unsigned long)event->scratch_bytes);
+    }
+
+    return true;
+}
+
+bool at_set_op_profile(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "CLEAR") == 0) {
+        ei_op_profiler_clear();
+    }
+    else {
+        ei_op_profiler_enable(atoi(argv[0]) != 0);
+    }
+    ei_printf("OK\n");
+
+    return true;
+}
+#endif // EI_CLASSIFIER_OP_PROFILER == 1
+
 ATServer *ei_at_init(EiDeviceParticle *device)
 {
     ATServer *at;
@@ -445,5 +603,10 @@ ATServer *ei_at_init(EiDeviceParticle *device)
     at->register_command(AT_RUNIMPULSECONT, AT_RUNIMPULSE_HELP_TEXT, at_run_impulse_cont, nullptr, nullptr, nullptr);
     at->register_command(AT_RUNIMPULSEDEBUG, AT_RUNIMPULSEDEBUG_HELP_TEXT, nullptr, nullptr, at_run_impulse_debug, AT_RUNIMPULSEDEBUG_ARGS);
     at->register_command(AT_RUNIMPULSESTATIC, AT_RUNIMPULSESTATIC_HELP_TEXT, nullptr, nullptr, at_run_impulse_static_data, AT_RUNIMPULSESTATIC_ARGS);
+    at->register_command(AT_TRANSFERMODE, AT_TRANSFERMODE_HELP_TEXT, nullptr, at_get_transfer_mode, at_set_transfer_mode, AT_TRANSFERMODE_ARGS);
+    at->register_command(AT_RESULTMODE, AT_RESULTMODE_HELP_TEXT, nullptr, at_get_result_mode, at_set_result_mode, AT_RESULTMODE_ARGS);
+#if EI_CLASSIFIER_OP_PROFILER == 1
+    at->register_command(AT_OPPROFILE, AT_OPPROFILE_HELP_TEXT, nullptr, at_get_op_profile, at_set_op_profile, AT_OPPROFILE_ARGS);
+#endif
     return at;
 }
@@ -0,0 +1,352 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include "Particle.h"
+#include "ei_console.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/ei_device_interface.h"
+#include "firmware-sdk/ei_ring_buffer.h"
+#include <atomic>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+/* Private variables ------------------------------------------------------- */
+static uint8_t ring_storage[EI_CONSOLE_BUFFER_SIZE];
+static EiRingBuffer<uint8_t> ring;
+static os_thread_t drain_thread;
+static std::atomic<bool> running(false);
+static std::atomic<int> printf_policy(EI_CONSOLE_DEFAULT_POLICY);
+
+/* the ring has one producer, writers from different threads (app, timers) take turns.
+ * Only held while copying into the ring, a mutex so a low priority writer holding it gets boosted */
+static os_mutex_t producer_mutex;
+
+static std::atomic<uint32_t> bytes_written(0);
+static std::atomic<uint32_t> bytes_dropped(0);
+static std::atomic<uint32_t> bytes_discarded(0);
+static std::atomic<uint32_t> writes_stalled(0);
+
+/** What console_write() does when the ring has no room */
+typedef enum {
+    CONSOLE_WAIT_NONE,          // drop what doesn't fit
+    CONSOLE_WAIT_NONE_WHOLE,    // drop the whole write if it doesn't fit (binary frames)
+    CONSOLE_WAIT_TIMEOUT,       // wait up to EI_CONSOLE_BLOCK_TIMEOUT_MS without progress
+    CONSOLE_WAIT_CONNECTED      // wait as long as a host has the port open
+} console_wait_t;
+
+/* Private functions ------------------------------------------------------- */
+/**
+ * @brief Copy into the ring, taking turns with other writers.
+ * Data that fits in the ring goes in as a whole, so lines from different threads don't mix.
+ * CONSOLE_WAIT_TIMEOUT and CONSOLE_WAIT_CONNECTED wait for the drain thread when there is no room,
+ * whatever doesn't fit in the end is dropped. The wait happens outside the producer mutex.
+ */
+static void console_write(const uint8_t *data, size_t length, console_wait_t wait)
+{
+    bool block = wait == CONSOLE_WAIT_TIMEOUT || wait == CONSOLE_WAIT_CONNECTED;
+
+    if (!running.load(std::memory_order_acquire)) {
+        Serial.write(data, length);
+        return;
+    }
+
+    bool stalled = false;
+    bool waiting = false;
+    system_tick_t wait_start = 0;
+    // once part of the data is in, the rest goes in as room frees up
+    size_t wanted = (length < ring.get_capacity()) ? length : ring.get_capacity();
+    if (wait == CONSOLE_WAIT_NONE_WHOLE) {
+        wanted = length;
+    }
+
+    while (length > 0) {
+        size_t n = 0;
+
+        os_mutex_lock(producer_mutex);
+        size_t room = ring.free_space();
+        if (room >= wanted || (wait == CONSOLE_WAIT_NONE && room > 0)) {
+            n = (length < room) ? length : room;
+            ring.push(data, n);
+        }
+        os_mutex_unlock(producer_mutex);
+
+        data += n;
+        length -= n;
+        if (length == 0 || !block) {
+            break;
+        }
+        if (n > 0) {
+            wanted = 1;
+            waiting = false;
+            continue;
+        }
+
+        if (!stalled) {
+            stalled = true;
+            writes_stalled++;
+        }
+        if (!waiting) {
+            waiting = true;
+            wait_start = millis();
+        }
+        else if (wait == CONSOLE_WAIT_TIMEOUT && millis() - wait_start >= EI_CONSOLE_BLOCK_TIMEOUT_MS) {
+            break;
+        }
+        // without a host the drain thread discards the data anyway
+        if (wait == CONSOLE_WAIT_CONNECTED && !Serial.isConnected()) {
+            break;
+        }
+        delay(1);
+    }
+
+    if (length > 0) {
+        bytes_dropped += length;
+    }
+}
+
+static console_wait_t printf_wait(void)
+{
+    return printf_policy.load(std::memory_order_relaxed) == EI_CONSOLE_POLICY_BLOCK ?
+        CONSOLE_WAIT_TIMEOUT : CONSOLE_WAIT_NONE;
+}
+
+/**
+ * @brief Drain thread: hand the oldest contiguous chunk of the ring to Serial, as much as the
+ * USB serial driver takes without blocking
+ */
+static os_thread_return_t console_drain(void *param)
+{
+    (void)param;
+
+    while (true) {
+        const uint8_t *chunk;
+        size_t n = ring.peek(0, EI_CONSOLE_DRAIN_CHUNK, &chunk);
+        if (n == 0) {
+            delay(1);
+            continue;
+        }
+
+        // nobody has the port open, the data would be lost in Serial anyway
+        if (!Serial.isConnected()) {
+            ring.consume(n);
+            bytes_discarded += n;
+            continue;
+        }
+
+        int room = Serial.availableForWrite();
+        if (room <= 0) {
+            delay(1);
+            continue;
+        }
+        if (n > (size_t)room) {
+            n = (size_t)room;
+        }
+
+        size_t written = Serial.write(chunk, n);
+        ring.consume(written);
+        bytes_written += written;
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+bool ei_console_init(void)
+{
+    if (running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    ring.init(ring_storage, sizeof(ring_storage));
+
+    if (os_mutex_create(&producer_mutex) != 0) {
+        return false;
+    }
+
+    if (os_thread_create(&drain_thread, "ei_console", OS_THREAD_PRIORITY_DEFAULT, console_drain, nullptr,
+            EI_CONSOLE_THREAD_STACK_SIZE) != 0) {
+        os_mutex_destroy(producer_mutex);
+        return false;
+    }
+
+    running.store(true, std::memory_order_release);
+    return true;
+}
+
+void ei_console_set_policy(ei_console_policy_t policy)
+{
+    printf_policy.store(policy, std::memory_order_relaxed);
+}
+
+ei_console_policy_t ei_console_get_policy(void)
+{
+    return (ei_console_policy_t)printf_policy.load(std::memory_order_relaxed);
+}
+
+void ei_console_get_stats(ei_console_stats_t *stats)
+{
+    stats->bytes_written = bytes_written.load();
+    stats->bytes_dropped = bytes_dropped.load();
+    stats->bytes_discarded = bytes_discarded.load();
+    stats->writes_stalled = writes_stalled.load();
+    stats->high_water_mark = ring.get_high_water_mark();
+}
+
+bool ei_console_flush(uint32_t timeout_ms)
+{
+    if (!running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    // the drain thread consumes a chunk only after Serial.write() returned
+    system_tick_t start = millis();
+    while (ring.available() > 0) {
+        if (millis() - start >= timeout_ms) {
+            return false;
+        }
+        delay(1);
+    }
+    return true;
+}
+
+/**
+ * @brief Hook for the AT server, makes sure a command's response is out before it continues
+ */
+void ei_serial_flush(void)
+{
+    ei_console_flush();
+}
+
+void ei_printf(const char *format, ...)
+{
+    // formatted on the caller's stack, so printing threads don't share a buffer
+    char buf[EI_CONSOLE_PRINTF_STACK_BUFFER];
+
+    va_list args;
+    va_start(args, format);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int r = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (r <= 0) {
+        va_end(args_copy);
+        return;
+    }
+
+    if ((size_t)r < sizeof(buf)) {
+        console_write((const uint8_t *)buf, (size_t)r, printf_wait());
+    }
+    else {
+        char *long_buf = (char *)malloc((size_t)r + 1);
+        if (long_buf) {
+            vsnprintf(long_buf, (size_t)r + 1, format, args_copy);
+            console_write((const uint8_t *)long_buf, (size_t)r, printf_wait());
+            free(long_buf);
+        }
+        else {
+            console_write((const uint8_t *)buf, sizeof(buf) - 1, printf_wait());
+            bytes_dropped += (size_t)r - (sizeof(buf) - 1);
+        }
+    }
+    va_end(args_copy);
+}
+
+/**
+ * @brief Same output as Serial.print(f, 6), formatted here so it can go through the ring
+ */
+void ei_printf_float(float f)
+{
+    char buf[32];
+    size_t len = 0;
+    double number = f;
+    const uint8_t digits = 6;
+
+    if (std::isnan(number)) {
+        len = snprintf(buf, sizeof(buf), "nan");
+    }
+    else if (std::isinf(number)) {
+        len = snprintf(buf, sizeof(buf), "inf");
+    }
+    else if (number > 4294967040.0 || number < -4294967040.0) {
+        len = snprintf(buf, sizeof(buf), "ovf");
+    }
+    else {
+        if (number < 0.0) {
+            buf[len++] = '-';
+            number = -number;
+        }
+
+        double rounding = 0.5;
+        for (uint8_t i = 0; i < digits; i++) {
+            rounding /= 10.0;
+        }
+        number += rounding;
+
+        unsigned long int_part = (unsigned long)number;
+        double remainder = number - (double)int_part;
+        len += snprintf(buf + len, sizeof(buf) - len, "%lu.", int_part);
+
+        for (uint8_t i = 0; i < digits; i++) {
+            remainder *= 10.0;
+            unsigned int digit = (unsigned int)remainder;
+            buf[len++] = '0' + digit;
+            remainder -= digit;
+        }
+    }
+
+    console_write((const uint8_t *)buf, len, printf_wait());
+}
+
+void ei_putchar(char c)
+{
+    console_write((const uint8_t *)&c, 1, printf_wait());
+}
+
+/**
+ * @brief Data transfers (base64 dumps, binary frames) wait for room as long as the host has the
+ * port open, so they don't lose bytes to a slow host. While inference runs
+ * (EI_CONSOLE_POLICY_DROP) only result frames are written, a frame that doesn't fit is dropped
+ * whole and the host sees the gap in the frame sequence numbers.
+ */
+void ei_write_string(char *data, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+    console_write((const uint8_t *)data, (size_t)length,
+        printf_policy.load(std::memory_order_relaxed) == EI_CONSOLE_POLICY_DROP ?
+            CONSOLE_WAIT_NONE_WHOLE : CONSOLE_WAIT_CONNECTED);
+}
@@ -0,0 +1,115 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Buffered serial console. ei_printf(), ei_printf_float(), ei_putchar() and ei_write_string()
+ * copy into a ring buffer and return, a background thread drains the ring into Serial in
+ * chunks of whatever the USB serial driver can take, so the caller never waits for the host.
+ * Before ei_console_init() output goes straight to Serial.
+*/
+#ifndef EI_CONSOLE_H
+#define EI_CONSOLE_H
+
+/* Includes ---------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+
+/** Size of the output ring in bytes */
+#ifndef EI_CONSOLE_BUFFER_SIZE
+#define EI_CONSOLE_BUFFER_SIZE          4096
+#endif
+
+/** Longest a blocking ei_printf() or ei_putchar() waits for room in the ring before it drops the rest */
+#ifndef EI_CONSOLE_BLOCK_TIMEOUT_MS
+#define EI_CONSOLE_BLOCK_TIMEOUT_MS     1000
+#endif
+
+/** Largest chunk handed to Serial.write() in one go */
+#ifndef EI_CONSOLE_DRAIN_CHUNK
+#define EI_CONSOLE_DRAIN_CHUNK          512
+#endif
+
+/** ei_printf() formats lines up to this length on the caller's stack, longer ones in a heap buffer */
+#ifndef EI_CONSOLE_PRINTF_STACK_BUFFER
+#define EI_CONSOLE_PRINTF_STACK_BUFFER  128
+#endif
+
+/** Stack size of the drain thread */
+#ifndef EI_CONSOLE_THREAD_STACK_SIZE
+#define EI_CONSOLE_THREAD_STACK_SIZE    1024
+#endif
+
+/** What ei_printf() and ei_putchar() do when the ring is full */
+typedef enum {
+    EI_CONSOLE_POLICY_BLOCK = 0,    // wait for the drain thread, up to EI_CONSOLE_BLOCK_TIMEOUT_MS
+    EI_CONSOLE_POLICY_DROP          // drop what doesn't fit and count it
+} ei_console_policy_t;
+
+#ifndef EI_CONSOLE_DEFAULT_POLICY
+#define EI_CONSOLE_DEFAULT_POLICY       EI_CONSOLE_POLICY_BLOCK
+#endif
+
+typedef struct {
+    uint32_t bytes_written;     // bytes handed to Serial
+    uint32_t bytes_dropped;     // bytes dropped on a full ring (or a blocking write that gave up)
+    uint32_t bytes_discarded;   // bytes drained while no host had the port open
+    uint32_t writes_stalled;    // writes that had to wait for room in the ring
+    size_t high_water_mark;     // highest ring fill level in bytes
+} ei_console_stats_t;
+
+/**
+ * @brief Start the drain thread, call once after Serial.begin()
+ * @return false if the thread could not be created, output stays unbuffered
+ */
+bool ei_console_init(void);
+
+/**
+ * @brief Select what ei_printf() and ei_putchar() do when the ring is full.
+ * ei_write_string() (data transfers) waits without a time limit while a host has the port open,
+ * with EI_CONSOLE_POLICY_DROP it drops a write that doesn't fit as a whole instead.
+ * The inference loops switch to EI_CONSOLE_POLICY_DROP while they run.
+ */
+void ei_console_set_policy(ei_console_policy_t policy);
+ei_console_policy_t ei_console_get_policy(void);
+
+void ei_console_get_stats(ei_console_stats_t *stats);
+
+/**
+ * @brief Wait until everything written so far has been handed to Serial
+ * @param timeout_ms Give up after this long
+ * @return false on timeout
+ */
+bool ei_console_flush(uint32_t timeout_ms = EI_CONSOLE_BLOCK_TIMEOUT_MS);
+
+#endif /* EI_CONSOLE_H */
@@ -41,6 +41,7 @@
 #include "ei_microphone.h"
 #include "ei_device_particle.h"
 #include "ei_flash_memory.h"
+#include "ei_flash_media_ram.h"
 
 #include "Particle.h"
 
@@ -96,7 +97,9 @@ EiDeviceInfo* EiDeviceInfo::get_device(void)
     /* Initializing EdgeImpulse classes here in order for
      * Flash memory to be initialized before mainloop start
      */
-    static EiFlashMemory memory(sizeof(EiConfig));
+    static uint8_t media_buffer[EI_FLASH_MEDIA_RAM_SIZE(EI_FLASH_BLOCK_SIZE, EI_FLASH_N_BLOCKS)];
+    static EiFlashMediaRam media(media_buffer, EI_FLASH_BLOCK_SIZE, EI_FLASH_N_BLOCKS);
+    static EiFlashMemory memory(&media, sizeof(EiConfig));
     static EiDeviceParticle dev(static_cast<EiDeviceMemory*>(&memory));
 
     return &dev;
@@ -0,0 +1,82 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_FLASH_MEDIA_H
+#define EI_FLASH_MEDIA_H
+
+/* Includes ---------------------------------------------------------------- */
+#include <cstdint>
+
+/**
+ * @brief Raw block device underneath EiFlashMemory, with NOR flash semantics:
+ * erase_block() sets a whole block (data and spare area) to 0xFF, programming can
+ * only clear bits. Every block has a small spare area next to its data that the
+ * sample store uses for its own bookkeeping.
+ * All functions return false when the operation failed, the block is treated as bad then.
+ */
+class EiFlashMedia {
+public:
+    EiFlashMedia(uint32_t block_size, uint32_t block_count, uint32_t spare_size, uint32_t erase_time)
+        : block_size(block_size)
+        , block_count(block_count)
+        , spare_size(spare_size)
+        , erase_time(erase_time) {};
+
+    virtual ~EiFlashMedia() {};
+
+    virtual bool read(uint32_t block, uint32_t offset, uint8_t *data, uint32_t num_bytes) = 0;
+    virtual bool program(uint32_t block, uint32_t offset, const uint8_t *data, uint32_t num_bytes) = 0;
+    virtual bool erase_block(uint32_t block) = 0;
+    virtual bool read_spare(uint32_t block, uint8_t *data, uint32_t num_bytes) = 0;
+    virtual bool program_spare(uint32_t block, const uint8_t *data, uint32_t num_bytes) = 0;
+
+    /**
+     * @brief Make sure everything programmed so far is persistent
+     */
+    virtual bool sync(void)
+    {
+        return true;
+    }
+
+    /** data bytes per block */
+    const uint32_t block_size;
+    /** total number of blocks, including bad ones */
+    const uint32_t block_count;
+    /** spare bytes per block */
+    const uint32_t spare_size;
+    /** erase time of a single block in ms */
+    const uint32_t erase_time;
+};
+
+#endif /* EI_FLASH_MEDIA_H */
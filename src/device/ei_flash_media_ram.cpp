@@ -0,0 +1,104 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <cstring>
+
+#include "ei_flash_media_ram.h"
+
+EiFlashMediaRam::EiFlashMediaRam(uint8_t *buffer, uint32_t block_size, uint32_t block_count)
+    : EiFlashMedia(block_size, block_count, EI_FLASH_MEDIA_RAM_SPARE_SIZE, 0)
+    , buffer(buffer)
+{
+    // starts out erased
+    memset(buffer, 0xFF, EI_FLASH_MEDIA_RAM_SIZE(block_size, block_count));
+}
+
+void EiFlashMediaRam::program_at(uint8_t *dest, const uint8_t *data, uint32_t num_bytes)
+{
+    // programming only clears bits
+    for (uint32_t i = 0; i < num_bytes; i++) {
+        dest[i] &= data[i];
+    }
+}
+
+bool EiFlashMediaRam::read(uint32_t block, uint32_t offset, uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || offset + num_bytes > block_size) {
+        return false;
+    }
+
+    memcpy(data, &buffer[block * (block_size + spare_size) + offset], num_bytes);
+    return true;
+}
+
+bool EiFlashMediaRam::program(uint32_t block, uint32_t offset, const uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || offset + num_bytes > block_size) {
+        return false;
+    }
+
+    program_at(&buffer[block * (block_size + spare_size) + offset], data, num_bytes);
+    return true;
+}
+
+bool EiFlashMediaRam::erase_block(uint32_t block)
+{
+    if (block >= block_count) {
+        return false;
+    }
+
+    memset(&buffer[block * (block_size + spare_size)], 0xFF, block_size + spare_size);
+    return true;
+}
+
+bool EiFlashMediaRam::read_spare(uint32_t block, uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || num_bytes > spare_size) {
+        return false;
+    }
+
+    memcpy(data, &buffer[block * (block_size + spare_size) + block_size], num_bytes);
+    return true;
+}
+
+bool EiFlashMediaRam::program_spare(uint32_t block, const uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || num_bytes > spare_size) {
+        return false;
+    }
+
+    program_at(&buffer[block * (block_size + spare_size) + block_size], data, num_bytes);
+    return true;
+}
@@ -0,0 +1,68 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_FLASH_MEDIA_RAM_H
+#define EI_FLASH_MEDIA_RAM_H
+
+/* Includes ---------------------------------------------------------------- */
+#include "ei_flash_media.h"
+
+#define EI_FLASH_MEDIA_RAM_SPARE_SIZE   16
+
+/**
+ * @brief EiFlashMedia in a RAM buffer, with the same NOR semantics as flash: programming
+ * can only clear bits and erasing sets a block to 0xFF. Content is lost on reset.
+ * Blocks are stored back to back, each one followed by its spare area.
+ */
+class EiFlashMediaRam : public EiFlashMedia {
+public:
+    EiFlashMediaRam(uint8_t *buffer, uint32_t block_size, uint32_t block_count);
+
+    bool read(uint32_t block, uint32_t offset, uint8_t *data, uint32_t num_bytes) override;
+    bool program(uint32_t block, uint32_t offset, const uint8_t *data, uint32_t num_bytes) override;
+    bool erase_block(uint32_t block) override;
+    bool read_spare(uint32_t block, uint8_t *data, uint32_t num_bytes) override;
+    bool program_spare(uint32_t block, const uint8_t *data, uint32_t num_bytes) override;
+
+private:
+    void program_at(uint8_t *dest, const uint8_t *data, uint32_t num_bytes);
+
+    uint8_t *buffer;
+};
+
+/** Bytes of RAM needed for block_count blocks of block_size */
+#define EI_FLASH_MEDIA_RAM_SIZE(block_size, block_count) \
+    ((block_size + EI_FLASH_MEDIA_RAM_SPARE_SIZE) * (block_count))
+
+#endif /* EI_FLASH_MEDIA_RAM_H */
@@ -32,107 +32,543 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-/**
- * RAM Implementation using a separate derived class from EiDeviceMemory.
- * The virtual functions used with the EiDeviceRAM class hardfault on Particle Photon 2
-*/
-
 /* Includes ---------------------------------------------------------------- */
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "ei_flash_memory.h"
 
-/* Private variables ------------------------------------------------------- */
-uint8_t ram_memory[RAM_N_BLOCKS * RAM_BLOCK_SIZE];
+/* Private defines --------------------------------------------------------- */
+#define SPARE_MAGIC         0xE15A
+/** Programmed after the data of a block, see flush_data() */
+#define COMMIT_MARKER       0xC0DE
+/** Not 0x00, unformatted flash can read as all zeros */
+#define BAD_MARKER          0x5A
+#define NO_BLOCK            0xFFFF
+/** Bytes copied per step when moving a block */
+#define COPY_CHUNK_SIZE     256
+
+typedef enum {
+    BLOCK_FREE = 0,
+    BLOCK_USED,
+    BLOCK_PENDING_ERASE,
+    BLOCK_BAD
+} block_state_t;
+
+/**
+ * Spare area of a block. Fields are programmed at different times (after the erase,
+ * on allocation, after the data, when retired) and only ever go from 0xFF to their value.
+ */
+typedef struct {
+    uint32_t erase_count;
+    uint16_t magic;
+    uint8_t bad;
+    uint8_t obsolete;
+    uint16_t logical;
+    uint16_t committed;
+    uint32_t seq;
+} spare_t;
+
+static bool is_erased(const spare_t *spare)
+{
+    const uint8_t *bytes = (const uint8_t *)spare;
+
+    for (size_t i = 0; i < sizeof(spare_t); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+EiFlashMemory::EiFlashMemory(EiFlashMedia *media, uint32_t config_size):
+    EiDeviceMemory(config_size, media->erase_time,
+        (media->block_count > EI_FLASH_SPARE_BLOCKS ? media->block_count - EI_FLASH_SPARE_BLOCKS : 0) * media->block_size,
+        media->block_size),
+    media(media),
+    blocks(nullptr),
+    logical_map(nullptr),
+    erase_queue(nullptr),
+    erase_queue_head(0),
+    erase_queue_count(0),
+    next_seq(0),
+    bad_blocks(0)
+{
+    if (!mount()) {
+        ei_printf("ERR: Failed to mount sample flash\n");
+        unmount();
+        memory_blocks = 0;
+        memory_size = 0;
+    }
+}
+
+EiFlashMemory::~EiFlashMemory()
+{
+    unmount();
+}
+
+bool EiFlashMemory::mount(void)
+{
+    if (memory_blocks == 0 || media->block_count >= NO_BLOCK || media->spare_size < sizeof(spare_t)) {
+        return false;
+    }
+
+    blocks = (ei_flash_block_t *)ei_calloc(media->block_count, sizeof(ei_flash_block_t));
+    logical_map = (uint16_t *)ei_malloc(memory_blocks * sizeof(uint16_t));
+    erase_queue = (uint16_t *)ei_malloc(media->block_count * sizeof(uint16_t));
+
+    if (!blocks || !logical_map || !erase_queue) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < memory_blocks; i++) {
+        logical_map[i] = NO_BLOCK;
+    }
+
+    for (uint16_t block = 0; block < media->block_count; block++) {
+        spare_t spare;
+
+        if (!media->read_spare(block, (uint8_t *)&spare, sizeof(spare_t))) {
+            return false;
+        }
+
+        blocks[block].logical = NO_BLOCK;
+
+        if (spare.bad == BAD_MARKER) {
+            blocks[block].state = BLOCK_BAD;
+            bad_blocks++;
+            continue;
+        }
+
+        // erased but never formatted (e.g. a new flash file), the spare is only programmed after
+        // the erase so the data is erased as well
+        if (is_erased(&spare)) {
+            blocks[block].state = BLOCK_FREE;
+            continue;
+        }
+
+        // never formatted, or erase didn't complete
+        if (spare.magic != SPARE_MAGIC) {
+            retire_block(block);
+            continue;
+        }
+
+        blocks[block].erase_count = spare.erase_count;
+        blocks[block].formatted = true;
+
+        if (spare.logical == NO_BLOCK) {
+            blocks[block].state = BLOCK_FREE;
+            continue;
+        }
+
+        // an uncommitted copy is an interrupted write, whatever it replaces is still there
+        if (spare.obsolete == 0x00 || spare.logical >= memory_blocks || spare.committed != COMMIT_MARKER) {
+            retire_block(block);
+            continue;
+        }
+
+        if (spare.seq >= next_seq) {
+            next_seq = spare.seq + 1;
+        }
+
+        // the newest copy of a logical block wins
+        uint16_t current = logical_map[spare.logical];
+        if (current != NO_BLOCK) {
+            if (blocks[current].seq > spare.seq) {
+                retire_block(block);
+                continue;
+            }
+            retire_block(current);
+        }
+
+        blocks[block].state = BLOCK_USED;
+        blocks[block].logical = spare.logical;
+        blocks[block].seq = spare.seq;
+        blocks[block].committed = true;
+        logical_map[spare.logical] = block;
+    }
+
+    return true;
+}
+
+void EiFlashMemory::unmount(void)
+{
+    ei_free(blocks);
+    ei_free(logical_map);
+    ei_free(erase_queue);
+
+    blocks = nullptr;
+    logical_map = nullptr;
+    erase_queue = nullptr;
+    erase_queue_head = 0;
+    erase_queue_count = 0;
+    next_seq = 0;
+    bad_blocks = 0;
+}
+
+bool EiFlashMemory::program_spare(uint16_t block, uint32_t erase_count, uint8_t bad, uint8_t obsolete, uint16_t logical, uint32_t seq)
+{
+    spare_t spare;
+
+    memset(&spare, 0xFF, sizeof(spare_t));
+    spare.erase_count = erase_count;
+    if (erase_count != 0xFFFFFFFF) {
+        spare.magic = SPARE_MAGIC;
+    }
+    spare.bad = bad;
+    spare.obsolete = obsolete;
+    spare.logical = logical;
+    spare.seq = seq;
+
+    return media->program_spare(block, (const uint8_t *)&spare, sizeof(spare_t));
+}
+
+bool EiFlashMemory::commit_block(uint16_t block)
+{
+    spare_t spare;
+
+    memset(&spare, 0xFF, sizeof(spare_t));
+    spare.committed = COMMIT_MARKER;
+
+    if (!media->program_spare(block, (const uint8_t *)&spare, sizeof(spare_t))) {
+        return false;
+    }
+
+    blocks[block].committed = true;
+
+    return true;
+}
+
+/**
+ * Unmap a block and queue it for erase
+ */
+void EiFlashMemory::retire_block(uint16_t block)
+{
+    if (blocks[block].state == BLOCK_USED) {
+        // so it's not picked up again on the next mount, if that fails it's erased before anyway
+        program_spare(block, 0xFFFFFFFF, 0xFF, 0x00, NO_BLOCK, 0xFFFFFFFF);
+    }
+
+    blocks[block].state = BLOCK_PENDING_ERASE;
+    blocks[block].logical = NO_BLOCK;
+
+    erase_queue[(erase_queue_head + erase_queue_count) % media->block_count] = block;
+    erase_queue_count++;
+}
+
+void EiFlashMemory::mark_bad(uint16_t block)
+{
+    program_spare(block, 0xFFFFFFFF, BAD_MARKER, 0xFF, NO_BLOCK, 0xFFFFFFFF);
+
+    blocks[block].state = BLOCK_BAD;
+    blocks[block].logical = NO_BLOCK;
+    bad_blocks++;
+}
+
+uint32_t EiFlashMemory::erase_ahead(uint32_t max_blocks)
+{
+    uint32_t n_erased = 0;
+
+    while (n_erased < max_blocks && erase_queue_count > 0) {
+        uint16_t block = erase_queue[erase_queue_head];
+        erase_queue_head = (erase_queue_head + 1) % media->block_count;
+        erase_queue_count--;
+        n_erased++;
+
+        uint32_t erase_count = blocks[block].erase_count + 1;
+
+        if (!media->erase_block(block) || !program_spare(block, erase_count, 0xFF, 0xFF, NO_BLOCK, 0xFFFFFFFF)) {
+            mark_bad(block);
+            continue;
+        }
+
+        blocks[block].erase_count = erase_count;
+        blocks[block].state = BLOCK_FREE;
+        blocks[block].formatted = true;
+        blocks[block].committed = false;
+    }
+
+    return n_erased;
+}
+
+/**
+ * Map a logical block to the least worn erased block, erases queued blocks when none is left
+ */
+uint16_t EiFlashMemory::allocate_block(uint16_t logical)
+{
+    while (true) {
+        uint16_t best = NO_BLOCK;
+
+        for (uint16_t block = 0; block < media->block_count; block++) {
+            if (blocks[block].state == BLOCK_FREE
+                && (best == NO_BLOCK || blocks[block].erase_count < blocks[best].erase_count)) {
+                best = block;
+            }
+        }
+
+        if (best == NO_BLOCK) {
+            if (erase_ahead(1) == 0) {
+                return NO_BLOCK;
+            }
+            continue;
+        }
+
+        uint32_t erase_count = blocks[best].formatted ? 0xFFFFFFFF : blocks[best].erase_count;
+        if (!program_spare(best, erase_count, 0xFF, 0xFF, logical, next_seq)) {
+            mark_bad(best);
+            continue;
+        }
+
+        blocks[best].formatted = true;
+        blocks[best].committed = false;
+        blocks[best].state = BLOCK_USED;
+        blocks[best].logical = logical;
+        blocks[best].seq = next_seq++;
+        logical_map[logical] = best;
+
+        return best;
+    }
+}
+
+/**
+ * Move the content of a block that failed to program to a new one and retire the old one as bad.
+ * The old block is only marked bad once the copy is complete (and committed if the old one was).
+ */
+uint16_t EiFlashMemory::relocate_block(uint16_t logical, uint16_t old_block)
+{
+    uint8_t chunk[COPY_CHUNK_SIZE];
+    bool was_committed = blocks[old_block].committed;
+
+    while (true) {
+        uint16_t block = allocate_block(logical);
+        if (block == NO_BLOCK) {
+            mark_bad(old_block);
+            logical_map[logical] = NO_BLOCK;
+            return NO_BLOCK;
+        }
+
+        bool ok = true;
+        for (uint32_t offset = 0; offset < block_size && ok; offset += COPY_CHUNK_SIZE) {
+            uint32_t n = block_size - offset < COPY_CHUNK_SIZE ? block_size - offset : COPY_CHUNK_SIZE;
+            ok = media->read(old_block, offset, chunk, n) && media->program(block, offset, chunk, n);
+        }
+
+        if (ok && (!was_committed || commit_block(block))) {
+            mark_bad(old_block);
+            return block;
+        }
+
+        mark_bad(block);
+    }
+}
 
 uint32_t EiFlashMemory::read_data(uint8_t *data, uint32_t address, uint32_t num_bytes)
 {
+    uint32_t n_read = 0;
+
+    if (address >= memory_size) {
+        return 0;
+    }
     if (num_bytes > memory_size - address) {
         num_bytes = memory_size - address;
     }
 
-    memcpy(data, &ram_memory[address], num_bytes);
+    while (n_read < num_bytes) {
+        uint32_t logical = (address + n_read) / block_size;
+        uint32_t offset = (address + n_read) % block_size;
+        uint32_t n = block_size - offset;
+        if (n > num_bytes - n_read) {
+            n = num_bytes - n_read;
+        }
 
-    return num_bytes;
+        uint16_t block = logical_map[logical];
+        if (block == NO_BLOCK) {
+            memset(data + n_read, 0xFF, n);
+        }
+        else if (!media->read(block, offset, data + n_read, n)) {
+            break;
+        }
+
+        n_read += n;
+    }
+
+    return n_read;
 }
 
 uint32_t EiFlashMemory::write_data(const uint8_t *data, uint32_t address, uint32_t num_bytes)
 {
+    uint32_t n_written = 0;
+
+    if (address >= memory_size) {
+        return 0;
+    }
     if (num_bytes > memory_size - address) {
         num_bytes = memory_size - address;
     }
 
-    memcpy(&ram_memory[address], data, num_bytes);
+    while (n_written < num_bytes) {
+        uint32_t logical = (address + n_written) / block_size;
+        uint32_t offset = (address + n_written) % block_size;
+        uint32_t n = block_size - offset;
+        if (n > num_bytes - n_written) {
+            n = num_bytes - n_written;
+        }
 
-    return num_bytes;
+        uint16_t block = logical_map[logical];
+        if (block == NO_BLOCK) {
+            block = allocate_block(logical);
+        }
+
+        // every failure retires a block, so this ends
+        while (block != NO_BLOCK && !media->program(block, offset, data + n_written, n)) {
+            block = relocate_block(logical, block);
+        }
+
+        if (block == NO_BLOCK) {
+            break;
+        }
+
+        n_written += n;
+    }
+
+    return n_written;
 }
 
+/**
+ * Unmap all blocks touched by the region, they're erased later from the erase queue
+ */
 uint32_t EiFlashMemory::erase_data(uint32_t address, uint32_t num_bytes)
 {
+    if (address >= memory_size) {
+        return 0;
+    }
     if (num_bytes > memory_size - address) {
         num_bytes = memory_size - address;
     }
 
-    memset(&ram_memory[address], 0, num_bytes);
+    for (uint32_t logical = address / block_size; logical * block_size < address + num_bytes; logical++) {
+        uint16_t block = logical_map[logical];
+        if (block != NO_BLOCK) {
+            retire_block(block);
+            logical_map[logical] = NO_BLOCK;
+        }
+    }
 
     return num_bytes;
 }
 
 uint32_t EiFlashMemory::get_available_sample_blocks(void)
 {
-    return memory_blocks - used_blocks;
+    // keep one block for out-of-place config updates
+    uint32_t good_blocks = media->block_count - bad_blocks - 1;
+    uint32_t usable_blocks = good_blocks < memory_blocks ? good_blocks : memory_blocks;
+
+    return usable_blocks > used_blocks ? usable_blocks - used_blocks : 0;
 }
 
 uint32_t EiFlashMemory::get_available_sample_bytes(void)
 {
-    return (memory_blocks - used_blocks) * block_size;
+    return get_available_sample_blocks() * block_size;
 }
 
+/**
+ * Write and commit the config to new blocks first, the old ones are only retired when that worked
+ */
 bool EiFlashMemory::save_config(const uint8_t *config, uint32_t config_size)
 {
-    uint32_t used_bytes = used_blocks * block_size;
-    if (erase_data(0, used_bytes) != used_bytes) {
+    if (used_blocks == 0 || config_size > used_blocks * block_size) {
         return false;
     }
 
-    if (write_data(config, 0, config_size) != config_size) {
+    uint16_t *old_blocks = (uint16_t *)ei_malloc(used_blocks * sizeof(uint16_t));
+    if (old_blocks == nullptr) {
         return false;
     }
 
-    return true;
-}
+    for (uint32_t logical = 0; logical < used_blocks; logical++) {
+        old_blocks[logical] = logical_map[logical];
+        logical_map[logical] = NO_BLOCK;
+    }
 
-bool EiFlashMemory::load_config(uint8_t *config, uint32_t config_size)
-{
-    if (read_data(config, 0, config_size) != config_size) {
-        return false;
+    bool ok = write_data(config, 0, config_size) == config_size;
+    if (ok) {
+        flush_data();
+        for (uint32_t logical = 0; logical < used_blocks && ok; logical++) {
+            ok = logical_map[logical] == NO_BLOCK || blocks[logical_map[logical]].committed;
+        }
     }
-    return true;
-}
 
-uint32_t EiFlashMemory::read_sample_data(uint8_t *sample_data, uint32_t address, uint32_t sample_data_size)
-{
-    uint32_t offset = used_blocks * block_size;
+    for (uint32_t logical = 0; logical < used_blocks; logical++) {
+        uint16_t retired = ok ? old_blocks[logical] : logical_map[logical];
+
+        if (!ok) {
+            logical_map[logical] = old_blocks[logical];
+        }
+        if (retired != NO_BLOCK) {
+            retire_block(retired);
+        }
+    }
+
+    ei_free(old_blocks);
+
+    media->sync();
 
-    return read_data(sample_data, offset + address, sample_data_size);
+    return ok;
 }
 
-uint32_t EiFlashMemory::write_sample_data(const uint8_t *sample_data, uint32_t address, uint32_t sample_data_size)
+/**
+ * Make the written data persistent, then commit the blocks that were written since the last flush
+ */
+uint32_t EiFlashMemory::flush_data(void)
 {
-    uint32_t offset = used_blocks * block_size;
+    media->sync();
+
+    for (uint16_t block = 0; blocks != nullptr && block < media->block_count; block++) {
+        if (blocks[block].state != BLOCK_USED || blocks[block].committed) {
+            continue;
+        }
 
-    return write_data(sample_data, offset + address, sample_data_size);
+        uint16_t logical = blocks[block].logical;
+        uint16_t current = block;
+
+        // every failure retires a block, so this ends
+        while (current != NO_BLOCK && !commit_block(current)) {
+            current = relocate_block(logical, current);
+        }
+    }
+
+    media->sync();
+
+    return 0;
 }
 
-uint32_t EiFlashMemory::erase_sample_data(uint32_t address, uint32_t num_bytes)
+uint32_t EiFlashMemory::get_pending_erase_blocks(void)
 {
-    uint32_t offset = used_blocks * block_size;
-
-    return erase_data(offset + address, num_bytes);
+    return erase_queue_count;
 }
 
+uint32_t EiFlashMemory::get_bad_blocks(void)
+{
+    return bad_blocks;
+}
 
-EiFlashMemory::EiFlashMemory(uint32_t config_size):
-    EiDeviceMemory(config_size, RAM_ERASE_TIME, RAM_N_BLOCKS * RAM_BLOCK_SIZE, RAM_BLOCK_SIZE)
+void EiFlashMemory::get_erase_count_range(uint32_t *min_count, uint32_t *max_count)
 {
+    *min_count = 0xFFFFFFFF;
+    *max_count = 0;
 
-}
\ No newline at end of file
+    for (uint16_t block = 0; blocks != nullptr && block < media->block_count; block++) {
+        if (blocks[block].state == BLOCK_BAD) {
+            continue;
+        }
+        if (blocks[block].erase_count < *min_count) {
+            *min_count = blocks[block].erase_count;
+        }
+        if (blocks[block].erase_count > *max_count) {
+            *max_count = blocks[block].erase_count;
+        }
+    }
+
+    if (*min_count > *max_count) {
+        *min_count = 0;
+    }
+}
@@ -32,37 +32,84 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 /**
- * RAM Implementation using a separate derived class from EiDeviceMemory.
- * The virtual functions used with the EiDeviceRAM class hardfault on Particle Photon 2
+ * Log-structured sample store on top of a raw EiFlashMedia.
+ * Logical blocks of EiDeviceMemory are mapped to physical blocks on the first write.
+ * Erasing only unmaps blocks and queues them, the actual erases are done on allocation
+ * when no erased block is left, or ahead of time (erase_ahead()) on media with slow erases.
+ * New blocks are taken from the erased ones with the lowest erase count, blocks that fail
+ * to erase or program are marked bad and never used again.
+ * Blocks are committed in flush_data(), after their data. Mount ignores copies that were
+ * never committed, so an interrupted write or out-of-place update leaves the old data.
 */
 #ifndef EI_FLASH_MEMORY_H
 #define EI_FLASH_MEMORY_H
 
 /* Includes ---------------------------------------------------------------- */
 #include "firmware-sdk/ei_device_memory.h"
+#include "ei_flash_media.h"
 
 /*
   Flash Related Parameter Define
+  The Photon 2 has no flash for samples, they are kept in RAM (EiFlashMediaRam)
 */
-#define RAM_ERASE_TIME      10
-#define RAM_N_BLOCKS        112
-#define RAM_BLOCK_SIZE      512
+#define EI_FLASH_N_BLOCKS       112
+#define EI_FLASH_BLOCK_SIZE     512
+/** Physical blocks that are not exposed as logical ones, room for bad blocks and out-of-place updates */
+#define EI_FLASH_SPARE_BLOCKS   8
+
+/** Per physical block state kept in RAM, rebuilt from the spare areas on mount */
+typedef struct {
+    uint32_t erase_count;
+    uint32_t seq;
+    uint16_t logical;
+    uint8_t state;
+    bool formatted;     // false if the block was found erased on mount, the spare is formatted on allocation
+    bool committed;
+} ei_flash_block_t;
 
 class EiFlashMemory : public EiDeviceMemory {
 protected:
-    uint32_t read_data(uint8_t *data, uint32_t address, uint32_t num_bytes);
-    uint32_t write_data(const uint8_t *data, uint32_t address, uint32_t num_bytes);
-    uint32_t erase_data(uint32_t address, uint32_t num_bytes);
+    uint32_t read_data(uint8_t *data, uint32_t address, uint32_t num_bytes) override;
+    uint32_t write_data(const uint8_t *data, uint32_t address, uint32_t num_bytes) override;
+    uint32_t erase_data(uint32_t address, uint32_t num_bytes) override;
+
+public:
+    EiFlashMemory(EiFlashMedia *media, uint32_t config_size);
+    ~EiFlashMemory();
     uint32_t get_available_sample_blocks(void) override;
     uint32_t get_available_sample_bytes(void) override;
     bool save_config(const uint8_t *config, uint32_t config_size) override;
-    bool load_config(uint8_t *config, uint32_t config_size) override;
-    uint32_t read_sample_data(uint8_t *sample_data, uint32_t address, uint32_t sample_data_size) override;
-    uint32_t write_sample_data(const uint8_t *sample_data, uint32_t address, uint32_t sample_data_size) override;
-    uint32_t erase_sample_data(uint32_t address, uint32_t num_bytes) override;
+    uint32_t flush_data(void) override;
 
-public:
-    EiFlashMemory(uint32_t config_size);
+    /**
+     * @brief Erase blocks from the erase queue
+     * @param max_blocks maximum number of blocks to erase
+     * @return number of blocks taken from the queue
+     */
+    uint32_t erase_ahead(uint32_t max_blocks);
+
+    uint32_t get_pending_erase_blocks(void);
+    uint32_t get_bad_blocks(void);
+    void get_erase_count_range(uint32_t *min_count, uint32_t *max_count);
+
+private:
+    bool mount(void);
+    void unmount(void);
+    uint16_t allocate_block(uint16_t logical);
+    uint16_t relocate_block(uint16_t logical, uint16_t old_block);
+    void retire_block(uint16_t block);
+    void mark_bad(uint16_t block);
+    bool commit_block(uint16_t block);
+    bool program_spare(uint16_t block, uint32_t erase_count, uint8_t bad, uint8_t obsolete, uint16_t logical, uint32_t seq);
+
+    EiFlashMedia *media;
+    ei_flash_block_t *blocks;
+    uint16_t *logical_map;
+    uint16_t *erase_queue;
+    uint32_t erase_queue_head;
+    uint32_t erase_queue_count;
+    uint32_t next_seq;
+    uint32_t bad_blocks;
 };
 
 #endif /* EI_FLASH_MEMORY_H */
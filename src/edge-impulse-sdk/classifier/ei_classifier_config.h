@@ -100,6 +100,82 @@
     #endif // ESP32P4 check
 #endif
 
+// Portable SIMD (AVX2 / SSE2, or GCC / Clang vector extensions) int8 FULLY_CONNECTED, CONV_2D and
+// DEPTHWISE_CONV_2D kernels for targets that run the reference kernels, e.g. a Linux host replaying
+// data for validation. Bit-exact with the reference kernels; no effect with CMSIS-NN, ARC MLI, ESP-NN or MVP.
+#ifndef EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD
+    #define EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD     0
+#endif // EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD
+
+// Run the MFE (implementation version 3 and up) and MFCC blocks of the model through the fixed-point
+// int16 feature path (extract_mfe_features_q15 / extract_mfcc_features_q15), also in continuous mode.
+// MFCC blocks with a 0 Hz low frequency (v4+) keep the float path, see ei_dsp_block_extract_fn().
+// Without it a block only takes the fixed-point path when its extract_fn is set to the q15 variant.
+#ifndef EI_CLASSIFIER_DSP_AUDIO_Q15
+    #define EI_CLASSIFIER_DSP_AUDIO_Q15                   0
+#endif // EI_CLASSIFIER_DSP_AUDIO_Q15
+
+// Keep the TFLite interpreter / EON model, its arena and memory plan alive between
+// run_classifier_init() and run_classifier_deinit() instead of setting them up on every inference.
+// Trades the arena being allocated at all times for lower per-inference latency (e.g. in continuous mode).
+#ifndef EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER
+    #define EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER     0
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER
+
+// Maximum number of TFLite graphs (learning blocks) that can be kept resident at the same time
+#ifndef EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS
+    #define EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS      4
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS
+
+// Size (in bytes) of one static region that DSP scratch and the TFLite / EON tensor arena time-share
+// during inference (see ei_shared_arena.h), 0 to allocate both from the heap. The tensor arena is placed
+// at the top of the region after the DSP scratch is gone, only the feature matrices live through both.
+#ifndef EI_CLASSIFIER_SHARED_ARENA_SIZE
+    #define EI_CLASSIFIER_SHARED_ARENA_SIZE               0
+#endif // EI_CLASSIFIER_SHARED_ARENA_SIZE
+
+// Allocate the process_impulse_continuous() workspace in run_classifier_init() (only for impulses
+// whose DSP blocks can run continuously), so the continuous loop starts without allocating.
+// 0 to allocate it on the first run_classifier_continuous() call instead.
+#ifndef EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT
+    #define EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT    1
+#endif // EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT
+
+// Check that process_impulse_continuous() does not allocate on the heap once run_classifier_init()
+// has run: every DSP scratch buffer, matrix and tensor arena taken from the heap between entry and
+// exit of a slice is counted (ei_shared_arena_heap_alloc_count()), and a slice with any fails with
+// EI_IMPULSE_CONTINUOUS_HEAP_ALLOCATION. Zero is only reachable with
+// EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER=1 and an EI_CLASSIFIER_SHARED_ARENA_SIZE that holds the
+// DSP scratch and the tensor arena at once; without them the scratch and the arena of every slice come
+// from the heap. Objects created with operator new (e.g. the TFLM interpreter) are not counted.
+#ifndef EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS
+    #define EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS    0
+#endif // EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS
+
+// Record time, cycles, bytes touched and scratch usage of every operator the TFLite interpreter or
+// an EON model runs into a fixed-size ring (see ei_op_profiler.h). EON operators are recorded through
+// the registrations of tflite::micro::RegisterOp(), at most 16 operator types per build.
+// Recording is switched on and off at runtime with ei_op_profiler_enable().
+#ifndef EI_CLASSIFIER_OP_PROFILER
+    #define EI_CLASSIFIER_OP_PROFILER                     0
+#endif // EI_CLASSIFIER_OP_PROFILER
+
+// Have the operator profiler record from boot, instead of after ei_op_profiler_enable(true)
+#ifndef EI_CLASSIFIER_OP_PROFILER_ENABLED_AT_BOOT
+    #define EI_CLASSIFIER_OP_PROFILER_ENABLED_AT_BOOT     0
+#endif // EI_CLASSIFIER_OP_PROFILER_ENABLED_AT_BOOT
+
+// Number of operator events kept in the profiler ring
+#ifndef EI_CLASSIFIER_OP_PROFILER_RING_SIZE
+    #define EI_CLASSIFIER_OP_PROFILER_RING_SIZE           32
+#endif // EI_CLASSIFIER_OP_PROFILER_RING_SIZE
+
+// Number of operators (over all graphs and subgraphs) for which the profiler keeps the scratch usage
+// found at prepare time
+#ifndef EI_CLASSIFIER_OP_PROFILER_MAX_OPS
+    #define EI_CLASSIFIER_OP_PROFILER_MAX_OPS             64
+#endif // EI_CLASSIFIER_OP_PROFILER_MAX_OPS
+
 // no include checks in the compiler? then just include metadata and then ops_define (optional if on EON model)
 #ifndef __has_include
     #include "model-parameters/model_metadata.h"
@@ -39,6 +39,7 @@
 // needed for standalone C example
 #include "model-parameters/model_metadata.h"
 #include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 
 #ifndef EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT
 #define EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT 10
@@ -237,6 +238,19 @@ typedef struct {
      * the impulse contains an anomaly detection block, otherwise 0.
      */
     int64_t anomaly_us;
+
+    /**
+     * Part of `classification_us` (in microseconds) spent before invoking the model:
+     * setting up the inference engine (arena, interpreter, tensor allocation) and
+     * filling the input tensor. Setup is skipped if the interpreter is kept resident
+     * (`EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER`).
+     */
+    int64_t classification_setup_us;
+
+    /**
+     * Part of `classification_us` (in microseconds) spent invoking the model
+     */
+    int64_t classification_invoke_us;
 } ei_impulse_result_timing_t;
 
 /**
@@ -307,6 +321,12 @@ typedef struct {
      * Timing information for the processing (DSP) and inference blocks.
      */
     ei_impulse_result_timing_t timing;
+
+    /**
+     * Per-operator profile of the last model invocation. Empty unless the SDK is built
+     * with `EI_CLASSIFIER_OP_PROFILER=1` and the profiler is enabled.
+     */
+    ei_impulse_result_op_profile_t op_profile;
 #ifdef __cplusplus
     /**
      * Raw outputs from the neural network. The number of elements in this array is
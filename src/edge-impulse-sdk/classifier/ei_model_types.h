@@ -437,12 +437,103 @@ typedef struct ei_impulse {
     uint32_t *freeform_outputs;
 } ei_impulse_t;
 
+/**
+ * State of a continuous audio DSP block (MFCC, MFE, spectrogram), kept between slices.
+ * The block's part of the feature window is a ring: new rows are written over the oldest
+ * ones at `window_head`, so the window is never rolled. `frame` is a ring as well.
+ * The buffers are sized by run_classifier_init() and kept until run_classifier_deinit().
+ */
+typedef struct {
+    float *frame;                   // frame that was not complete at the end of the last slice
+    size_t frame_size;
+    int frame_ix;                   // number of samples in `frame`
+    size_t frame_start;             // first sample of `frame`
+    float *preemphasis_history;     // last raw samples of the last slice
+    int preemphasis_history_size;
+    bool has_preemphasis_history;
+    bool first_run;                 // implementation version 1 stack frame workaround
+    size_t window_head;             // oldest value in the block's feature window
+    EIDSP_i16 *pcm;                 // fixed-point blocks: preemphasis history, then the samples not framed yet
+    size_t pcm_size;
+    size_t pcm_len;                 // number of samples after the history
+    bool has_pcm_history;
+} ei_dsp_cont_state_t;
+
+/**
+ * Buffers used by process_impulse_continuous(). Allocated once by run_classifier_init()
+ * so the continuous loop does not touch the heap for every slice.
+ */
+typedef struct {
+    ei::matrix_t *features_matrix;      // sliding window of DSP output features, a ring per DSP block
+    ei_dsp_cont_state_t *block_states;  // per DSP block slice state
+    uint64_t features_written;
+    ei::matrix_t *normalized_matrix;    // normalized copy of the window, passed to the learn blocks
+    ei::matrix_t **block_matrices;      // per DSP block views into normalized_matrix
+    ei_feature_t *features;
+    size_t features_size;
+    ei_feature_t *raw_outputs;
+    size_t raw_outputs_size;
+    ei_impulse_result_classification_t *classification;
+    size_t classification_size;
+} ei_continuous_workspace_t;
+
+// Kept boxes are bucketed on a grid of at most EI_NMS_GRID_DIM x EI_NMS_GRID_DIM cells
+#ifndef EI_NMS_GRID_DIM
+#define EI_NMS_GRID_DIM 16
+#endif
+
+/**
+ * Buffers used by ei_run_nms(). Grown on demand and kept on the impulse state,
+ * so object detection post-processing does not touch the heap for every frame.
+ */
+typedef struct {
+    float *boxes;       // [y1, x1, y2, x2] per box, filled when NMS runs over a results vector
+    float *scores;
+    int *classes;
+    float *corners;     // [x1, y1, x2, y2] per box, normalized so x1 <= x2 and y1 <= y2
+    int *order;         // candidates above the score threshold, highest score first
+    int *next;          // per box link in the grid cell list of kept boxes
+    int *selected;      // kept boxes, highest score first
+    int *cell_heads;    // EI_NMS_GRID_DIM * EI_NMS_GRID_DIM list heads
+    size_t capacity;    // number of boxes the buffers above can hold
+} ei_nms_workspace_t;
+
+/**
+ * A connected group of FOMO grid cells for one class, corners are inclusive cell coordinates
+ */
+typedef struct {
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t label_ix;  // index into impulse->categories
+    float value;        // highest output value in the group (raw int8 value for quantized models)
+} ei_fomo_component_t;
+
+/**
+ * Buffers used by the FOMO decoder. Sized for the output grid on first use and kept on the
+ * impulse state, so decoding a frame does not touch the heap.
+ */
+typedef struct {
+    uint8_t *row_hits;                  // per output value in the current grid row, 1 if above the threshold
+    uint32_t *row_labels;               // provisional labels per cell and class, previous and current grid row
+    uint32_t *parent;                   // union-find parent per provisional label, always points to a lower label
+    ei_fomo_component_t *components;    // bounds and peak value per provisional label
+    size_t row_values;                  // number of output values in one grid row
+    size_t max_labels;                  // number of provisional labels (including the unused label 0) the buffers can hold
+} ei_fomo_workspace_t;
+
 class ei_impulse_state_t {
 typedef DspHandle* _dsp_handle_ptr_t;
 public:
     const ei_impulse_t *impulse; // keep a pointer to the impulse
     _dsp_handle_ptr_t *dsp_handles;
     bool is_temp_handle = false; // to know if we're using the old (stateless) API
+    bool mel_tables_acquired = false; // run_classifier_init() took references to the cached DSP tables
+    ei_continuous_workspace_t continuous;
+    ei_nms_workspace_t nms;
+    ei_fomo_workspace_t fomo;
+    ei::numpy::fft_plans_t fft_plans; // software FFT plans, built by run_classifier_init()
     ei_impulse_state_t(const ei_impulse_t *impulse)
         : impulse(impulse)
     {
@@ -451,6 +542,10 @@ public:
         for(size_t ix = 0; ix < num_dsp_blocks; ix++) {
             dsp_handles[ix] = nullptr;
         }
+        memset(&continuous, 0, sizeof(continuous));
+        memset(&nms, 0, sizeof(nms));
+        memset(&fomo, 0, sizeof(fomo));
+        memset(&fft_plans, 0, sizeof(fft_plans));
     }
 
     DspHandle* get_dsp_handle(size_t ix) {
@@ -470,6 +565,300 @@ public:
         }
     }
 
+    // workspace buffers show up in ei_memory_in_use when EIDSP_TRACK_ALLOCATIONS is set
+    static void* workspace_calloc(size_t num, size_t size)
+    {
+        void *ptr = ei_calloc(num, size);
+        if (ptr) {
+            ei_dsp_register_alloc(num * size, ptr);
+        }
+        return ptr;
+    }
+
+    static void workspace_free(void *ptr, size_t size)
+    {
+        ei_free(ptr);
+        ei_dsp_register_free(size, ptr);
+    }
+
+    /**
+     * Allocate the continuous workspace, does nothing if it's already allocated
+     * @return false if we ran out of memory
+     */
+    bool alloc_continuous_workspace()
+    {
+        if (continuous.features_matrix != nullptr) {
+            return true;
+        }
+
+        ei_continuous_workspace_t *ws = &continuous;
+
+        ws->features_matrix = new ei::matrix_t(1, impulse->nn_input_frame_size);
+        ws->normalized_matrix = new ei::matrix_t(1, impulse->nn_input_frame_size);
+        if (!ws->features_matrix || !ws->features_matrix->buffer ||
+            !ws->normalized_matrix || !ws->normalized_matrix->buffer) {
+            free_continuous_workspace();
+            return false;
+        }
+
+        ws->block_matrices = (ei::matrix_t**)workspace_calloc(impulse->dsp_blocks_size, sizeof(ei::matrix_t*));
+        ws->block_states = (ei_dsp_cont_state_t*)workspace_calloc(impulse->dsp_blocks_size, sizeof(ei_dsp_cont_state_t));
+        if (!ws->block_matrices || !ws->block_states) {
+            free_continuous_workspace();
+            return false;
+        }
+
+        size_t out_features_index = 0;
+        for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+            uint32_t n_output_features = impulse->dsp_blocks[ix].n_output_features;
+            if (out_features_index + n_output_features > impulse->nn_input_frame_size) {
+                free_continuous_workspace();
+                return false;
+            }
+            ws->block_matrices[ix] = new ei::matrix_t(1, n_output_features,
+                ws->normalized_matrix->buffer + out_features_index);
+            if (!ws->block_matrices[ix]) {
+                free_continuous_workspace();
+                return false;
+            }
+            out_features_index += n_output_features;
+        }
+
+        ws->features_size = impulse->dsp_blocks_size + impulse->learning_blocks_size;
+        ws->features = (ei_feature_t*)workspace_calloc(ws->features_size, sizeof(ei_feature_t));
+
+        // learning blocks index into this with their output tensor ids
+        ws->raw_outputs_size = impulse->output_tensors_size > impulse->learning_blocks_size ?
+            impulse->output_tensors_size : impulse->learning_blocks_size;
+        ws->raw_outputs = (ei_feature_t*)workspace_calloc(ws->raw_outputs_size, sizeof(ei_feature_t));
+
+#ifdef EI_DSP_RESULT_OVERRIDE
+        ws->classification_size = EI_DSP_RESULT_OVERRIDE;
+#else
+        ws->classification_size = impulse->label_count;
+#endif
+        if (ws->classification_size > 0) {
+            ws->classification = (ei_impulse_result_classification_t*)workspace_calloc(
+                ws->classification_size, sizeof(ei_impulse_result_classification_t));
+        }
+
+        if (!ws->features || !ws->raw_outputs ||
+            (ws->classification_size > 0 && !ws->classification)) {
+            free_continuous_workspace();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Start a new continuous stream: forget the features and the slice state of the DSP blocks,
+     * but keep their slice buffers
+     */
+    void reset_continuous_workspace()
+    {
+        ei_continuous_workspace_t *ws = &continuous;
+
+        ws->features_written = 0;
+        if (ws->block_states) {
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                ei_dsp_cont_state_t *state = &ws->block_states[ix];
+                state->frame_ix = 0;
+                state->frame_start = 0;
+                state->has_preemphasis_history = false;
+                state->first_run = false;
+                state->window_head = 0;
+                state->pcm_len = 0;
+                state->has_pcm_history = false;
+            }
+        }
+    }
+
+    void free_continuous_workspace()
+    {
+        ei_continuous_workspace_t *ws = &continuous;
+
+        reset_continuous_workspace();
+        if (ws->block_states) {
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                ei_free(ws->block_states[ix].frame);
+                ei_free(ws->block_states[ix].preemphasis_history);
+                ei_free(ws->block_states[ix].pcm);
+            }
+            workspace_free(ws->block_states, impulse->dsp_blocks_size * sizeof(ei_dsp_cont_state_t));
+        }
+
+        if (ws->block_matrices) {
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                delete ws->block_matrices[ix];
+            }
+            workspace_free(ws->block_matrices, impulse->dsp_blocks_size * sizeof(ei::matrix_t*));
+        }
+        delete ws->features_matrix;
+        delete ws->normalized_matrix;
+        if (ws->features) {
+            workspace_free(ws->features, ws->features_size * sizeof(ei_feature_t));
+        }
+        if (ws->raw_outputs) {
+            workspace_free(ws->raw_outputs, ws->raw_outputs_size * sizeof(ei_feature_t));
+        }
+        if (ws->classification) {
+            workspace_free(ws->classification, ws->classification_size * sizeof(ei_impulse_result_classification_t));
+        }
+        memset(ws, 0, sizeof(ei_continuous_workspace_t));
+    }
+
+    /**
+     * Make sure the NMS workspace can hold box_count boxes, keeps the buffers if they're already large enough
+     * @return false if we ran out of memory
+     */
+    bool alloc_nms_workspace(size_t box_count)
+    {
+        ei_nms_workspace_t *ws = &nms;
+
+        if (ws->cell_heads != nullptr && box_count <= ws->capacity) {
+            return true;
+        }
+
+        free_nms_workspace();
+
+        ws->cell_heads = (int*)workspace_calloc(EI_NMS_GRID_DIM * EI_NMS_GRID_DIM, sizeof(int));
+        ws->boxes = (float*)workspace_calloc(4 * box_count, sizeof(float));
+        ws->scores = (float*)workspace_calloc(box_count, sizeof(float));
+        ws->classes = (int*)workspace_calloc(box_count, sizeof(int));
+        ws->corners = (float*)workspace_calloc(4 * box_count, sizeof(float));
+        ws->order = (int*)workspace_calloc(box_count, sizeof(int));
+        ws->next = (int*)workspace_calloc(box_count, sizeof(int));
+        ws->selected = (int*)workspace_calloc(box_count, sizeof(int));
+        ws->capacity = box_count;
+        if (!ws->cell_heads || !ws->boxes || !ws->scores || !ws->classes ||
+            !ws->corners || !ws->order || !ws->next || !ws->selected) {
+            free_nms_workspace();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Make room for box_count boxes in the NMS workspace, keeping the boxes, scores and classes already
+     * stored. Capacity at least doubles, so decoders can add candidates one by one.
+     * @return false if we ran out of memory, the workspace is left as it was
+     */
+    bool grow_nms_workspace(size_t box_count)
+    {
+        if (nms.cell_heads != nullptr && box_count <= nms.capacity) {
+            return true;
+        }
+
+        size_t new_capacity = nms.capacity * 2;
+        if (new_capacity < box_count) {
+            new_capacity = box_count;
+        }
+        if (new_capacity < 64) {
+            new_capacity = 64;
+        }
+
+        ei_nms_workspace_t old = nms;
+        memset(&nms, 0, sizeof(ei_nms_workspace_t));
+        if (!alloc_nms_workspace(new_capacity)) {
+            nms = old;
+            return false;
+        }
+
+        if (old.capacity > 0) {
+            memcpy(nms.boxes, old.boxes, 4 * old.capacity * sizeof(float));
+            memcpy(nms.scores, old.scores, old.capacity * sizeof(float));
+            memcpy(nms.classes, old.classes, old.capacity * sizeof(int));
+        }
+        free_nms_buffers(&old);
+        return true;
+    }
+
+    void free_nms_workspace()
+    {
+        free_nms_buffers(&nms);
+    }
+
+    static void free_nms_buffers(ei_nms_workspace_t *ws)
+    {
+        if (ws->cell_heads) {
+            workspace_free(ws->cell_heads, EI_NMS_GRID_DIM * EI_NMS_GRID_DIM * sizeof(int));
+        }
+        if (ws->boxes) {
+            workspace_free(ws->boxes, 4 * ws->capacity * sizeof(float));
+        }
+        if (ws->scores) {
+            workspace_free(ws->scores, ws->capacity * sizeof(float));
+        }
+        if (ws->classes) {
+            workspace_free(ws->classes, ws->capacity * sizeof(int));
+        }
+        if (ws->corners) {
+            workspace_free(ws->corners, 4 * ws->capacity * sizeof(float));
+        }
+        if (ws->order) {
+            workspace_free(ws->order, ws->capacity * sizeof(int));
+        }
+        if (ws->next) {
+            workspace_free(ws->next, ws->capacity * sizeof(int));
+        }
+        if (ws->selected) {
+            workspace_free(ws->selected, ws->capacity * sizeof(int));
+        }
+        memset(ws, 0, sizeof(ei_nms_workspace_t));
+    }
+
+    /**
+     * Make sure the FOMO workspace fits a grid of rows x cols cells with label_count classes,
+     * keeps the buffers if they're already large enough
+     * @return false if we ran out of memory
+     */
+    bool alloc_fomo_workspace(size_t rows, size_t cols, size_t label_count)
+    {
+        ei_fomo_workspace_t *ws = &fomo;
+
+        const size_t row_values = cols * (label_count + 1);
+        // a cell only opens a new label when its left neighbour is empty, so at most every other cell per row
+        const size_t max_labels = ((cols + 1) / 2) * rows * label_count + 1;
+
+        if (ws->parent != nullptr && row_values <= ws->row_values && max_labels <= ws->max_labels) {
+            return true;
+        }
+
+        free_fomo_workspace();
+
+        ws->row_hits = (uint8_t*)workspace_calloc(row_values, sizeof(uint8_t));
+        ws->row_labels = (uint32_t*)workspace_calloc(2 * row_values, sizeof(uint32_t));
+        ws->parent = (uint32_t*)workspace_calloc(max_labels, sizeof(uint32_t));
+        ws->components = (ei_fomo_component_t*)workspace_calloc(max_labels, sizeof(ei_fomo_component_t));
+        ws->row_values = row_values;
+        ws->max_labels = max_labels;
+        if (!ws->row_hits || !ws->row_labels || !ws->parent || !ws->components) {
+            free_fomo_workspace();
+            return false;
+        }
+        return true;
+    }
+
+    void free_fomo_workspace()
+    {
+        ei_fomo_workspace_t *ws = &fomo;
+
+        if (ws->row_hits) {
+            workspace_free(ws->row_hits, ws->row_values * sizeof(uint8_t));
+        }
+        if (ws->row_labels) {
+            workspace_free(ws->row_labels, 2 * ws->row_values * sizeof(uint32_t));
+        }
+        if (ws->parent) {
+            workspace_free(ws->parent, ws->max_labels * sizeof(uint32_t));
+        }
+        if (ws->components) {
+            workspace_free(ws->components, ws->max_labels * sizeof(ei_fomo_component_t));
+        }
+        memset(ws, 0, sizeof(ei_fomo_workspace_t));
+    }
+
     void* operator new(size_t size) {
         return ei_malloc(size);
     }
@@ -489,6 +878,9 @@ public:
     ~ei_impulse_state_t()
     {
         reset();
+        free_continuous_workspace();
+        free_nms_workspace();
+        free_fomo_workspace();
         ei_free(dsp_handles);
     }
 };
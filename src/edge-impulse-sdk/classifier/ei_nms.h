@@ -40,236 +40,245 @@
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
-#if (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX)
+#if (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX || EI_HAS_SSD)
 
-// The code below comes from tensorflow/lite/kernels/internal/reference/non_max_suppression.h
-// Copyright 2019 The TensorFlow Authors.  All rights reserved.
-// Licensed under the Apache License, Version 2.0
 #include <algorithm>
 #include <cmath>
-#include <deque>
-#include <queue>
-
-// A pair of diagonal corners of the box.
-struct BoxCornerEncoding {
-  float y1;
-  float x1;
-  float y2;
-  float x2;
-};
-
-static inline float ComputeIntersectionOverUnion(const float* boxes, const int i,
-                                          const int j) {
-  auto& box_i = reinterpret_cast<const BoxCornerEncoding*>(boxes)[i];
-  auto& box_j = reinterpret_cast<const BoxCornerEncoding*>(boxes)[j];
-  const float box_i_y_min = std::min<float>(box_i.y1, box_i.y2);
-  const float box_i_y_max = std::max<float>(box_i.y1, box_i.y2);
-  const float box_i_x_min = std::min<float>(box_i.x1, box_i.x2);
-  const float box_i_x_max = std::max<float>(box_i.x1, box_i.x2);
-  const float box_j_y_min = std::min<float>(box_j.y1, box_j.y2);
-  const float box_j_y_max = std::max<float>(box_j.y1, box_j.y2);
-  const float box_j_x_min = std::min<float>(box_j.x1, box_j.x2);
-  const float box_j_x_max = std::max<float>(box_j.x1, box_j.x2);
-
-  const float area_i =
-      (box_i_y_max - box_i_y_min) * (box_i_x_max - box_i_x_min);
-  const float area_j =
-      (box_j_y_max - box_j_y_min) * (box_j_x_max - box_j_x_min);
-  if (area_i <= 0 || area_j <= 0) return 0.0;
-  const float intersection_ymax = std::min<float>(box_i_y_max, box_j_y_max);
-  const float intersection_xmax = std::min<float>(box_i_x_max, box_j_x_max);
-  const float intersection_ymin = std::max<float>(box_i_y_min, box_j_y_min);
-  const float intersection_xmin = std::max<float>(box_i_x_min, box_j_x_min);
-  const float intersection_area =
-      std::max<float>(intersection_ymax - intersection_ymin, 0.0) *
-      std::max<float>(intersection_xmax - intersection_xmin, 0.0);
-  return intersection_area / (area_i + area_j - intersection_area);
+#include <string.h>
+
+/**
+ * IoU of two boxes in normalized [x1, y1, x2, y2] form, 0 if either box is empty
+ */
+static inline float ei_nms_iou(const float *a, const float *b) {
+    const float area_a = (a[2] - a[0]) * (a[3] - a[1]);
+    const float area_b = (b[2] - b[0]) * (b[3] - b[1]);
+    if (area_a <= 0 || area_b <= 0) return 0.0f;
+    const float intersection_area =
+        std::max<float>(std::min(a[3], b[3]) - std::max(a[1], b[1]), 0.0f) *
+        std::max<float>(std::min(a[2], b[2]) - std::max(a[0], b[0]), 0.0f);
+    return intersection_area / (area_a + area_b - intersection_area);
+}
+
+static inline int ei_nms_cell(float v, float origin, float inv_cell_size, int grid_dim) {
+    const float f = (v - origin) * inv_cell_size;
+    if (!(f > 0.0f)) return 0; // also catches NaN
+    if (f >= (float)grid_dim) return grid_dim - 1;
+    return (int)f;
 }
 
-// Implements (Single-Class) Soft NMS (with Gaussian weighting).
-// Supports functionality of TensorFlow ops NonMaxSuppressionV4 & V5.
-// Reference: "Soft-NMS - Improving Object Detection With One Line of Code"
-//            [Bodla et al, https://arxiv.org/abs/1704.04503]
-// Implementation adapted from the TensorFlow NMS code at
-// tensorflow/core/kernels/non_max_suppression_op.cc.
-//
-// Arguments:
-//  boxes: box encodings in format [y1, x1, y2, x2], shape: [num_boxes, 4]
-//  num_boxes: number of candidates
-//  scores: scores for candidate boxes, in the same order. shape: [num_boxes]
-//  max_output_size: the maximum number of selections.
-//  iou_threshold: Intersection-over-Union (IoU) threshold for NMS
-//  score_threshold: All candidate scores below this value are rejected
-//  soft_nms_sigma: Soft NMS parameter, used for decaying scores
-//
-// Outputs:
-//  selected_indices: all the selected indices. Underlying array must have
-//    length >= max_output_size. Cannot be null.
-//  selected_scores: scores of selected indices. Defer from original value for
-//    Soft NMS. If not null, array must have length >= max_output_size.
-//  num_selected_indices: Number of selections. Only these many elements are
-//    set in selected_indices, selected_scores. Cannot be null.
-//
-// Assumes inputs are valid (for eg, iou_threshold must be >= 0).
-static inline void NonMaxSuppression(const float* boxes, const int num_boxes,
-                              const float* scores, const int max_output_size,
-                              const float iou_threshold,
-                              const float score_threshold,
-                              const float soft_nms_sigma, int* selected_indices,
-                              float* selected_scores,
-                              int* num_selected_indices) {
-  struct Candidate {
-    int index;
-    float score;
-    int suppress_begin_index;
-  };
-
-  // Priority queue to hold candidates.
-  auto cmp = [](const Candidate bs_i, const Candidate bs_j) {
-    return bs_i.score < bs_j.score;
-  };
-  std::priority_queue<Candidate, std::deque<Candidate>, decltype(cmp)>
-      candidate_priority_queue(cmp);
-  // Populate queue with candidates above the score threshold.
-  for (int i = 0; i < num_boxes; ++i) {
-    if (scores[i] > score_threshold) {
-      candidate_priority_queue.emplace(Candidate({i, scores[i], 0}));
+/**
+ * Greedy (hard) non-max suppression.
+ *
+ * Candidates with a score above score_threshold are visited highest score first; a candidate
+ * is kept unless its IoU with an already kept box is >= iou_threshold. Kept boxes are bucketed
+ * by their top-left corner on a uniform grid, so a candidate is only tested against kept boxes
+ * in the cells it can overlap. With class_aware set, boxes only suppress boxes of the same class,
+ * which lets all classes go through one call.
+ *
+ * @param ws Workspace, must hold at least bb_count boxes (see ei_impulse_state_t::alloc_nms_workspace)
+ * @param boxes [y1, x1, y2, x2] per box
+ * @param scores Score per box
+ * @param classes Class index per box, only read when class_aware is set
+ * @param bb_count Number of boxes
+ * @param selected_count Out: number of kept boxes, indices are in ws->selected (highest score first)
+ */
+static void ei_nms_select(
+    ei_nms_workspace_t *ws,
+    const float *boxes,
+    const float *scores,
+    const int *classes,
+    size_t bb_count,
+    float iou_threshold,
+    float score_threshold,
+    bool class_aware,
+    size_t *selected_count) {
+
+    *selected_count = 0;
+
+    size_t candidate_count = 0;
+    float min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    for (size_t ix = 0; ix < bb_count; ix++) {
+        if (!(scores[ix] > score_threshold)) {
+            continue;
+        }
+        const float *b = boxes + (ix * 4);
+        float *c = ws->corners + (ix * 4);
+        c[0] = std::min(b[1], b[3]);
+        c[1] = std::min(b[0], b[2]);
+        c[2] = std::max(b[1], b[3]);
+        c[3] = std::max(b[0], b[2]);
+        if (c[0] < min_x) min_x = c[0];
+        if (c[1] < min_y) min_y = c[1];
+        if (c[2] > max_x) max_x = c[2];
+        if (c[3] > max_y) max_y = c[3];
+        ws->order[candidate_count++] = (int)ix;
     }
-  }
-
-  *num_selected_indices = 0;
-  int num_outputs = std::min(static_cast<int>(candidate_priority_queue.size()),
-                             max_output_size);
-  if (num_outputs == 0) return;
-
-  // NMS loop.
-  float scale = 0;
-  if (soft_nms_sigma > 0.0) {
-    scale = -0.5 / soft_nms_sigma;
-  }
-  while (*num_selected_indices < num_outputs &&
-         !candidate_priority_queue.empty()) {
-    Candidate next_candidate = candidate_priority_queue.top();
-    const float original_score = next_candidate.score;
-    candidate_priority_queue.pop();
-
-    // Overlapping boxes are likely to have similar scores, therefore we
-    // iterate through the previously selected boxes backwards in order to
-    // see if `next_candidate` should be suppressed. We also enforce a property
-    // that a candidate can be suppressed by another candidate no more than
-    // once via `suppress_begin_index` which tracks which previously selected
-    // boxes have already been compared against next_candidate prior to a given
-    // iteration.  These previous selected boxes are then skipped over in the
-    // following loop.
-    bool should_hard_suppress = false;
-    for (int j = *num_selected_indices - 1;
-         j >= next_candidate.suppress_begin_index; --j) {
-      const float iou = ComputeIntersectionOverUnion(
-          boxes, next_candidate.index, selected_indices[j]);
-
-      // First decide whether to perform hard suppression.
-      if (iou >= iou_threshold) {
-        should_hard_suppress = true;
-        break;
-      }
-
-      // Suppress score if NMS sigma > 0.
-      if (soft_nms_sigma > 0.0) {
-        next_candidate.score =
-            next_candidate.score * std::exp(scale * iou * iou);
-      }
-
-      // If score has fallen below score_threshold, it won't be pushed back into
-      // the queue.
-      if (next_candidate.score <= score_threshold) break;
+    if (candidate_count == 0) {
+        return;
     }
-    // If `next_candidate.score` has not dropped below `score_threshold`
-    // by this point, then we know that we went through all of the previous
-    // selections and can safely update `suppress_begin_index` to
-    // `selected.size()`. If on the other hand `next_candidate.score`
-    // *has* dropped below the score threshold, then since `suppress_weight`
-    // always returns values in [0, 1], further suppression by items that were
-    // not covered in the above for loop would not have caused the algorithm
-    // to select this item. We thus do the same update to
-    // `suppress_begin_index`, but really, this element will not be added back
-    // into the priority queue.
-    next_candidate.suppress_begin_index = *num_selected_indices;
-
-    if (!should_hard_suppress) {
-      if (next_candidate.score == original_score) {
-        // Suppression has not occurred, so select next_candidate.
-        selected_indices[*num_selected_indices] = next_candidate.index;
-        if (selected_scores) {
-          selected_scores[*num_selected_indices] = next_candidate.score;
+
+    std::sort(ws->order, ws->order + candidate_count, [scores](int a, int b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    });
+
+    // with a non-positive threshold every kept box suppresses everything after it (IoU >= 0 always holds)
+    if (!(iou_threshold > 0.0f)) {
+        for (size_t ix = 0; ix < candidate_count; ix++) {
+            const int cand = ws->order[ix];
+            bool suppressed = false;
+            for (size_t k = 0; k < *selected_count; k++) {
+                if (!class_aware || classes[ws->selected[k]] == classes[cand]) {
+                    suppressed = true;
+                    break;
+                }
+            }
+            if (!suppressed) {
+                ws->selected[(*selected_count)++] = cand;
+            }
+        }
+        return;
+    }
+
+    // ~1 candidate per cell, a handful of candidates doesn't need a grid at all
+    int grid_dim = (int)sqrtf((float)candidate_count);
+    if (grid_dim < 1) grid_dim = 1;
+    if (grid_dim > EI_NMS_GRID_DIM) grid_dim = EI_NMS_GRID_DIM;
+
+    const float extent_x = max_x - min_x;
+    const float extent_y = max_y - min_y;
+    const float inv_cell_w = (extent_x > 0.0f && std::isfinite(extent_x)) ? (float)grid_dim / extent_x : 0.0f;
+    const float inv_cell_h = (extent_y > 0.0f && std::isfinite(extent_y)) ? (float)grid_dim / extent_y : 0.0f;
+
+    for (int ix = 0; ix < grid_dim * grid_dim; ix++) {
+        ws->cell_heads[ix] = -1;
+    }
+
+    // a kept box can only reach this far left / up from the cell holding its top-left corner
+    float kept_max_w = 0.0f;
+    float kept_max_h = 0.0f;
+
+    for (size_t ix = 0; ix < candidate_count; ix++) {
+        const int cand = ws->order[ix];
+        const float *c = ws->corners + (cand * 4);
+
+        const int cx0 = ei_nms_cell(c[0] - kept_max_w, min_x, inv_cell_w, grid_dim);
+        const int cy0 = ei_nms_cell(c[1] - kept_max_h, min_y, inv_cell_h, grid_dim);
+        const int cx1 = ei_nms_cell(c[2], min_x, inv_cell_w, grid_dim);
+        const int cy1 = ei_nms_cell(c[3], min_y, inv_cell_h, grid_dim);
+
+        bool suppressed = false;
+        for (int gy = cy0; gy <= cy1 && !suppressed; gy++) {
+            for (int gx = cx0; gx <= cx1 && !suppressed; gx++) {
+                for (int k = ws->cell_heads[gy * grid_dim + gx]; k >= 0; k = ws->next[k]) {
+                    if (class_aware && classes[k] != classes[cand]) {
+                        continue;
+                    }
+                    if (ei_nms_iou(c, ws->corners + (k * 4)) >= iou_threshold) {
+                        suppressed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (suppressed) {
+            continue;
         }
-        ++*num_selected_indices;
-      }
-      if ((soft_nms_sigma > 0.0) && (next_candidate.score > score_threshold)) {
-        // Soft suppression might have occurred and current score is still
-        // greater than score_threshold; add next_candidate back onto priority
-        // queue.
-        candidate_priority_queue.push(next_candidate);
-      }
+
+        ws->selected[(*selected_count)++] = cand;
+
+        const int cell = ei_nms_cell(c[1], min_y, inv_cell_h, grid_dim) * grid_dim +
+                         ei_nms_cell(c[0], min_x, inv_cell_w, grid_dim);
+        ws->next[cand] = ws->cell_heads[cell];
+        ws->cell_heads[cell] = cand;
+        if (c[2] - c[0] > kept_max_w) kept_max_w = c[2] - c[0];
+        if (c[3] - c[1] > kept_max_h) kept_max_h = c[3] - c[1];
     }
-  }
+}
+
+/**
+ * Append a candidate box to the boxes, scores and classes in handle->state.nms, for decoders that
+ * collect their candidates there before calling ei_run_nms() on those buffers
+ * @param box_count Number of boxes stored so far, incremented on success
+ * @return false if we ran out of memory
+ */
+static inline bool ei_nms_add_box(
+    ei_impulse_handle_t *handle,
+    size_t *box_count,
+    float ymin,
+    float xmin,
+    float ymax,
+    float xmax,
+    float score,
+    int label_ix) {
+
+    if (!handle->state.grow_nms_workspace(*box_count + 1)) {
+        return false;
+    }
+    ei_nms_workspace_t *ws = &handle->state.nms;
+
+    float *box = ws->boxes + (*box_count * 4);
+    box[0] = ymin;
+    box[1] = xmin;
+    box[2] = ymax;
+    box[3] = xmax;
+    ws->scores[*box_count] = score;
+    ws->classes[*box_count] = label_ix;
+    (*box_count)++;
+    return true;
 }
 
 /**
  * Run non-max suppression over the results array (for bounding boxes)
+ * Boxes are [y1, x1, y2, x2]; the kept boxes replace the contents of results, highest score first.
+ * With class_aware set, boxes of different classes never suppress each other.
  */
 EI_IMPULSE_ERROR ei_run_nms(
-    const ei_impulse_t *impulse,
+    ei_impulse_handle_t *handle,
     std::vector<ei_impulse_result_bounding_box_t> *results,
-    float *boxes,
-    float *scores,
-    int *classes,
+    const float *boxes,
+    const float *scores,
+    const int *classes,
     size_t bb_count,
     bool clip_boxes,
-    const ei_object_detection_nms_config_t *nms_config) {
+    const ei_object_detection_nms_config_t *nms_config,
+    bool class_aware = false) {
+
+    const ei_impulse_t *impulse = handle->impulse;
+
+    results->clear();
 
     if (bb_count < 1) {
         return EI_IMPULSE_OK;
     }
 
-    int *selected_indices = (int*)ei_malloc(1 * bb_count * sizeof(int));
-    float *selected_scores = (float*)ei_malloc(1 * bb_count * sizeof(float));
+    if (!scores || !boxes || !classes) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
 
-    if (!scores || !boxes || !selected_indices || !selected_scores || !classes) {
-        ei_free(selected_indices);
-        ei_free(selected_scores);
+    if (!handle->state.alloc_nms_workspace(bb_count)) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
+    ei_nms_workspace_t *ws = &handle->state.nms;
+
+    size_t selected_count;
+    ei_nms_select(ws,
+                  boxes,
+                  scores,
+                  classes,
+                  bb_count,
+                  nms_config->iou_threshold,
+                  nms_config->confidence_threshold,
+                  class_aware,
+                  &selected_count);
+
+    results->reserve(selected_count);
+
+    for (size_t ix = 0; ix < selected_count; ix++) {
 
-    //  boxes: box encodings in format [y1, x1, y2, x2], shape: [num_boxes, 4]
-    //  num_boxes: number of candidates
-    //  scores: scores for candidate boxes, in the same order. shape: [num_boxes]
-    //  max_output_size: the maximum number of selections.
-    //  iou_threshold: Intersection-over-Union (IoU) threshold for NMS
-    //  score_threshold: All candidate scores below this value are rejected
-    //  soft_nms_sigma: Soft NMS parameter, used for decaying scores
-
-    int num_selected_indices;
-
-    NonMaxSuppression(
-        (const float*)boxes, // boxes
-        bb_count, // num_boxes
-        (const float*)scores, // scores
-        bb_count, // max_output_size
-        nms_config->iou_threshold, // iou_threshold
-        nms_config->confidence_threshold, // score_threshold
-        0.0f, // soft_nms_sigma
-        selected_indices,
-        selected_scores,
-        &num_selected_indices);
-
-    std::vector<ei_impulse_result_bounding_box_t> new_results;
-
-    for (size_t ix = 0; ix < (size_t)num_selected_indices; ix++) {
-
-        int out_ix = selected_indices[ix];
+        int out_ix = ws->selected[ix];
         ei_impulse_result_bounding_box_t bb;
         bb.label  = impulse->categories[classes[out_ix]];
-        bb.value  = selected_scores[ix];
+        bb.value  = scores[out_ix];
 
         float ymin = boxes[(out_ix * 4) + 0];
         float xmin = boxes[(out_ix * 4) + 1];
@@ -287,97 +296,83 @@ EI_IMPULSE_ERROR ei_run_nms(
         bb.x      = static_cast<uint32_t>(xmin);
         bb.height = static_cast<uint32_t>(ymax) - bb.y;
         bb.width  = static_cast<uint32_t>(xmax) - bb.x;
-        new_results.push_back(bb);
+        results->push_back(bb);
 
         EI_LOGD("Found bb with label %s\n", bb.label);
     }
 
-    results->clear();
-
-    for (size_t ix = 0; ix < new_results.size(); ix++) {
-        results->push_back(new_results[ix]);
-    }
-
-    ei_free(selected_indices);
-    ei_free(selected_scores);
-
     return EI_IMPULSE_OK;
 
 }
 
 /**
  * Run non-max suppression over the results array (for bounding boxes)
+ * Boxes with a value of 0 are dropped.
  */
 EI_IMPULSE_ERROR ei_run_nms(
-    const ei_impulse_t *impulse,
+    ei_impulse_handle_t *handle,
     const ei_object_detection_nms_config_t *nms_config,
     std::vector<ei_impulse_result_bounding_box_t> *results,
-    bool clip_boxes = true
+    bool clip_boxes = true,
+    bool class_aware = false
     ) {
 
+    const ei_impulse_t *impulse = handle->impulse;
+
     size_t bb_count = 0;
     for (size_t ix = 0; ix < results->size(); ix++) {
-        auto bb = results->at(ix);
-        if (bb.value == 0) {
+        if ((*results)[ix].value == 0) {
             continue;
         }
         bb_count++;
     }
 
     if (bb_count < 1) {
+        results->clear();
         return EI_IMPULSE_OK;
     }
 
-    float *boxes = (float*)ei_malloc(4 * bb_count * sizeof(float));
-    float *scores = (float*)ei_malloc(1 * bb_count * sizeof(float));
-    int *classes = (int*) ei_malloc(bb_count * sizeof(int));
-
-    if (!scores || !boxes || !classes) {
-        ei_free(boxes);
-        ei_free(scores);
-        ei_free(classes);
+    if (!handle->state.alloc_nms_workspace(bb_count)) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
+    ei_nms_workspace_t *ws = &handle->state.nms;
 
     size_t box_ix = 0;
     for (size_t ix = 0; ix < results->size(); ix++) {
-        auto bb = results->at(ix);
+        const ei_impulse_result_bounding_box_t &bb = (*results)[ix];
         if (bb.value == 0) {
             continue;
         }
-        boxes[(box_ix * 4) + 0] = bb.y;
-        boxes[(box_ix * 4) + 1] = bb.x;
-        boxes[(box_ix * 4) + 2] = bb.y + bb.height;
-        boxes[(box_ix * 4) + 3] = bb.x + bb.width;
-        scores[box_ix] = bb.value;
-
+        ws->boxes[(box_ix * 4) + 0] = bb.y;
+        ws->boxes[(box_ix * 4) + 1] = bb.x;
+        ws->boxes[(box_ix * 4) + 2] = bb.y + bb.height;
+        ws->boxes[(box_ix * 4) + 3] = bb.x + bb.width;
+        ws->scores[box_ix] = bb.value;
+
+        // labels point into impulse->categories, so the pointer compare almost always hits
+        ws->classes[box_ix] = 0;
         for (size_t j = 0; j < impulse->label_count; j++) {
-          if (strcmp(impulse->categories[j], bb.label) == 0)
-          classes[box_ix] = j;
+            if (bb.label == impulse->categories[j] || strcmp(impulse->categories[j], bb.label) == 0) {
+                ws->classes[box_ix] = j;
+                break;
+            }
         }
 
         box_ix++;
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                          results,
-                                          boxes,
-                                          scores,
-                                          classes,
-                                          bb_count,
-                                          clip_boxes,
-                                          nms_config);
-
-
-    ei_free(boxes);
-    ei_free(scores);
-    ei_free(classes);
-
-    return nms_res;
-
+    return ei_run_nms(handle,
+                      results,
+                      ws->boxes,
+                      ws->scores,
+                      ws->classes,
+                      bb_count,
+                      clip_boxes,
+                      nms_config,
+                      class_aware);
 }
 
-#endif // (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE)
+#endif // (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX || EI_HAS_SSD)
 
 #if (EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLO || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX)
 
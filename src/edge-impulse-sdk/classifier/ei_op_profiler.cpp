@@ -0,0 +1,224 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
+
+#if EI_CLASSIFIER_OP_PROFILER == 1
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+// scratch usage per operator, keyed by graph, subgraph and operator index
+typedef struct {
+    const void *graph;
+    uint16_t subgraph_index;
+    uint16_t op_index;
+    uint32_t bytes;
+} op_profiler_scratch_t;
+
+static ei_op_profile_event_t op_profiler_ring[EI_CLASSIFIER_OP_PROFILER_RING_SIZE];
+static op_profiler_scratch_t op_profiler_scratch[EI_CLASSIFIER_OP_PROFILER_MAX_OPS];
+static size_t op_profiler_scratch_count = 0;
+static uint16_t op_profiler_head = 0;
+static uint16_t op_profiler_count = 0;
+static uint16_t op_profiler_invoke_first = 0;
+static uint16_t op_profiler_invoke_count = 0;
+static uint16_t op_profiler_invoke_id = 0;
+static bool op_profiler_enabled = EI_CLASSIFIER_OP_PROFILER_ENABLED_AT_BOOT == 1;
+static const void *op_profiler_graph = nullptr;
+static size_t op_profiler_graph_op_index = 0;
+
+__attribute__((weak)) uint32_t ei_op_profiler_read_cycles(void)
+{
+    return 0;
+}
+
+void ei_op_profiler_enable(bool enable)
+{
+    op_profiler_enabled = enable;
+}
+
+bool ei_op_profiler_is_enabled(void)
+{
+    return op_profiler_enabled;
+}
+
+void ei_op_profiler_clear(void)
+{
+    op_profiler_head = 0;
+    op_profiler_count = 0;
+    op_profiler_invoke_first = 0;
+    op_profiler_invoke_count = 0;
+}
+
+void ei_op_profiler_invoke_begin(void)
+{
+    if (!op_profiler_enabled) {
+        return;
+    }
+
+    op_profiler_invoke_id++;
+    op_profiler_invoke_first = op_profiler_head;
+    op_profiler_invoke_count = 0;
+}
+
+static op_profiler_scratch_t *find_op_scratch(const void *graph, size_t subgraph_index, size_t op_index)
+{
+    for (size_t ix = 0; ix < op_profiler_scratch_count; ix++) {
+        op_profiler_scratch_t *entry = &op_profiler_scratch[ix];
+        if (entry->graph == graph && entry->subgraph_index == subgraph_index && entry->op_index == op_index) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void ei_op_profiler_set_op_scratch(const void *graph, size_t subgraph_index, size_t op_index, size_t bytes)
+{
+    op_profiler_scratch_t *entry = find_op_scratch(graph, subgraph_index, op_index);
+    if (!entry) {
+        // no room: the operator reports 0 scratch bytes
+        if (op_profiler_scratch_count == EI_CLASSIFIER_OP_PROFILER_MAX_OPS) {
+            return;
+        }
+        entry = &op_profiler_scratch[op_profiler_scratch_count++];
+        entry->graph = graph;
+        entry->subgraph_index = (uint16_t)subgraph_index;
+        entry->op_index = (uint16_t)op_index;
+    }
+    entry->bytes = (uint32_t)bytes;
+}
+
+void ei_op_profiler_forget_graph(const void *graph)
+{
+    size_t kept = 0;
+    for (size_t ix = 0; ix < op_profiler_scratch_count; ix++) {
+        if (op_profiler_scratch[ix].graph != graph) {
+            op_profiler_scratch[kept++] = op_profiler_scratch[ix];
+        }
+    }
+    op_profiler_scratch_count = kept;
+}
+
+void ei_op_profiler_graph_begin(const void *graph)
+{
+    op_profiler_graph = graph;
+    op_profiler_graph_op_index = 0;
+}
+
+void ei_op_profiler_graph_end(void)
+{
+    op_profiler_graph = nullptr;
+}
+
+const void *ei_op_profiler_graph_next_op(size_t *op_index)
+{
+    if (op_profiler_graph) {
+        *op_index = op_profiler_graph_op_index++;
+    }
+    return op_profiler_graph;
+}
+
+void ei_op_profiler_op_begin(ei_op_profiler_mark_t *mark)
+{
+    mark->active = op_profiler_enabled;
+    if (!mark->active) {
+        return;
+    }
+
+    mark->start_cycles = ei_op_profiler_read_cycles();
+    mark->start_us = ei_read_timer_us();
+}
+
+void ei_op_profiler_op_end(const ei_op_profiler_mark_t *mark, const void *graph, size_t subgraph_index,
+    const char *op_name, size_t op_index, size_t bytes)
+{
+    if (!mark->active) {
+        return;
+    }
+
+    uint64_t end_us = ei_read_timer_us();
+    uint32_t end_cycles = ei_op_profiler_read_cycles();
+
+    ei_op_profile_event_t *event = &op_profiler_ring[op_profiler_head];
+    event->op_name = op_name;
+    event->op_index = (uint16_t)op_index;
+    event->invoke_id = op_profiler_invoke_id;
+    event->time_us = (uint32_t)(end_us - mark->start_us);
+    event->cycles = end_cycles - mark->start_cycles;
+    event->bytes = (uint32_t)bytes;
+    const op_profiler_scratch_t *scratch = find_op_scratch(graph, subgraph_index, op_index);
+    event->scratch_bytes = scratch ? scratch->bytes : 0;
+
+    op_profiler_head = (op_profiler_head + 1) % EI_CLASSIFIER_OP_PROFILER_RING_SIZE;
+    if (op_profiler_count < EI_CLASSIFIER_OP_PROFILER_RING_SIZE) {
+        op_profiler_count++;
+    }
+
+    // a graph with more operators than the ring keeps its last operators
+    if (op_profiler_invoke_count < EI_CLASSIFIER_OP_PROFILER_RING_SIZE) {
+        op_profiler_invoke_count++;
+    }
+    else {
+        op_profiler_invoke_first = op_profiler_head;
+    }
+}
+
+void ei_op_profiler_get_last_invoke(ei_impulse_result_op_profile_t *profile)
+{
+    if (!op_profiler_enabled) {
+        profile->ring = nullptr;
+        profile->ring_size = 0;
+        profile->first = 0;
+        profile->count = 0;
+        profile->invoke_id = op_profiler_invoke_id;
+        return;
+    }
+
+    profile->ring = op_profiler_ring;
+    profile->ring_size = EI_CLASSIFIER_OP_PROFILER_RING_SIZE;
+    profile->first = op_profiler_invoke_first;
+    profile->count = op_profiler_invoke_count;
+    profile->invoke_id = op_profiler_invoke_id;
+}
+
+void ei_op_profiler_get_events(ei_impulse_result_op_profile_t *profile)
+{
+    profile->ring = op_profiler_ring;
+    profile->ring_size = EI_CLASSIFIER_OP_PROFILER_RING_SIZE;
+    profile->first = (op_profiler_head + EI_CLASSIFIER_OP_PROFILER_RING_SIZE - op_profiler_count) % EI_CLASSIFIER_OP_PROFILER_RING_SIZE;
+    profile->count = op_profiler_count;
+    profile->invoke_id = op_profiler_invoke_id;
+}
+
+#endif // EI_CLASSIFIER_OP_PROFILER == 1
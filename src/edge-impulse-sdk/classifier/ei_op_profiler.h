@@ -0,0 +1,208 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_OP_PROFILER_H_
+#define _EI_CLASSIFIER_OP_PROFILER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+/**
+ * @addtogroup ei_structs
+ * @{
+ */
+
+/**
+ * @brief One operator run recorded by the operator profiler.
+ */
+typedef struct {
+    /**
+     * Operator name (e.g. "FULLY_CONNECTED"), static string
+     */
+    const char *op_name;
+
+    /**
+     * Index of the operator in its graph
+     */
+    uint16_t op_index;
+
+    /**
+     * Low 16 bits of the model invocation counter, groups the operators of one inference
+     */
+    uint16_t invoke_id;
+
+    /**
+     * Time (in microseconds) spent in the operator
+     */
+    uint32_t time_us;
+
+    /**
+     * CPU cycles spent in the operator, 0 if the target has no cycle counter
+     */
+    uint32_t cycles;
+
+    /**
+     * Bytes of all input and output tensors of the operator (weights included)
+     */
+    uint32_t bytes;
+
+    /**
+     * Scratch buffer bytes the operator requested at prepare time
+     */
+    uint32_t scratch_bytes;
+} ei_op_profile_event_t;
+
+/**
+ * @brief Window into the operator profiler ring.
+ *
+ * Event `ix` (0 <= ix < `count`) is `ring[(first + ix) % ring_size]`. The ring is overwritten
+ * by the next inference, copy the events out if they need to be kept.
+ */
+typedef struct {
+    /**
+     * Profiler ring, nullptr if the profiler is compiled out or disabled
+     */
+    const ei_op_profile_event_t *ring;
+
+    /**
+     * Number of events the ring holds (`EI_CLASSIFIER_OP_PROFILER_RING_SIZE`)
+     */
+    uint16_t ring_size;
+
+    /**
+     * Ring index of the first event
+     */
+    uint16_t first;
+
+    /**
+     * Number of events
+     */
+    uint16_t count;
+
+    /**
+     * Low 16 bits of the model invocation counter of the last inference
+     */
+    uint16_t invoke_id;
+} ei_impulse_result_op_profile_t;
+
+/** @} */
+
+#ifdef __cplusplus
+
+/**
+ * Start of an operator run, see ei_op_profiler_op_end()
+ */
+typedef struct {
+    uint64_t start_us;
+    uint32_t start_cycles;
+    bool active;
+} ei_op_profiler_mark_t;
+
+#if EI_CLASSIFIER_OP_PROFILER == 1
+
+/**
+ * Read the CPU cycle counter. Weak default returns 0, ports with a cycle counter override it.
+ */
+uint32_t ei_op_profiler_read_cycles(void);
+
+void ei_op_profiler_enable(bool enable);
+bool ei_op_profiler_is_enabled(void);
+
+/**
+ * Drop all recorded events
+ */
+void ei_op_profiler_clear(void);
+
+/**
+ * Called by the inference engines before invoking a model, starts a new group of events
+ */
+void ei_op_profiler_invoke_begin(void);
+
+/**
+ * Scratch usage of an operator, reported while the graph is prepared. `graph` is any pointer
+ * that identifies the model instance (e.g. its allocator), and is passed again to op_end.
+ */
+void ei_op_profiler_set_op_scratch(const void *graph, size_t subgraph_index, size_t op_index, size_t bytes);
+
+/**
+ * Drop the scratch usage of a graph, when it's prepared again or freed
+ */
+void ei_op_profiler_forget_graph(const void *graph);
+
+/**
+ * Open a graph that has no hooks per operator (EON). Until ei_op_profiler_graph_end(), operators
+ * registered through tflite::micro::RegisterOp() report their own scratch while prepared and
+ * record their own events while invoked, numbered in the order they run.
+ */
+void ei_op_profiler_graph_begin(const void *graph);
+void ei_op_profiler_graph_end(void);
+
+/**
+ * Graph opened with ei_op_profiler_graph_begin() (NULL if none), and the index of its next operator
+ */
+const void *ei_op_profiler_graph_next_op(size_t *op_index);
+
+void ei_op_profiler_op_begin(ei_op_profiler_mark_t *mark);
+void ei_op_profiler_op_end(const ei_op_profiler_mark_t *mark, const void *graph, size_t subgraph_index,
+    const char *op_name, size_t op_index, size_t bytes);
+
+/**
+ * Events of the last model invocation
+ */
+void ei_op_profiler_get_last_invoke(ei_impulse_result_op_profile_t *profile);
+
+/**
+ * All events in the ring, oldest first
+ */
+void ei_op_profiler_get_events(ei_impulse_result_op_profile_t *profile);
+
+#else
+
+__attribute__((unused)) static inline void ei_op_profiler_invoke_begin(void) { }
+__attribute__((unused)) static inline void ei_op_profiler_set_op_scratch(const void *graph, size_t subgraph_index, size_t op_index, size_t bytes) { }
+__attribute__((unused)) static inline void ei_op_profiler_forget_graph(const void *graph) { }
+__attribute__((unused)) static inline void ei_op_profiler_graph_begin(const void *graph) { }
+__attribute__((unused)) static inline void ei_op_profiler_graph_end(void) { }
+__attribute__((unused)) static inline void ei_op_profiler_op_begin(ei_op_profiler_mark_t *mark) { }
+__attribute__((unused)) static inline void ei_op_profiler_op_end(const ei_op_profiler_mark_t *mark, const void *graph, size_t subgraph_index,
+    const char *op_name, size_t op_index, size_t bytes) { }
+__attribute__((unused)) static inline void ei_op_profiler_get_last_invoke(ei_impulse_result_op_profile_t *profile) { }
+
+#endif // EI_CLASSIFIER_OP_PROFILER == 1
+
+#endif // __cplusplus
+
+#endif // _EI_CLASSIFIER_OP_PROFILER_H_
@@ -36,6 +36,7 @@
 #define _EDGE_IMPULSE_RUN_CLASSIFIER_H_
 
 #include "ei_model_types.h"
+#include "ei_classifier_config.h"
 #include "model-parameters/model_metadata.h"
 
 #include "ei_run_dsp.h"
@@ -44,6 +45,7 @@
 #include "postprocessing/ei_postprocessing.h"
 #include "edge-impulse-sdk/classifier/ei_data_normalization.h"
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
+#include "edge-impulse-sdk/classifier/ei_shared_arena.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
@@ -113,7 +115,10 @@ EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fm
 
 /* Private variables ------------------------------------------------------- */
 
-static uint64_t classifier_continuous_features_written = 0;
+
+#if EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS == 1
+static size_t classifier_continuous_allocations = 0;
+#endif // EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS
 
 /* Private functions ------------------------------------------------------- */
 
@@ -131,6 +136,27 @@ __attribute__((unused)) void display_results(ei_impulse_handle_t *handle, ei_imp
     display_postprocessing(handle, result);
 }
 
+/**
+ * @brief      Check if every DSP block of an impulse has a slice version
+ *             (MFCC, MFE and spectrogram), so it can run in process_impulse_continuous()
+ *
+ * @param[in]  impulse  The impulse
+ *
+ * @return     true if the impulse can run continuously
+ */
+__attribute__((unused)) static bool ei_impulse_supports_continuous(const ei_impulse_t *impulse)
+{
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        auto extract_fn = impulse->dsp_blocks[ix].extract_fn;
+        if (extract_fn != extract_mfcc_features && extract_fn != extract_mfcc_features_q15 &&
+            extract_fn != extract_mfe_features && extract_fn != extract_mfe_features_q15 &&
+            extract_fn != extract_spectrogram_features) {
+            return false;
+        }
+    }
+    return impulse->dsp_blocks_size > 0;
+}
+
 /**
  * @brief      Do inferencing over the processed feature matrix
  *
@@ -218,6 +244,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
+    // DSP scratch and the tensor arena time-share the shared arena (if enabled) until we return
+    ei_shared_arena_scope shared_arena_scope;
+    FftPlansScope fft_plans_scope(&handle->state.fft_plans);
+
 #if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
     static std::vector<ei_impulse_result_classification_t> classification_results;
     classification_results.clear(); // todo, should not clear and re-gen this every time...
@@ -362,7 +392,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
                 return EI_IMPULSE_OUT_OF_MEMORY;
             }
         } else {
-            ret = block.extract_fn(internal_signal, features[ix].matrix, block.config, handle->impulse->frequency);
+            ret = ei_dsp_block_extract_fn(&block)(internal_signal, features[ix].matrix, block.config, handle->impulse->frequency);
         }
 
         if (ret != EIDSP_OK) {
@@ -442,53 +472,30 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
 }
 
 /**
- * @brief      Process a complete impulse for continuous inference
- *
- * @param      handle               struct with information about model and DSP
- * @param      signal               Sample data
- * @param      result               Output classifier results
- * @param[in]  debug                Debug output enable
- *
- * @return     The ei impulse error.
+ * @brief      Run DSP on one slice, and inference once the window is full.
+ *             The continuous workspace is set up by the caller.
  */
-extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
-                                                       signal_t *signal,
-                                                       ei_impulse_result_t *result,
-                                                       bool debug = false)
+static EI_IMPULSE_ERROR process_impulse_continuous_slice(ei_impulse_handle_t *handle,
+                                                        signal_t *signal,
+                                                        ei_impulse_result_t *result,
+                                                        bool debug)
 {
-    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
-        return EI_IMPULSE_INFERENCE_ERROR;
-    }
-
-    memset(result, 0, sizeof(ei_impulse_result_t));
+    ei_continuous_workspace_t *ws = &handle->state.continuous;
 
 #if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
-    static std::vector<ei_impulse_result_classification_t> classification_results;
-    classification_results.clear(); // todo, should not clear and re-gen this every time...
-
     if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
         handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
+        for (size_t ix = 0; ix < ws->classification_size; ix++) {
     #ifdef EI_DSP_RESULT_OVERRIDE
-        for (size_t ix = 0; ix < EI_DSP_RESULT_OVERRIDE; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = "",
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
+            ws->classification[ix].label = "";
     #else
-        for (size_t ix = 0; ix < handle->impulse->label_count; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = handle->impulse->categories[ix],
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
+            ws->classification[ix].label = handle->impulse->categories[ix];
     #endif
+            ws->classification[ix].value = 0.0f;
+        }
+        result->classification = ws->classification;
     }
 
-    result->classification = classification_results.data();
-
 #else // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
 
     for (int i = 0; i < handle->impulse->label_count; i++) {
@@ -498,16 +505,11 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
 #endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
 
-    // smart pointer to results array
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[handle->impulse->learning_blocks_size]);
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
+    result->_raw_outputs = ws->raw_outputs;
+    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * ws->raw_outputs_size);
 
     auto impulse = handle->impulse;
-    static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
-    if (!static_features_matrix.buffer) {
-        return EI_IMPULSE_ALLOC_FAILED;
-    }
+    ei::matrix_t *features_matrix = ws->features_matrix;
 
     EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
 
@@ -524,20 +526,27 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         }
 
         ei::matrix_t fm(1, block.n_output_features,
-                        static_features_matrix.buffer + out_features_index);
+                        features_matrix->buffer + out_features_index);
 
-        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
+        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size, ei_dsp_cont_state_t *state);
 
         /* Switch to the slice version of the mfcc feature extract function */
-        if (block.extract_fn == extract_mfcc_features) {
+        extract_fn_t extract_fn = ei_dsp_block_extract_fn(&block);
+        if (extract_fn == extract_mfcc_features) {
             extract_fn_slice = &extract_mfcc_per_slice_features;
         }
-        else if (block.extract_fn == extract_spectrogram_features) {
+        else if (extract_fn == extract_mfcc_features_q15) {
+            extract_fn_slice = &extract_mfcc_q15_per_slice_features;
+        }
+        else if (extract_fn == extract_spectrogram_features) {
             extract_fn_slice = &extract_spectrogram_per_slice_features;
         }
-        else if (block.extract_fn == extract_mfe_features) {
+        else if (extract_fn == extract_mfe_features) {
             extract_fn_slice = &extract_mfe_per_slice_features;
         }
+        else if (extract_fn == extract_mfe_features_q15) {
+            extract_fn_slice = &extract_mfe_q15_per_slice_features;
+        }
         else {
             ei_printf("ERR: Unknown extract function, only MFCC, MFE and spectrogram supported\n");
             return EI_IMPULSE_DSP_ERROR;
@@ -550,10 +559,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
             return EI_IMPULSE_DSP_ERROR;
         }
-        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written, &ws->block_states[ix]);
 #else
         SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
-        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written, &ws->block_states[ix]);
 #endif
 
         if (ret != EIDSP_OK) {
@@ -565,66 +574,38 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_CANCELED;
         }
 
-        classifier_continuous_features_written += (features_written.rows * features_written.cols);
+        ws->features_written += (features_written.rows * features_written.cols);
 
         out_features_index += block.n_output_features;
     }
 
     result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
 
-    if (classifier_continuous_features_written >= impulse->nn_input_frame_size) {
+    if (ws->features_written >= impulse->nn_input_frame_size) {
         dsp_start_us = ei_read_timer_us();
 
-        uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
-
-        // smart pointer to features array
-        std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
-        ei_feature_t* features = features_ptr.get();
-        if (features == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate features\n");
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-        memset(features, 0, sizeof(ei_feature_t) * block_num);
-
-        // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
-        if (matrix_ptrs == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
+        ei_feature_t *features = ws->features;
+        memset(features, 0, sizeof(ei_feature_t) * ws->features_size);
 
         out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
-            matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
-
-            if (matrix_ptrs[ix] == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
 
-            if (matrix_ptrs[ix]->buffer == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
-
-            features[ix].matrix = matrix_ptrs[ix].get();
+            features[ix].matrix = ws->block_matrices[ix];
             features[ix].blockId = block.blockId;
 
-            /* Create a copy of the matrix for normalization */
-            for (size_t m_ix = 0; m_ix < block.n_output_features; m_ix++) {
-                features[ix].matrix->buffer[m_ix] = static_features_matrix.buffer[out_features_index + m_ix];
-            }
+            /* Unroll the block's feature ring into the matrix for normalization */
+            ei::matrix_t window(1, block.n_output_features, features_matrix->buffer + out_features_index);
+            ei_dsp_cont_window_copy(&window, &ws->block_states[ix], features[ix].matrix->buffer);
 
-            if (block.extract_fn == extract_mfcc_features) {
+            if (block.extract_fn == extract_mfcc_features || block.extract_fn == extract_mfcc_features_q15) {
                 calc_cepstral_mean_and_var_normalization_mfcc(features[ix].matrix, block.config);
             }
             else if (block.extract_fn == extract_spectrogram_features) {
                 calc_cepstral_mean_and_var_normalization_spectrogram(features[ix].matrix, block.config);
             }
-            else if (block.extract_fn == extract_mfe_features) {
+            else if (block.extract_fn == extract_mfe_features || block.extract_fn == extract_mfe_features_q15) {
                 calc_cepstral_mean_and_var_normalization_mfe(features[ix].matrix, block.config);
             }
             out_features_index += block.n_output_features;
@@ -646,7 +627,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
         }
-        delete[] matrix_ptrs;
         ei_impulse_error = run_postprocessing(handle, result);
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
@@ -658,6 +638,57 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     return ei_impulse_error;
 }
 
+/**
+ * @brief      Process a complete impulse for continuous inference
+ *
+ * @param      handle               struct with information about model and DSP
+ * @param      signal               Sample data
+ * @param      result               Output classifier results
+ * @param[in]  debug                Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+                                                       signal_t *signal,
+                                                       ei_impulse_result_t *result,
+                                                       bool debug = false)
+{
+    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    memset(result, 0, sizeof(ei_impulse_result_t));
+
+    // normally allocated by run_classifier_init(), only allocates here if that was not called
+    // (or EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT is 0)
+    if (!handle->state.alloc_continuous_workspace()) {
+        ei_printf("ERR: Out of memory, can't allocate continuous workspace\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    // after the workspace, which outlives this call and stays on the heap
+    ei_shared_arena_scope shared_arena_scope;
+    FftPlansScope fft_plans_scope(&handle->state.fft_plans);
+
+#if EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS == 1
+    uint32_t heap_allocs = ei_shared_arena_heap_alloc_count();
+#endif
+
+    EI_IMPULSE_ERROR res = process_impulse_continuous_slice(handle, signal, result, debug);
+
+#if EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS == 1
+    uint32_t slice_heap_allocs = ei_shared_arena_heap_alloc_count() - heap_allocs;
+    if (res == EI_IMPULSE_OK && slice_heap_allocs > 0) {
+        classifier_continuous_allocations++;
+        ei_printf("ERR: process_impulse_continuous made %lu heap allocations in this slice\n",
+            (unsigned long)slice_heap_allocs);
+        return EI_IMPULSE_CONTINUOUS_HEAP_ALLOCATION;
+    }
+#endif
+
+    return res;
+}
+
 /**
  * Check if the current impulse could be used by 'run_classifier_image_quantized'
  */
@@ -831,6 +862,54 @@ static void ei_result_struct_timing_us_to_ms(ei_impulse_result_t *result) {
     result->timing.postprocessing = (int)((result->timing.postprocessing_us + 500) / 1000);
 }
 
+/**
+ * Build (or share) the lookup tables of the DSP blocks once, rather than on every call
+ */
+static void ei_acquire_dsp_tables(ei_impulse_state_t *state)
+{
+    if (!state->mel_tables_acquired) {
+        if (ei_dsp_mel_tables(state->impulse, true) != EIDSP_OK) {
+            EI_LOGW("Can't cache the MFE / MFCC tables, they're built on every call\n");
+            ei_dsp_mel_tables(state->impulse, false);
+        }
+        else {
+            state->mel_tables_acquired = true;
+        }
+    }
+
+    if (ei_dsp_build_fft_plans(state->impulse, &state->fft_plans) != EIDSP_OK) {
+        EI_LOGW("Can't cache the FFT plans, they're set up on every call\n");
+    }
+}
+
+/**
+ * Size the slice buffers of the DSP blocks in the continuous workspace, so the first slices of
+ * run_classifier_continuous() don't allocate them. Does nothing without a workspace.
+ */
+static void ei_alloc_continuous_dsp_states(ei_impulse_handle_t *handle)
+{
+    ei_continuous_workspace_t *ws = &handle->state.continuous;
+    if (!ws->block_states) {
+        return;
+    }
+
+    for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
+        if (ei_dsp_cont_alloc_state(&handle->impulse->dsp_blocks[ix], handle->impulse->frequency,
+                handle->impulse->slice_size, &ws->block_states[ix]) != EIDSP_OK) {
+            EI_LOGW("Can't allocate the continuous state of DSP block %d, it's allocated on the first slice\n", (int)ix);
+        }
+    }
+}
+
+static void ei_release_dsp_tables(ei_impulse_state_t *state)
+{
+    if (state->mel_tables_acquired) {
+        ei_dsp_mel_tables(state->impulse, false);
+        state->mel_tables_acquired = false;
+    }
+    numpy::free_fft_plans(&state->fft_plans);
+}
+
 /* Public functions ------------------------------------------------------- */
 
 /* Tread carefully: public functions are not to be changed
@@ -862,10 +941,19 @@ will be documented by Doxygen. */
  */
 extern "C" void run_classifier_init(void)
 {
-
-    classifier_continuous_features_written = 0;
-    ei_dsp_clear_continuous_audio_state();
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1)
+    ei_tflite_resident_release_impulse(ei_default_impulse.impulse);
+#endif
     init_impulse(&ei_default_impulse);
+#if EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT == 1
+    // run_classifier() doesn't use the workspace, skip it for impulses that can't run continuously
+    if (ei_impulse_supports_continuous(ei_default_impulse.impulse) && !ei_default_impulse.state.alloc_continuous_workspace()) {
+        ei_printf("ERR: Out of memory, can't allocate continuous workspace\n");
+    }
+#endif
+    ei_acquire_dsp_tables(&ei_default_impulse.state);
+    ei_default_impulse.state.reset_continuous_workspace();
+    ei_alloc_continuous_dsp_states(&ei_default_impulse);
     init_postprocessing(&ei_default_impulse);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     init_data_normalization(&ei_default_impulse);
@@ -888,9 +976,19 @@ extern "C" void run_classifier_init(void)
  */
 __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 {
-    classifier_continuous_features_written = 0;
-    ei_dsp_clear_continuous_audio_state();
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1)
+    ei_tflite_resident_release_impulse(handle->impulse);
+#endif
     init_impulse(handle);
+#if EI_CLASSIFIER_CONTINUOUS_WORKSPACE_AT_INIT == 1
+    // run_classifier() doesn't use the workspace, skip it for impulses that can't run continuously
+    if (ei_impulse_supports_continuous(handle->impulse) && !handle->state.alloc_continuous_workspace()) {
+        ei_printf("ERR: Out of memory, can't allocate continuous workspace\n");
+    }
+#endif
+    ei_acquire_dsp_tables(&handle->state);
+    handle->state.reset_continuous_workspace();
+    ei_alloc_continuous_dsp_states(handle);
     init_postprocessing(handle);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     init_data_normalization(handle);
@@ -911,16 +1009,42 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 extern "C" void run_classifier_deinit(void)
 {
     deinit_postprocessing(&ei_default_impulse);
+    ei_default_impulse.state.free_continuous_workspace();
+    ei_default_impulse.state.free_nms_workspace();
+    ei_default_impulse.state.free_fomo_workspace();
+    ei_release_dsp_tables(&ei_default_impulse.state);
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1)
+    ei_tflite_resident_release_impulse(ei_default_impulse.impulse);
+#endif
 }
 
 __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 {
     deinit_postprocessing(handle);
+    handle->state.free_continuous_workspace();
+    handle->state.free_nms_workspace();
+    handle->state.free_fomo_workspace();
+    ei_release_dsp_tables(&handle->state);
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1)
+    ei_tflite_resident_release_impulse(handle->impulse);
+#endif
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     deinit_data_normalization(handle);
 #endif
 }
 
+#if EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS == 1
+/**
+ * @brief Number of process_impulse_continuous() calls that allocated DSP scratch, a matrix or a
+ *  tensor arena on the heap, and returned EI_IMPULSE_CONTINUOUS_HEAP_ALLOCATION.
+ *  Should stay at 0 after run_classifier_init().
+ */
+__attribute__((unused)) size_t ei_get_continuous_allocation_count(void)
+{
+    return classifier_continuous_allocations;
+}
+#endif // EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS
+
 /**
  * @brief Run preprocessing (DSP) on new slice of raw features. Add output features
  *  to rolling matrix and run inference on full sample.
@@ -85,9 +85,190 @@ float ei_dsp_image_buffer[EI_DSP_IMAGE_BUFFER_STATIC_SIZE];
 #endif
 
 // this is the frame we work on... allocate it statically so we share between invocations
-static float *ei_dsp_cont_current_frame = nullptr;
-static size_t ei_dsp_cont_current_frame_size = 0;
-static int ei_dsp_cont_current_frame_ix = 0;
+/**
+ * Continuous mode: the part of the feature window of an audio DSP block is a ring of feature rows.
+ * Returns where `n` new values can be written in place, or nullptr when they would wrap around the
+ * end of the window (write them elsewhere, and hand them to ei_dsp_cont_window_push()).
+ */
+static float *ei_dsp_cont_window_ptr(matrix_t *window, ei_dsp_cont_state_t *state, size_t n)
+{
+    if (state->window_head + n > window->rows * window->cols) {
+        return nullptr;
+    }
+    return window->buffer + state->window_head;
+}
+
+/**
+ * Add `n` new values to the window, overwriting the oldest ones. `values` is either the pointer
+ * ei_dsp_cont_window_ptr() returned (already in place) or a buffer that's copied in.
+ */
+static int ei_dsp_cont_window_push(matrix_t *window, ei_dsp_cont_state_t *state, const float *values, size_t n)
+{
+    const size_t window_size = window->rows * window->cols;
+    if (n > window_size) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+    if (n == 0) {
+        return EIDSP_OK;
+    }
+
+    if (values != window->buffer + state->window_head) {
+        const size_t to_end = window_size - state->window_head < n ? window_size - state->window_head : n;
+        memcpy(window->buffer + state->window_head, values, to_end * sizeof(float));
+        memcpy(window->buffer, values + to_end, (n - to_end) * sizeof(float));
+    }
+    state->window_head = (state->window_head + n) % window_size;
+
+    return EIDSP_OK;
+}
+
+/**
+ * Copy the window out oldest value first (the order the non-continuous DSP blocks produce)
+ */
+__attribute__((unused)) static void ei_dsp_cont_window_copy(const matrix_t *window, const ei_dsp_cont_state_t *state, float *out)
+{
+    const size_t window_size = window->rows * window->cols;
+    memcpy(out, window->buffer + state->window_head, (window_size - state->window_head) * sizeof(float));
+    memcpy(out + (window_size - state->window_head), window->buffer, state->window_head * sizeof(float));
+}
+
+/**
+ * Preemphasis history for the current slice: the last samples of the previous slice,
+ * or nullptr on the first slice (which is preemphasized against its own end).
+ */
+static const float *ei_dsp_cont_preemphasis_history(ei_dsp_cont_state_t *state, int shift)
+{
+    if (!state->has_preemphasis_history || state->preemphasis_history_size != shift) {
+        return nullptr;
+    }
+    return state->preemphasis_history;
+}
+
+/**
+ * Make sure the slice state has room for `shift` samples of preemphasis history,
+ * keeps the buffer when it already has the right size
+ */
+static int ei_dsp_cont_alloc_preemphasis_history(ei_dsp_cont_state_t *state, int shift)
+{
+    if (state->preemphasis_history && state->preemphasis_history_size == shift) {
+        return EIDSP_OK;
+    }
+
+    ei_free(state->preemphasis_history);
+    state->preemphasis_history = (float*)ei_calloc(shift * sizeof(float), 1);
+    state->preemphasis_history_size = state->preemphasis_history ? shift : 0;
+    state->has_preemphasis_history = false;
+    if (!state->preemphasis_history) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * Keep the last `shift` raw samples of the slice for the preemphasis of the next slice
+ */
+static int ei_dsp_cont_save_preemphasis_history(ei_dsp_cont_state_t *state, signal_t *signal, int shift)
+{
+    state->has_preemphasis_history = false;
+    if (shift <= 0 || (size_t)shift > signal->total_length) {
+        return EIDSP_OK;
+    }
+
+    int ret = ei_dsp_cont_alloc_preemphasis_history(state, shift);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    ret = signal->get_data(signal->total_length - shift, shift, state->preemphasis_history);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+    state->has_preemphasis_history = true;
+
+    return EIDSP_OK;
+}
+
+/**
+ * Make sure the slice state holds a frame of `frame_size` samples, keeps it when it already does
+ */
+static int ei_dsp_cont_alloc_frame(ei_dsp_cont_state_t *state, size_t frame_size)
+{
+    if (state->frame && state->frame_size == frame_size) {
+        return EIDSP_OK;
+    }
+
+    ei_free(state->frame);
+    state->frame = (float*)ei_calloc(frame_size * sizeof(float), 1);
+    state->frame_size = state->frame ? frame_size : 0;
+    state->frame_ix = 0;
+    state->frame_start = 0;
+    if (!state->frame) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * The frame of a slice state is a ring that starts at `frame_start`, moving on by a stride only
+ * moves the start. Writes `n` samples of `signal` from `offset` on at position `ix` of the frame.
+ */
+static int ei_dsp_cont_frame_write(ei_dsp_cont_state_t *state, signal_t *signal, size_t offset, size_t ix, size_t n)
+{
+    const size_t pos = (state->frame_start + ix) % state->frame_size;
+    const size_t to_end = state->frame_size - pos < n ? state->frame_size - pos : n;
+
+    int ret = signal->get_data(offset, to_end, state->frame + pos);
+    if (ret == EIDSP_OK && n > to_end) {
+        ret = signal->get_data(offset + to_end, n - to_end, state->frame);
+    }
+    return ret;
+}
+
+static const ei_dsp_cont_state_t *cont_frame_state;
+static int cont_frame_get_data(size_t offset, size_t length, float *out_ptr) {
+    const size_t pos = (cont_frame_state->frame_start + offset) % cont_frame_state->frame_size;
+    const size_t to_end = cont_frame_state->frame_size - pos < length ? cont_frame_state->frame_size - pos : length;
+
+    memcpy(out_ptr, cont_frame_state->frame + pos, to_end * sizeof(float));
+    memcpy(out_ptr + to_end, cont_frame_state->frame, (length - to_end) * sizeof(float));
+    return EIDSP_OK;
+}
+
+/**
+ * Signal over the (complete) frame of the slice state, oldest sample first
+ */
+static void ei_dsp_cont_frame_signal(const ei_dsp_cont_state_t *state, signal_t *frame_signal)
+{
+    cont_frame_state = state;
+    frame_signal->total_length = state->frame_size;
+    frame_signal->get_data = &cont_frame_get_data;
+}
+
+/**
+ * Make sure the fixed-point PCM buffer of the slice state holds `pcm_size` samples,
+ * keeps the first `keep` samples when it has to grow
+ */
+static int ei_dsp_cont_alloc_pcm(ei_dsp_cont_state_t *state, size_t pcm_size, size_t keep)
+{
+    if (state->pcm_size >= pcm_size) {
+        return EIDSP_OK;
+    }
+
+    EIDSP_i16 *pcm = (EIDSP_i16*)ei_calloc(pcm_size, sizeof(EIDSP_i16));
+    if (!pcm) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+    if (state->pcm) {
+        memcpy(pcm, state->pcm, keep * sizeof(EIDSP_i16));
+        ei_free(state->pcm);
+    }
+    state->pcm = pcm;
+    state->pcm_size = pcm_size;
+
+    return EIDSP_OK;
+}
 
 __attribute__((unused)) int extract_hr_features(
     signal_t *signal,
@@ -285,7 +466,69 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
 }
 
 
-__attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfcc_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, int implementation_version) {
+/**
+ * Fixed-point variant of extract_mfcc_features: reads the signal as int16 (signal_t::get_data_i16)
+ * and computes the filterbank energies in q15 / integer arithmetic. Select it per DSP block by using
+ * it as the block's extract_fn instead of extract_mfcc_features.
+ */
+__attribute__((unused)) int extract_mfcc_features_q15(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+    ei_dsp_config_mfcc_t config = *((ei_dsp_config_mfcc_t*)config_ptr);
+
+    if (config.axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if((config.implementation_version == 0) || (config.implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    if (signal->total_length == 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+
+    // calculate the size of the MFCC matrix
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfcc_buffer_size(
+            signal->total_length, frequency, config.frame_length, config.frame_stride, config.num_cepstral, config.implementation_version);
+    /* Only throw size mismatch error calculated buffer doesn't fit for continuous inferencing */
+    if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
+        ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
+        ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    output_matrix->rows = out_matrix_size.rows;
+    output_matrix->cols = out_matrix_size.cols;
+
+    // and run the MFCC extraction
+    // mfcc_q15 trims the signal to whole frames, and does the preemphasis per frame
+    signal_t frame_signal = *signal;
+
+    int ret = speechpy::feature::mfcc_q15(output_matrix, &frame_signal, 1.0f, config.pre_shift, config.pre_cof,
+        frequency, config.frame_length, config.frame_stride, config.num_cepstral, config.num_filters, config.fft_length,
+        config.low_frequency, config.high_frequency, true, config.implementation_version);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: MFCC failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    // cepstral mean and variance normalization
+    ret = speechpy::processing::cmvnw(output_matrix, config.win_size, true, false);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: cmvnw failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    output_matrix->cols = out_matrix_size.rows * out_matrix_size.cols;
+    output_matrix->rows = 1;
+
+    return EIDSP_OK;
+}
+
+
+__attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfcc_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, int implementation_version, ei_dsp_cont_state_t *state) {
     uint32_t frequency = (uint32_t)sampling_frequency;
 
     int x;
@@ -296,19 +539,18 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->num_cepstral,
             implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
-    if (x != EIDSP_OK) {
-        EIDSP_ERR(x);
+    // the new rows go over the oldest rows in the window, if they wrap around the end of
+    // the window they're calculated in a separate buffer and copied in
+    const size_t n_values = out_matrix_size.rows * out_matrix_size.cols;
+    if (n_values > output_matrix->rows * output_matrix->cols) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
 
-    // slice in the output matrix to write to
-    // the offset in the classification matrix here is always at the end
-    size_t output_matrix_offset = (output_matrix->rows * output_matrix->cols) -
-        (out_matrix_size.rows * out_matrix_size.cols);
-
-    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
+    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols,
+        ei_dsp_cont_window_ptr(output_matrix, state, n_values));
+    if (!output_matrix_slice.buffer) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
 
     // and run the MFCC extraction
     x = speechpy::feature::mfcc(&output_matrix_slice, signal,
@@ -319,6 +561,11 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
         EIDSP_ERR(x);
     }
 
+    x = ei_dsp_cont_window_push(output_matrix, state, output_matrix_slice.buffer, n_values);
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
     matrix_size_out->rows += out_matrix_size.rows;
     if (out_matrix_size.cols > 0) {
         matrix_size_out->cols = out_matrix_size.cols;
@@ -327,7 +574,7 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -349,8 +596,9 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 
     const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
 
-    // preemphasis class to preprocess the audio...
-    class speechpy::processing::preemphasis pre(signal, config.pre_shift, config.pre_cof, false);
+    // preemphasis class to preprocess the audio, continuing from the end of the previous slice
+    class speechpy::processing::preemphasis pre(signal, config.pre_shift, config.pre_cof, false,
+        ei_dsp_cont_preemphasis_history(state, config.pre_shift));
     preemphasis = &pre;
 
     signal_t preemphasized_audio_signal;
@@ -371,12 +619,10 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
-    int x;
-
-    // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    // normally sized by run_classifier_init() already
+    int x = ei_dsp_cont_alloc_frame(state, frame_length_values);
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
     }
 
     int implementation_version = config.implementation_version;
@@ -384,19 +630,9 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
-        }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
-    }
-
-
-    if ((frame_length_values) > preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix) {
+    if ((frame_length_values) > preemphasized_audio_signal.total_length  + state->frame_ix) {
         ei_printf("ERR: frame_length (%d) cannot be larger than signal's total length (%d) for continuous classification\n",
-            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix);
+            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + state->frame_ix);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
@@ -408,49 +644,44 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
         implementation_version = 2;
     }
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size (ix=%d size=%d)\n",
-            ei_dsp_cont_current_frame_ix, (int)ei_dsp_cont_current_frame_size);
+    if (state->frame_ix > (int)state->frame_size) {
+        ei_printf("ERR: continuous frame index is larger than frame size (ix=%d size=%d)\n",
+            state->frame_ix, (int)state->frame_size);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = ei_dsp_cont_frame_write(state, &preemphasized_audio_signal, 0, state->frame_ix, frame_length_values - state->frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now the frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
-        if (x != EIDSP_OK) {
-            EIDSP_ERR(x);
-        }
+        ei_dsp_cont_frame_signal(state, &frame_signal);
 
-        x = extract_mfcc_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
+        x = extract_mfcc_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version, state);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
-        if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
-        }
+        // if there's overlap between frames the next one starts a stride further
+        state->frame_start = (state->frame_start + frame_stride_values) % frame_length_values;
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->frame_ix < 0) {
+        offset_in_signal = -state->frame_ix;
+        state->frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
         offset_in_signal -= signal->total_length;
-        return EIDSP_OK;
+        return ei_dsp_cont_save_preemphasis_history(state, signal, config.pre_shift);
     }
 
     // now... we need to discard part of the signal...
@@ -460,7 +691,7 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     size_t range_signal_orig_length = range_signal->total_length;
 
     // then we'll just go through normal processing of the signal:
-    x = extract_mfcc_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
+    x = extract_mfcc_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version, state);
     if (x != EIDSP_OK) {
         EIDSP_ERR(x);
     }
@@ -478,21 +709,22 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the frame buffer for the next slice
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->frame_ix = bytes_left_end_of_frame;
+    state->frame_start = 0;
 
     preemphasis = nullptr;
 
-    return EIDSP_OK;
+    return ei_dsp_cont_save_preemphasis_history(state, signal, config.pre_shift);
 #endif
 }
 
@@ -553,7 +785,7 @@ __attribute__((unused)) int extract_spectrogram_features(signal_t *signal, matri
 }
 
 
-__attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_spectrogram_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_spectrogram_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
     uint32_t frequency = (uint32_t)sampling_frequency;
 
     int x;
@@ -564,22 +796,18 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->fft_length / 2 + 1,
             config->implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
-    if (x != EIDSP_OK) {
-        if (preemphasis) {
-            delete preemphasis;
-        }
-        EIDSP_ERR(x);
+    // the new rows go over the oldest rows in the window, if they wrap around the end of
+    // the window they're calculated in a separate buffer and copied in
+    const size_t n_values = out_matrix_size.rows * out_matrix_size.cols;
+    if (n_values > output_matrix->rows * output_matrix->cols) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
 
-    // slice in the output matrix to write to
-    // the offset in the classification matrix here is always at the end
-    size_t output_matrix_offset = (output_matrix->rows * output_matrix->cols) -
-        (out_matrix_size.rows * out_matrix_size.cols);
-
-    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
+    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols,
+        ei_dsp_cont_window_ptr(output_matrix, state, n_values));
+    if (!output_matrix_slice.buffer) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
 
     // and run the spectrogram extraction
     int ret = speechpy::feature::spectrogram(&output_matrix_slice, signal,
@@ -590,6 +818,11 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
         EIDSP_ERR(ret);
     }
 
+    x = ei_dsp_cont_window_push(output_matrix, state, output_matrix_slice.buffer, n_values);
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
     matrix_size_out->rows += out_matrix_size.rows;
     if (out_matrix_size.cols > 0) {
         matrix_size_out->cols = out_matrix_size.cols;
@@ -598,7 +831,7 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -606,7 +839,6 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
-    static bool first_run = false;
 
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
@@ -623,11 +855,11 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     buffer */
     if(config.implementation_version < 2) {
 
-        if (first_run == true) {
+        if (state->first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->first_run = true;
     }
 
     // Go from the time (e.g. 0.25 seconds to number of frames based on freq)
@@ -650,21 +882,10 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
-    int x;
-
-    // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
-    }
-
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
-        }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+    // normally sized by run_classifier_init() already
+    int x = ei_dsp_cont_alloc_frame(state, frame_length_values);
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
     }
 
     matrix_size_out->rows = 0;
@@ -673,43 +894,38 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
+    if (state->frame_ix > (int)state->frame_size) {
+        ei_printf("ERR: continuous frame index is larger than frame size\n");
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->frame_ix`
         // starting at offset 0
-        x = signal->get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = ei_dsp_cont_frame_write(state, signal, 0, state->frame_ix, frame_length_values - state->frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now the frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
-        if (x != EIDSP_OK) {
-            EIDSP_ERR(x);
-        }
+        ei_dsp_cont_frame_signal(state, &frame_signal);
 
-        x = extract_spectrogram_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
+        x = extract_spectrogram_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, state);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
-        if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
-        }
+        // if there's overlap between frames the next one starts a stride further
+        state->frame_start = (state->frame_start + frame_stride_values) % frame_length_values;
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->frame_ix < 0) {
+        offset_in_signal = -state->frame_ix;
+        state->frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -724,7 +940,7 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     size_t range_signal_orig_length = range_signal->total_length;
 
     // then we'll just go through normal processing of the signal:
-    x = extract_spectrogram_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
+    x = extract_spectrogram_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, state);
     if (x != EIDSP_OK) {
         EIDSP_ERR(x);
     }
@@ -742,20 +958,21 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the frame buffer for the next slice
         x = signal->get_data(
             (signal->total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->frame_ix = bytes_left_end_of_frame;
+    state->frame_start = 0;
 
     if (config.implementation_version < 2) {
-        if (first_run == true) {
+        if (state->first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
@@ -864,7 +1081,74 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
     return EIDSP_OK;
 }
 
-__attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+/**
+ * Fixed-point variant of extract_mfe_features: reads the signal as int16 (signal_t::get_data_i16)
+ * and computes the filterbank energies in q15 / integer arithmetic. Select it per DSP block by using
+ * it as the block's extract_fn instead of extract_mfe_features. Only implementation version 3 and up
+ * have a fixed-point path, older blocks run extract_mfe_features.
+ */
+__attribute__((unused)) int extract_mfe_features_q15(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+    ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
+
+    if (config.axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if (signal->total_length == 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    if ((config.implementation_version == 0) || (config.implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    if (config.implementation_version < 3) {
+        return extract_mfe_features(signal, output_matrix, config_ptr, sampling_frequency);
+    }
+
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+
+    // calculate the size of the MFE matrix
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfe_buffer_size(
+            signal->total_length, frequency, config.frame_length, config.frame_stride, config.num_filters,
+            config.implementation_version);
+    /* Only throw size mismatch error calculated buffer doesn't fit for continuous inferencing */
+    if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
+        ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
+        ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    output_matrix->rows = out_matrix_size.rows;
+    output_matrix->cols = out_matrix_size.cols;
+
+    // mfe_q15 trims the signal to whole frames, and does the same preemphasis as
+    // extract_mfe_features per frame (rescaled to [-1 .. 1])
+    signal_t frame_signal = *signal;
+
+    int ret = speechpy::feature::mfe_q15(output_matrix, nullptr, &frame_signal, 1.0f / 32768.0f, 1, 0.98f,
+        frequency, config.frame_length, config.frame_stride, config.num_filters, config.fft_length,
+        config.low_frequency, config.high_frequency, config.implementation_version);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: MFE failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    // normalization
+    ret = speechpy::processing::mfe_normalization(output_matrix, config.noise_floor_db);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: normalization failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    output_matrix->cols = out_matrix_size.rows * out_matrix_size.cols;
+    output_matrix->rows = 1;
+
+    return EIDSP_OK;
+}
+
+__attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
     uint32_t frequency = (uint32_t)sampling_frequency;
 
     int x;
@@ -875,19 +1159,18 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->num_filters,
             config->implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
-    if (x != EIDSP_OK) {
-        EIDSP_ERR(x);
+    // the new rows go over the oldest rows in the window, if they wrap around the end of
+    // the window they're calculated in a separate buffer and copied in
+    const size_t n_values = out_matrix_size.rows * out_matrix_size.cols;
+    if (n_values > output_matrix->rows * output_matrix->cols) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
 
-    // slice in the output matrix to write to
-    // the offset in the classification matrix here is always at the end
-    size_t output_matrix_offset = (output_matrix->rows * output_matrix->cols) -
-        (out_matrix_size.rows * out_matrix_size.cols);
-
-    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
+    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols,
+        ei_dsp_cont_window_ptr(output_matrix, state, n_values));
+    if (!output_matrix_slice.buffer) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
 
     // and run the MFE extraction
     // This probably seems incorrect, but the mfe func can actually handle all versions
@@ -908,6 +1191,11 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
         EIDSP_ERR(x);
     }
 
+    x = ei_dsp_cont_window_push(output_matrix, state, output_matrix_slice.buffer, n_values);
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
     matrix_size_out->rows += out_matrix_size.rows;
     if (out_matrix_size.cols > 0) {
         matrix_size_out->cols = out_matrix_size.cols;
@@ -916,7 +1204,7 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -927,7 +1215,6 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // signal is already the right size,
     // output matrix is not the right size, but we can start writing at offset 0 and then it's OK too
 
-    static bool first_run = false;
 
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
@@ -947,11 +1234,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // subtracted and there for never used. But skip the first slice to fit the feature_matrix
     // buffer
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->first_run = true;
     }
 
     // ok all setup, let's construct the signal (with preemphasis for impl version >3)
@@ -965,7 +1252,9 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     }
     else {
         // preemphasis class to preprocess the audio...
-        class speechpy::processing::preemphasis *pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
+        // continuing from the end of the previous slice
+        class speechpy::processing::preemphasis *pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true,
+            ei_dsp_cont_preemphasis_history(state, 1));
         preemphasis = pre;
         preemphasized_audio_signal.total_length = signal->total_length;
         preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
@@ -998,24 +1287,13 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
-    int x;
-
-    // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
-    }
-
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
-            if (preemphasis) {
-                delete preemphasis;
-            }
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    // normally sized by run_classifier_init() already
+    int x = ei_dsp_cont_alloc_frame(state, frame_length_values);
+    if (x != EIDSP_OK) {
+        if (preemphasis) {
+            delete preemphasis;
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        EIDSP_ERR(x);
     }
 
     matrix_size_out->rows = 0;
@@ -1024,8 +1302,8 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
+    if (state->frame_ix > (int)state->frame_size) {
+        ei_printf("ERR: continuous frame index is larger than frame size\n");
         if (preemphasis) {
             delete preemphasis;
         }
@@ -1033,10 +1311,10 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = ei_dsp_cont_frame_write(state, &preemphasized_audio_signal, 0, state->frame_ix, frame_length_values - state->frame_ix);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1044,17 +1322,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now the frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
-        if (x != EIDSP_OK) {
-            if (preemphasis) {
-                delete preemphasis;
-            }
-            EIDSP_ERR(x);
-        }
+        ei_dsp_cont_frame_signal(state, &frame_signal);
 
-        x = extract_mfe_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
+        x = extract_mfe_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, state);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1062,22 +1334,21 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
-        if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
-        }
+        // if there's overlap between frames the next one starts a stride further
+        state->frame_start = (state->frame_start + frame_stride_values) % frame_length_values;
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->frame_ix < 0) {
+        offset_in_signal = -state->frame_ix;
+        state->frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
         if (preemphasis) {
             delete preemphasis;
+            return ei_dsp_cont_save_preemphasis_history(state, signal, 1);
         }
         offset_in_signal -= signal->total_length;
         return EIDSP_OK;
@@ -1090,7 +1361,7 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     size_t range_signal_orig_length = range_signal->total_length;
 
     // then we'll just go through normal processing of the signal:
-    x = extract_mfe_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
+    x = extract_mfe_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, state);
     if (x != EIDSP_OK) {
         if (preemphasis) {
             delete preemphasis;
@@ -1111,11 +1382,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the frame buffer for the next slice
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->frame);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1124,23 +1395,402 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->frame_ix = bytes_left_end_of_frame;
+    state->frame_start = 0;
 
 
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
 
     if (preemphasis) {
         delete preemphasis;
+        return ei_dsp_cont_save_preemphasis_history(state, signal, 1);
     }
 
     return EIDSP_OK;
 #endif
 }
 
+#if !(defined(__cplusplus) && EI_C_LINKAGE == 1)
+/**
+ * Samples in a frame of `seconds` for the fixed-point blocks, same as stack_frames()
+ */
+static size_t ei_dsp_q15_frame_values(uint32_t frequency, float seconds)
+{
+    return static_cast<size_t>(
+        speechpy::processing::ceil_unless_very_close_to_floor(static_cast<float>(frequency) * seconds));
+}
+
+/**
+ * Continuous mode of the fixed-point MFE / MFCC blocks. The int16 samples that did not make a whole
+ * frame yet are kept in state->pcm (behind the `pre_shift` samples of preemphasis history), the slice
+ * is appended and `run` computes all whole frames straight into the block's feature window.
+ */
+template <typename run_fn_t>
+static int extract_q15_per_slice(signal_t *signal, matrix_t *output_matrix, uint32_t frequency,
+    float frame_length, float frame_stride, int pre_shift, uint16_t version, uint16_t cols,
+    matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state, run_fn_t run)
+{
+    matrix_size_out->rows = 0;
+    matrix_size_out->cols = 0;
+
+    if (pre_shift < 0) {
+        pre_shift = 0;
+    }
+
+    const size_t frame_length_values = ei_dsp_q15_frame_values(frequency, frame_length);
+    const size_t frame_stride_values = ei_dsp_q15_frame_values(frequency, frame_stride);
+
+    if (frame_stride_values == 0 || frame_stride_values > frame_length_values) {
+        ei_printf("ERR: frame_length (");
+        ei_printf_float(frame_length);
+        ei_printf(") cannot be lower than frame_stride (");
+        ei_printf_float(frame_stride);
+        ei_printf(") for continuous classification\n");
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    // the samples left over are always less than a frame
+    int ret = ei_dsp_cont_alloc_pcm(state, pre_shift + frame_length_values + signal->total_length,
+        pre_shift + state->pcm_len);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    EIDSP_i16 *samples = state->pcm + pre_shift;
+    ret = numpy::signal_get_data_i16(signal, 0, signal->total_length, samples + state->pcm_len);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+    const size_t length = state->pcm_len + signal->total_length;
+
+    size_t frames = 0;
+    if (length >= frame_length_values) {
+        frames = speechpy::feature::calculate_mfe_buffer_size(length, frequency, frame_length, frame_stride,
+            cols, version).rows;
+
+        const size_t n_values = frames * cols;
+        if (n_values > output_matrix->rows * output_matrix->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        matrix_t output_matrix_slice(frames, cols, ei_dsp_cont_window_ptr(output_matrix, state, n_values));
+        if (!output_matrix_slice.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        signal_t frames_signal;
+        frames_signal.total_length = length;
+        frames_signal.get_data_i16 = [samples](size_t offset, size_t count, EIDSP_i16 *out_ptr) {
+            memcpy(out_ptr, samples + offset, count * sizeof(EIDSP_i16));
+            return EIDSP_OK;
+        };
+
+        // the first slice of a stream is preemphasized against its own end, as the float path does
+        ret = run(&output_matrix_slice, &frames_signal, state->has_pcm_history ? state->pcm : nullptr);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        ret = ei_dsp_cont_window_push(output_matrix, state, output_matrix_slice.buffer, n_values);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        matrix_size_out->rows = frames;
+        matrix_size_out->cols = cols;
+    }
+
+    // keep the samples from the next frame on, and the history before them
+    const size_t consumed = frames * frame_stride_values;
+    memmove(state->pcm, state->pcm + consumed, (pre_shift + length - consumed) * sizeof(EIDSP_i16));
+    state->pcm_len = length - consumed;
+    state->has_pcm_history = state->has_pcm_history || consumed >= static_cast<size_t>(pre_shift);
+
+    return EIDSP_OK;
+}
+#endif
+
+/**
+ * Slice version of extract_mfcc_features_q15, for continuous mode
+ */
+__attribute__((unused)) int extract_mfcc_q15_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
+#if defined(__cplusplus) && EI_C_LINKAGE == 1
+    ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
+    EIDSP_ERR(EIDSP_NOT_SUPPORTED);
+#else
+    ei_dsp_config_mfcc_t config = *((ei_dsp_config_mfcc_t*)config_ptr);
+
+    if (config.axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if ((config.implementation_version == 0) || (config.implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    if (signal->total_length == 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+    // for continuous use v2 stack frame calculations
+    const uint16_t implementation_version = config.implementation_version == 1 ? 2 : config.implementation_version;
+
+    return extract_q15_per_slice(signal, output_matrix, frequency, config.frame_length, config.frame_stride,
+        config.pre_shift, implementation_version, config.num_cepstral, matrix_size_out, state,
+        [&](matrix_t *out, signal_t *frames_signal, const EIDSP_i16 *pre_history) {
+            int ret = speechpy::feature::mfcc_q15(out, frames_signal, 1.0f, config.pre_shift, config.pre_cof,
+                frequency, config.frame_length, config.frame_stride, config.num_cepstral, config.num_filters,
+                config.fft_length, config.low_frequency, config.high_frequency, true, implementation_version,
+                pre_history);
+            if (ret != EIDSP_OK) {
+                ei_printf("ERR: MFCC failed (%d)\n", ret);
+            }
+            return ret;
+        });
+#endif
+}
+
+/**
+ * Slice version of extract_mfe_features_q15, for continuous mode. Like the non-continuous
+ * variant only implementation version 3 and up run in fixed point.
+ */
+__attribute__((unused)) int extract_mfe_q15_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_dsp_cont_state_t *state) {
+#if defined(__cplusplus) && EI_C_LINKAGE == 1
+    ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
+    EIDSP_ERR(EIDSP_NOT_SUPPORTED);
+#else
+    ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
+
+    if (config.axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if ((config.implementation_version == 0) || (config.implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    if (config.implementation_version < 3) {
+        return extract_mfe_per_slice_features(signal, output_matrix, config_ptr, sampling_frequency, matrix_size_out, state);
+    }
+
+    if (signal->total_length == 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+
+    return extract_q15_per_slice(signal, output_matrix, frequency, config.frame_length, config.frame_stride,
+        1, config.implementation_version, config.num_filters, matrix_size_out, state,
+        [&](matrix_t *out, signal_t *frames_signal, const EIDSP_i16 *pre_history) {
+            int ret = speechpy::feature::mfe_q15(out, nullptr, frames_signal, 1.0f / 32768.0f, 1, 0.98f,
+                frequency, config.frame_length, config.frame_stride, config.num_filters, config.fft_length,
+                config.low_frequency, config.high_frequency, config.implementation_version, pre_history);
+            if (ret != EIDSP_OK) {
+                ei_printf("ERR: MFE failed (%d)\n", ret);
+            }
+            return ret;
+        });
+#endif
+}
+
+/**
+ * Extract function a DSP block runs with. With EI_CLASSIFIER_DSP_AUDIO_Q15 the MFE and MFCC
+ * blocks of the model run through their fixed-point variants. MFCC blocks whose lowest mel
+ * filter starts at 0 Hz (v4+) stay on float: after preemphasis the bins around DC sit below
+ * the range of the 16-bit FFT and the first cepstral coefficients drift.
+ */
+__attribute__((unused)) static extract_fn_t ei_dsp_block_extract_fn(const ei_model_dsp_t *block)
+{
+#if EI_CLASSIFIER_DSP_AUDIO_Q15 == 1
+    if (block->extract_fn == extract_mfcc_features) {
+        const ei_dsp_config_mfcc_t *config = (const ei_dsp_config_mfcc_t *)block->config;
+        if (config->implementation_version >= 4 && config->low_frequency == 0) {
+            return block->extract_fn;
+        }
+        return extract_mfcc_features_q15;
+    }
+    if (block->extract_fn == extract_mfe_features) {
+        return extract_mfe_features_q15;
+    }
+#endif
+    return block->extract_fn;
+}
+
+/**
+ * Size the slice buffers (frame, preemphasis history, fixed-point samples) of a continuous DSP
+ * block for slices of `slice_size` samples, so process_impulse_continuous() does not allocate
+ * them on the first slice. Nothing to do for blocks that don't run continuously.
+ */
+__attribute__((unused)) static int ei_dsp_cont_alloc_state(const ei_model_dsp_t *block, const float sampling_frequency,
+    size_t slice_size, ei_dsp_cont_state_t *state)
+{
+#if defined(__cplusplus) && EI_C_LINKAGE == 1
+    return EIDSP_OK;
+#else
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+    const extract_fn_t extract_fn = ei_dsp_block_extract_fn(block);
+    int ret = EIDSP_OK;
+
+    if (extract_fn == extract_mfcc_features) {
+        const ei_dsp_config_mfcc_t *config = (const ei_dsp_config_mfcc_t *)block->config;
+        ret = ei_dsp_cont_alloc_frame(state, frequency * config->frame_length);
+        if (ret == EIDSP_OK && config->pre_shift > 0 && (size_t)config->pre_shift <= slice_size) {
+            ret = ei_dsp_cont_alloc_preemphasis_history(state, config->pre_shift);
+        }
+    }
+    else if (extract_fn == extract_spectrogram_features) {
+        const ei_dsp_config_spectrogram_t *config = (const ei_dsp_config_spectrogram_t *)block->config;
+        ret = ei_dsp_cont_alloc_frame(state, frequency * config->frame_length);
+    }
+    else if (extract_fn == extract_mfe_features ||
+             (extract_fn == extract_mfe_features_q15 && ((const ei_dsp_config_mfe_t *)block->config)->implementation_version < 3)) {
+        const ei_dsp_config_mfe_t *config = (const ei_dsp_config_mfe_t *)block->config;
+        ret = ei_dsp_cont_alloc_frame(state, frequency * config->frame_length);
+        if (ret == EIDSP_OK && config->implementation_version >= 3) {
+            ret = ei_dsp_cont_alloc_preemphasis_history(state, 1);
+        }
+    }
+    else if (extract_fn == extract_mfcc_features_q15) {
+        const ei_dsp_config_mfcc_t *config = (const ei_dsp_config_mfcc_t *)block->config;
+        const size_t pre_shift = config->pre_shift > 0 ? config->pre_shift : 0;
+        ret = ei_dsp_cont_alloc_pcm(state, pre_shift + ei_dsp_q15_frame_values(frequency, config->frame_length) + slice_size, 0);
+    }
+    else if (extract_fn == extract_mfe_features_q15) {
+        const ei_dsp_config_mfe_t *config = (const ei_dsp_config_mfe_t *)block->config;
+        ret = ei_dsp_cont_alloc_pcm(state, 1 + ei_dsp_q15_frame_values(frequency, config->frame_length) + slice_size, 0);
+    }
+
+    return ret;
+#endif
+}
+
+static int ei_dsp_mel_table_ref(bool acquire, uint16_t num_filters, uint16_t fft_length, uint32_t frequency,
+    uint32_t low_frequency, uint32_t high_frequency, uint16_t version, bool legacy_filterbank)
+{
+    if (!acquire) {
+        speechpy::feature::release_mel_table(num_filters, fft_length, frequency, low_frequency, high_frequency,
+            version, legacy_filterbank);
+        return EIDSP_OK;
+    }
+    return speechpy::feature::acquire_mel_table(num_filters, fft_length, frequency, low_frequency, high_frequency,
+        version, legacy_filterbank);
+}
+
+/**
+ * Take (or drop) references to the cached mel filterbank / DCT tables of the MFCC and MFE blocks
+ * of an impulse, so those are built once and not for every window or slice.
+ * Blocks without a cached table still work, they build the table on every call.
+ */
+__attribute__((unused)) static int ei_dsp_mel_tables(const ei_impulse_t *impulse, bool acquire)
+{
+    const uint32_t frequency = static_cast<uint32_t>(impulse->frequency);
+
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t *block = &impulse->dsp_blocks[ix];
+        int ret = EIDSP_OK;
+
+        if (block->extract_fn == extract_mfcc_features || block->extract_fn == extract_mfcc_features_q15) {
+            ei_dsp_config_mfcc_t *config = (ei_dsp_config_mfcc_t*)block->config;
+            ret = ei_dsp_mel_table_ref(acquire, config->num_filters, config->fft_length, frequency,
+                config->low_frequency, config->high_frequency, config->implementation_version, false);
+        }
+        else if (block->extract_fn == extract_mfe_features || block->extract_fn == extract_mfe_features_q15) {
+            ei_dsp_config_mfe_t *config = (ei_dsp_config_mfe_t*)block->config;
+            // before v3 the MFE (the fixed-point block falls back to it) uses mfe_v3()
+            const bool legacy_filterbank = config->implementation_version < 3;
+            ret = ei_dsp_mel_table_ref(acquire, config->num_filters, config->fft_length, frequency,
+                config->low_frequency, config->high_frequency, config->implementation_version, legacy_filterbank);
+        }
+
+        if (ret != EIDSP_OK) {
+            return ret;
+        }
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * FFT lengths the software rfft() of a DSP block runs at (the DCT of MFCC included), 0 for unused entries
+ */
+__attribute__((unused)) static void ei_dsp_block_fft_lengths(const ei_model_dsp_t *block, size_t lengths[2])
+{
+    lengths[0] = 0;
+    lengths[1] = 0;
+
+    if (block->extract_fn == extract_mfcc_features || block->extract_fn == extract_mfcc_features_q15) {
+        ei_dsp_config_mfcc_t *config = (ei_dsp_config_mfcc_t*)block->config;
+        lengths[0] = config->fft_length;
+        lengths[1] = config->num_filters;
+    }
+    else if (block->extract_fn == extract_mfe_features || block->extract_fn == extract_mfe_features_q15) {
+        lengths[0] = ((ei_dsp_config_mfe_t*)block->config)->fft_length;
+    }
+    else if (block->extract_fn == extract_spectrogram_features) {
+        lengths[0] = ((ei_dsp_config_spectrogram_t*)block->config)->fft_length;
+    }
+    else if (block->extract_fn == extract_spectral_analysis_features) {
+        ei_dsp_config_spectral_analysis_t *config = (ei_dsp_config_spectral_analysis_t*)block->config;
+        if (!config->analysis_type || strcmp(config->analysis_type, "Wavelet") != 0) {
+            lengths[0] = config->fft_length;
+        }
+    }
+
+    // the real FFT only does even lengths
+    for (size_t ix = 0; ix < 2; ix++) {
+        if (lengths[ix] % 2 != 0) {
+            lengths[ix] = 0;
+        }
+    }
+}
+
+/**
+ * Build the FFT plans for the FFT lengths of the DSP blocks of an impulse into `plans`,
+ * so the twiddle factors are set up once and not for every frame or axis.
+ * All or none of the plans are built.
+ */
+__attribute__((unused)) static int ei_dsp_build_fft_plans(const ei_impulse_t *impulse, numpy::fft_plans_t *plans)
+{
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        size_t lengths[2];
+        ei_dsp_block_fft_lengths(&impulse->dsp_blocks[ix], lengths);
+        for (size_t jx = 0; jx < 2; jx++) {
+            if (lengths[jx] == 0) {
+                continue;
+            }
+            int ret = numpy::build_fft_plan(plans, lengths[jx]);
+            if (ret != EIDSP_OK) {
+                numpy::free_fft_plans(plans);
+                return ret;
+            }
+        }
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * Lets software_rfft() use the FFT plans of an impulse handle until the scope ends
+ */
+class FftPlansScope {
+public:
+    FftPlansScope(numpy::fft_plans_t *plans) {
+        _prev = numpy::use_fft_plans(plans);
+    }
+
+    ~FftPlansScope() {
+        numpy::use_fft_plans(_prev);
+    }
+
+private:
+    numpy::fft_plans_t *_prev;
+};
+
 __attribute__((unused)) int extract_image_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_image_t config = *((ei_dsp_config_image_t*)config_ptr);
 
@@ -1401,17 +2051,11 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
 #endif // (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE != EI_CLASSIFIER_DRPAI)
 
 /**
- * Clear all state regarding continuous audio. Invoke this function after continuous audio loop ends.
+ * Clear all state regarding continuous audio. The state is kept per impulse handle, and is
+ * cleared by run_classifier_init() and freed by run_classifier_deinit(); this is a no-op
+ * kept for existing callers.
  */
 __attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
-    if (ei_dsp_cont_current_frame) {
-        ei_free(ei_dsp_cont_current_frame);
-    }
-
-    ei_dsp_cont_current_frame = nullptr;
-    ei_dsp_cont_current_frame_size = 0;
-    ei_dsp_cont_current_frame_ix = 0;
-
     return EIDSP_OK;
 }
 
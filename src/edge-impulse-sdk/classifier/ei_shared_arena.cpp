@@ -0,0 +1,273 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "edge-impulse-sdk/classifier/ei_shared_arena.h"
+
+#if EI_CLASSIFIER_SHARED_ARENA_SIZE > 0
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * One region, two stacks: DSP scratch grows up from the bottom, model arenas grow down from
+ * the top. Every block starts with a header that links it to the previous block on the same
+ * end. A block freed out of order is only marked, and given back once everything above it
+ * on its end is freed as well. A block that does not fit goes to the heap.
+ */
+
+#define SHARED_ARENA_ALIGN      16
+#define SHARED_ARENA_NONE       UINT32_MAX
+#define SHARED_ARENA_MAGIC      0x45494152 /* "EIAR" */
+
+typedef struct {
+    uint32_t size;      /* bytes taken from the region, header included */
+    uint32_t prev;      /* offset of the previous block on the same end */
+    uint32_t freed;
+    uint32_t magic;
+} shared_arena_block_t;
+
+static_assert(sizeof(shared_arena_block_t) == SHARED_ARENA_ALIGN, "block header must keep payloads aligned");
+
+/* usable size, the model stack starts aligned */
+#define SHARED_ARENA_BYTES      (EI_CLASSIFIER_SHARED_ARENA_SIZE & ~(SHARED_ARENA_ALIGN - 1))
+
+static uint8_t shared_arena[EI_CLASSIFIER_SHARED_ARENA_SIZE] __attribute__((aligned(SHARED_ARENA_ALIGN)));
+
+static size_t arena_low = 0;                        /* end of the DSP stack */
+static size_t arena_high = SHARED_ARENA_BYTES;      /* start of the model stack */
+static uint32_t arena_low_last = SHARED_ARENA_NONE;
+static uint32_t arena_high_last = SHARED_ARENA_NONE;
+static uint32_t arena_active = 0;
+static ei_shared_arena_stats_t arena_stats = { SHARED_ARENA_BYTES, 0, 0, 0, 0, 0 };
+
+static inline shared_arena_block_t *block_at(uint32_t offset)
+{
+    return (shared_arena_block_t *)(shared_arena + offset);
+}
+
+static inline bool in_arena(const void *ptr)
+{
+    return (const uint8_t *)ptr >= shared_arena && (const uint8_t *)ptr < shared_arena + EI_CLASSIFIER_SHARED_ARENA_SIZE;
+}
+
+static void update_peaks(void)
+{
+    size_t model_use = SHARED_ARENA_BYTES - arena_high;
+
+    if (arena_low > arena_stats.dsp_peak) {
+        arena_stats.dsp_peak = arena_low;
+    }
+    if (model_use > arena_stats.model_peak) {
+        arena_stats.model_peak = model_use;
+    }
+    if (arena_low + model_use > arena_stats.peak) {
+        arena_stats.peak = arena_low + model_use;
+    }
+}
+
+static void note_fallback(size_t size)
+{
+    arena_stats.heap_fallbacks++;
+    if (size > arena_stats.heap_fallback_max_bytes) {
+        arena_stats.heap_fallback_max_bytes = size;
+    }
+}
+
+/**
+ * Bytes taken from the region for a payload of size bytes, 0 if it can never fit
+ */
+static size_t block_bytes(size_t size)
+{
+    if (size == 0 || size > SHARED_ARENA_BYTES) {
+        return 0;
+    }
+    return sizeof(shared_arena_block_t) + ((size + SHARED_ARENA_ALIGN - 1) & ~(size_t)(SHARED_ARENA_ALIGN - 1));
+}
+
+static void *alloc_low(size_t size)
+{
+    size_t bytes = block_bytes(size);
+    if (bytes == 0 || bytes > arena_high - arena_low) {
+        return NULL;
+    }
+
+    shared_arena_block_t *block = block_at((uint32_t)arena_low);
+    block->size = (uint32_t)bytes;
+    block->prev = arena_low_last;
+    block->freed = 0;
+    block->magic = SHARED_ARENA_MAGIC;
+
+    arena_low_last = (uint32_t)arena_low;
+    arena_low += bytes;
+    update_peaks();
+
+    return block + 1;
+}
+
+static void *alloc_high(size_t size)
+{
+    size_t bytes = block_bytes(size);
+    if (bytes == 0 || bytes > arena_high - arena_low) {
+        return NULL;
+    }
+
+    arena_high -= bytes;
+
+    shared_arena_block_t *block = block_at((uint32_t)arena_high);
+    block->size = (uint32_t)bytes;
+    block->prev = arena_high_last;
+    block->freed = 0;
+    block->magic = SHARED_ARENA_MAGIC;
+
+    arena_high_last = (uint32_t)arena_high;
+    update_peaks();
+
+    return block + 1;
+}
+
+/**
+ * Give back freed blocks at the inner end of both stacks
+ */
+static void pop_freed(void)
+{
+    while (arena_low_last != SHARED_ARENA_NONE && block_at(arena_low_last)->freed) {
+        arena_low = arena_low_last;
+        arena_low_last = block_at(arena_low_last)->prev;
+    }
+    while (arena_high_last != SHARED_ARENA_NONE && block_at(arena_high_last)->freed) {
+        arena_high = arena_high_last + block_at(arena_high_last)->size;
+        arena_high_last = block_at(arena_high_last)->prev;
+    }
+}
+
+void ei_shared_arena_begin(void)
+{
+    arena_active++;
+}
+
+void ei_shared_arena_end(void)
+{
+    if (arena_active > 0) {
+        arena_active--;
+    }
+}
+
+void *ei_shared_arena_scratch_malloc(size_t size)
+{
+    if (arena_active) {
+        void *ptr = alloc_low(size);
+        if (ptr) {
+            return ptr;
+        }
+        note_fallback(size);
+    }
+    ei_shared_arena_heap_allocs()++;
+    return ei_malloc(size);
+}
+
+void *ei_shared_arena_scratch_calloc(size_t nitems, size_t size)
+{
+    if (size != 0 && nitems > SIZE_MAX / size) {
+        return NULL;
+    }
+    if (arena_active) {
+        void *ptr = alloc_low(nitems * size);
+        if (ptr) {
+            memset(ptr, 0, nitems * size);
+            return ptr;
+        }
+        note_fallback(nitems * size);
+    }
+    ei_shared_arena_heap_allocs()++;
+    return ei_calloc(nitems, size);
+}
+
+void ei_shared_arena_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (!in_arena(ptr)) {
+        ei_free(ptr);
+        return;
+    }
+
+    shared_arena_block_t *block = (shared_arena_block_t *)ptr - 1;
+    if (block->magic != SHARED_ARENA_MAGIC || block->freed) {
+        ei_printf("ERR: Invalid or double free of shared arena block %p\n", ptr);
+        return;
+    }
+    block->freed = 1;
+    pop_freed();
+}
+
+void *ei_shared_arena_model_calloc(size_t align, size_t size)
+{
+    if (arena_active && align <= SHARED_ARENA_ALIGN) {
+        void *ptr = alloc_high(size);
+        if (ptr) {
+            memset(ptr, 0, size);
+            return ptr;
+        }
+        note_fallback(size);
+    }
+    ei_shared_arena_heap_allocs()++;
+    return ei_aligned_calloc(align, size);
+}
+
+void ei_shared_arena_model_free(void *ptr)
+{
+    if (ptr && !in_arena(ptr)) {
+        ei_aligned_free(ptr);
+        return;
+    }
+    ei_shared_arena_free(ptr);
+}
+
+void ei_shared_arena_get_stats(ei_shared_arena_stats_t *stats)
+{
+    *stats = arena_stats;
+}
+
+void ei_shared_arena_reset_peak(void)
+{
+    arena_stats.peak = 0;
+    arena_stats.dsp_peak = 0;
+    arena_stats.model_peak = 0;
+    arena_stats.heap_fallbacks = 0;
+    arena_stats.heap_fallback_max_bytes = 0;
+    update_peaks();
+}
+
+#endif // EI_CLASSIFIER_SHARED_ARENA_SIZE > 0
@@ -0,0 +1,162 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_SHARED_ARENA_H_
+#define _EI_CLASSIFIER_SHARED_ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+/**
+ * @brief Usage of the shared DSP / model arena.
+ *
+ * All sizes include the per-block bookkeeping. `peak` is the combined high-water mark: DSP
+ * scratch and model arenas that were in the region at the same time.
+ */
+typedef struct {
+    /**
+     * Size of the region (`EI_CLASSIFIER_SHARED_ARENA_SIZE`), 0 if the shared arena is compiled out
+     */
+    size_t size;
+
+    /**
+     * Combined high-water mark of the region
+     */
+    size_t peak;
+
+    /**
+     * High-water mark of the DSP end (feature matrices and DSP scratch)
+     */
+    size_t dsp_peak;
+
+    /**
+     * High-water mark of the model end (tensor arenas)
+     */
+    size_t model_peak;
+
+    /**
+     * Number of allocations that did not fit and went to the heap instead
+     */
+    uint32_t heap_fallbacks;
+
+    /**
+     * Largest allocation that went to the heap
+     */
+    size_t heap_fallback_max_bytes;
+} ei_shared_arena_stats_t;
+
+#ifdef __cplusplus
+
+/**
+ * Running count of DSP scratch and model arena allocations served from the heap: outside of an
+ * inference, without a shared arena, or because they did not fit. Wraps around.
+ */
+inline uint32_t &ei_shared_arena_heap_allocs(void)
+{
+    // inline, not static: one counter for all translation units
+    static uint32_t count = 0;
+    return count;
+}
+
+inline uint32_t ei_shared_arena_heap_alloc_count(void)
+{
+    return ei_shared_arena_heap_allocs();
+}
+
+#if EI_CLASSIFIER_SHARED_ARENA_SIZE > 0
+
+/**
+ * Route allocations into the region until the matching ei_shared_arena_end().
+ * Called by process_impulse() and process_impulse_continuous(); calls nest.
+ */
+void ei_shared_arena_begin(void);
+void ei_shared_arena_end(void);
+
+/**
+ * DSP scratch (matrix buffers, ei_dsp_malloc / ei_dsp_calloc), taken from the bottom of the region.
+ * Falls back to ei_malloc / ei_calloc when no inference is running or the block does not fit.
+ */
+void *ei_shared_arena_scratch_malloc(size_t size);
+void *ei_shared_arena_scratch_calloc(size_t nitems, size_t size);
+
+/**
+ * Free a block from either end of the region, or pass a heap block on to ei_free()
+ */
+void ei_shared_arena_free(void *ptr);
+
+/**
+ * Model tensor arena, taken from the top of the region so it only overlaps DSP scratch that is
+ * already gone. Matches the ei_aligned_calloc / ei_aligned_free signatures the engines use.
+ */
+void *ei_shared_arena_model_calloc(size_t align, size_t size);
+void ei_shared_arena_model_free(void *ptr);
+
+void ei_shared_arena_get_stats(ei_shared_arena_stats_t *stats);
+
+/**
+ * Restart the high-water marks and fallback counters from the current usage
+ */
+void ei_shared_arena_reset_peak(void);
+
+#else
+
+__attribute__((unused)) static inline void ei_shared_arena_begin(void) { }
+__attribute__((unused)) static inline void ei_shared_arena_end(void) { }
+__attribute__((unused)) static inline void *ei_shared_arena_scratch_malloc(size_t size) { ei_shared_arena_heap_allocs()++; return ei_malloc(size); }
+__attribute__((unused)) static inline void *ei_shared_arena_scratch_calloc(size_t nitems, size_t size) { ei_shared_arena_heap_allocs()++; return ei_calloc(nitems, size); }
+__attribute__((unused)) static inline void ei_shared_arena_free(void *ptr) { ei_free(ptr); }
+__attribute__((unused)) static inline void *ei_shared_arena_model_calloc(size_t align, size_t size) { ei_shared_arena_heap_allocs()++; return ei_aligned_calloc(align, size); }
+__attribute__((unused)) static inline void ei_shared_arena_model_free(void *ptr) { ei_aligned_free(ptr); }
+__attribute__((unused)) static inline void ei_shared_arena_get_stats(ei_shared_arena_stats_t *stats) { *stats = { }; }
+__attribute__((unused)) static inline void ei_shared_arena_reset_peak(void) { }
+
+#endif // EI_CLASSIFIER_SHARED_ARENA_SIZE > 0
+
+/**
+ * Keeps the shared arena active for the lifetime of the object
+ */
+class ei_shared_arena_scope {
+public:
+    ei_shared_arena_scope() { ei_shared_arena_begin(); }
+    ~ei_shared_arena_scope() { ei_shared_arena_end(); }
+    ei_shared_arena_scope(const ei_shared_arena_scope&) = delete;
+    ei_shared_arena_scope& operator=(const ei_shared_arena_scope&) = delete;
+};
+
+#endif // __cplusplus
+
+#endif // _EI_CLASSIFIER_SHARED_ARENA_H_
@@ -42,11 +42,30 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdint.h>
+#include <cfloat>
 
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/engines.h"
+#include "edge-impulse-sdk/dsp/config.hpp"
+
+// the CMSIS-DSP kernels only beat the fused loop below when they are vectorized (Helium)
+#if EIDSP_USE_CMSIS_DSP && defined(ARM_MATH_MVEF)
+#define EI_ANOMALY_KMEANS_USE_CMSIS 1
+#else
+#define EI_ANOMALY_KMEANS_USE_CMSIS 0
+#endif
+
+#if EI_ANOMALY_KMEANS_USE_CMSIS
+#include "edge-impulse-sdk/CMSIS/DSP/Include/dsp/basic_math_functions.h"
+#include "edge-impulse-sdk/CMSIS/DSP/Include/dsp/statistics_functions.h"
+#endif
+
+/** Input dimensions summed up between two checks against the best cluster so far */
+#ifndef EI_ANOMALY_KMEANS_CHUNK
+#define EI_ANOMALY_KMEANS_CHUNK 16
+#endif
 
 #ifdef __cplusplus
 namespace {
@@ -68,34 +87,91 @@ static void standard_scaler(float *input, const float *scale, const float *mean,
 }
 
 /**
- * Calculate the distance between input vector and the cluster
+ * Squared euclidean distance between n input values and the matching centroid values
+ */
+static inline float squared_distance(const float *input, const float *centroid, size_t n) {
+#if EI_ANOMALY_KMEANS_USE_CMSIS
+    if (n >= 4) {
+        float diff[EI_ANOMALY_KMEANS_CHUNK];
+        float dist;
+        arm_sub_f32(input, centroid, diff, n);
+        arm_power_f32(diff, n, &dist);
+        return dist;
+    }
+#endif
+    // independent accumulators, so the compiler can keep them in vector lanes
+    float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+    size_t ix = 0;
+    for (; ix + 4 <= n; ix += 4) {
+        float d0 = input[ix] - centroid[ix];
+        float d1 = input[ix + 1] - centroid[ix + 1];
+        float d2 = input[ix + 2] - centroid[ix + 2];
+        float d3 = input[ix + 3] - centroid[ix + 3];
+        acc0 += d0 * d0;
+        acc1 += d1 * d1;
+        acc2 += d2 * d2;
+        acc3 += d3 * d3;
+    }
+    for (; ix < n; ix++) {
+        float d = input[ix] - centroid[ix];
+        acc0 += d * d;
+    }
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+/**
+ * Calculate the squared distance between input vector and the cluster centroid.
+ * Gives up once the partial sum reaches limit, the result is then >= limit.
  * @param input Array of input values (already scaled by standard_scaler)
- * @param input_size Size of the input array
- * @param cluster A cluster (number of centroids should match input_size)
+ * @param input_size Size of the input array (and of the centroid)
+ * @param cluster A cluster
+ * @param limit Squared distance at which the cluster can't be the closest anymore
  */
-static float calculate_cluster_distance(float *input, size_t input_size, const ei_classifier_anom_cluster_t *cluster) {
-    // todo: check input_size and centroid size?
+static inline float calculate_cluster_distance_sq(const float *input, size_t input_size, const ei_classifier_anom_cluster_t *cluster, float limit) {
+    if (input_size <= EI_ANOMALY_KMEANS_CHUNK) {
+        return squared_distance(input, cluster->centroid, input_size);
+    }
 
     float dist = 0.0f;
-    for (size_t ix = 0; ix < input_size; ix++) {
-        dist += pow(input[ix] - cluster->centroid[ix], 2);
+    for (size_t ix = 0; ix < input_size; ix += EI_ANOMALY_KMEANS_CHUNK) {
+        size_t n = input_size - ix < EI_ANOMALY_KMEANS_CHUNK ? input_size - ix : EI_ANOMALY_KMEANS_CHUNK;
+        dist += squared_distance(input + ix, cluster->centroid + ix, n);
+        if (dist >= limit) {
+            break;
+        }
     }
-    return sqrt(dist) - cluster->max_error;
+    return dist;
 }
 
 /**
- * Get minimum distance to a cluster
+ * Get minimum distance to a cluster (distance to the centroid minus the max_error of the cluster)
+ * Clusters are compared on squared distances: a cluster only beats the current minimum if
+ * its distance is below min + max_error, so the sum is abandoned once it reaches the square
+ * of that. sqrt is only taken for a cluster that does beat it.
  * @param input Array of input values (already scaled by standard_scaler)
  * @param input_size Size of the input array
  * @param clusters Array of clusters
  * @param cluster_size Size of cluster array
  */
 static float get_min_distance_to_cluster(float *input, size_t input_size, const ei_classifier_anom_cluster_t *clusters, size_t cluster_size) {
-    float min = 1000.0f;
-    for (size_t ix = 0; ix < cluster_size; ix++) {
-        float dist = calculate_cluster_distance(input, input_size, &clusters[ix]);
-        if (dist < min) {
-            min = dist;
+    if (cluster_size == 0) {
+        return 0.0f;
+    }
+
+    float min = sqrtf(calculate_cluster_distance_sq(input, input_size, &clusters[0], FLT_MAX)) - clusters[0].max_error;
+
+    for (size_t ix = 1; ix < cluster_size; ix++) {
+        float reach = min + clusters[ix].max_error;
+        if (reach <= 0.0f) {
+            continue;
+        }
+        float limit = reach * reach;
+        float dist = calculate_cluster_distance_sq(input, input_size, &clusters[ix], limit);
+        if (dist < limit) {
+            float score = sqrtf(dist) - clusters[ix].max_error;
+            if (score < min) {
+                min = score;
+            }
         }
     }
     return min;
@@ -40,6 +40,9 @@
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/classifier/ei_shared_arena.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
@@ -66,7 +69,11 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     TfLiteTensor *outputs = *output_arg;
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+    // the operators report their scratch to the profiler while prepared
+    ei_op_profiler_forget_graph(graph_config);
+    ei_op_profiler_graph_begin(graph_config);
+    TfLiteStatus init_status = graph_config->model_init(ei_shared_arena_model_calloc);
+    ei_op_profiler_graph_end();
     if (init_status != kTfLiteOk) {
         ei_printf("Failed to initialize the model (error code %d)\n", init_status);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
@@ -89,6 +96,163 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+/**
+ * Initialized EON model and its tensors that are kept alive
+ * between run_classifier_init() and run_classifier_deinit()
+ */
+typedef struct {
+    ei_learning_block_config_tflite_graph_t *block_config;
+    TfLiteTensor input;
+    TfLiteTensor *outputs;
+} ei_tflite_resident_graph_t;
+
+static ei_tflite_resident_graph_t ei_tflite_resident_graphs[EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS] = { };
+
+static void ei_tflite_resident_release(ei_tflite_resident_graph_t *graph) {
+    if (graph->block_config == nullptr) {
+        return;
+    }
+
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)graph->block_config->graph_config;
+    graph_config->model_reset(ei_shared_arena_model_free);
+    ei_free(graph->outputs);
+
+    memset(graph, 0, sizeof(ei_tflite_resident_graph_t));
+}
+
+/**
+ * Reset all resident models and free their arenas
+ */
+__attribute__((unused)) static void ei_tflite_resident_release_all(void) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        ei_tflite_resident_release(&ei_tflite_resident_graphs[ix]);
+    }
+}
+
+/**
+ * Release the resident models of an impulse's learning blocks,
+ * graphs of other impulse handles stay resident
+ */
+__attribute__((unused)) static void ei_tflite_resident_release_impulse(const ei_impulse_t *impulse) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        ei_tflite_resident_graph_t *graph = &ei_tflite_resident_graphs[ix];
+        for (size_t block = 0; block < impulse->learning_blocks_size; block++) {
+            if (graph->block_config == impulse->learning_blocks[block].config) {
+                ei_tflite_resident_release(graph);
+                break;
+            }
+        }
+    }
+}
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+/**
+ * Get an initialized model for a graph. If the model is kept resident
+ * (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER) it's only initialized on the first call,
+ * otherwise it needs to be released with inference_tflite_release() after inference.
+ *
+ * @param      ctx_start_us       Pointer to the start time
+ * @param      input              Pointer to input tensor
+ * @param      outputs            Pointer to output tensors (array is allocated here)
+ * @param      p_tensor_arena     Unused, the model manages its own arena
+ *
+ * @return  EI_IMPULSE_OK if successful
+ */
+static EI_IMPULSE_ERROR inference_tflite_acquire(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    uint64_t *ctx_start_us,
+    TfLiteTensor* input,
+    TfLiteTensor** outputs,
+    ei_unique_ptr_t& p_tensor_arena) {
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+    *ctx_start_us = ei_read_timer_us();
+
+    ei_tflite_resident_graph_t *graph = nullptr;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        if (ei_tflite_resident_graphs[ix].block_config == block_config) {
+            graph = &ei_tflite_resident_graphs[ix];
+            break;
+        }
+    }
+
+    if (graph) {
+        *input = graph->input;
+        *outputs = graph->outputs;
+        return EI_IMPULSE_OK;
+    }
+
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        if (ei_tflite_resident_graphs[ix].block_config == nullptr) {
+            graph = &ei_tflite_resident_graphs[ix];
+            break;
+        }
+    }
+
+    if (!graph) {
+        // more graphs than resident slots, evict the first one
+        graph = &ei_tflite_resident_graphs[0];
+        ei_tflite_resident_release(graph);
+    }
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+    *outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    if (*outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        ctx_start_us,
+        input,
+        outputs,
+        p_tensor_arena);
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+    if (init_res != EI_IMPULSE_OK) {
+        ei_free(*outputs);
+        return init_res;
+    }
+
+    graph->block_config = block_config;
+    graph->input = *input;
+    graph->outputs = *outputs;
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+    return init_res;
+}
+
+/**
+ * Reset a model obtained through inference_tflite_acquire()
+ * (no-op if the model is kept resident)
+ */
+static void inference_tflite_release(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    TfLiteTensor* outputs) {
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 0
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+    graph_config->model_reset(ei_shared_arena_model_free);
+    ei_free(outputs);
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 0
+}
+
+/**
+ * Invoke the EON model. The generated code has no hooks per operator, the operator
+ * profiler records each operator through its wrapped registration instead.
+ */
+static TfLiteStatus inference_tflite_invoke(ei_learning_block_config_tflite_graph_t *block_config)
+{
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    ei_op_profiler_graph_begin(graph_config);
+    TfLiteStatus status = graph_config->model_invoke();
+    ei_op_profiler_graph_end();
+
+    return status;
+}
+
 /**
  * Run TFLite model
  *
@@ -110,15 +274,19 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     ei_impulse_result_t *result,
     bool debug) {
 
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+    ei_op_profiler_invoke_begin();
+    uint64_t invoke_start_us = ei_read_timer_us();
 
-    if (graph_config->model_invoke() != kTfLiteOk) {
+    if (inference_tflite_invoke(block_config) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
     uint64_t ctx_end_us = ei_read_timer_us();
+    ei_op_profiler_get_last_invoke(&result->op_profile);
 
     result->timing.classification_us = ctx_end_us - ctx_start_us;
+    result->timing.classification_setup_us = invoke_start_us - ctx_start_us;
+    result->timing.classification_invoke_us = ctx_end_us - invoke_start_us;
 
     EI_LOGD("Predictions (time: %d ms.):\n", result->timing.classification);
 
@@ -170,7 +338,8 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     }
 
     // invoke the model
-    if (graph_config->model_invoke() != kTfLiteOk) {
+    ei_op_profiler_invoke_begin();
+    if (inference_tflite_invoke(block_config) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
@@ -179,7 +348,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (graph_config->model_reset(ei_shared_arena_model_free) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
     ei_free(outputs);
@@ -207,18 +376,14 @@ EI_IMPULSE_ERROR run_nn_inference(
     bool debug = false)
 {
     ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
     TfLiteTensor input;
-    TfLiteTensor *outputs;
-
-    // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    TfLiteTensor *outputs = nullptr;
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
 
-    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+    EI_IMPULSE_ERROR init_res = inference_tflite_acquire(
         block_config,
         &ctx_start_us,
         &input,
@@ -294,8 +459,7 @@ EI_IMPULSE_ERROR run_nn_inference(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    inference_tflite_release(block_config, outputs);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -319,18 +483,14 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
     bool debug = false) {
 
     ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
     uint64_t ctx_start_us;
     TfLiteTensor input;
-    TfLiteTensor *outputs;
-
-    // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    TfLiteTensor *outputs = nullptr;
 
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
 
-    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+    EI_IMPULSE_ERROR init_res = inference_tflite_acquire(
         block_config,
         &ctx_start_us,
         &input,
@@ -430,8 +590,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    inference_tflite_release(block_config, outputs);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
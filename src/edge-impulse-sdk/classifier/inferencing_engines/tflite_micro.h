@@ -45,6 +45,9 @@
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated_full.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/classifier/ei_shared_arena.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 
@@ -122,12 +125,12 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     p_tensor_arena = ei_unique_ptr_t(tensor_arena, [](void*){});
 #else
     // Create an area of memory to use for input, output, and intermediate arrays.
-    uint8_t *tensor_arena = (uint8_t*)ei_aligned_calloc(16, graph_config->arena_size);
+    uint8_t *tensor_arena = (uint8_t*)ei_shared_arena_model_calloc(16, graph_config->arena_size);
     if (tensor_arena == NULL) {
         ei_printf("Failed to allocate TFLite arena (%zu bytes)\n", graph_config->arena_size);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
     }
-    p_tensor_arena = ei_unique_ptr_t(tensor_arena, ei_aligned_free);
+    p_tensor_arena = ei_unique_ptr_t(tensor_arena, ei_shared_arena_model_free);
 #endif
 
     static bool tflite_first_run = true;
@@ -203,15 +206,182 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+/**
+ * Interpreter, arena and tensors of a TFLite graph that are kept alive
+ * between run_classifier_init() and run_classifier_deinit()
+ */
+typedef struct {
+    ei_learning_block_config_tflite_graph_t *block_config;
+    tflite::MicroInterpreter *interpreter;
+    void *profiler;
+    void *tensor_arena;
+    TfLiteTensor *input;
+    TfLiteTensor **outputs;
+} ei_tflite_resident_graph_t;
+
+static ei_tflite_resident_graph_t ei_tflite_resident_graphs[EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS] = { };
+
+static void ei_tflite_resident_release(ei_tflite_resident_graph_t *graph) {
+    if (graph->block_config == nullptr) {
+        return;
+    }
+
+    delete graph->interpreter;
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    delete (tflite::MicroProfiler*)graph->profiler;
+#endif
+#ifndef EI_CLASSIFIER_ALLOCATION_STATIC
+    ei_shared_arena_model_free(graph->tensor_arena);
+#endif
+    ei_free(graph->outputs);
+
+    memset(graph, 0, sizeof(ei_tflite_resident_graph_t));
+}
+
+/**
+ * Release all resident interpreters and their arenas
+ */
+__attribute__((unused)) static void ei_tflite_resident_release_all(void) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        ei_tflite_resident_release(&ei_tflite_resident_graphs[ix]);
+    }
+}
+
+/**
+ * Release the resident interpreters of an impulse's learning blocks,
+ * graphs of other impulse handles stay resident
+ */
+__attribute__((unused)) static void ei_tflite_resident_release_impulse(const ei_impulse_t *impulse) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        ei_tflite_resident_graph_t *graph = &ei_tflite_resident_graphs[ix];
+        for (size_t block = 0; block < impulse->learning_blocks_size; block++) {
+            if (graph->block_config == impulse->learning_blocks[block].config) {
+                ei_tflite_resident_release(graph);
+                break;
+            }
+        }
+    }
+}
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+/**
+ * Get a ready-to-invoke interpreter for a graph. If the interpreter is kept resident
+ * (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER) it's only set up on the first call,
+ * otherwise it needs to be released with inference_tflite_release() after inference.
+ *
+ * @param      ctx_start_us       Pointer to the start time
+ * @param      input              Pointer to input tensor
+ * @param      outputs            Pointer to output tensors (array is allocated here)
+ * @param      micro_interpreter  Pointer to interpreter
+ * @param      p_tensor_arena     Arena, ownership is taken over if the interpreter is kept resident
+ *
+ * @return  EI_IMPULSE_OK if successful
+ */
+static EI_IMPULSE_ERROR inference_tflite_acquire(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    uint64_t *ctx_start_us,
+    TfLiteTensor** input,
+    TfLiteTensor*** outputs,
+    tflite::MicroInterpreter** micro_interpreter,
+    ei_unique_ptr_t& p_tensor_arena,
+    void** micro_profiler) {
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+    *ctx_start_us = ei_read_timer_us();
+
+    ei_tflite_resident_graph_t *graph = nullptr;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        if (ei_tflite_resident_graphs[ix].block_config == block_config) {
+            graph = &ei_tflite_resident_graphs[ix];
+            break;
+        }
+    }
+
+    if (graph) {
+        *input = graph->input;
+        *outputs = graph->outputs;
+        *micro_interpreter = graph->interpreter;
+        *micro_profiler = graph->profiler;
+        return EI_IMPULSE_OK;
+    }
+
+#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+    // all graphs share the same static arena, so only one can be resident
+    ei_tflite_resident_release_all();
+#endif
+
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_RESIDENT_MAX_GRAPHS; ix++) {
+        if (ei_tflite_resident_graphs[ix].block_config == nullptr) {
+            graph = &ei_tflite_resident_graphs[ix];
+            break;
+        }
+    }
+
+    if (!graph) {
+        // more graphs than resident slots, evict the first one
+        graph = &ei_tflite_resident_graphs[0];
+        ei_tflite_resident_release(graph);
+    }
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+    *outputs = (TfLiteTensor**)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor*));
+    if (*outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        ctx_start_us,
+        input,
+        *outputs,
+        micro_interpreter,
+        p_tensor_arena,
+        micro_profiler);
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+    if (init_res != EI_IMPULSE_OK) {
+        ei_free(*outputs);
+        return init_res;
+    }
+
+    graph->block_config = block_config;
+    graph->interpreter = *micro_interpreter;
+    graph->profiler = *micro_profiler;
+    graph->tensor_arena = p_tensor_arena.release();
+    graph->input = *input;
+    graph->outputs = *outputs;
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1
+
+    return init_res;
+}
+
+/**
+ * Release an interpreter obtained through inference_tflite_acquire()
+ * (no-op if the interpreter is kept resident)
+ */
+static void inference_tflite_release(
+    tflite::MicroInterpreter* interpreter,
+    TfLiteTensor** outputs,
+    void* micro_profiler) {
+
+#if EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 0
+    delete interpreter;
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    delete (tflite::MicroProfiler*)micro_profiler;
+#endif
+    ei_free(outputs);
+#endif // EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 0
+}
+
 /**
  * Run TFLite model
  *
  * @param   ctx_start_us    Start time of the setup function (see above)
  * @param   output          Output tensor
  * @param   interpreter     TFLite interpreter (non-compiled models)
- * @param   tensor_arena    Allocated arena (will be freed)
  * @param   result          Struct for results
- * @param   debug           Whether to print debug info
+ * @param   micro_profiler  Profiler (if EI_CLASSIFIER_ENABLE_PROFILER is set)
  *
  * @return  EI_IMPULSE_OK if successful
  */
@@ -221,17 +391,27 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     ei_impulse_result_t *result,
     void* micro_profiler) {
 
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    // a resident interpreter keeps its profiler, only report events of this run
+    ((tflite::MicroProfiler*)micro_profiler)->ClearEvents();
+#endif
+
+    ei_op_profiler_invoke_begin();
+    uint64_t invoke_start_us = ei_read_timer_us();
+
     // Run inference, and report any error
     TfLiteStatus invoke_status = interpreter->Invoke();
     if (invoke_status != kTfLiteOk) {
-        delete interpreter;
         ei_printf("Invoke failed (%d)\n", invoke_status);
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
     uint64_t ctx_end_us = ei_read_timer_us();
+    ei_op_profiler_get_last_invoke(&result->op_profile);
 
     result->timing.classification_us = ctx_end_us - ctx_start_us;
+    result->timing.classification_setup_us = invoke_start_us - ctx_start_us;
+    result->timing.classification_invoke_us = ctx_end_us - invoke_start_us;
 
     EI_LOGD("Predictions (time: %d ms.):\n", result->timing.classification);
 
@@ -270,7 +450,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     matrix_t *output_matrix)
 {
     TfLiteTensor* input = nullptr; // will be owned by TFLite
-    TfLiteTensor** outputs = (TfLiteTensor**)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor*));
+    TfLiteTensor** outputs = nullptr;
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
@@ -282,6 +462,17 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     void* profiler = nullptr;
 #endif
 
+#if (EI_CLASSIFIER_TFLITE_RESIDENT_INTERPRETER == 1) && defined(EI_CLASSIFIER_ALLOCATION_STATIC)
+    // the block config lives on the caller's stack so this graph is never kept resident,
+    // but it's planned into the same static arena as the resident interpreters
+    ei_tflite_resident_release_all();
+#endif
+
+    outputs = (TfLiteTensor**)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor*));
+    if (outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
         &ctx_start_us,
@@ -292,30 +483,33 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         (void**)&profiler);
 
     if (init_res != EI_IMPULSE_OK) {
+        ei_free(outputs);
         return init_res;
     }
 
-    auto input_res = fill_input_tensor_from_signal(signal, input);
-    if (input_res != EI_IMPULSE_OK) {
-        return input_res;
-    }
+    EI_IMPULSE_ERROR res = fill_input_tensor_from_signal(signal, input);
 
-    // Run inference, and report any error
-    TfLiteStatus invoke_status = interpreter->Invoke();
-    if (invoke_status != kTfLiteOk) {
-        ei_printf("Invoke failed (%d)\n", invoke_status);
-        return EI_IMPULSE_TFLITE_ERROR;
+    if (res == EI_IMPULSE_OK) {
+        // Run inference, and report any error
+        ei_op_profiler_invoke_begin();
+        TfLiteStatus invoke_status = interpreter->Invoke();
+        if (invoke_status != kTfLiteOk) {
+            ei_printf("Invoke failed (%d)\n", invoke_status);
+            res = EI_IMPULSE_TFLITE_ERROR;
+        }
     }
 
-    auto output_res = fill_output_matrix_from_tensor(outputs[0], output_matrix);
-    if (output_res != EI_IMPULSE_OK) {
-        return output_res;
+    if (res == EI_IMPULSE_OK) {
+        res = fill_output_matrix_from_tensor(outputs[0], output_matrix);
     }
 
     delete interpreter;
+#ifdef EI_CLASSIFIER_ENABLE_PROFILER
+    delete profiler;
+#endif
     ei_free(outputs);
 
-    return EI_IMPULSE_OK;
+    return res;
 }
 
 /**
@@ -340,7 +534,7 @@ EI_IMPULSE_ERROR run_nn_inference(
     ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
 
     TfLiteTensor* input = nullptr; // will be owned by TFLite
-    TfLiteTensor** outputs = (TfLiteTensor**)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor*));
+    TfLiteTensor** outputs = nullptr;
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
@@ -352,11 +546,11 @@ EI_IMPULSE_ERROR run_nn_inference(
     void* profiler = nullptr;
 #endif
 
-    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+    EI_IMPULSE_ERROR init_res = inference_tflite_acquire(
         block_config,
         &ctx_start_us,
         &input,
-        outputs,
+        &outputs,
         &interpreter,
         p_tensor_arena,
         (void**)&profiler);
@@ -427,8 +621,7 @@ EI_IMPULSE_ERROR run_nn_inference(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    delete interpreter;
-    ei_free(outputs);
+    inference_tflite_release(interpreter, outputs, profiler);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -456,7 +649,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
     uint64_t ctx_start_us;
 
     TfLiteTensor* input = nullptr; // will be owned by TFLite
-    TfLiteTensor** outputs = (TfLiteTensor**)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor*));
+    TfLiteTensor** outputs = nullptr;
 
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
 
@@ -467,11 +660,11 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
     void* profiler = nullptr;
 #endif
 
-    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+    EI_IMPULSE_ERROR init_res = inference_tflite_acquire(
         block_config,
         &ctx_start_us,
         &input,
-        outputs,
+        &outputs,
         &interpreter,
         p_tensor_arena,
         (void**)&profiler);
@@ -565,8 +758,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    delete interpreter;
-    ei_free(outputs);
+    inference_tflite_release(interpreter, outputs, profiler);
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -42,21 +42,34 @@ float centroid_euclidean_distance(const ei_impulse_result_bounding_box_t bbox1,
     return distance;
 }
 
+/**
+ * Optimal (Jonker-Volgenant) assignment between traces and detections.
+ * The cost matrix and solver buffers are members, so aligning every frame only
+ * allocates until they've grown to the largest traces x detections seen.
+ */
 class JonkerVolgenantAlignment {
 public:
     JonkerVolgenantAlignment(float threshold, bool use_iou = true) : threshold(threshold), use_iou(use_iou) {
     }
 
-    std::vector<std::tuple<int, int, float>> align(const std::vector<ei_impulse_result_bounding_box_t> traces,
-                                                   const std::vector<ei_impulse_result_bounding_box_t> detections) {
+    /**
+     * Align traces with detections
+     * @param matches Out: (trace_idx, detection_idx, iou or distance) for every accepted pair,
+     *                cleared first
+     */
+    void align(const ei_impulse_result_bounding_box_t *traces, size_t traces_count,
+               const ei_impulse_result_bounding_box_t *detections, size_t detections_count,
+               std::vector<std::tuple<int, int, float>> &matches) {
 
-        if (traces.empty() || detections.empty()) {
-            return {};
+        matches.clear();
+
+        if (traces_count == 0 || detections_count == 0) {
+            return;
         }
 
-        std::vector<double> cost_mtx(traces.size() * detections.size());
-        for (size_t trace_idx = 0; trace_idx < traces.size(); ++trace_idx) {
-            for (size_t detection_idx = 0; detection_idx < detections.size(); ++detection_idx) {
+        cost_mtx.resize(traces_count * detections_count);
+        for (size_t trace_idx = 0; trace_idx < traces_count; ++trace_idx) {
+            for (size_t detection_idx = 0; detection_idx < detections_count; ++detection_idx) {
                 float cost = 0.0;
                 if (use_iou) {
                     float iou = intersection_over_union(traces[trace_idx], detections[detection_idx]);
@@ -65,51 +78,56 @@ public:
                     cost = centroid_euclidean_distance(traces[trace_idx], detections[detection_idx]);
                 }
                 EI_LOGD("t_idx=%zu d_idx=%zu cost=%.6f\n", trace_idx, detection_idx, cost);
-                cost_mtx[trace_idx * detections.size() + detection_idx] = cost;
+                cost_mtx[trace_idx * detections_count + detection_idx] = cost;
             }
         }
 
-        int64_t *alignments_a = new int64_t[traces.size()];
-        int64_t *alignments_b = new int64_t[detections.size()];
+        alignments_a.resize(traces_count);
+        alignments_b.resize(detections_count);
 
-        solve(traces.size(), detections.size(), cost_mtx.data(), false, alignments_a, alignments_b);
-        EI_LOGD("detections size %zu\n", detections.size());
-        EI_LOGD("traces size %zu\n", traces.size());
+        if (solve(traces_count, detections_count, cost_mtx.data(), false, alignments_a.data(), alignments_b.data(), &lsap_workspace) != 0) {
+            EI_LOGW("JonkerVolgenantAlignment: no valid assignment (NaN in cost matrix?)\n");
+            return;
+        }
+        EI_LOGD("detections size %zu\n", detections_count);
+        EI_LOGD("traces size %zu\n", traces_count);
 
-        for (size_t i = 0; i < traces.size(); i++) {
+        for (size_t i = 0; i < traces_count; i++) {
             EI_LOGD("alignments_a[%zu] %lld\n", i, alignments_a[i]);
         }
 
-        for (size_t i = 0; i < detections.size(); i++) {
+        for (size_t i = 0; i < detections_count; i++) {
             EI_LOGD("alignments_b[%zu] %lld\n", i, alignments_b[i]);
         }
 
-        std::vector<std::tuple<int, int, float>> matches;
-        size_t num_iterations = traces.size() > detections.size() ? detections.size() : traces.size();
+        size_t num_iterations = traces_count > detections_count ? detections_count : traces_count;
 
         for (size_t i = 0; i < num_iterations; i++) {
             size_t trace_idx = alignments_a[i];
             size_t detection_idx = alignments_b[i];
 
             if (use_iou) {
-                float iou = 1 - cost_mtx[trace_idx * detections.size() + detection_idx];
+                float iou = 1 - cost_mtx[trace_idx * detections_count + detection_idx];
                 if (iou > threshold) {
                     matches.emplace_back(trace_idx, detection_idx, iou);
                 }
             } else {
-                float cost = cost_mtx[trace_idx * detections.size() + detection_idx];
+                float cost = cost_mtx[trace_idx * detections_count + detection_idx];
                 if (cost < threshold) {
                     matches.emplace_back(trace_idx, detection_idx, cost);
                 }
             }
         }
-        delete[] alignments_a;
-        delete[] alignments_b;
-        return matches;
     }
 
     float threshold;
     bool use_iou;
+
+private:
+    std::vector<double> cost_mtx;
+    std::vector<int64_t> alignments_a;
+    std::vector<int64_t> alignments_b;
+    rectangular_lsap_workspace_t lsap_workspace;
 };
 
 class GreedyAlignment {
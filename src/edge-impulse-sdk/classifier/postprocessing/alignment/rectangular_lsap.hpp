@@ -48,13 +48,31 @@ Author: PM Larsen
 #define RECTANGULAR_LSAP_INFEASIBLE -1
 #define RECTANGULAR_LSAP_INVALID -2
 
-template <typename T> std::vector<intptr_t> argsort_iter(const std::vector<T> &v)
+/**
+ * Scratch buffers for solve(). Keep one around between calls and the vectors
+ * only grow until they fit the largest cost matrix seen, after that solving
+ * does not touch the heap.
+ */
+struct rectangular_lsap_workspace_t {
+    std::vector<double> temp;
+    std::vector<double> u;
+    std::vector<double> v;
+    std::vector<double> shortestPathCosts;
+    std::vector<intptr_t> path;
+    std::vector<intptr_t> col4row;
+    std::vector<intptr_t> row4col;
+    std::vector<bool> SR;
+    std::vector<bool> SC;
+    std::vector<intptr_t> remaining;
+    std::vector<intptr_t> order;
+};
+
+template <typename T> void argsort_iter(const std::vector<T> &v, std::vector<intptr_t> &index)
 {
-    std::vector<intptr_t> index(v.size());
+    index.resize(v.size());
     std::iota(index.begin(), index.end(), 0);
     std::sort(index.begin(), index.end(), [&v](intptr_t i, intptr_t j)
               {return v[i] < v[j];});
-    return index;
 }
 
 static intptr_t
@@ -128,17 +146,22 @@ augmenting_path(intptr_t nc, double *cost, std::vector<double>& u,
 }
 
 static int solve(intptr_t nr, intptr_t nc, double* cost, bool maximize,
-                 int64_t* a, int64_t* b) {
+                 int64_t* a, int64_t* b, rectangular_lsap_workspace_t *ws = nullptr) {
     // handle trivial inputs
     if (nr == 0 || nc == 0) {
         return 0;
     }
 
+    rectangular_lsap_workspace_t local_ws;
+    if (ws == nullptr) {
+        ws = &local_ws;
+    }
+
     // tall rectangular cost matrix must be transposed
     bool transpose = nc < nr;
 
     // make a copy of the cost matrix if we need to modify it
-    std::vector<double> temp;
+    std::vector<double>& temp = ws->temp;
     if (transpose || maximize) {
         temp.resize(nr * nc);
 
@@ -173,15 +196,24 @@ static int solve(intptr_t nr, intptr_t nc, double* cost, bool maximize,
     }
 
     // initialize variables
-    std::vector<double> u(nr, 0);
-    std::vector<double> v(nc, 0);
-    std::vector<double> shortestPathCosts(nc);
-    std::vector<intptr_t> path(nc, -1);
-    std::vector<intptr_t> col4row(nr, -1);
-    std::vector<intptr_t> row4col(nc, -1);
-    std::vector<bool> SR(nr);
-    std::vector<bool> SC(nc);
-    std::vector<intptr_t> remaining(nc);
+    std::vector<double>& u = ws->u;
+    std::vector<double>& v = ws->v;
+    std::vector<double>& shortestPathCosts = ws->shortestPathCosts;
+    std::vector<intptr_t>& path = ws->path;
+    std::vector<intptr_t>& col4row = ws->col4row;
+    std::vector<intptr_t>& row4col = ws->row4col;
+    std::vector<bool>& SR = ws->SR;
+    std::vector<bool>& SC = ws->SC;
+    std::vector<intptr_t>& remaining = ws->remaining;
+    u.assign(nr, 0);
+    v.assign(nc, 0);
+    shortestPathCosts.assign(nc, 0);
+    path.assign(nc, -1);
+    col4row.assign(nr, -1);
+    row4col.assign(nc, -1);
+    SR.assign(nr, false);
+    SC.assign(nc, false);
+    remaining.assign(nc, 0);
 
     // iteratively build the solution
     for (intptr_t curRow = 0; curRow < nr; curRow++) {
@@ -222,7 +254,8 @@ static int solve(intptr_t nr, intptr_t nc, double* cost, bool maximize,
 
     if (transpose) {
         intptr_t i = 0;
-        for (auto v: argsort_iter(col4row)) {
+        argsort_iter(col4row, ws->order);
+        for (auto v: ws->order) {
             a[i] = col4row[v];
             b[i] = v;
             i++;
@@ -59,185 +59,14 @@ typedef struct {
     float keep_grace;
 } ei_obj_tracking_params_t;
 
-class ExponentialMovingAverage {
-public:
-    ExponentialMovingAverage(int n, float gain = 2) : gain(gain / (n + 1)), ema_value(-255.0) {
-    }
-
-    void update(float value) {
-        if (ema_value == -255.0) {
-            ema_value = value;
-        } else {
-            ema_value = (value * gain) + (ema_value * (1 - gain));
-        }
-    }
-
-    float smoothed_value() {
-        return ema_value;
-    }
-
-private:
-    float gain;
-    float ema_value;
-};
-
-class Trace {
-public:
-    Trace(int id, int t, const ei_impulse_result_bounding_box_t& initial_bbox, uint32_t max_observations = 5)
-        : id(id), last_ground_truth_update_t(t), last_prediction(initial_bbox), max_observations(max_observations) {
-        if (max_observations < 2) {
-            EI_LOGE("%s", "max_observations needs to be at least 2 for counting");
-        }
-
-        trace_label = initial_bbox.label;
-        trace_score = initial_bbox.value;
-        observations.push_back(initial_bbox);
-        float initial_centroid[2] = { initial_bbox.x + static_cast<float>(initial_bbox.width) / 2,
-                                      initial_bbox.y + static_cast<float>(initial_bbox.height) / 2 };
-
-        float initial_width_height[2] = { static_cast<float>(initial_bbox.width),
-                                          static_cast<float>(initial_bbox.height) };
-
-        centroid_filter = new TinyEKF(initial_centroid, 8, 2);
-        width_height_filter = new TinyEKF(initial_width_height, 8, 2);
-
-        // Use x0, y0, x1, y1 for EMAs
-        xyxy_emas[0] = new ExponentialMovingAverage(this->max_observations);
-        xyxy_emas[1] = new ExponentialMovingAverage(this->max_observations);
-        xyxy_emas[2] = new ExponentialMovingAverage(this->max_observations);
-        xyxy_emas[3] = new ExponentialMovingAverage(this->max_observations);
-    }
-
-    ~Trace() {
-        delete centroid_filter;
-        delete width_height_filter;
-        delete xyxy_emas[0];
-        delete xyxy_emas[1];
-        delete xyxy_emas[2];
-        delete xyxy_emas[3];
-    }
-
-    ei_impulse_result_bounding_box_t predict() {
-        fx_centroid[0] = centroid_filter->x[0];
-        fx_centroid[1] = centroid_filter->x[1];
-        fx_width_height[0] = width_height_filter->x[0];
-        fx_width_height[1] = width_height_filter->x[1];
-
-        centroid_filter->predict(fx_centroid);
-        width_height_filter->predict(fx_width_height);
-
-        ei_impulse_result_bounding_box_t p_bbox = {"", 0, 0, 0, 0, 0.0};
-        p_bbox.label = trace_label;
-        p_bbox.value = trace_score;
-        p_bbox.x = round(clip((centroid_filter->x[0] - width_height_filter->x[0] / 2), 0));
-        p_bbox.y = round(clip(centroid_filter->x[1] - width_height_filter->x[1] / 2, 0));
-        p_bbox.width = round(clip(width_height_filter->x[0], 0));
-        p_bbox.height = round(clip(width_height_filter->x[1], 0));
-        last_prediction = p_bbox;
-        EI_LOGD("predict %d %d %d %d %f\n", last_prediction.x, last_prediction.y, last_prediction.width, last_prediction.height, last_prediction.value);
-        return last_prediction;
-    }
-
-    void update(int t, const ei_impulse_result_bounding_box_t* bbox) {
-        if (bbox == nullptr) {
-            EI_LOGD("update (last prediction) %d %d %d %d %f\n", last_prediction.x, last_prediction.y, last_prediction.width, last_prediction.height, last_prediction.value);
-            bbox = &last_prediction;
-        } else {
-            EI_LOGD("update (ground truth prediction) %d %d %d %d %f\n", bbox->x, bbox->y, bbox->width, bbox->height, bbox->value);
-            last_ground_truth_update_t = t;
-        }
-
-        hx_centroid[0] = centroid_filter->x[0];
-        hx_centroid[1] = centroid_filter->x[1];
-        hx_width_height[0] = width_height_filter->x[0];
-        hx_width_height[1] = width_height_filter->x[1];
-
-        float centroid[2] = { bbox->x + static_cast<float>(bbox->width) / 2,
-                              bbox->y + static_cast<float>(bbox->height) / 2 };
-        centroid_filter->update(centroid , hx_centroid);
-
-        float width_height[2] = { static_cast<float>(bbox->width),
-                                  static_cast<float>(bbox->height) };
-        width_height_filter->update(width_height, hx_width_height);
-
-        trace_score = bbox->value;
-        observations.push_back(*bbox);
-        while (observations.size() > max_observations) {
-            observations.erase(observations.begin());
-        }
-
-        xyxy_emas[0]->update(bbox->x);
-        xyxy_emas[1]->update(bbox->y);
-        xyxy_emas[2]->update(bbox->width);
-        xyxy_emas[3]->update(bbox->height);
-
-    }
-
-    std::tuple<int, int, int, int> last_centroid_segment() const {
-        if (observations.size() < 2) {
-            return {};
-        }
-        auto obs_t_minus1 = observations[observations.size() - 2];
-        auto obs_t_0 = observations.back();
-
-        return {obs_t_minus1.x + static_cast<float>(obs_t_minus1.width) / 2,
-                obs_t_minus1.y + static_cast<float>(obs_t_minus1.height) / 2,
-                obs_t_0.x + static_cast<float>(obs_t_0.width) / 2,
-                obs_t_0.y + static_cast<float>(obs_t_0.height) / 2};
-    }
-
-    const ei_impulse_result_bounding_box_t* last_observation() const {
-        if (observations.empty()) {
-            return nullptr;
-        }
-        return &observations.back();
-    }
-
-    ei_impulse_result_bounding_box_t smoothed_last_observation() const {
-        ei_impulse_result_bounding_box_t bbox = {"", 0, 0, 0, 0, 0.0};
-        if (observations.empty()) {
-            return bbox;
-        }
-
-        bbox.x = round(xyxy_emas[0]->smoothed_value());
-        bbox.y = round(xyxy_emas[1]->smoothed_value());
-        bbox.width = round(xyxy_emas[2]->smoothed_value());
-        bbox.height = round(xyxy_emas[3]->smoothed_value());
-        bbox.label = trace_label;
-        bbox.value = trace_score;
-        return bbox;
-    }
-
-    void debug_output() const {
-#if EI_LOG_LEVEL == EI_LOG_LEVEL_DEBUG
-        // output debug info, C-style
-        ei_printf("Trace %d:\n", id);
-        ei_printf("  Last ground truth update: %d\n", last_ground_truth_update_t);
-        ei_printf("  Last prediction: %d %d %d %d %f\n", last_prediction.x, last_prediction.y, last_prediction.width, last_prediction.height, last_prediction.value);
-        ei_printf("  Observations:\n");
-        for (const auto& obs : observations) {
-            ei_printf("%d %d %d %d %f\n", obs.x, obs.y, obs.width, obs.height, obs.value);
-        }
+// Cap on the number of open traces. Trace state lives in a fixed pool inside the Tracker,
+// detections that would start a new trace while the pool is full are not tracked.
+#ifndef EI_OBJECT_TRACKING_MAX_TRACES
+#define EI_OBJECT_TRACKING_MAX_TRACES 32
 #endif
-    }
 
-    uint32_t id;
-    uint32_t last_ground_truth_update_t;
-    ei_impulse_result_bounding_box_t last_prediction;
-
-private:
-    std::vector<ei_impulse_result_bounding_box_t> observations;
-    TinyEKF* centroid_filter;
-    TinyEKF* width_height_filter;
-    uint32_t max_observations;
-    float fx_centroid[2];
-    float fx_width_height[2];
-    float hx_centroid[2];
-    float hx_width_height[2];
-    const char* trace_label;
-    float trace_score;
-    ExponentialMovingAverage *xyxy_emas[4];
-};
+// Only the last two observations of a trace are ever read (last observation and centroid segment)
+#define EI_OBJECT_TRACKING_OBSERVATION_HISTORY 2
 
 class Tracker {
 public:
@@ -247,26 +76,32 @@ public:
               alignment(threshold, use_iou) {
         trace_seq_id = 0;
         t = 0;
-    }
+        open_count = 0;
 
-    ~Tracker() {
-        for (auto trace : open_traces) {
-            delete trace;
-        }
-        for (auto trace : closed_traces) {
-            delete trace;
+        // hand out slot 0 first
+        for (size_t ix = 0; ix < EI_OBJECT_TRACKING_MAX_TRACES; ix++) {
+            free_slots[ix] = EI_OBJECT_TRACKING_MAX_TRACES - 1 - ix;
         }
+        free_count = EI_OBJECT_TRACKING_MAX_TRACES;
+
+        // all traces use the same filter settings
+        TinyEKF::init_model(&ekf_model);
+
+        object_tracking_output.reserve(EI_OBJECT_TRACKING_MAX_TRACES);
+        last_obs_matches.reserve(EI_OBJECT_TRACKING_MAX_TRACES);
+        predicted_matches.reserve(EI_OBJECT_TRACKING_MAX_TRACES);
     }
 
-    std::vector<Trace*>open_traces;
-    std::vector<Trace*>closed_traces;
     std::vector<ei_object_tracking_trace_t> object_tracking_output;
 
     /**
      * Process new detections.
-     * @param detections Bounding boxes, this vector might be reordered.
+     * @param bbs Bounding boxes, copied and sorted internally
+     * @param bbs_count Number of bounding boxes
      */
-    void process_new_detections(std::vector<ei_impulse_result_bounding_box_t> detections) {
+    void process_new_detections(const ei_impulse_result_bounding_box_t *bbs, size_t bbs_count) {
+        detections.assign(bbs, bbs + bbs_count);
+
         // sort detections by x, y, width, height, label (same in Python code, see ei_tracking/tracking.py)
         // so it doesn't matter in what order we pass in the detections
         std::sort(detections.begin(), detections.end(), [](const ei_impulse_result_bounding_box_t& a, const ei_impulse_result_bounding_box_t& b) {
@@ -278,12 +113,11 @@ public:
         });
 
         // firstly try an alignment with last observations...
-        std::vector<ei_impulse_result_bounding_box_t> last_obs_bboxes;
-        for (auto trace : open_traces) {
-            last_obs_bboxes.push_back(*trace->last_observation());
+        for (size_t ix = 0; ix < open_count; ix++) {
+            trace_boxes[ix] = *last_observation(open_slots[ix]);
         }
 
-        std::vector<std::tuple<int, int, float>> last_obs_matches = alignment.align(last_obs_bboxes, detections);
+        alignment.align(trace_boxes, open_count, detections.data(), detections.size(), last_obs_matches);
 
         float last_obs_cost = 0;
         for (auto last_obs_match : last_obs_matches) {
@@ -293,13 +127,13 @@ public:
         EI_LOGD("last_obs_cost %f\n", last_obs_cost);
 
         // ... then with the kalman filter predictions
-        std::vector<ei_impulse_result_bounding_box_t> predicted_bboxes;
-        for (auto trace : open_traces) {
-            predicted_bboxes.push_back(trace->predict());
-            EI_LOGD("predicted %d %d %d %d %f\n", trace->last_prediction.x, trace->last_prediction.y, trace->last_prediction.width, trace->last_prediction.height, trace->last_prediction.value);
+        for (size_t ix = 0; ix < open_count; ix++) {
+            uint16_t slot = open_slots[ix];
+            trace_boxes[ix] = predict(slot);
+            EI_LOGD("predicted %d %d %d %d %f\n", trace_last_prediction[slot].x, trace_last_prediction[slot].y, trace_last_prediction[slot].width, trace_last_prediction[slot].height, trace_last_prediction[slot].value);
         }
 
-        std::vector<std::tuple<int, int, float>> predicted_matches = alignment.align(predicted_bboxes, detections);
+        alignment.align(trace_boxes, open_count, detections.data(), detections.size(), predicted_matches);
         float predicted_cost = 0;
         for (auto predicted_match : predicted_matches) {
             EI_LOGD("predicted_match %d %d %f\n", std::get<0>(predicted_match), std::get<1>(predicted_match), std::get<2>(predicted_match));
@@ -308,89 +142,118 @@ public:
         EI_LOGD("predicted_cost %f\n", predicted_cost);
 
         // and use whichever matching set is better
-        std::vector<std::tuple<int, int, float>> matches;
+        const std::vector<std::tuple<int, int, float>> *matches;
 
         if (last_obs_cost < predicted_cost) {
             EI_LOGD("using last_obs_matches matches\n");
-            matches = last_obs_matches;
+            matches = &last_obs_matches;
         }
         else {
             EI_LOGD("using predicted_matches matches\n");
-            matches = predicted_matches;
+            matches = &predicted_matches;
         }
 
         // assume all detections are unassigned and will becomes new tracks
-        // until we see otherwise ( i.e. they match an existing track )∂        //
-        std::set<uint16_t>unassigned_detection_idxs;
-        for (size_t i = 0; i < detections.size(); i++) {
-            unassigned_detection_idxs.insert(i);
-        }
-
-        // keep track of open traces idxs that haven't been updated
-        std::set<uint16_t>open_traces_idxs_to_be_updated;
-        for (size_t i = 0; i < open_traces.size(); i++) {
-            open_traces_idxs_to_be_updated.insert(i);
-        }
+        // until we see otherwise ( i.e. they match an existing track )
+        detection_assigned.assign(detections.size(), 0);
 
         // update existing traces with any matches
-        for (size_t i = 0; i < matches.size(); i++) {
-            uint32_t trace_idx = std::get<0>(matches[i]);
-            uint32_t detection_idx = std::get<1>(matches[i]);
-            EI_LOGD("t_idx=%u d_idx=%u iou=%.6f\n", trace_idx, detection_idx, std::get<2>(matches[i]));
-
-            Trace *trace = open_traces[trace_idx];
-            open_traces_idxs_to_be_updated.erase(trace_idx);
-            trace->update(t, &detections[detection_idx]);
-            unassigned_detection_idxs.erase(detection_idx);
+        for (size_t i = 0; i < matches->size(); i++) {
+            uint32_t trace_idx = std::get<0>((*matches)[i]);
+            uint32_t detection_idx = std::get<1>((*matches)[i]);
+            EI_LOGD("t_idx=%u d_idx=%u iou=%.6f\n", trace_idx, detection_idx, std::get<2>((*matches)[i]));
+
+            update(open_slots[trace_idx], &detections[detection_idx]);
+            detection_assigned[detection_idx] = 1;
         }
 
-        for (auto detection_idx : unassigned_detection_idxs ) {
-            EI_LOGD("unassigned detection %d %d %d %d %d %f => starting new trace\n", detection_idx, detections[detection_idx].x, detections[detection_idx].y, detections[detection_idx].width, detections[detection_idx].height, detections[detection_idx].value);
-            open_traces.push_back(new Trace(trace_seq_id, t, detections[detection_idx], max_observations));
+        for (size_t detection_idx = 0; detection_idx < detections.size(); detection_idx++) {
+            if (detection_assigned[detection_idx]) {
+                continue;
+            }
+            if (free_count == 0) {
+                EI_LOGD("unassigned detection %d dropped, all %d traces in use\n", (int)detection_idx, EI_OBJECT_TRACKING_MAX_TRACES);
+                continue;
+            }
+            EI_LOGD("unassigned detection %d %d %d %d %d %f => starting new trace\n", (int)detection_idx, detections[detection_idx].x, detections[detection_idx].y, detections[detection_idx].width, detections[detection_idx].height, detections[detection_idx].value);
+            uint16_t slot = free_slots[--free_count];
+            open_trace(slot, detections[detection_idx]);
+            open_slots[open_count++] = slot;
             trace_seq_id += 1;
         }
 
-        std::vector<Trace*>traces_tmp;
-
-        for (auto trace : open_traces) {
-            EI_LOGD("grace checking trace %d at t=%d (trace.last_ground_truth_update_t=%d)\n", trace->id, t, trace->last_ground_truth_update_t);
-            uint32_t time_since_last_update = t - trace->last_ground_truth_update_t;
+        // close stale traces, compacting the open list in place (keeps creation order)
+        size_t still_open = 0;
+        for (size_t ix = 0; ix < open_count; ix++) {
+            uint16_t slot = open_slots[ix];
+            EI_LOGD("grace checking trace %d at t=%d (trace.last_ground_truth_update_t=%d)\n", trace_id[slot], t, trace_last_ground_truth_update_t[slot]);
+            uint32_t time_since_last_update = t - trace_last_ground_truth_update_t[slot];
             if (time_since_last_update > keep_grace) {
                 // been too long since last update, close it
-                EI_LOGD("closing trace %d\n", trace->id);
-                closed_traces.push_back(trace);
+                EI_LOGD("closing trace %d\n", trace_id[slot]);
+                free_slots[free_count++] = slot;
             }
             else {
-                if (trace->last_ground_truth_update_t != t) {
+                if (trace_last_ground_truth_update_t[slot] != t) {
                     // wasn't match this step, so do rollout of filters
-                    EI_LOGD("self rollout of trace %d\n", trace->id);
-                    trace->update(t, nullptr);
+                    EI_LOGD("self rollout of trace %d\n", trace_id[slot]);
+                    update(slot, nullptr);
                 }
-                EI_LOGD("trace %d still alive\n", trace->id);
-                traces_tmp.push_back(trace);
+                EI_LOGD("trace %d still alive\n", trace_id[slot]);
+                open_slots[still_open++] = slot;
             }
         }
+        open_count = still_open;
 
-        open_traces = traces_tmp;
         object_tracking_output.clear();
 
-        for (auto trace : open_traces) {
+        for (size_t ix = 0; ix < open_count; ix++) {
+            uint16_t slot = open_slots[ix];
+            const ei_impulse_result_bounding_box_t &prediction = trace_last_prediction[slot];
             ei_object_tracking_trace_t trace_result = { 0 };
-            trace_result.id = trace->id;
-            trace_result.last_ground_truth_update_t = trace->last_ground_truth_update_t;
-            trace_result.label = trace->last_prediction.label;
-            trace_result.x = trace->last_prediction.x;
-            trace_result.y = trace->last_prediction.y;
-            trace_result.width = trace->last_prediction.width;
-            trace_result.height = trace->last_prediction.height;
-            trace_result.last_centroid_segment = trace->last_centroid_segment();
-            trace_result.value = trace->last_prediction.value;
+            trace_result.id = trace_id[slot];
+            trace_result.last_ground_truth_update_t = trace_last_ground_truth_update_t[slot];
+            trace_result.label = prediction.label;
+            trace_result.x = prediction.x;
+            trace_result.y = prediction.y;
+            trace_result.width = prediction.width;
+            trace_result.height = prediction.height;
+            trace_result.last_centroid_segment = last_centroid_segment(slot);
+            trace_result.value = prediction.value;
 
             object_tracking_output.push_back(trace_result);
         }
         t += 1;
     }
 
+    void process_new_detections(const std::vector<ei_impulse_result_bounding_box_t> &bbs) {
+        process_new_detections(bbs.data(), bbs.size());
+    }
+
+    /**
+     * Last observation of an open trace, smoothed with an EMA over max_observations
+     * @param open_trace_idx Index into object_tracking_output
+     */
+    ei_impulse_result_bounding_box_t smoothed_last_observation(size_t open_trace_idx) const {
+        ei_impulse_result_bounding_box_t bbox = {"", 0, 0, 0, 0, 0.0};
+        if (open_trace_idx >= open_count) {
+            return bbox;
+        }
+        uint16_t slot = open_slots[open_trace_idx];
+
+        bbox.x = round(trace_ema[slot][0]);
+        bbox.y = round(trace_ema[slot][1]);
+        bbox.width = round(trace_ema[slot][2]);
+        bbox.height = round(trace_ema[slot][3]);
+        bbox.label = trace_label[slot];
+        bbox.value = trace_score[slot];
+        return bbox;
+    }
+
+    size_t open_traces_count() const {
+        return open_count;
+    }
+
     void set_threshold(float threshold) {
         alignment.threshold = threshold;
     }
@@ -402,10 +265,153 @@ public:
     uint32_t keep_grace;
     uint16_t max_observations;
 private:
+    void open_trace(uint16_t slot, const ei_impulse_result_bounding_box_t& initial_bbox) {
+        if (max_observations < 2) {
+            EI_LOGE("%s", "max_observations needs to be at least 2 for counting");
+        }
+
+        trace_id[slot] = trace_seq_id;
+        trace_last_ground_truth_update_t[slot] = t;
+        trace_last_prediction[slot] = initial_bbox;
+        trace_label[slot] = initial_bbox.label;
+        trace_score[slot] = initial_bbox.value;
+
+        trace_observations[slot][EI_OBJECT_TRACKING_OBSERVATION_HISTORY - 1] = initial_bbox;
+        trace_observations_count[slot] = 1;
+        trace_observations_limit[slot] = max_observations < 1 ? 1 :
+            (max_observations > EI_OBJECT_TRACKING_OBSERVATION_HISTORY ? EI_OBJECT_TRACKING_OBSERVATION_HISTORY : max_observations);
+
+        float initial_centroid[2] = { initial_bbox.x + static_cast<float>(initial_bbox.width) / 2,
+                                      initial_bbox.y + static_cast<float>(initial_bbox.height) / 2 };
+
+        float initial_width_height[2] = { static_cast<float>(initial_bbox.width),
+                                          static_cast<float>(initial_bbox.height) };
+
+        TinyEKF::init_state(initial_centroid, trace_centroid_x[slot], trace_centroid_P[slot]);
+        TinyEKF::init_state(initial_width_height, trace_width_height_x[slot], trace_width_height_P[slot]);
+
+        // Use x0, y0, x1, y1 for EMAs, -255 marks "no value yet"
+        float gain = 2;
+        trace_ema_gain[slot] = gain / ((int)max_observations + 1);
+        for (size_t ix = 0; ix < 4; ix++) {
+            trace_ema[slot][ix] = -255.0;
+        }
+    }
+
+    ei_impulse_result_bounding_box_t predict(uint16_t slot) {
+        float *centroid_x = trace_centroid_x[slot];
+        float *width_height_x = trace_width_height_x[slot];
+
+        TinyEKF::predict(&ekf_model, centroid_x, trace_centroid_P[slot]);
+        TinyEKF::predict(&ekf_model, width_height_x, trace_width_height_P[slot]);
+
+        ei_impulse_result_bounding_box_t p_bbox = {"", 0, 0, 0, 0, 0.0};
+        p_bbox.label = trace_label[slot];
+        p_bbox.value = trace_score[slot];
+        p_bbox.x = round(clip((centroid_x[0] - width_height_x[0] / 2), 0));
+        p_bbox.y = round(clip(centroid_x[1] - width_height_x[1] / 2, 0));
+        p_bbox.width = round(clip(width_height_x[0], 0));
+        p_bbox.height = round(clip(width_height_x[1], 0));
+        trace_last_prediction[slot] = p_bbox;
+        EI_LOGD("predict %d %d %d %d %f\n", p_bbox.x, p_bbox.y, p_bbox.width, p_bbox.height, p_bbox.value);
+        return p_bbox;
+    }
+
+    void update(uint16_t slot, const ei_impulse_result_bounding_box_t* bbox) {
+        if (bbox == nullptr) {
+            bbox = &trace_last_prediction[slot];
+            EI_LOGD("update (last prediction) %d %d %d %d %f\n", bbox->x, bbox->y, bbox->width, bbox->height, bbox->value);
+        } else {
+            EI_LOGD("update (ground truth prediction) %d %d %d %d %f\n", bbox->x, bbox->y, bbox->width, bbox->height, bbox->value);
+            trace_last_ground_truth_update_t[slot] = t;
+        }
+
+        float *centroid_x = trace_centroid_x[slot];
+        float *width_height_x = trace_width_height_x[slot];
+
+        float hx_centroid[2] = { centroid_x[0], centroid_x[1] };
+        float hx_width_height[2] = { width_height_x[0], width_height_x[1] };
+
+        float centroid[2] = { bbox->x + static_cast<float>(bbox->width) / 2,
+                              bbox->y + static_cast<float>(bbox->height) / 2 };
+        TinyEKF::update(&ekf_model, centroid_x, trace_centroid_P[slot], centroid, hx_centroid);
+
+        float width_height[2] = { static_cast<float>(bbox->width),
+                                  static_cast<float>(bbox->height) };
+        TinyEKF::update(&ekf_model, width_height_x, trace_width_height_P[slot], width_height, hx_width_height);
+
+        trace_score[slot] = bbox->value;
+
+        // shift the observation history, newest entry last
+        ei_impulse_result_bounding_box_t *observations = trace_observations[slot];
+        for (size_t ix = 1; ix < EI_OBJECT_TRACKING_OBSERVATION_HISTORY; ix++) {
+            observations[ix - 1] = observations[ix];
+        }
+        observations[EI_OBJECT_TRACKING_OBSERVATION_HISTORY - 1] = *bbox;
+        if (trace_observations_count[slot] < trace_observations_limit[slot]) {
+            trace_observations_count[slot]++;
+        }
+
+        const float values[4] = { (float)bbox->x, (float)bbox->y, (float)bbox->width, (float)bbox->height };
+        const float gain = trace_ema_gain[slot];
+        for (size_t ix = 0; ix < 4; ix++) {
+            if (trace_ema[slot][ix] == -255.0) {
+                trace_ema[slot][ix] = values[ix];
+            } else {
+                trace_ema[slot][ix] = (values[ix] * gain) + (trace_ema[slot][ix] * (1 - gain));
+            }
+        }
+    }
+
+    std::tuple<int, int, int, int> last_centroid_segment(uint16_t slot) const {
+        if (trace_observations_count[slot] < 2) {
+            return {};
+        }
+        const ei_impulse_result_bounding_box_t &obs_t_minus1 = trace_observations[slot][EI_OBJECT_TRACKING_OBSERVATION_HISTORY - 2];
+        const ei_impulse_result_bounding_box_t &obs_t_0 = trace_observations[slot][EI_OBJECT_TRACKING_OBSERVATION_HISTORY - 1];
+
+        return {obs_t_minus1.x + static_cast<float>(obs_t_minus1.width) / 2,
+                obs_t_minus1.y + static_cast<float>(obs_t_minus1.height) / 2,
+                obs_t_0.x + static_cast<float>(obs_t_0.width) / 2,
+                obs_t_0.y + static_cast<float>(obs_t_0.height) / 2};
+    }
+
+    const ei_impulse_result_bounding_box_t* last_observation(uint16_t slot) const {
+        return &trace_observations[slot][EI_OBJECT_TRACKING_OBSERVATION_HISTORY - 1];
+    }
+
     uint32_t trace_seq_id;
     uint32_t t;
     JonkerVolgenantAlignment alignment;
-    std::vector<std::string> seen_labels;
+    TinyEKFModel ekf_model;
+
+    // trace pool, one entry per slot
+    uint32_t trace_id[EI_OBJECT_TRACKING_MAX_TRACES];
+    uint32_t trace_last_ground_truth_update_t[EI_OBJECT_TRACKING_MAX_TRACES];
+    ei_impulse_result_bounding_box_t trace_last_prediction[EI_OBJECT_TRACKING_MAX_TRACES];
+    ei_impulse_result_bounding_box_t trace_observations[EI_OBJECT_TRACKING_MAX_TRACES][EI_OBJECT_TRACKING_OBSERVATION_HISTORY];
+    uint8_t trace_observations_count[EI_OBJECT_TRACKING_MAX_TRACES];
+    uint8_t trace_observations_limit[EI_OBJECT_TRACKING_MAX_TRACES];
+    float trace_centroid_x[EI_OBJECT_TRACKING_MAX_TRACES][TINYEKF_X_SIZE];
+    float trace_centroid_P[EI_OBJECT_TRACKING_MAX_TRACES][TINYEKF_P_SIZE];
+    float trace_width_height_x[EI_OBJECT_TRACKING_MAX_TRACES][TINYEKF_X_SIZE];
+    float trace_width_height_P[EI_OBJECT_TRACKING_MAX_TRACES][TINYEKF_P_SIZE];
+    float trace_ema_gain[EI_OBJECT_TRACKING_MAX_TRACES];
+    float trace_ema[EI_OBJECT_TRACKING_MAX_TRACES][4];
+    const char* trace_label[EI_OBJECT_TRACKING_MAX_TRACES];
+    float trace_score[EI_OBJECT_TRACKING_MAX_TRACES];
+
+    uint16_t open_slots[EI_OBJECT_TRACKING_MAX_TRACES]; // open traces, oldest first
+    size_t open_count;
+    uint16_t free_slots[EI_OBJECT_TRACKING_MAX_TRACES];
+    size_t free_count;
+
+    // per frame scratch, only grows
+    std::vector<ei_impulse_result_bounding_box_t> detections;
+    std::vector<uint8_t> detection_assigned;
+    ei_impulse_result_bounding_box_t trace_boxes[EI_OBJECT_TRACKING_MAX_TRACES];
+    std::vector<std::tuple<int, int, float>> last_obs_matches;
+    std::vector<std::tuple<int, int, float>> predicted_matches;
 };
 
 EI_IMPULSE_ERROR init_object_tracking(ei_impulse_handle_t *handle, void** state, void *config)
@@ -450,15 +456,11 @@ EI_IMPULSE_ERROR process_object_tracking(ei_impulse_handle_t *handle,
     const ei_object_tracking_config_t *ei_object_tracking_config = (ei_object_tracking_config_t*)config_ptr;
 
     if((void *)object_tracker != NULL) {
-        ei_impulse_result_bounding_box_t *bbs = result->bounding_boxes;
-        uint32_t bbs_num = result->bounding_boxes_count;
-        std::vector<ei_impulse_result_bounding_box_t> detections(bbs, bbs + bbs_num);
-
         object_tracker->keep_grace = ei_object_tracking_config->keep_grace;
         object_tracker->max_observations = ei_object_tracking_config->max_observations;
         object_tracker->set_threshold(ei_object_tracking_config->threshold);
 
-        object_tracker->process_new_detections(detections);
+        object_tracker->process_new_detections(result->bounding_boxes, result->bounding_boxes_count);
 
         result->postprocessed_output.object_tracking_output.open_traces = object_tracker->object_tracking_output.data();
         result->postprocessed_output.object_tracking_output.open_traces_count = object_tracker->object_tracking_output.size();
@@ -343,7 +343,7 @@ void nhwc_to_nchw_inplace(std::vector<T>& data,
 }
 
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR process_qc_face_det_lite_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR process_qc_face_det_lite_common(ei_impulse_handle_t *handle,
                                                                                 ei_impulse_result_t *result,
                                                                                 T *heatmap_buf,
                                                                                 uint32_t heatmap_buf_size,
@@ -356,6 +356,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_qc_face_det_lite_common(
                                                                                 float threshold,
                                                                                 size_t object_detection_count,
                                                                                 ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
     const int width = impulse->input_width;
     const int height = impulse->input_height;
     const uint32_t grid_size_x = width / 8;
@@ -425,7 +426,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_qc_face_det_lite_common(
         }
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
                                         &results,
                                         boxes.data(),
                                         scores.data(),
@@ -494,7 +495,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_qc_face_det_lite_f32(ei_
         return EI_IMPULSE_POSTPROCESSING_ERROR;
     }
 
-    return process_qc_face_det_lite_common(impulse,
+    return process_qc_face_det_lite_common(handle,
                                            result,
                                            heatmap_mtx->buffer,
                                            heatmap_mtx->cols * heatmap_mtx->rows,
@@ -579,7 +580,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_qc_yolox_f32(ei_impulse_
         }
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse, &config->nms_config, &results);
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle, &config->nms_config, &results);
     if (nms_res != EI_IMPULSE_OK) {
         return nms_res;
     }
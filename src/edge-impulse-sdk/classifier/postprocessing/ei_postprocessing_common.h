@@ -44,6 +44,12 @@
 #include "edge-impulse-sdk/dsp/ei_vector.h"
 #include <string>
 
+// The SSD detection post-process op already runs per class NMS inside the model,
+// set to 1 to run class-aware NMS again with the block's nms_config
+#ifndef EI_CLASSIFIER_SSD_RUN_NMS
+#define EI_CLASSIFIER_SSD_RUN_NMS 0
+#endif
+
 #ifdef EI_HAS_PADDLEOCR_DETECTOR
 #include <utility>
 #include <queue>
@@ -61,130 +67,213 @@ int16_t get_block_number(ei_impulse_handle_t *handle, void *init_func)
 }
 
 /**
- * Checks whether a new section overlaps with a cube,
- * and if so, will **update the cube**
+ * Root of a provisional FOMO label, halves the path on the way up
  */
-__attribute__((unused)) static bool ei_cube_check_overlap(ei_classifier_cube_t *c, uint32_t x, uint32_t y, uint32_t width, uint32_t height, float confidence) {
-    bool is_overlapping = !(c->x + c->width < x || c->y + c->height < y || c->x > x + width || c->y > y + height);
-    if (!is_overlapping) return false;
-
-    // if we overlap, but the x of the new box is lower than the x of the current box
-    if (x < c->x) {
-        // update x to match new box and make width larger (by the diff between the boxes)
-        c->x = x;
-        c->width += c->x - x;
-    }
-    // if we overlap, but the y of the new box is lower than the y of the current box
-    if (y < c->y) {
-        // update y to match new box and make height larger (by the diff between the boxes)
-        c->y = y;
-        c->height += c->y - y;
-    }
-    // if we overlap, and x+width of the new box is higher than the x+width of the current box
-    if (x + width > c->x + c->width) {
-        // just make the box wider
-        c->width += (x + width) - (c->x + c->width);
-    }
-    // if we overlap, and y+height of the new box is higher than the y+height of the current box
-    if (y + height > c->y + c->height) {
-        // just make the box higher
-        c->height += (y + height) - (c->y + c->height);
-    }
-    // if the new box has higher confidence, then override confidence of the whole box
-    if (confidence > c->confidence) {
-        c->confidence = confidence;
-    }
-    return true;
+static inline uint32_t ei_fomo_find(uint32_t *parent, uint32_t label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
 }
 
-__attribute__((unused)) static void ei_handle_cube(std::vector<ei_classifier_cube_t*> *cubes, uint32_t x, uint32_t y, float vf, const char *label, float detection_threshold) {
-    if (vf < detection_threshold) return;
+/**
+ * Join the groups of two provisional FOMO labels, the lower root becomes the root of both
+ */
+static inline uint32_t ei_fomo_union(uint32_t *parent, uint32_t a, uint32_t b) {
+    a = ei_fomo_find(parent, a);
+    b = ei_fomo_find(parent, b);
+    if (a < b) {
+        parent[b] = a;
+        return a;
+    }
+    parent[a] = b;
+    return b;
+}
 
-    bool has_overlapping = false;
-    uint32_t width = 1;
-    uint32_t height = 1;
+/**
+ * Group the cells of a FOMO output grid that are above the threshold into 8-connected components,
+ * separately per class.
+ *
+ * One pass over the grid: every row is thresholded into ws->row_hits, a hit takes the label of an
+ * already visited neighbour (W, NW, N, NE) and touching labels are joined with union-find. Bounds
+ * and peak values are kept per provisional label and folded into the roots at the end, so the cost
+ * does not depend on how many cells light up.
+ *
+ * @param buffer rows x cols cells of (label_count + 1) values, background first
+ * @param threshold A value is a hit unless it's below the threshold
+ * @param component_count Out: number of components in ws->components, in the order of their
+ *                        first cell (row, column, class)
+ */
+template <typename T, typename TThreshold>
+static void ei_fomo_label_components(ei_fomo_workspace_t *ws,
+                                     const T *buffer,
+                                     size_t rows,
+                                     size_t cols,
+                                     size_t label_count,
+                                     TThreshold threshold,
+                                     size_t *component_count) {
+    const size_t stride = label_count + 1;
+    const size_t row_values = cols * stride;
+    uint8_t *hits = ws->row_hits;
+    uint32_t *parent = ws->parent;
+    ei_fomo_component_t *components = ws->components;
+    uint32_t *prev_labels = ws->row_labels;
+    uint32_t *cur_labels = ws->row_labels + row_values;
+    uint32_t next_label = 1;
+
+    memset(prev_labels, 0, row_values * sizeof(uint32_t));
+
+    for (size_t y = 0; y < rows; y++) {
+        const T *row = buffer + (y * row_values);
+
+        // no branches, so this vectorizes; background values are never read back
+        for (size_t ix = 0; ix < row_values; ix++) {
+            hits[ix] = !(row[ix] < threshold);
+        }
+
+        memset(cur_labels, 0, row_values * sizeof(uint32_t));
+
+        for (size_t x = 0; x < cols; x++) {
+            for (size_t c = 0; c < label_count; c++) {
+                const size_t ix = (x * stride) + 1 + c;
+                if (!hits[ix]) {
+                    continue;
+                }
 
-    for (auto c : *cubes) {
-        // not cube for same class? continue
-        if (strcmp(c->label, label) != 0) continue;
+                // N touches W, NW and NE, so those are already joined with it
+                uint32_t label = prev_labels[ix];
+                if (label == 0) {
+                    uint32_t w = 0;
+                    uint32_t ne = 0;
+                    if (x > 0) {
+                        w = cur_labels[ix - stride] ? cur_labels[ix - stride] : prev_labels[ix - stride];
+                    }
+                    if (x + 1 < cols) {
+                        ne = prev_labels[ix + stride];
+                    }
+                    if (w && ne) {
+                        label = ei_fomo_union(parent, w, ne);
+                    }
+                    else {
+                        label = w ? w : ne;
+                    }
+                }
 
-        if (ei_cube_check_overlap(c, x, y, width, height, vf)) {
-            has_overlapping = true;
-            break;
+                ei_fomo_component_t *comp;
+                if (label == 0) {
+                    label = next_label++;
+                    parent[label] = label;
+                    comp = &components[label];
+                    comp->x0 = comp->x1 = (uint16_t)x;
+                    comp->y0 = comp->y1 = (uint16_t)y;
+                    comp->label_ix = (uint16_t)c;
+                    comp->value = static_cast<float>(row[ix]);
+                }
+                else {
+                    comp = &components[label];
+                    if (x < comp->x0) comp->x0 = (uint16_t)x;
+                    if (x > comp->x1) comp->x1 = (uint16_t)x;
+                    comp->y1 = (uint16_t)y;
+                    if (static_cast<float>(row[ix]) > comp->value) comp->value = static_cast<float>(row[ix]);
+                }
+                cur_labels[ix] = label;
+            }
+        }
+
+        uint32_t *tmp = prev_labels;
+        prev_labels = cur_labels;
+        cur_labels = tmp;
+    }
+
+    // parents always have a lower label, so walking down folds every label into its root
+    for (uint32_t label = next_label - 1; label > 0; label--) {
+        const uint32_t p = parent[label];
+        if (p == label) {
+            continue;
         }
+        ei_fomo_component_t *dst = &components[p];
+        const ei_fomo_component_t *src = &components[label];
+        if (src->x0 < dst->x0) dst->x0 = src->x0;
+        if (src->y0 < dst->y0) dst->y0 = src->y0;
+        if (src->x1 > dst->x1) dst->x1 = src->x1;
+        if (src->y1 > dst->y1) dst->y1 = src->y1;
+        if (src->value > dst->value) dst->value = src->value;
     }
 
-    if (!has_overlapping) {
-        ei_classifier_cube_t *cube = new ei_classifier_cube_t();
-        cube->x = x;
-        cube->y = y;
-        cube->width = 1;
-        cube->height = 1;
-        cube->confidence = vf;
-        cube->label = label;
-        cubes->push_back(cube);
+    size_t count = 0;
+    for (uint32_t label = 1; label < next_label; label++) {
+        if (parent[label] == label) {
+            components[count++] = components[label];
+        }
     }
+    *component_count = count;
 }
 
-__attribute__((unused)) static void process_cubes(ei_impulse_result_t *result, std::vector<ei_classifier_cube_t*> *cubes, uint32_t out_width_factor, uint32_t object_detection_count) {
-    std::vector<ei_classifier_cube_t*> bbs;
+/**
+ * Turn FOMO components into bounding boxes. Components of the same class whose boxes touch or
+ * overlap are merged into the first one.
+ */
+__attribute__((unused)) static void ei_fomo_fill_results(const ei_impulse_t *impulse,
+                                                         ei_impulse_result_t *result,
+                                                         ei_fomo_component_t *components,
+                                                         size_t component_count,
+                                                         uint32_t out_width_factor,
+                                                         uint32_t object_detection_count) {
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    uint32_t added_boxes_count = 0;
     results.clear();
 
-    for (auto sc : *cubes) {
+    size_t kept = 0;
+    for (size_t ix = 0; ix < component_count; ix++) {
+        const ei_fomo_component_t sc = components[ix];
         bool has_overlapping = false;
 
-        uint32_t x = sc->x;
-        uint32_t y = sc->y;
-        uint32_t width = sc->width;
-        uint32_t height = sc->height;
-        const char *label = sc->label;
-        float vf = sc->confidence;
+        for (size_t k = 0; k < kept; k++) {
+            ei_fomo_component_t *c = &components[k];
+            // not for same class? continue
+            if (c->label_ix != sc.label_ix) continue;
 
-        for (auto c : bbs) {
-            // not cube for same class? continue
-            if (strcmp(c->label, label) != 0) continue;
+            if (c->x1 + 1 < sc.x0 || c->y1 + 1 < sc.y0 || c->x0 > sc.x1 + 1 || c->y0 > sc.y1 + 1) continue;
 
-            if (ei_cube_check_overlap(c, x, y, width, height, vf)) {
-                has_overlapping = true;
-                break;
-            }
+            if (sc.x0 < c->x0) c->x0 = sc.x0;
+            if (sc.y0 < c->y0) c->y0 = sc.y0;
+            if (sc.x1 > c->x1) c->x1 = sc.x1;
+            if (sc.y1 > c->y1) c->y1 = sc.y1;
+            if (sc.value > c->value) c->value = sc.value;
+            has_overlapping = true;
+            break;
         }
 
-        if (has_overlapping) {
-            continue;
+        if (!has_overlapping) {
+            components[kept++] = sc;
         }
+    }
 
-        bbs.push_back(sc);
+    results.reserve(kept > object_detection_count ? kept : object_detection_count);
 
+    for (size_t ix = 0; ix < kept; ix++) {
+        const ei_fomo_component_t *c = &components[ix];
         ei_impulse_result_bounding_box_t tmp = {
-            .label = sc->label,
-            .x = (uint32_t)(sc->x * out_width_factor),
-            .y = (uint32_t)(sc->y * out_width_factor),
-            .width = (uint32_t)(sc->width * out_width_factor),
-            .height = (uint32_t)(sc->height * out_width_factor),
-            .value = sc->confidence
+            .label = impulse->categories[c->label_ix],
+            .x = (uint32_t)(c->x0 * out_width_factor),
+            .y = (uint32_t)(c->y0 * out_width_factor),
+            .width = (uint32_t)((c->x1 - c->x0 + 1) * out_width_factor),
+            .height = (uint32_t)((c->y1 - c->y0 + 1) * out_width_factor),
+            .value = c->value
         };
-
         results.push_back(tmp);
-        added_boxes_count++;
     }
 
     // if we didn't detect min required objects, fill the rest with fixed value
-    if (added_boxes_count < object_detection_count) {
+    if (kept < object_detection_count) {
         results.resize(object_detection_count);
-        for (size_t ix = added_boxes_count; ix < object_detection_count; ix++) {
+        for (size_t ix = kept; ix < object_detection_count; ix++) {
             results[ix].value = 0.0f;
         }
     }
 
-    for (auto c : *cubes) {
-        delete c;
-    }
-
     result->bounding_boxes = results.data();
-    result->bounding_boxes_count = added_boxes_count;
+    result->bounding_boxes_count = kept;
 }
 
 /**
@@ -450,8 +539,6 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_fomo_f32(ei_impulse_hand
     const ei_impulse_t *impulse = handle->impulse;
     const ei_fill_result_fomo_f32_config_t *config = (ei_fill_result_fomo_f32_config_t*)config_ptr;
 
-    std::vector<ei_classifier_cube_t*> cubes;
-
     int out_width_factor = impulse->input_width / config->out_width;
 
     ei::matrix_t* raw_output_mtx = NULL;
@@ -460,19 +547,16 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_fomo_f32(ei_impulse_hand
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    for (size_t y = 0; y < config->out_width; y++) {
-        for (size_t x = 0; x < config->out_height; x++) {
-            size_t loc = ((y * config->out_height) + x) * (impulse->label_count + 1);
-
-            for (size_t ix = 1; ix < (size_t)impulse->label_count + 1; ix++) {
-                float vf = raw_output_mtx->buffer[loc+ix];
-
-                ei_handle_cube(&cubes, x, y, vf, impulse->categories[ix - 1], config->threshold);
-            }
-        }
+    if (!handle->state.alloc_fomo_workspace(config->out_width, config->out_height, impulse->label_count)) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
     }
+    ei_fomo_workspace_t *ws = &handle->state.fomo;
 
-    process_cubes(result, &cubes, out_width_factor, config->object_detection_count);
+    size_t component_count;
+    ei_fomo_label_components(ws, raw_output_mtx->buffer, config->out_width, config->out_height,
+                             impulse->label_count, config->threshold, &component_count);
+
+    ei_fomo_fill_results(impulse, result, ws->components, component_count, out_width_factor, config->object_detection_count);
 
     return EI_IMPULSE_OK;
 #else
@@ -490,8 +574,6 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_fomo_i8(ei_impulse_handl
     const ei_impulse_t *impulse = handle->impulse;
     const ei_fill_result_fomo_i8_config_t *config = (ei_fill_result_fomo_i8_config_t*)config_ptr;
 
-    std::vector<ei_classifier_cube_t*> cubes;
-
     int out_width_factor = impulse->input_width / config->out_width;
 
     ei::matrix_i8_t* raw_output_mtx = NULL;
@@ -500,20 +582,30 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_fomo_i8(ei_impulse_handl
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    for (size_t y = 0; y < config->out_width; y++) {
-        for (size_t x = 0; x < config->out_height; x++) {
-            size_t loc = ((y * config->out_height) + x) * (impulse->label_count + 1);
-
-            for (size_t ix = 1; ix < (size_t)impulse->label_count + 1; ix++) {
-                int8_t v = raw_output_mtx->buffer[loc+ix];
-                float vf = static_cast<float>(v - config->zero_point) * config->scale;
+    if (!handle->state.alloc_fomo_workspace(config->out_width, config->out_height, impulse->label_count)) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    ei_fomo_workspace_t *ws = &handle->state.fomo;
 
-                ei_handle_cube(&cubes, x, y, vf, impulse->categories[ix - 1], config->threshold);
-            }
+    // the scale is positive, so dequantizing keeps the order and the grid can be thresholded on the
+    // raw values: find the lowest raw value that dequantizes to at least the threshold
+    int16_t threshold_q = 128;
+    for (int16_t v = -128; v <= 127; v++) {
+        if (!(static_cast<float>(v - config->zero_point) * config->scale < config->threshold)) {
+            threshold_q = v;
+            break;
         }
     }
 
-    process_cubes(result, &cubes, out_width_factor, config->object_detection_count);
+    size_t component_count;
+    ei_fomo_label_components(ws, raw_output_mtx->buffer, config->out_width, config->out_height,
+                             impulse->label_count, threshold_q, &component_count);
+
+    for (size_t ix = 0; ix < component_count; ix++) {
+        ws->components[ix].value = (ws->components[ix].value - config->zero_point) * config->scale;
+    }
+
+    ei_fomo_fill_results(impulse, result, ws->components, component_count, out_width_factor, config->object_detection_count);
 
     return EI_IMPULSE_OK;
 #else
@@ -643,6 +735,23 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_ssd_f32(ei_impulse_handl
         }
     }
 
+#if EI_CLASSIFIER_SSD_RUN_NMS == 1
+    if (config->nms_config.iou_threshold > 0.0f) {
+        EI_IMPULSE_ERROR nms_res = ei_run_nms(handle, &config->nms_config, &results, true /*clip_boxes*/, true /*class_aware*/);
+        if (nms_res != EI_IMPULSE_OK) {
+            return nms_res;
+        }
+
+        added_boxes_count = results.size();
+        if ((size_t)added_boxes_count < config->object_detection_count) {
+            results.resize(config->object_detection_count);
+            for (size_t ix = added_boxes_count; ix < config->object_detection_count; ix++) {
+                results[ix].value = 0.0f;
+            }
+        }
+    }
+#endif // EI_CLASSIFIER_SSD_RUN_NMS == 1
+
     result->bounding_boxes = results.data();
     result->bounding_boxes_count = added_boxes_count;
 
@@ -731,7 +840,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolov5_f32(ei_impulse_ha
         }
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse, &config->nms_config, &results);
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle, &config->nms_config, &results);
     if (nms_res != EI_IMPULSE_OK) {
         return nms_res;
     }
@@ -835,7 +944,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolov5_i8(ei_impulse_han
         }
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse, &config->nms_config, &results);
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle, &config->nms_config, &results);
     if (nms_res != EI_IMPULSE_OK) {
         return nms_res;
     }
@@ -1045,7 +1154,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolox_f32(ei_impulse_han
         }
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse, &config->nms_config, &results);
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle, &config->nms_config, &results);
     if (nms_res != EI_IMPULSE_OK) {
         return nms_res;
     }
@@ -1485,7 +1594,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolov2_f32(ei_impulse_ha
 
 #if EI_HAS_TAO_DECODE_DETECTIONS
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR process_tao_decode_detections_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR process_tao_decode_detections_common(ei_impulse_handle_t *handle,
                                                                                      ei_impulse_result_t *result,
                                                                                      T *data,
                                                                                      float zero_point,
@@ -1494,21 +1603,17 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_decode_detections_co
                                                                                      float threshold,
                                                                                      size_t object_detection_count,
                                                                                      ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
 
     size_t col_size = 12 + impulse->label_count + 1;
     size_t row_count = output_features_count / col_size;
 
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    static std::vector<ei_impulse_result_bounding_box_t> class_results;
+    size_t box_count = 0;
     results.clear();
 
     for (size_t cls_idx = 1; cls_idx < (size_t)(impulse->label_count + 1); cls_idx++)  {
 
-        std::vector<float> boxes;
-        std::vector<float> scores;
-        std::vector<int> classes;
-        class_results.clear();
-
         for (size_t ix = 0; ix < row_count; ix++) {
 
             float score = (static_cast<float>(data[ix * col_size + cls_idx]) - zero_point) * scale;
@@ -1583,31 +1688,24 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_decode_detections_co
             xmax *= impulse->input_width;
             ymax *= impulse->input_height;
 
-            boxes.push_back(ymin);
-            boxes.push_back(xmin);
-            boxes.push_back(ymax);
-            boxes.push_back(xmax);
-            scores.push_back(score);
-            classes.push_back((int)(cls_idx-1));
-        }
-
-        size_t nr_boxes = scores.size();
-        EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                              &class_results,
-                                              boxes.data(),
-                                              scores.data(),
-                                              classes.data(),
-                                              nr_boxes,
-                                              true /*clip_boxes*/,
-                                              &nms_config);
-
-        if (nms_res != EI_IMPULSE_OK) {
-            return nms_res;
+            if (!ei_nms_add_box(handle, &box_count, ymin, xmin, ymax, xmax, score, (int)(cls_idx-1))) {
+                return EI_IMPULSE_OUT_OF_MEMORY;
+            }
         }
+    }
 
-        for (auto bb: class_results) {
-            results.push_back(bb);
-        }
+    // one pass over all classes, boxes only suppress boxes of their own class
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
+                                          &results,
+                                          handle->state.nms.boxes,
+                                          handle->state.nms.scores,
+                                          handle->state.nms.classes,
+                                          box_count,
+                                          true /*clip_boxes*/,
+                                          &nms_config,
+                                          true /*class_aware*/);
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
     }
 
     prepare_nms_results_common(object_detection_count, result, &results);
@@ -1618,7 +1716,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_decode_detections_co
 
 #if EI_HAS_TAO_YOLOV3
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR  process_tao_yolov3_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR  process_tao_yolov3_common(ei_impulse_handle_t *handle,
                                                                                      ei_impulse_result_t *result,
                                                                                      T *data,
                                                                                      float zero_point,
@@ -1627,22 +1725,18 @@ __attribute__((unused)) static EI_IMPULSE_ERROR  process_tao_yolov3_common(const
                                                                                      float threshold,
                                                                                      size_t object_detection_count,
                                                                                      ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
     // # x: 3-D tensor. Last dimension is
     //          (cy, cx, ph, pw, step_y, step_x, pred_y, pred_x, pred_h, pred_w, object, cls...)
     size_t col_size = 11 + impulse->label_count;
     size_t row_count = output_features_count / col_size;
 
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    static std::vector<ei_impulse_result_bounding_box_t> class_results;
+    size_t box_count = 0;
 
     results.clear();
     for (size_t cls_idx = 0; cls_idx < (size_t)impulse->label_count; cls_idx++)  {
 
-        std::vector<float> boxes;
-        std::vector<float> scores;
-        std::vector<int> classes;
-        class_results.clear();
-
         for (size_t ix = 0; ix < row_count; ix++) {
             size_t data_ix = ix * col_size;
             float r_0  = (static_cast<float>(data[data_ix +  0]) - zero_point) * scale;
@@ -1680,30 +1774,24 @@ __attribute__((unused)) static EI_IMPULSE_ERROR  process_tao_yolov3_common(const
             ymax *= impulse->input_height;
             xmax *= impulse->input_width;
 
-            boxes.push_back(ymin);
-            boxes.push_back(xmin);
-            boxes.push_back(ymax);
-            boxes.push_back(xmax);
-            scores.push_back(score);
-            classes.push_back((int)cls_idx);
-        }
-
-        size_t nr_boxes = scores.size();
-        EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                              &class_results,
-                                              boxes.data(),
-                                              scores.data(),
-                                              classes.data(),
-                                              nr_boxes,
-                                              true /*clip_boxes*/,
-                                              &nms_config);
-        if (nms_res != EI_IMPULSE_OK) {
-            return nms_res;
+            if (!ei_nms_add_box(handle, &box_count, ymin, xmin, ymax, xmax, score, (int)cls_idx)) {
+                return EI_IMPULSE_OUT_OF_MEMORY;
+            }
         }
+    }
 
-        for (auto bb: class_results) {
-            results.push_back(bb);
-        }
+    // one pass over all classes, boxes only suppress boxes of their own class
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
+                                          &results,
+                                          handle->state.nms.boxes,
+                                          handle->state.nms.scores,
+                                          handle->state.nms.classes,
+                                          box_count,
+                                          true /*clip_boxes*/,
+                                          &nms_config,
+                                          true /*class_aware*/);
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
     }
 
     prepare_nms_results_common(object_detection_count, result, &results);
@@ -1713,7 +1801,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR  process_tao_yolov3_common(const
 
 #if EI_HAS_TAO_YOLOV4
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_common(ei_impulse_handle_t *handle,
                                                                           ei_impulse_result_t *result,
                                                                           T *data,
                                                                           float zero_point,
@@ -1722,24 +1810,20 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_common(const
                                                                           float threshold,
                                                                           size_t object_detection_count,
                                                                           ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
     // # x: 3-D tensor. Last dimension is
     //          (cy, cx, ph, pw, step_y, step_x, pred_y, pred_x, pred_h, pred_w, object, cls...)
     size_t col_size = 11 + impulse->label_count;
     size_t row_count = output_features_count / col_size;
 
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    static std::vector<ei_impulse_result_bounding_box_t> class_results;
+    size_t box_count = 0;
     results.clear();
 
     const float grid_scale_xy = 1.0f;
 
     for (size_t cls_idx = 0; cls_idx < (size_t)impulse->label_count; cls_idx++)  {
 
-        std::vector<float> boxes;
-        std::vector<float> scores;
-        std::vector<int> classes;
-        class_results.clear();
-
         for (size_t ix = 0; ix < row_count; ix++) {
 
             float r_0  = (static_cast<float>(data[ix * col_size +  0]) - zero_point) * scale;
@@ -1787,30 +1871,24 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_common(const
             ymax *= impulse->input_height;
             xmax *= impulse->input_width;
 
-            boxes.push_back(ymin);
-            boxes.push_back(xmin);
-            boxes.push_back(ymax);
-            boxes.push_back(xmax);
-            scores.push_back(score);
-            classes.push_back((int)cls_idx);
-        }
-
-        size_t nr_boxes = scores.size();
-        EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                              &class_results,
-                                              boxes.data(),
-                                              scores.data(),
-                                              classes.data(),
-                                              nr_boxes,
-                                              true /*clip_boxes*/,
-                                              &nms_config);
-        if (nms_res != EI_IMPULSE_OK) {
-            return nms_res;
+            if (!ei_nms_add_box(handle, &box_count, ymin, xmin, ymax, xmax, score, (int)cls_idx)) {
+                return EI_IMPULSE_OUT_OF_MEMORY;
+            }
         }
+    }
 
-        for (auto bb: class_results) {
-            results.push_back(bb);
-        }
+    // one pass over all classes, boxes only suppress boxes of their own class
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
+                                          &results,
+                                          handle->state.nms.boxes,
+                                          handle->state.nms.scores,
+                                          handle->state.nms.classes,
+                                          box_count,
+                                          true /*clip_boxes*/,
+                                          &nms_config,
+                                          true /*class_aware*/);
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
     }
 
     prepare_nms_results_common(object_detection_count, result, &results);
@@ -1834,7 +1912,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_detection_i8(ei_impu
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_decode_detections_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_decode_detections_common(handle,
                                                                result,
                                                                raw_output_mtx->buffer,
                                                                config->zero_point,
@@ -1866,7 +1944,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_detection_f32(ei_imp
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_decode_detections_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_decode_detections_common(handle,
                                                                result,
                                                                raw_output_mtx->buffer,
                                                                0.0f,
@@ -1897,7 +1975,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov3_f32(ei_impuls
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_yolov3_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_yolov3_common(handle,
                                                      result,
                                                      raw_output_mtx->buffer,
                                                      0.0f,
@@ -1928,7 +2006,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov3_i8(ei_impulse
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_yolov3_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_yolov3_common(handle,
                                                      result,
                                                      raw_output_mtx->buffer,
                                                      config->zero_point,
@@ -1959,7 +2037,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_f32(ei_impuls
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_yolov4_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_yolov4_common(handle,
                                                      result,
                                                      raw_output_mtx->buffer,
                                                      0.0f,
@@ -1990,7 +2068,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_i8(ei_impulse
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = process_tao_yolov4_common(impulse,
+    EI_IMPULSE_ERROR res = process_tao_yolov4_common(handle,
                                                      result,
                                                      raw_output_mtx->buffer,
                                                      config->zero_point,
@@ -2007,7 +2085,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_tao_yolov4_i8(ei_impulse
 
 #if EI_HAS_YOLO_PRO
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolo_pro_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolo_pro_common(ei_impulse_handle_t *handle,
                                                                                     ei_impulse_result_t *result,
                                                                                     T *data,
                                                                                     float zero_point,
@@ -2016,21 +2094,17 @@ __attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolo_pro_comm
                                                                                     float threshold,
                                                                                     size_t object_detection_count,
                                                                                     ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
     size_t col_size = 4 + impulse->label_count;
     size_t row_count = output_features_count / col_size;
 
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    static std::vector<ei_impulse_result_bounding_box_t> class_results;
+    size_t box_count = 0;
     results.clear();
 
     // (xmin, ymin, xmax, ymax, cls...)
     for (size_t cls_idx = 0; cls_idx < (size_t)impulse->label_count; cls_idx++)  {
 
-        std::vector<float> boxes;
-        std::vector<float> scores;
-        std::vector<int> classes;
-        class_results.clear();
-
 
         for (size_t ix = 0; ix < row_count; ix++) {
             size_t base_ix = ix * col_size;
@@ -2073,33 +2147,25 @@ __attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolo_pro_comm
                 ymax *= static_cast<float>(impulse->input_height);
                 xmax *= static_cast<float>(impulse->input_width);
 
-                boxes.push_back(ymin);
-                boxes.push_back(xmin);
-                boxes.push_back(ymax);
-                boxes.push_back(xmax);
-                scores.push_back(score);
-                classes.push_back((int)cls_idx);
+                if (!ei_nms_add_box(handle, &box_count, ymin, xmin, ymax, xmax, score, (int)cls_idx)) {
+                    return EI_IMPULSE_OUT_OF_MEMORY;
+                }
             }
         }
+    }
 
-        size_t nr_boxes = scores.size();
-
-        EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                            &class_results,
-                                            boxes.data(),
-                                            scores.data(),
-                                            classes.data(),
-                                            nr_boxes,
-                                            true /*clip_boxes*/,
-                                            &nms_config);
-
-        if (nms_res != EI_IMPULSE_OK) {
-            return nms_res;
-        }
-
-        for (auto bb: class_results) {
-            results.push_back(bb);
-        }
+    // one pass over all classes, boxes only suppress boxes of their own class
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
+                                          &results,
+                                          handle->state.nms.boxes,
+                                          handle->state.nms.scores,
+                                          handle->state.nms.classes,
+                                          box_count,
+                                          true /*clip_boxes*/,
+                                          &nms_config,
+                                          true /*class_aware*/);
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
     }
 
     prepare_nms_results_common(object_detection_count, result, &results);
@@ -2122,7 +2188,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolo_pro_f32(ei_impulse_
     if (!find_mtx_res) {
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
-    EI_IMPULSE_ERROR res = fill_result_struct_yolo_pro_common(impulse,
+    EI_IMPULSE_ERROR res = fill_result_struct_yolo_pro_common(handle,
                                                                 result,
                                                                 raw_output_mtx->buffer,
                                                                 0.0f,
@@ -2153,7 +2219,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolo_pro_i8(ei_impulse_h
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    EI_IMPULSE_ERROR res = fill_result_struct_yolo_pro_common(impulse,
+    EI_IMPULSE_ERROR res = fill_result_struct_yolo_pro_common(handle,
                                                     result,
                                                     raw_output_mtx->buffer,
                                                     config->zero_point,
@@ -2174,7 +2240,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolo_pro_i8(ei_impulse_h
 #define EI_YOLOV11_COORD_NORMALIZED 1
 
 template<typename T>
-__attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolov11_common(const ei_impulse_t *impulse,
+__attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolov11_common(ei_impulse_handle_t *handle,
                                                                                    ei_impulse_result_t *result,
                                                                                    bool is_coord_normalized,
                                                                                    T *data,
@@ -2184,21 +2250,17 @@ __attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolov11_commo
                                                                                    float threshold,
                                                                                    size_t object_detection_count,
                                                                                    ei_object_detection_nms_config_t nms_config) {
+    const ei_impulse_t *impulse = handle->impulse;
     size_t row_count = 4 + impulse->label_count;
     size_t col_size = output_features_count / row_count;
 
     static std::vector<ei_impulse_result_bounding_box_t> results;
-    static std::vector<ei_impulse_result_bounding_box_t> class_results;
+    size_t box_count = 0;
     results.clear();
 
     // output shape: (num_classes + 4, num_detections) e.g. (5, 189)
     //  [0] -> (xcenter, ycenter, width, height, cls...)
     for (size_t cls_idx = 0; cls_idx < (size_t)impulse->label_count; cls_idx++)  {
-        std::vector<float> boxes;
-        std::vector<float> scores;
-        std::vector<int> classes;
-        class_results.clear();
-
         for (size_t det_idx = 0; det_idx < col_size; det_idx++) {
 
             float xcenter = (static_cast<float>(data[0 * col_size + det_idx]) - zero_point) * scale;
@@ -2264,33 +2326,25 @@ __attribute__((unused)) static EI_IMPULSE_ERROR fill_result_struct_yolov11_commo
 #endif
 
             if (score >= threshold && score <= 1.0f) {
-                boxes.push_back(ymin);
-                boxes.push_back(xmin);
-                boxes.push_back(ymax);
-                boxes.push_back(xmax);
-                scores.push_back(score);
-                classes.push_back((int)cls_idx);
+                if (!ei_nms_add_box(handle, &box_count, ymin, xmin, ymax, xmax, score, (int)cls_idx)) {
+                    return EI_IMPULSE_OUT_OF_MEMORY;
+                }
             }
         }
+    }
 
-        size_t nr_boxes = scores.size();
-
-        EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                            &class_results,
-                                            boxes.data(),
-                                            scores.data(),
-                                            classes.data(),
-                                            nr_boxes,
-                                            true /*clip_boxes*/,
-                                            &nms_config);
-
-        if (nms_res != EI_IMPULSE_OK) {
-            return nms_res;
-        }
-
-        for (auto bb: class_results) {
-            results.push_back(bb);
-        }
+    // one pass over all classes, boxes only suppress boxes of their own class
+    EI_IMPULSE_ERROR nms_res = ei_run_nms(handle,
+                                          &results,
+                                          handle->state.nms.boxes,
+                                          handle->state.nms.scores,
+                                          handle->state.nms.classes,
+                                          box_count,
+                                          true /*clip_boxes*/,
+                                          &nms_config,
+                                          true /*class_aware*/);
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
     }
 
     prepare_nms_results_common(object_detection_count, result, &results);
@@ -2317,7 +2371,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolov11_f32(ei_impulse_h
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    return fill_result_struct_yolov11_common(impulse,
+    return fill_result_struct_yolov11_common(handle,
                                              result,
                                              config->version == EI_YOLOV11_COORD_NORMALIZED,
                                              raw_output_mtx->buffer,
@@ -2351,7 +2405,7 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_yolov11_i8(ei_impulse_ha
         return EI_IMPULSE_OUTPUT_TENSOR_NULL;
     }
 
-    return fill_result_struct_yolov11_common(impulse,
+    return fill_result_struct_yolov11_common(handle,
                                              result,
                                              config->version == EI_YOLOV11_COORD_NORMALIZED,
                                              raw_output_mtx->buffer,
@@ -28,30 +28,35 @@ void print_arr(T *arr, int m, int n, const char *name = "arr") {
 #endif
 }
 
+/**
+ * Constant model of the filter (state transition, noise, observation and control matrices).
+ * It only depends on dt and the noise scales, so all filters with the same settings share one copy.
+ */
+typedef struct {
+    float F[16];
+    float Q[16];
+    float H[8];
+    float R[4];
+    float B[8];
+    float u[2];
+} TinyEKFModel;
+
+/**
+ * Allocation-free EKF. The state lives with the caller:
+ * x is TINYEKF_X_SIZE floats (4x2, position and velocity for two observed values),
+ * P is TINYEKF_P_SIZE floats (4x4 covariance).
+ */
+#define TINYEKF_X_SIZE 8
+#define TINYEKF_P_SIZE 16
+
 class TinyEKF {
 public:
-    TinyEKF(const float* x0, uint32_t EKF_N, uint32_t EKF_M,
-            float dt = 0.1,
-            float *u = nullptr,
-            float process_noise_scale = 0.1,
-            float observation_noise_scale=0.1)
-{
-        // set private variables
-        this->EKF_N = EKF_N;
-        this->EKF_M = EKF_M;
-        this->dt = dt;
-
-        x = new float[this->EKF_N];
-        memset(x, 0, sizeof(float) * this->EKF_N);
-        // x is the state
-        x[0] = x0[0];
-        x[1] = x0[1];
-        x[2] = x0[0];
-        x[3] = x0[1];
-
-        // print init x
-        print_arr(x, 1, this->EKF_N, "init x");
-
+    static void init_model(TinyEKFModel *m,
+                           float dt = 0.1,
+                           const float *u = nullptr,
+                           float process_noise_scale = 0.1,
+                           float observation_noise_scale = 0.1)
+    {
         // F is the state transition model
         // self.F = np.array(
         //     [[1, 0, self.dt, 0],
@@ -59,32 +64,24 @@ public:
         //      [0, 0, 1, 0],
         //      [0, 0, 0, 1]]
         // )
-
-        F = new float[16];
-        memset(F, 0, sizeof(float) * 16);
         for (int i = 0; i < 4; ++i) {
             for (int j = 0; j < 4; ++j) {
-                F[i * 4 + j] = (i == j) ? 1 : 0;
+                m->F[i * 4 + j] = (i == j) ? 1 : 0;
             }
         }
-        F[2] = F[7] = this->dt;
+        m->F[2] = m->F[7] = dt;
 
         // print F
-        print_arr(F, 4, 4, "init F");
+        print_arr(m->F, 4, 4, "init F");
 
         // H is the observation model
-        H = new float[8];
-        memset(H, 0, sizeof(float) * 8);
-
-        H[0] = H[5] = 1;
+        memset(m->H, 0, sizeof(m->H));
+        m->H[0] = m->H[5] = 1;
 
         // print H
-        print_arr(H, 2, 4, "init H");
+        print_arr(m->H, 2, 4, "init H");
 
         // Q is the covariance of the process noise
-        Q = new float[16];
-        memset(Q, 0, sizeof(float) * 16);
-
         // self.Q = (
         //     np.array(
         //         [
@@ -96,31 +93,28 @@ public:
         //     )
         //     * process_noise_scale**2
         // )
-
-        Q[0] = Q[5] = pow(dt, 4) / 4;
-        Q[2] = Q[7] = Q[8] = Q[13] = pow(dt, 3) / 2;
-        Q[10] = Q[15] = pow(dt, 2);
+        memset(m->Q, 0, sizeof(m->Q));
+        m->Q[0] = m->Q[5] = pow(dt, 4) / 4;
+        m->Q[2] = m->Q[7] = m->Q[8] = m->Q[13] = pow(dt, 3) / 2;
+        m->Q[10] = m->Q[15] = pow(dt, 2);
 
         for (int i = 0; i < 4; ++i) {
             for (int j = 0; j < 4; ++j) {
-                Q[i * 4 + j] = Q[i * 4 + j] * pow(process_noise_scale, 2);
+                m->Q[i * 4 + j] = m->Q[i * 4 + j] * pow(process_noise_scale, 2);
             }
         }
 
         // print Q
-        print_arr(Q, 4, 4, "init Q");
+        print_arr(m->Q, 4, 4, "init Q");
 
         // R is the covariance of the observation noise
-        R = new float[4];
-        memset(R, 0, sizeof(float) * 4);
-
         for (int i = 0; i < 2; ++i) {
             for (int j = 0; j < 2; ++j) {
-                R[i * 2 + j] = (i == j) ? (pow(observation_noise_scale, 2)) : 0;
+                m->R[i * 2 + j] = (i == j) ? (pow(observation_noise_scale, 2)) : 0;
             }
         }
         // print R
-        print_arr(R, 2, 2, "init R");
+        print_arr(m->R, 2, 2, "init R");
 
         // control-input mode
         // self.B = np.array(
@@ -129,22 +123,35 @@ public:
         //      [self.dt, 0],
         //      [0, self.dt]]
         // )
-
-        B = new float[this->EKF_N * this->EKF_N * 2];
-        memset(B, 0, sizeof(float) * this->EKF_N * this->EKF_N * 2);
-        B[0] = B[3] = (dt * dt) / 2;
-        B[4] = B[7] = dt;
+        memset(m->B, 0, sizeof(m->B));
+        m->B[0] = m->B[3] = (dt * dt) / 2;
+        m->B[4] = m->B[7] = dt;
 
         if (u == nullptr) {
-            u = new float[2];
-            u[0] = u[1] = 0.1;
+            m->u[0] = m->u[1] = 0.1;
+        }
+        else {
+            m->u[0] = u[0];
+            m->u[1] = u[1];
         }
-        this->u = u;
+    }
 
-        // P is the predict / update transition
-        P = new float[16];
-        memset(P, 0, sizeof(float) * 16);
+    /**
+     * Reset a filter state to x0 (two observed values) with identity covariance
+     */
+    static void init_state(const float *x0, float *x, float *P)
+    {
+        memset(x, 0, sizeof(float) * TINYEKF_X_SIZE);
+        // x is the state
+        x[0] = x0[0];
+        x[1] = x0[1];
+        x[2] = x0[0];
+        x[3] = x0[1];
 
+        // print init x
+        print_arr(x, 1, TINYEKF_X_SIZE, "init x");
+
+        // P is the predict / update transition
         for (int i = 0; i < 4; ++i) {
             for (int j = 0; j < 4; ++j) {
                 P[i * 4 + j] = (i == j) ? 1 : 0;
@@ -155,35 +162,11 @@ public:
         print_arr(P, 4, 4, "init P");
     }
 
-    ~TinyEKF() {
-        delete[] x;
-        delete[] P;
-        delete[] Q;
-        delete[] F;
-        delete[] H;
-        delete[] R;
-        delete[] B;
-        delete[] u;
-    }
+    static void predict(const TinyEKFModel *m, float *x, float *P);
+    static bool update(const TinyEKFModel *m, float *x, float *P, const float *z, const float *hx);
 
-    void predict(const float *fx);
-    bool update(const float *z, const float *hx);
-    float *x;
 private:
-    uint32_t EKF_N;
-    uint32_t EKF_M;
-
-    float *P;
-    float *Q;
-    float *F;
-    float *H;
-    float *R;
-
-    float *B;
-    float *u;
-    float dt;
-
-    void update_step3(float *GH);
+    static void update_step3(float *P, float *GH);
 
     /// @private
     static void _mulmat(
@@ -364,71 +347,75 @@ private:
     /// @private
     static bool invert(const float * a, float * ainv, uint32_t EKF_M)
     {
-        float tmp[EKF_M];
+        // only ever called for the 2x2 innovation covariance
+        float tmp[2];
+        if (EKF_M > 2) {
+            return false;
+        }
 
         return _cholsl(a, ainv, tmp, EKF_M) == 0;
     }
 };
 
-void TinyEKF::predict(const float *fx) {
+inline void TinyEKF::predict(const TinyEKFModel *m, float *x, float *P) {
 
     // self.x = self.F @ self.x + self.B @ self.u
 
     float Bu[4];
-    _mulmat(this->B, this->u, Bu, 4, 2, 1);
+    _mulmat(m->B, m->u, Bu, 4, 2, 1);
 
     // print Bu
     print_arr(Bu, 4, 1, "Bu");
 
     // print x before
-    print_arr(this->x, 1, 4, "x before");
+    print_arr(x, 1, 4, "x before");
 
     float Fx[8];
-    _mulmat(this->F, this->x, Fx, 4, 4, 2);
+    _mulmat(m->F, x, Fx, 4, 4, 2);
 
     // print Fx
     print_arr(Fx, 4, 2, "Fx");
     // print x after
-    print_arr(this->x, 1, 4, "x after");
-
-    //_addmat(Fx, Bu, this->x, 4, 1);
-    this->x[0] = Fx[0] + Bu[0];
-    this->x[1] = Fx[1] + Bu[1];
-    this->x[2] = Fx[2] + Bu[0];
-    this->x[3] = Fx[3] + Bu[1];
-    this->x[4] = Fx[4] + Bu[2];
-    this->x[5] = Fx[5] + Bu[3];
-    this->x[6] = Fx[6] + Bu[2];
-    this->x[7] = Fx[7] + Bu[3];
+    print_arr(x, 1, 4, "x after");
+
+    //_addmat(Fx, Bu, x, 4, 1);
+    x[0] = Fx[0] + Bu[0];
+    x[1] = Fx[1] + Bu[1];
+    x[2] = Fx[2] + Bu[0];
+    x[3] = Fx[3] + Bu[1];
+    x[4] = Fx[4] + Bu[2];
+    x[5] = Fx[5] + Bu[3];
+    x[6] = Fx[6] + Bu[2];
+    x[7] = Fx[7] + Bu[3];
 
     // this is the formula for the next part
     // self.P_pre = np.dot(F, self.P_post).dot(F.T) + Q
 
     // np.dot(F, self.P_post)
     float FP[16];
-    _mulmat(F, P, FP, 4, 4, 4);
+    _mulmat(m->F, P, FP, 4, 4, 4);
     // print FP
     print_arr(FP, 4, 4, "FP");
 
     // F.T
     float Ft[16];
-    _transpose(F, Ft, 4, 4);
+    _transpose(m->F, Ft, 4, 4);
 
     // .dot(F.T)
     float FPFt[16];
     _mulmat(FP, Ft, FPFt, 4, 4, 4);
 
     // + Q
-    _addmat(FPFt, Q, P, 4, 4);
+    _addmat(FPFt, m->Q, P, 4, 4);
 
     // print P
     print_arr(P, 4, 4, "P");
 }
 
-bool TinyEKF::update(const float *z, const float *hx) {
+inline bool TinyEKF::update(const TinyEKFModel *m, float *x, float *P, const float *z, const float *hx) {
 
     float Ht[8];
-    _transpose(H, Ht, 2, 4);
+    _transpose(m->H, Ht, 2, 4);
 
     // print Ht
     print_arr(Ht, 4, 2, "Ht");
@@ -437,13 +424,13 @@ bool TinyEKF::update(const float *z, const float *hx) {
     _mulmat(P, Ht, PHt, 4, 4, 2);
 
     float HP[8];
-    _mulmat(H, P, HP, 2, 4, 4);
+    _mulmat(m->H, P, HP, 2, 4, 4);
 
     float HpHt[4];
     _mulmat(HP, Ht, HpHt, 2, 4, 2);
 
     float HpHtR[4];
-    _addmat(HpHt, R, HpHtR, 2, 2);
+    _addmat(HpHt, m->R, HpHtR, 2, 2);
 
     float HPHtRinv[4];
     if (!invert(HpHtR, HPHtRinv, 2)) {
@@ -457,7 +444,7 @@ bool TinyEKF::update(const float *z, const float *hx) {
     print_arr(G, 4, 2, "G");
 
     // print x
-    print_arr(this->x, 1, 4, "x in update");
+    print_arr(x, 1, 4, "x in update");
 
     // we get hx as an argument to function
     float z_hx[4];
@@ -476,16 +463,16 @@ bool TinyEKF::update(const float *z, const float *hx) {
     // // print Gz_hx
     print_arr(Gz_hx, 4, 2, "Gz_hx");
 
-    _addvec(this->x, Gz_hx, this->x, 8);
+    _addvec(x, Gz_hx, x, 8);
 
     float GH[16];
-    _mulmat(G, H, GH, 4, 2, 4);
-    update_step3(GH);
+    _mulmat(G, m->H, GH, 4, 2, 4);
+    update_step3(P, GH);
     return true;
 }
 
 /// @private
-void TinyEKF::update_step3(float *GH)
+inline void TinyEKF::update_step3(float *P, float *GH)
 {
     _negate(GH, 4, 4);
     _addeye(GH, 4);
@@ -493,4 +480,4 @@ void TinyEKF::update_step3(float *GH)
     float GHP[16];
     _mulmat(GH, P, GHP, 4, 4, 4);
     memcpy(P, GHP, 16 * sizeof(float));
-}
\ No newline at end of file
+}
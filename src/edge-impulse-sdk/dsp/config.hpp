@@ -110,6 +110,18 @@
 #define EIDSP_SIGNAL_C_FN_POINTER    0
 #endif // EIDSP_SIGNAL_C_FN_POINTER
 
+// Number of mel filterbank / DCT tables that are kept between calls (built by run_classifier_init()),
+// set to 0 to rebuild the tables on every MFE / MFCC call instead
+#ifndef EIDSP_MEL_TABLE_CACHE_SIZE
+#define EIDSP_MEL_TABLE_CACHE_SIZE   4
+#endif // EIDSP_MEL_TABLE_CACHE_SIZE
+
+// Number of software (KissFFT) FFT plans an impulse handle keeps between calls (built by run_classifier_init()),
+// set to 0 to set up the twiddle factors on every rfft call instead
+#ifndef EIDSP_FFT_PLAN_CACHE_SIZE
+#define EIDSP_FFT_PLAN_CACHE_SIZE    4
+#endif // EIDSP_FFT_PLAN_CACHE_SIZE
+
 #ifndef EIDSP_USE_ESP_DSP
 #if defined(ESP32) || defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3) || defined(CONFIG_IDF_TARGET_ESP32P4) || defined(CONFIG_IDF_TARGET_ESP32C3)
 #define EIDSP_USE_ESP_DSP 1
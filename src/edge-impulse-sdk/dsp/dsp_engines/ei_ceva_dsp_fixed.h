@@ -149,6 +149,11 @@ static int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n_ff
     return EIDSP_OK;
 }
 
+// no fixed-point FFT on this engine, callers fall back to the float FFT
+static int hw_r2c_fft_q15(int16_t *input, int16_t *output, size_t n_fft) {
+    return ei::EIDSP_NO_HW_ACCEL;
+}
+
 } // namespace fft
 
 } // namespace ei
@@ -37,6 +37,7 @@
 #include <memory>
 #include "../porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/classifier/ei_shared_arena.h"
 #include "config.hpp"
 
 extern size_t ei_memory_in_use;
@@ -138,9 +139,9 @@ namespace ei {
     #define ei_dsp_register_matrix_alloc(...) (void)0
     #define ei_dsp_register_free(...) (void)0
     #define ei_dsp_register_matrix_free(...) (void)0
-    #define ei_dsp_malloc ei_malloc
-    #define ei_dsp_calloc ei_calloc
-    #define ei_dsp_free(ptr, size) ei_free(ptr)
+    #define ei_dsp_malloc ei_shared_arena_scratch_malloc
+    #define ei_dsp_calloc ei_shared_arena_scratch_calloc
+    #define ei_dsp_free(ptr, size) ei_shared_arena_free(ptr)
     #define EI_DSP_MATRIX(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_MATRIX_B(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_QUANTIZED_MATRIX(name, ...) quantized_matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
@@ -157,7 +158,7 @@ public:
      * @param size The size of the memory block, in bytes.
      */
     static void *ei_wrapped_malloc(const char *fn, const char *file, int line, size_t size) {
-        void *ptr = ei_malloc(size);
+        void *ptr = ei_shared_arena_scratch_malloc(size);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, size, ptr);
         }
@@ -171,7 +172,7 @@ public:
      * @param size Size of each element
      */
     static void *ei_wrapped_calloc(const char *fn, const char *file, int line, size_t num, size_t size) {
-        void *ptr = ei_calloc(num, size);
+        void *ptr = ei_shared_arena_scratch_calloc(num, size);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, num * size, ptr);
         }
@@ -184,7 +185,7 @@ public:
      * @param size Size of the block of memory previously allocated.
      */
     static void ei_wrapped_free(const char *fn, const char *file, int line, void *ptr, size_t size) {
-        ei_free(ptr);
+        ei_shared_arena_free(ptr);
         ei_dsp_register_free_internal(fn, file, line, size, ptr);
     }
 };
@@ -192,7 +193,7 @@ public:
 
 // This needs to be a real function so I can bind with a lambda
 __attribute__((unused)) static void ei_dsp_free_func(void *ptr, size_t size) {
-    ei_free(ptr);
+    ei_shared_arena_free(ptr);
 #if EIDSP_TRACK_ALLOCATIONS
     ei_dsp_register_free_internal("unique_ptr free", "", 0, size, ptr);
 #endif
@@ -212,7 +213,7 @@ static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size) {
     auto ptr = reinterpret_cast<void**>(ptr_in);
     *ptr = ei_dsp_malloc(size);
     return ei_unique_ptr_t(*ptr, [size](void *ptr) {
-        ei_free(ptr);
+        ei_shared_arena_free(ptr);
         ei_dsp_register_free_internal("unique_ptr", "", 0, size, ptr);
     });
 }
@@ -521,7 +521,27 @@ public:
         return EIDSP_OK;
     }
 
-    static int dct_transform(float vector[], size_t len)
+    /**
+     * Calculate the (cos, sin) pairs dct_transform() needs for a DCT over `len` values
+     * @param out Output, 2 * len values
+     * @param len Number of items the DCT runs over
+     */
+    static void dct_twiddles(float *out, size_t len)
+    {
+        for (size_t i = 0; i < len; i++) {
+            float temp = i * M_PI / (len * 2);
+            out[i * 2] = cos(temp);
+            out[i * 2 + 1] = sin(temp);
+        }
+    }
+
+    /**
+     * DCT type 2 through a real FFT of the reordered input (no scaling)
+     * @param vector Input / output array
+     * @param len Number of items in the array
+     * @param twiddles Optional table of len (cos, sin) pairs, see dct_twiddles(), computed here if nullptr
+     */
+    static int dct_transform(float vector[], size_t len, const float *twiddles = nullptr)
     {
         const size_t fft_data_out_size = (len / 2 + 1) * sizeof(ei::fft_complex_t);
         const size_t fft_data_in_size = len * sizeof(float);
@@ -557,6 +577,15 @@ public:
         }
 
         size_t i = 0;
+        if (twiddles) {
+            for (; i < len / 2 + 1; i++) {
+                vector[i] = fft_data_out[i].r * twiddles[i * 2] + fft_data_out[i].i * twiddles[i * 2 + 1];
+            }
+            for (; i < len; i++) {
+                int conj_idx = len-i;
+                vector[i] = fft_data_out[conj_idx].r * twiddles[i * 2] - fft_data_out[conj_idx].i * twiddles[i * 2 + 1];
+            }
+        }
         for (; i < len / 2 + 1; i++) {
             float temp = i * M_PI / (len * 2);
             vector[i] = fft_data_out[i].r * cos(temp) + fft_data_out[i].i * sin(temp);
@@ -578,14 +607,16 @@ public:
      * Return the Discrete Cosine Transform of arbitrary type sequence 2.
      * @param input Input array (of size N)
      * @param N number of items in input and output array
+     * @param twiddles Optional precalculated twiddles for N, see dct_twiddles()
      * @returns EIDSP_OK if OK
      */
-    static int dct2(float *input, size_t N, DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE) {
+    static int dct2(float *input, size_t N, DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE,
+        const float *twiddles = nullptr) {
         if (N == 0) {
             return EIDSP_OK;
         }
 
-        int ret = dct_transform(input, N);
+        int ret = dct_transform(input, N, twiddles);
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
@@ -608,11 +639,13 @@ public:
     /**
      * Discrete Cosine Transform of arbitrary type sequence 2 on a matrix.
      * @param matrix
+     * @param twiddles Optional precalculated twiddles for the number of columns, see dct_twiddles()
      * @returns EIDSP_OK if OK
      */
-    static int dct2(matrix_t *matrix, DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE) {
+    static int dct2(matrix_t *matrix, DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE,
+        const float *twiddles = nullptr) {
         for (size_t row = 0; row < matrix->rows; row++) {
-            int r = dct2(matrix->buffer + (row * matrix->cols), matrix->cols, normalization);
+            int r = dct2(matrix->buffer + (row * matrix->cols), matrix->cols, normalization, twiddles);
             if (r != EIDSP_OK) {
                 return r;
             }
@@ -1497,6 +1530,41 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Read int16 samples from a signal. Uses the signal's `get_data_i16` if set,
+     * otherwise reads through `get_data` and rounds / saturates the floats to int16.
+     * @param signal Signal to read from
+     * @param offset Offset in the signal
+     * @param length Number of samples to read
+     * @param out_ptr Out buffer, at least `length` samples
+     * @returns 0 if OK
+     */
+    static int signal_get_data_i16(signal_t *signal, size_t offset, size_t length, EIDSP_i16 *out_ptr)
+    {
+        if (signal->get_data_i16) {
+            return signal->get_data_i16(offset, length, out_ptr);
+        }
+
+        float chunk[32];
+        while (length > 0) {
+            size_t n = length < 32 ? length : 32;
+            int ret = signal->get_data(offset, n, chunk);
+            if (ret != EIDSP_OK) {
+                return ret;
+            }
+            for (size_t ix = 0; ix < n; ix++) {
+                float v = roundf(chunk[ix]);
+                if (v > 32767.0f) v = 32767.0f;
+                else if (v < -32768.0f) v = -32768.0f;
+                out_ptr[ix] = static_cast<EIDSP_i16>(v);
+            }
+            offset += n;
+            out_ptr += n;
+            length -= n;
+        }
+        return EIDSP_OK;
+    }
+
 #if EIDSP_SIGNAL_C_FN_POINTER == 0
     /**
      * Create a signal structure from a buffer.
@@ -1784,9 +1852,138 @@ public:
         return EIDSP_OK;
     }
 
+    typedef struct {
+        size_t n_fft;               // 0 if the plan is free
+        kiss_fftr_cfg cfg;          // nullptr until software_rfft() needs it
+        size_t mem_length;
+    } fft_plan_t;
+
+    /**
+     * Software FFT plans, one per FFT length. Kept on the impulse handle
+     * (ei_impulse_state_t::fft_plans) and filled in by build_fft_plan().
+     */
+    typedef struct {
+        fft_plan_t plans[EIDSP_FFT_PLAN_CACHE_SIZE > 0 ? EIDSP_FFT_PLAN_CACHE_SIZE : 1];
+    } fft_plans_t;
+
+    /**
+     * Active set of FFT plans, see use_fft_plans()
+     */
+    static fft_plans_t *&active_fft_plans()
+    {
+        static fft_plans_t *plans = nullptr;
+        return plans;
+    }
+
+    /**
+     * Let software_rfft() use (and fill in) `plans`, pass nullptr to stop using them.
+     * run_classifier makes the plans of the impulse handle active while its DSP blocks run.
+     * @returns the plans that were active before
+     */
+    static fft_plans_t *use_fft_plans(fft_plans_t *plans)
+    {
+        fft_plans_t *prev = active_fft_plans();
+        active_fft_plans() = plans;
+        return prev;
+    }
+
+    static fft_plan_t *find_fft_plan(fft_plans_t *plans, size_t n_fft)
+    {
+        if (!plans) {
+            return nullptr;
+        }
+        for (size_t ix = 0; ix < EIDSP_FFT_PLAN_CACHE_SIZE; ix++) {
+            if (plans->plans[ix].n_fft == n_fft) {
+                return &plans->plans[ix];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Drop all plans in `plans` and free their KissFFT configs
+     */
+    static void free_fft_plans(fft_plans_t *plans)
+    {
+        for (size_t ix = 0; ix < EIDSP_FFT_PLAN_CACHE_SIZE; ix++) {
+            fft_plan_t *plan = &plans->plans[ix];
+            if (plan->cfg) {
+                ei_dsp_free(plan->cfg, plan->mem_length);
+            }
+            plan->cfg = nullptr;
+            plan->mem_length = 0;
+            plan->n_fft = 0;
+        }
+    }
+
+    /**
+     * Keep the software FFT plan (KissFFT twiddle factors) for `n_fft` in `plans` between rfft() calls.
+     * Does nothing if `plans` already has it. The plan is only built when the FFT of this size
+     * doesn't run on the hardware FFT.
+     * @returns EIDSP_OK if OK (or EIDSP_FFT_PLAN_CACHE_SIZE is 0), EIDSP_OUT_OF_MEM if `plans` is full
+     */
+    static int build_fft_plan(fft_plans_t *plans, size_t n_fft)
+    {
+#if (EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)) && EIDSP_FFT_PLAN_CACHE_SIZE > 0
+        if (n_fft == 0) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        if (find_fft_plan(plans, n_fft)) {
+            return EIDSP_OK;
+        }
+
+        fft_plan_t *plan = find_fft_plan(plans, 0);
+        if (!plan) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        plan->n_fft = n_fft;
+        plan->cfg = nullptr;
+
+        // run one transform, software_rfft() fills in the plan if this size falls back to software
+        EI_DSP_MATRIX(fft_input, 1, n_fft);
+        EI_DSP_MATRIX(fft_output, 1, (n_fft / 2 + 1) * 2);
+        if (!fft_input.buffer || !fft_output.buffer) {
+            plan->n_fft = 0;
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        fft_plans_t *prev = use_fft_plans(plans);
+        int ret = rfft(fft_input.buffer, n_fft, (fft_complex_t*)fft_output.buffer, n_fft / 2 + 1, n_fft);
+        use_fft_plans(prev);
+        if (ret != EIDSP_OK) {
+            if (plan->cfg) {
+                ei_dsp_free(plan->cfg, plan->mem_length);
+            }
+            plan->cfg = nullptr;
+            plan->n_fft = 0;
+            EIDSP_ERR(ret);
+        }
+        return EIDSP_OK;
+#else
+        // caching is disabled
+        return EIDSP_OK;
+#endif
+    }
+
     static int software_rfft(float *fft_input, fft_complex_t *output, size_t n_fft, size_t n_fft_out_features)
     {
     #if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
+    #if EIDSP_FFT_PLAN_CACHE_SIZE > 0
+        fft_plan_t *plan = find_fft_plan(active_fft_plans(), n_fft);
+        if (plan) {
+            if (!plan->cfg) {
+                plan->cfg = kiss_fftr_alloc(n_fft, 0, NULL, NULL, &plan->mem_length);
+                if (!plan->cfg) {
+                    EIDSP_ERR(EIDSP_OUT_OF_MEM);
+                }
+                ei_dsp_register_alloc(plan->mem_length, plan->cfg);
+            }
+
+            kiss_fftr(plan->cfg, fft_input, (kiss_fft_cpx*)output);
+            return EIDSP_OK;
+        }
+    #endif // EIDSP_FFT_PLAN_CACHE_SIZE > 0
+
         // create fftr context
         size_t kiss_fftr_mem_length;
 
@@ -1862,6 +2059,96 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Power spectrum of an int16 frame, using the fixed-point FFT of the DSP engine if there is one.
+     * The frame is scaled up (block floating point) so its peak uses the full q15 range before the FFT.
+     * `out_buffer[ix] * fft_points / 2^(2 * out_shift)` is the power spectrum of the frame
+     * (same scale as `power_spectrum()`).
+     * @param frame Row of a frame
+     * @param frame_size Size of the frame
+     * @param out_buffer Out buffer, size should be fft_points / 2 + 1
+     * @param out_buffer_size Buffer size
+     * @param fft_points (int): The length of FFT. If fft_length is greater than frame_len, the frames will be zero-padded.
+     * @param fft_buffer Working memory, 3 * fft_points values
+     * @param out_shift Set to the number of bits the frame was scaled up with
+     * @returns EIDSP_OK if OK
+     */
+    static int power_spectrum_q15(
+        const EIDSP_i16 *frame,
+        size_t frame_size,
+        uint32_t *out_buffer,
+        size_t out_buffer_size,
+        uint16_t fft_points,
+        EIDSP_i16 *fft_buffer,
+        int *out_shift)
+    {
+        if (out_buffer_size != static_cast<size_t>(fft_points / 2 + 1)) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (frame_size > fft_points) {
+            frame_size = fft_points;
+        }
+
+        EIDSP_i16 *fft_input = fft_buffer;
+        EIDSP_i16 *fft_output = fft_buffer + fft_points;
+
+        int32_t peak = 0;
+        for (size_t ix = 0; ix < frame_size; ix++) {
+            int32_t v = frame[ix] < 0 ? -static_cast<int32_t>(frame[ix]) : frame[ix];
+            if (v > peak) {
+                peak = v;
+            }
+        }
+
+        int shift = 0;
+        if (peak > 0) {
+            while (shift < 15 && (peak << (shift + 1)) <= INT16_MAX) {
+                shift++;
+            }
+        }
+        *out_shift = shift;
+
+        for (size_t ix = 0; ix < frame_size; ix++) {
+            fft_input[ix] = static_cast<EIDSP_i16>(static_cast<int32_t>(frame[ix]) * (1 << shift));
+        }
+        memset(fft_input + frame_size, 0, (fft_points - frame_size) * sizeof(EIDSP_i16));
+
+        auto res = ei::fft::hw_r2c_fft_q15(fft_input, fft_output, fft_points);
+        if (!handle_fft_hw_failure(res, fft_points)) {
+            for (size_t ix = 0; ix < out_buffer_size; ix++) {
+                int32_t re = fft_output[ix * 2];
+                int32_t im = fft_output[ix * 2 + 1];
+                out_buffer[ix] = static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im);
+            }
+            return EIDSP_OK;
+        }
+
+        // no fixed-point FFT, go through the float one (downscaled by fft_points, like the q15 FFT)
+        EI_DSP_MATRIX(fft_input_f, 1, frame_size);
+        if (!fft_input_f.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        int16_to_float(fft_input, fft_input_f.buffer, frame_size);
+
+        fft_complex_t *fft_output_f = NULL;
+        auto ptr = EI_MAKE_TRACKED_POINTER(fft_output_f, out_buffer_size);
+        EI_ERR_AND_RETURN_ON_NULL(fft_output_f, EIDSP_OUT_OF_MEM);
+
+        int ret = rfft(fft_input_f.buffer, frame_size, fft_output_f, out_buffer_size, fft_points);
+        if (ret != EIDSP_OK) {
+            return ret;
+        }
+
+        const float scale = 1.0f / (static_cast<float>(fft_points) * static_cast<float>(fft_points));
+        for (size_t ix = 0; ix < out_buffer_size; ix++) {
+            float p = (fft_output_f[ix].r * fft_output_f[ix].r + fft_output_f[ix].i * fft_output_f[ix].i) * scale;
+            out_buffer[ix] = p >= 4294967295.0f ? UINT32_MAX : static_cast<uint32_t>(p + 0.5f);
+        }
+
+        return EIDSP_OK;
+    }
+
     static int welch_max_hold(
         float *input,
         size_t input_size,
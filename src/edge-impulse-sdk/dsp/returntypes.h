@@ -81,6 +81,7 @@ typedef enum {
     EI_IMPULSE_POSTPROCESSING_THRESHOLD_KEY_NOT_FOUND = -34, /**< Trying to set a threshold whose key cannot be found */
     EI_IMPULSE_CALL_SIGNATURE_REMOVED = -35, /**< This function has been removed, on GCC this will error out at compile time (with a migration message), but not all compilers support this */
     EI_IMPULSE_NORDIC_AXON_ERROR = -36, /**< Error in Nordic Axon inferencing engine */
+    EI_IMPULSE_CONTINUOUS_HEAP_ALLOCATION = -37, /**< process_impulse_continuous() allocated on the heap after run_classifier_init() (only with EI_CLASSIFIER_CHECK_CONTINUOUS_ALLOCATIONS) */
 } EI_IMPULSE_ERROR;
 
 #endif // _EIDSP_RETURN_TYPES_H_
@@ -43,6 +43,34 @@
 namespace ei {
 namespace speechpy {
 
+/**
+ * Mel filterbank in sparse form, plus the DCT twiddles for MFCC over the same number of filters.
+ * Filter i covers the power spectrum bins filter_start[i] up to (not including)
+ * filter_start[i] + weight_offset[i + 1] - weight_offset[i], its weights start at weights[weight_offset[i]].
+ * Built by feature::build_mel_table(), or declared const (e.g. dumped from a built table)
+ * so it lives in flash, see feature::register_mel_table().
+ */
+typedef struct {
+    // parameters the table was built for
+    uint16_t num_filters;
+    uint16_t fft_length;
+    uint32_t sampling_frequency;
+    uint32_t low_frequency;
+    uint32_t high_frequency;
+    uint16_t version;               // 3 for anything before v4 (same table), see feature::mel_table_version()
+    bool legacy_filterbank;         // weights of feature::filterbanks() (mfe_v3), otherwise of mfe()
+
+    const uint16_t *filter_start;   // num_filters, first bin of every filter
+    const uint16_t *filter_middle;  // num_filters, bin with weight 1.0
+    const uint16_t *weight_offset;  // num_filters + 1
+    const float *weights;
+    const uint16_t *weights_q15;    // same weights in q15 (1.0 is 32768), not used for legacy_filterbank
+    const float *dct_twiddles;      // num_filters (cos, sin) pairs, see numpy::dct_twiddles()
+
+    void *buffer;                   // allocation holding the arrays above, nullptr for const tables
+    size_t buffer_size;
+} mel_table_t;
+
 class feature {
 public:
     /**
@@ -193,6 +221,382 @@ public:
         return static_cast<int>(floor((fft_size + 1) * hertz / sampling_freq));
     }
 
+    /**
+     * Calculate the FFT bins of the mel filter edges (filter i spans bins[i] .. bins[i + 2],
+     * with its peak at bins[i + 1]).
+     * @param mels Working memory of num_filters + 2 floats, reused to hold the bins
+     * @param num_filters Number of filters in the filterbank
+     * @param fft_length Number of FFT points
+     * @param sampling_frequency In Hz
+     * @param low_frequency Lowest band edge of the mel filters in Hz
+     * @param high_frequency Highest band edge of the mel filters in Hz
+     * @param version Implementation version of the DSP block
+     * @returns The num_filters + 2 bins (aliases `mels`)
+     */
+    static uint16_t *calculate_mel_bins(float *mels, uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version)
+    {
+        const int MELS_SIZE = num_filters + 2;
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
+
+        numpy::linspace(
+            functions::frequency_to_mel(static_cast<float>(low_frequency)),
+            functions::frequency_to_mel(static_cast<float>(high_frequency)),
+            num_filters + 2,
+            mels);
+
+        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
+        // go to -1 size b/c special handling, see after
+        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
+            mels[ix] = functions::mel_to_frequency(mels[ix]);
+            if (mels[ix] < low_frequency) {
+                mels[ix] = low_frequency;
+            }
+            if (mels[ix] > high_frequency) {
+                mels[ix] = high_frequency;
+            }
+            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
+        }
+
+        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
+        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
+        // thus calculating the bucket to 64, not 65.
+        // we're adjusting this here a tiny bit to ensure we have the same result
+        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
+        if (mels[MELS_SIZE-1] > high_frequency) {
+            mels[MELS_SIZE-1] = high_frequency;
+        }
+        mels[MELS_SIZE-1] -= 0.001;
+        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+
+        return bins;
+    }
+
+    /**
+     * Implementation version as far as the mel table is concerned, only v4 changed the filter edges
+     */
+    static uint16_t mel_table_version(uint16_t version, bool legacy_filterbank)
+    {
+        return (legacy_filterbank || version < 4) ? 3 : 4;
+    }
+
+    /**
+     * Fill in the default band edges, the same way mfe() (or mfe_v3() for legacy_filterbank) does
+     */
+    static void mel_table_frequencies(uint32_t sampling_frequency, uint16_t version, bool legacy_filterbank,
+        uint32_t *low_frequency, uint32_t *high_frequency)
+    {
+        if (*high_frequency == 0) {
+            *high_frequency = sampling_frequency / 2;
+        }
+        if ((legacy_filterbank || version < 4) && *low_frequency == 0) {
+            *low_frequency = 300;
+        }
+    }
+
+    /**
+     * Build the sparse mel filterbank and DCT twiddles for a set of MFE / MFCC parameters.
+     * Free the table with free_mel_table().
+     * @param table Output
+     * @param legacy_filterbank Use the (quantized, if EIDSP_QUANTIZE_FILTERBANK) weights
+     *     of filterbanks() that mfe_v3() uses, rather than the ones of mfe()
+     * @returns EIDSP_OK if OK
+     */
+    static int build_mel_table(mel_table_t *table, uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+        memset(table, 0, sizeof(mel_table_t));
+
+        if (num_filters == 0 || sampling_frequency == 0) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        mel_table_frequencies(sampling_frequency, version, legacy_filterbank, &low_frequency, &high_frequency);
+        version = mel_table_version(version, legacy_filterbank);
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+        const int MELS_SIZE = num_filters + 2;
+        const size_t mem_size = MELS_SIZE * sizeof(float);
+        float *mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
+        EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
+        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
+        // (filterbanks() puts the bins like calculate_mel_bins() does before v4)
+        uint16_t* bins = calculate_mel_bins(mels, num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version);
+
+        // non-zero weights: everything between the edges of a filter, and its middle
+        // (filterbanks() has no weight at all when left, middle and right are the same bin)
+        size_t n_weights = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            if (bins[i + 2] >= power_spectrum_frame_size) {
+                EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+            }
+            if (legacy_filterbank && bins[i] == bins[i + 2]) {
+                continue;
+            }
+            size_t start = bins[i] < bins[i + 1] ? bins[i] + 1 : bins[i + 1];
+            size_t end = bins[i + 1] < bins[i + 2] ? bins[i + 2] : bins[i + 1] + 1;
+            n_weights += end - start;
+        }
+        if (n_weights > UINT16_MAX) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        // floats first, so everything is aligned
+        const size_t buffer_size = (n_weights + 2 * num_filters) * sizeof(float) +
+            (3 * num_filters + 1 + n_weights) * sizeof(uint16_t);
+        uint8_t *buffer = (uint8_t*)ei_dsp_calloc(buffer_size, 1);
+        EI_ERR_AND_RETURN_ON_NULL(buffer, EIDSP_OUT_OF_MEM);
+
+        float *weights = (float*)buffer;
+        float *dct_twiddles = weights + n_weights;
+        uint16_t *filter_start = (uint16_t*)(dct_twiddles + 2 * num_filters);
+        uint16_t *filter_middle = filter_start + num_filters;
+        uint16_t *weight_offset = filter_middle + num_filters;
+        uint16_t *weights_q15 = weight_offset + num_filters + 1;
+
+        size_t offset = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            size_t left = bins[i];
+            size_t middle = bins[i+1];
+            size_t right = bins[i+2];
+
+            filter_start[i] = left < middle ? left + 1 : middle;
+            filter_middle[i] = middle;
+            weight_offset[i] = offset;
+
+            if (legacy_filterbank && left == right) {
+                continue;
+            }
+
+            size_t end = middle < right ? right : middle + 1;
+            for (size_t bin = filter_start[i]; bin < end; bin++, offset++) {
+                float weight;
+                if (bin < middle) {
+                    weight = (static_cast<float>(bin) - left) / (middle - left);
+                    weights_q15[offset] = ((bin - left) << 15) / (middle - left);
+                }
+                else if (bin > middle) {
+                    weight = (right - static_cast<float>(bin)) / (right - middle);
+                    weights_q15[offset] = ((right - bin) << 15) / (right - middle);
+                }
+                else {
+                    weight = 1.0f;
+                    weights_q15[offset] = 1 << 15;
+                }
+#if EIDSP_QUANTIZE_FILTERBANK
+                if (legacy_filterbank) {
+                    weight = numpy::dequantize_zero_one(numpy::quantize_zero_one(weight));
+                }
+#endif
+                weights[offset] = weight;
+            }
+        }
+        weight_offset[num_filters] = offset;
+
+        numpy::dct_twiddles(dct_twiddles, num_filters);
+
+        table->num_filters = num_filters;
+        table->fft_length = fft_length;
+        table->sampling_frequency = sampling_frequency;
+        table->low_frequency = low_frequency;
+        table->high_frequency = high_frequency;
+        table->version = version;
+        table->legacy_filterbank = legacy_filterbank;
+        table->filter_start = filter_start;
+        table->filter_middle = filter_middle;
+        table->weight_offset = weight_offset;
+        table->weights = weights;
+        table->weights_q15 = weights_q15;
+        table->dct_twiddles = dct_twiddles;
+        table->buffer = buffer;
+        table->buffer_size = buffer_size;
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Free a table built by build_mel_table(), does nothing for const tables
+     */
+    static void free_mel_table(mel_table_t *table)
+    {
+        if (table->buffer) {
+            ei_dsp_free(table->buffer, table->buffer_size);
+        }
+        memset(table, 0, sizeof(mel_table_t));
+    }
+
+    static bool mel_table_matches(const mel_table_t *table, uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+        return table->num_filters == num_filters && table->fft_length == fft_length &&
+            table->sampling_frequency == sampling_frequency && table->low_frequency == low_frequency &&
+            table->high_frequency == high_frequency && table->version == version &&
+            table->legacy_filterbank == legacy_filterbank;
+    }
+
+#if EIDSP_MEL_TABLE_CACHE_SIZE > 0
+    typedef struct {
+        const mel_table_t *table;   // nullptr if the entry is free
+        mel_table_t built;          // storage for tables built by acquire_mel_table()
+        uint32_t refs;
+        bool registered;            // registered tables are never released
+    } mel_table_cache_entry_t;
+
+    static mel_table_cache_entry_t *mel_table_cache()
+    {
+        static mel_table_cache_entry_t cache[EIDSP_MEL_TABLE_CACHE_SIZE];
+        return cache;
+    }
+
+    static mel_table_cache_entry_t *find_mel_table_entry(uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+        mel_table_frequencies(sampling_frequency, version, legacy_filterbank, &low_frequency, &high_frequency);
+        version = mel_table_version(version, legacy_filterbank);
+
+        mel_table_cache_entry_t *cache = mel_table_cache();
+        for (size_t ix = 0; ix < EIDSP_MEL_TABLE_CACHE_SIZE; ix++) {
+            if (cache[ix].table && mel_table_matches(cache[ix].table, num_filters, fft_length,
+                    sampling_frequency, low_frequency, high_frequency, version, legacy_filterbank)) {
+                return &cache[ix];
+            }
+        }
+        return nullptr;
+    }
+#endif // EIDSP_MEL_TABLE_CACHE_SIZE > 0
+
+    /**
+     * Look up the cached table for these parameters
+     * @returns The table, or nullptr if it's not cached
+     */
+    static const mel_table_t *find_mel_table(uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+#if EIDSP_MEL_TABLE_CACHE_SIZE > 0
+        mel_table_cache_entry_t *entry = find_mel_table_entry(num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, legacy_filterbank);
+        return entry ? entry->table : nullptr;
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * Build (or take another reference to) the cached table for these parameters,
+     * so mfe() / mfcc() don't have to build it on every call. Release with release_mel_table().
+     * @returns EIDSP_OK if OK (or EIDSP_MEL_TABLE_CACHE_SIZE is 0), EIDSP_OUT_OF_MEM if the cache is full
+     */
+    static int acquire_mel_table(uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+#if EIDSP_MEL_TABLE_CACHE_SIZE > 0
+        mel_table_cache_entry_t *entry = find_mel_table_entry(num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, legacy_filterbank);
+        if (entry) {
+            entry->refs++;
+            return EIDSP_OK;
+        }
+
+        mel_table_cache_entry_t *cache = mel_table_cache();
+        for (size_t ix = 0; ix < EIDSP_MEL_TABLE_CACHE_SIZE; ix++) {
+            if (cache[ix].table) {
+                continue;
+            }
+            int ret = build_mel_table(&cache[ix].built, num_filters, fft_length, sampling_frequency,
+                low_frequency, high_frequency, version, legacy_filterbank);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+            cache[ix].table = &cache[ix].built;
+            cache[ix].refs = 1;
+            cache[ix].registered = false;
+            return EIDSP_OK;
+        }
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+#else
+        // caching is disabled
+        return EIDSP_OK;
+#endif
+    }
+
+    /**
+     * Drop a reference taken with acquire_mel_table(), the table is freed with the last one
+     */
+    static void release_mel_table(uint16_t num_filters, uint16_t fft_length,
+        uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency, uint16_t version,
+        bool legacy_filterbank)
+    {
+#if EIDSP_MEL_TABLE_CACHE_SIZE > 0
+        mel_table_cache_entry_t *entry = find_mel_table_entry(num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, legacy_filterbank);
+        if (!entry || entry->registered || entry->refs == 0) {
+            return;
+        }
+        if (--entry->refs == 0) {
+            free_mel_table(&entry->built);
+            entry->table = nullptr;
+        }
+#endif
+    }
+
+    /**
+     * Add a const (flash resident) table to the cache, e.g. the arrays of a table built by
+     * build_mel_table() for the model, dumped into the firmware. The table must stay valid.
+     * @returns EIDSP_OK if OK, EIDSP_OUT_OF_MEM if the cache is full
+     */
+    static int register_mel_table(const mel_table_t *table)
+    {
+#if EIDSP_MEL_TABLE_CACHE_SIZE > 0
+        if (find_mel_table(table->num_filters, table->fft_length, table->sampling_frequency,
+                table->low_frequency, table->high_frequency, table->version, table->legacy_filterbank)) {
+            return EIDSP_OK;
+        }
+
+        mel_table_cache_entry_t *cache = mel_table_cache();
+        for (size_t ix = 0; ix < EIDSP_MEL_TABLE_CACHE_SIZE; ix++) {
+            if (!cache[ix].table) {
+                cache[ix].table = table;
+                cache[ix].refs = 0;
+                cache[ix].registered = true;
+                return EIDSP_OK;
+            }
+        }
+#endif
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+
+    /**
+     * The cached table for these parameters, or else a table built into `tmp` just for this call
+     * (the caller frees `tmp->buffer`, which stays nullptr if the cached table was used)
+     */
+    static int get_mel_table(const mel_table_t **table, mel_table_t *tmp, uint16_t num_filters,
+        uint16_t fft_length, uint32_t sampling_frequency, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version, bool legacy_filterbank)
+    {
+        memset(tmp, 0, sizeof(mel_table_t));
+
+        *table = find_mel_table(num_filters, fft_length, sampling_frequency, low_frequency, high_frequency,
+            version, legacy_filterbank);
+        if (*table) {
+            return EIDSP_OK;
+        }
+
+        int ret = build_mel_table(tmp, num_filters, fft_length, sampling_frequency, low_frequency,
+            high_frequency, version, legacy_filterbank);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+        *table = tmp;
+        return EIDSP_OK;
+    }
+
     /**
      * Compute Mel-filterbank energy features from an audio signal.
      * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
@@ -267,47 +671,17 @@ public:
         }
 
         const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
-        // Computing the Mel filterbank
-        // converting the upper and lower frequencies to Mels.
-        // num_filter + 2 is because for num_filter filterbanks we need
-        // num_filter+2 point.
-        float *mels;
-        const int MELS_SIZE = num_filters + 2;
-        const size_t mem_size = MELS_SIZE * sizeof(float);
-        mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
-        EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
-        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
-        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
-
-        numpy::linspace(
-            functions::frequency_to_mel(static_cast<float>(low_frequency)),
-            functions::frequency_to_mel(static_cast<float>(high_frequency)),
-            num_filters + 2,
-            mels);
-
-        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
-        // go to -1 size b/c special handling, see after
-        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
-            mels[ix] = functions::mel_to_frequency(mels[ix]);
-            if (mels[ix] < low_frequency) {
-                mels[ix] = low_frequency;
-            }
-            if (mels[ix] > high_frequency) {
-                mels[ix] = high_frequency;
-            }
-            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
-        }
-
-        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
-        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
-        // thus calculating the bucket to 64, not 65.
-        // we're adjusting this here a tiny bit to ensure we have the same result
-        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
-        if (mels[MELS_SIZE-1] > high_frequency) {
-            mels[MELS_SIZE-1] = high_frequency;
+        // the mel filterbank, cached by run_classifier_init() or built just for this call
+        mel_table_t tmp_table;
+        const mel_table_t *table;
+        ret = get_mel_table(&table, &tmp_table, num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, false);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
         }
-        mels[MELS_SIZE-1] -= 0.001;
-        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+        const size_t tmp_table_size = tmp_table.buffer_size;
+        ei_unique_ptr_t __table_ptr__(tmp_table.buffer,
+            [tmp_table_size](void* ptr){ei::ei_dsp_free_func(ptr, tmp_table_size);});
 
         EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
         if (!power_spectrum_frame.buffer) {
@@ -358,36 +732,256 @@ public:
 
             auto row_ptr = out_features->get_row_ptr(ix);
             for (size_t i = 0; i < num_filters; i++) {
-                size_t left = bins[i];
-                size_t middle = bins[i+1];
-                size_t right = bins[i+2];
+                // only the non-zero weights of the filter are in the table
+                const size_t start = table->filter_start[i];
+                const size_t middle = table->filter_middle[i];
+                const size_t end = start + table->weight_offset[i + 1] - table->weight_offset[i];
+                const float *weights = table->weights + table->weight_offset[i];
 
-                assert(right < power_spectrum_frame_size);
-                // now we have weights and locations to move from fft to mel sgram
-                // both left and right become zero weights, so skip them
-
-                // middle always has weight of 1.0
-                // since we skip left and right, if left = middle we need to handle that
+                // middle always has weight of 1.0, add it first
                 row_ptr[i] = power_spectrum_frame.buffer[middle];
 
-                for (size_t bin = left+1; bin < right; bin++) {
-                    if (bin < middle) {
-                        row_ptr[i] +=
-                            ((static_cast<float>(bin) - left) / (middle - left)) * // weight *
-                            power_spectrum_frame.buffer[bin];
+                for (size_t bin = start; bin < middle; bin++) {
+                    row_ptr[i] += weights[bin - start] * power_spectrum_frame.buffer[bin];
+                }
+                for (size_t bin = middle + 1; bin < end; bin++) {
+                    row_ptr[i] += weights[bin - start] * power_spectrum_frame.buffer[bin];
+                }
+            }
+
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+        }
+
+        numpy::zero_handling(out_features);
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Compute Mel-filterbank energy features from an int16 audio signal, in fixed point.
+     * Frames, FFT and filterbank are computed on int16 / integer data (q15 FFT when the DSP
+     * engine has one), only the filterbank energies of each frame are converted to float.
+     * Matches `mfe()` up to quantization error.
+     * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
+     * @param out_energies A matrix in the form of Mx1 where M is the rows from `calculate_mfe_buffer_size`
+     * @param signal: audio signal, read through `get_data_i16` (or converted from `get_data`)
+     * @param signal_scale: value of one int16 step of the signal, in the units `mfe()` would see it
+     * @param pre_shift: preemphasis shift, see `processing::preemphasis`
+     * @param pre_cof: preemphasis coefficient, 0 to disable. Applied per frame in 32 bits,
+     *     so no precision is lost to an int16 preemphasized signal.
+     * @param sampling_frequency (int): the sampling frequency of the signal
+     *     we are working with.
+     * @param frame_length (float): the length of each frame in seconds.
+     *     Default is 0.020s
+     * @param frame_stride (float): the step between successive frames in seconds.
+     *     Default is 0.02s (means no overlap)
+     * @param num_filters (int): the number of filters in the filterbank,
+     *     default 40.
+     * @param fft_length (int): number of FFT points. Default is 512.
+     * @param low_frequency (int): lowest band edge of mel filters.
+     *     In Hz, default is 0.
+     * @param high_frequency (int): highest band edge of mel filters.
+     *     In Hz, default is samplerate/2
+     * @param pre_history: the `pre_shift` samples before the signal (continuous mode), or nullptr
+     *     to preemphasize the start of the signal against its end
+     * @EIDSP_OK if OK
+     */
+    static int mfe_q15(matrix_t *out_features, matrix_t *out_energies,
+        signal_t *signal, float signal_scale, int pre_shift, float pre_cof,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version, const EIDSP_i16 *pre_history = nullptr
+        )
+    {
+        int ret = 0;
+
+        if (high_frequency == 0) {
+            high_frequency = sampling_frequency / 2;
+        }
+
+        if (version<4) {
+            if (low_frequency == 0) {
+                low_frequency = 300;
+            }
+        }
+
+        // stack_frames trims the signal to whole frames, the preemphasis wraps around the full signal
+        const size_t signal_total_length = signal->total_length;
+
+        stack_frames_info_t stack_frame_info = { 0 };
+        stack_frame_info.signal = signal;
+
+        ret = processing::stack_frames(
+            &stack_frame_info,
+            sampling_frequency,
+            frame_length,
+            frame_stride,
+            false,
+            version
+        );
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (num_filters != out_features->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (out_energies) {
+            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+                EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+            }
+        }
+
+        memset(out_features->buffer, 0, out_features->rows * out_features->cols * sizeof(float));
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+
+        mel_table_t tmp_table;
+        const mel_table_t *table;
+        ret = get_mel_table(&table, &tmp_table, num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, false);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+        const size_t tmp_table_size = tmp_table.buffer_size;
+        ei_unique_ptr_t __table_ptr__(tmp_table.buffer,
+            [tmp_table_size](void* ptr){ei::ei_dsp_free_func(ptr, tmp_table_size);});
+
+        uint32_t *power_spectrum_frame = nullptr;
+        auto power_spectrum_ptr = EI_MAKE_TRACKED_POINTER(power_spectrum_frame, power_spectrum_frame_size);
+        EI_ERR_AND_RETURN_ON_NULL(power_spectrum_frame, EIDSP_OUT_OF_MEM);
+
+        if (pre_cof == 0.0f || pre_shift < 0) {
+            pre_shift = 0;
+        }
+        // q15, capped so the preemphasis below can't overflow int32
+        int32_t pre_cof_q15 = static_cast<int32_t>(pre_cof * 32768.0f + 0.5f);
+        if (pre_cof_q15 > INT16_MAX) {
+            pre_cof_q15 = INT16_MAX;
+        }
+
+        // the `pre_shift` samples before the frame, followed by the frame
+        EIDSP_i16 *history_frame = nullptr;
+        auto history_frame_ptr = EI_MAKE_TRACKED_POINTER(history_frame, (pre_shift + stack_frame_info.frame_length));
+        EI_ERR_AND_RETURN_ON_NULL(history_frame, EIDSP_OUT_OF_MEM);
+        EIDSP_i16 *signal_frame = history_frame + pre_shift;
+
+        EIDSP_i16 *fft_buffer = nullptr;
+        auto fft_buffer_ptr = EI_MAKE_TRACKED_POINTER(fft_buffer, 3 * fft_length);
+        EI_ERR_AND_RETURN_ON_NULL(fft_buffer, EIDSP_OUT_OF_MEM);
+
+        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+            // don't read outside of the audio buffer... zero pad instead
+            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_length = stack_frame_info.frame_length;
+            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
+                signal_length = stack_frame_info.signal->total_length - signal_offset;
+                memset(signal_frame + signal_length, 0,
+                    (stack_frame_info.frame_length - signal_length) * sizeof(EIDSP_i16));
+            }
+
+            ret = numpy::signal_get_data_i16(stack_frame_info.signal, signal_offset, signal_length, signal_frame);
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+
+            // preemphasis, like processing::preemphasis the start of the signal wraps to its end
+            // (or continues from pre_history)
+            int pre_exp = 0;
+            if (pre_shift > 0) {
+                for (int i = 0; i < pre_shift; i++) {
+                    if (pre_history && signal_offset + i < static_cast<size_t>(pre_shift)) {
+                        history_frame[i] = pre_history[signal_offset + i];
+                        continue;
                     }
-                    // intentionally skip middle, handled above
-                    if (bin > middle) {
-                        row_ptr[i] +=
-                            ((right - static_cast<float>(bin)) / (right - middle)) * // weight *
-                            power_spectrum_frame.buffer[bin];
+                    size_t hist_offset = (signal_offset + signal_total_length - pre_shift + i) % signal_total_length;
+                    ret = numpy::signal_get_data_i16(stack_frame_info.signal, hist_offset, 1, &history_frame[i]);
+                    if (ret != 0) {
+                        EIDSP_ERR(ret);
                     }
                 }
+
+                // x * 2^15 - cof * prev, then scale the frame down just enough to fit int16
+                int32_t peak = 0;
+                for (size_t i = 0; i < signal_length; i++) {
+                    int32_t v = static_cast<int32_t>(signal_frame[i]) * 32768 - pre_cof_q15 * history_frame[i];
+                    v = v < 0 ? -v : v;
+                    if (v > peak) {
+                        peak = v;
+                    }
+                }
+                pre_exp = 17;
+                while (pre_exp > 0 && (peak >> (pre_exp - 1)) < INT16_MAX) {
+                    pre_exp--;
+                }
+                const int64_t half = pre_exp > 0 ? 1 << (pre_exp - 1) : 0;
+                // walk backwards, so history_frame[i] still holds the raw sample
+                for (size_t i = signal_length; i-- > 0; ) {
+                    int32_t v = static_cast<int32_t>(signal_frame[i]) * 32768 - pre_cof_q15 * history_frame[i];
+                    signal_frame[i] = static_cast<EIDSP_i16>((v + half) >> pre_exp);
+                }
+                pre_exp -= 15;
             }
 
+            int shift;
+            ret = numpy::power_spectrum_q15(
+                signal_frame,
+                stack_frame_info.frame_length,
+                power_spectrum_frame,
+                power_spectrum_frame_size,
+                fft_length,
+                fft_buffer,
+                &shift
+            );
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
+
+            // power_spectrum_q15 output to the power spectrum mfe() computes
+            const float power_scale = ldexpf(static_cast<float>(fft_length) * signal_scale * signal_scale,
+                2 * (pre_exp - shift));
+
+            if (out_energies) {
+                uint64_t energy = 0;
+                for (size_t bin = 0; bin < power_spectrum_frame_size; bin++) {
+                    energy += power_spectrum_frame[bin];
+                }
+                out_energies->buffer[ix] = energy == 0 ? 1e-10 : static_cast<float>(energy) * power_scale;
+            }
+
+            // same triangular filters as mfe(), with q15 weights
+            const float mel_scale = ldexpf(power_scale, -15);
+            auto row_ptr = out_features->get_row_ptr(ix);
+            for (size_t i = 0; i < num_filters; i++) {
+                const size_t start = table->filter_start[i];
+                const size_t end = start + table->weight_offset[i + 1] - table->weight_offset[i];
+                const uint16_t *weights = table->weights_q15 + table->weight_offset[i];
+
+                uint64_t acc = 0;
+                for (size_t bin = start; bin < end; bin++) {
+                    acc += static_cast<uint64_t>(power_spectrum_frame[bin]) * weights[bin - start];
+                }
+
+                // the bins of this filter are below one step of the q15 FFT, use the power of its
+                // rounding noise (1/6 step per bin) rather than letting log() see zero
+                float energy = static_cast<float>(acc);
+                if (acc == 0) {
+                    for (size_t bin = start; bin < end; bin++) {
+                        energy += weights[bin - start];
+                    }
+                    energy /= 6.0f;
+                }
+
+                row_ptr[i] = energy * mel_scale;
+            }
         }
 
         numpy::zero_handling(out_features);
@@ -466,24 +1060,17 @@ public:
             *(out_features->buffer + i) = 0;
         }
 
-        uint16_t coefficients = fft_length / 2 + 1;
-
-        // calculate the filterbanks first... preferably I would want to do the matrix multiplications
-        // whenever they happen, but OK...
-#if EIDSP_QUANTIZE_FILTERBANK
-        EI_DSP_QUANTIZED_MATRIX(filterbanks, num_filters, coefficients, &numpy::dequantize_zero_one);
-#else
-        EI_DSP_MATRIX(filterbanks, num_filters, coefficients);
-#endif
-        if (!filterbanks.buffer) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
-        }
-
-        ret = feature::filterbanks(
-            &filterbanks, num_filters, coefficients, sampling_frequency, low_frequency, high_frequency, true);
+        // the filterbanks() weights in sparse form, cached by run_classifier_init() or built just for this call
+        mel_table_t tmp_table;
+        const mel_table_t *table;
+        ret = get_mel_table(&table, &tmp_table, num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, true);
         if (ret != 0) {
             EIDSP_ERR(ret);
         }
+        const size_t tmp_table_size = tmp_table.buffer_size;
+        ei_unique_ptr_t __table_ptr__(tmp_table.buffer,
+            [tmp_table_size](void* ptr){ei::ei_dsp_free_func(ptr, tmp_table_size);});
         for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
             size_t power_spectrum_frame_size = (fft_length / 2 + 1);
 
@@ -533,17 +1120,18 @@ public:
                 out_energies->buffer[ix] = energy;
             }
 
-            // calculate the out_features directly here
-            ret = numpy::dot_by_row(
-                ix,
-                power_spectrum_frame.buffer,
-                power_spectrum_frame_size,
-                &filterbanks,
-                out_features
-            );
+            // calculate the out_features directly here, only the non-zero weights are in the table
+            auto row_ptr = out_features->get_row_ptr(ix);
+            for (size_t i = 0; i < num_filters; i++) {
+                const size_t start = table->filter_start[i];
+                const size_t end = start + table->weight_offset[i + 1] - table->weight_offset[i];
+                const float *weights = table->weights + table->weight_offset[i];
 
-            if (ret != 0) {
-                EIDSP_ERR(ret);
+                float tmp = 0.0f;
+                for (size_t bin = start; bin < end; bin++) {
+                    tmp += power_spectrum_frame.buffer[bin] * weights[bin - start];
+                }
+                row_ptr[i] = tmp;
             }
         }
 
@@ -755,30 +1343,123 @@ public:
             EIDSP_ERR(ret);
         }
 
+        // DCT twiddles come with the cached mel table
+        const mel_table_t *table = find_mel_table(num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, false);
+
+        return mfcc_from_mfe(out_features, &features_matrix, &energy_matrix, num_cepstral, dc_elimination,
+            table ? table->dct_twiddles : nullptr);
+    }
+
+    /**
+     * Compute MFCC features from an int16 audio signal, with the filterbank energies
+     * calculated in fixed point (see `mfe_q15`).
+     * @param out_features Use `calculate_mfcc_buffer_size` to allocate the right matrix.
+     * @param signal: audio signal, read through `get_data_i16` (or converted from `get_data`)
+     * @param signal_scale: value of one int16 step of the signal, in the units `mfcc()` would see it
+     * @param pre_shift: preemphasis shift, see `mfe_q15`
+     * @param pre_cof: preemphasis coefficient, 0 to disable
+     * @param sampling_frequency (int): the sampling frequency of the signal
+     *     we are working with.
+     * @param frame_length (float): the length of each frame in seconds.
+     * @param frame_stride (float): the step between successive frames in seconds.
+     * @param num_cepstral (int): Number of cepstral coefficients.
+     * @param num_filters (int): the number of filters in the filterbank.
+     * @param fft_length (int): number of FFT points.
+     * @param low_frequency (int): lowest band edge of mel filters in Hz.
+     * @param high_frequency (int): highest band edge of mel filters in Hz.
+     * @param dc_elimination Whether the first dc component should
+     *     be eliminated or not.
+     * @param pre_history: the `pre_shift` samples before the signal, see `mfe_q15`
+     * @returns 0 if OK
+     */
+    static int mfcc_q15(matrix_t *out_features, signal_t *signal, float signal_scale,
+        int pre_shift, float pre_cof,
+        uint32_t sampling_frequency, float frame_length, float frame_stride,
+        uint16_t num_cepstral, uint16_t num_filters, uint16_t fft_length,
+        uint32_t low_frequency, uint32_t high_frequency, bool dc_elimination,
+        uint16_t version, const EIDSP_i16 *pre_history = nullptr)
+    {
+        if (out_features->cols != num_cepstral) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        matrix_size_t mfe_matrix_size =
+            calculate_mfe_buffer_size(
+                signal->total_length,
+                sampling_frequency,
+                frame_length,
+                frame_stride,
+                num_filters,
+                version);
+
+        if (out_features->rows != mfe_matrix_size.rows) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        EI_DSP_MATRIX(features_matrix, mfe_matrix_size.rows, mfe_matrix_size.cols);
+        if (!features_matrix.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        EI_DSP_MATRIX(energy_matrix, mfe_matrix_size.rows, 1);
+        if (!energy_matrix.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        int ret = mfe_q15(&features_matrix, &energy_matrix, signal, signal_scale, pre_shift, pre_cof,
+            sampling_frequency, frame_length, frame_stride, num_filters, fft_length,
+            low_frequency, high_frequency, version, pre_history);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        // DCT twiddles come with the cached mel table
+        const mel_table_t *table = find_mel_table(num_filters, fft_length, sampling_frequency,
+            low_frequency, high_frequency, version, false);
+
+        return mfcc_from_mfe(out_features, &features_matrix, &energy_matrix, num_cepstral, dc_elimination,
+            table ? table->dct_twiddles : nullptr);
+    }
+
+    /**
+     * Turn filterbank energies into MFCC: log, DCT type 2 and (optionally) the first
+     * cepstral coefficient replaced by the log of the frame energy.
+     * @param out_features Output matrix, rows x num_cepstral
+     * @param features_matrix Filterbank energies, modified in place
+     * @param energy_matrix Frame energies, rows x 1
+     * @param num_cepstral Number of cepstral coefficients
+     * @param dc_elimination Whether the first dc component should be eliminated or not.
+     * @param dct_twiddles Optional precalculated DCT twiddles (mel_table_t::dct_twiddles)
+     * @returns 0 if OK
+     */
+    static int mfcc_from_mfe(matrix_t *out_features, matrix_t *features_matrix, matrix_t *energy_matrix,
+        uint16_t num_cepstral, bool dc_elimination, const float *dct_twiddles = nullptr)
+    {
         // ok... now we need to calculate the MFCC from this...
         // first do log() over all features...
-        ret = numpy::log(&features_matrix);
+        int ret = numpy::log(features_matrix);
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
 
         // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
+        ret = numpy::dct2(features_matrix, DCT_NORMALIZATION_ORTHO, dct_twiddles);
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
 
         // replace first cepstral coefficient with log of frame energy for DC elimination
         if (dc_elimination) {
-            for (size_t row = 0; row < features_matrix.rows; row++) {
-                features_matrix.buffer[row * features_matrix.cols] = numpy::log(energy_matrix.buffer[row]);
+            for (size_t row = 0; row < features_matrix->rows; row++) {
+                features_matrix->buffer[row * features_matrix->cols] = numpy::log(energy_matrix->buffer[row]);
             }
         }
 
         // copy to the output...
-        for (size_t row = 0; row < features_matrix.rows; row++) {
+        for (size_t row = 0; row < features_matrix->rows; row++) {
             for(int i = 0; i < num_cepstral; i++) {
-                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix.buffer + (features_matrix.cols * row) + i);
+                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix->buffer + (features_matrix->cols * row) + i);
             }
         }
 
@@ -49,10 +49,13 @@ namespace processing {
      * @param signal: The input signal.
      * @param shift (int): The shift step.
      * @param cof (float): The preemphasising coefficient. 0 equals to no filtering.
+     * @param history: The `shift` samples before the start of the signal (e.g. the end of the
+     *     previous slice in continuous mode). When not set the start of the signal is
+     *     preemphasized against the end of the signal.
      */
     class preemphasis {
 public:
-        preemphasis(ei_signal_t *signal, int shift, float cof, bool rescale)
+        preemphasis(ei_signal_t *signal, int shift, float cof, bool rescale, const float *history = nullptr)
             : _signal(signal), _shift(shift), _cof(cof), _rescale(rescale)
         {
             _prev_buffer = (float*)ei_dsp_calloc(shift * sizeof(float), 1);
@@ -65,6 +68,11 @@ public:
 
             if (!_prev_buffer || !_end_of_signal_buffer) return;
 
+            if (history) {
+                memcpy(_end_of_signal_buffer, history, shift * sizeof(float));
+                return;
+            }
+
             // we need to get the shift bytes from the end of the buffer...
             signal->get_data(signal->total_length - shift, shift, _end_of_signal_buffer);
         }
@@ -277,7 +285,7 @@ namespace processing {
                             bool zero_padding,
                             uint16_t version)
     {
-        if (!info->signal || !info->signal->get_data || info->signal->total_length == 0) {
+        if (!info->signal || (!info->signal->get_data && !info->signal->get_data_i16) || info->signal->total_length == 0) {
             EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
         }
 
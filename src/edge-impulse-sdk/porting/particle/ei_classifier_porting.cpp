@@ -33,6 +33,7 @@
  */
 
 #include "../ei_classifier_porting.h"
+#include "../../classifier/ei_op_profiler.h"
 #if EI_PORTING_PARTICLE == 1
 
 #include <Particle.h>
@@ -58,6 +59,12 @@ uint64_t ei_read_timer_us() {
     return micros();
 }
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+uint32_t ei_op_profiler_read_cycles(void) {
+    return System.ticks();
+}
+#endif
+
 void ei_serial_set_baudrate(int baudrate)
 {
 
@@ -68,6 +75,23 @@ EI_WEAK_FN void ei_putchar(char c)
     Serial.write(c);
 }
 
+EI_WEAK_FN void ei_write_string(char *data, int length)
+{
+    Serial.write((const uint8_t *)data, length);
+}
+
+int ei_read_string(char *data, int max_length)
+{
+    int available = Serial.available();
+    if (available > max_length) {
+        available = max_length;
+    }
+    if (available <= 0) {
+        return 0;
+    }
+    return (int)Serial.readBytes(data, available);
+}
+
 EI_WEAK_FN char ei_getchar()
 {
     char ch = 0;
@@ -0,0 +1,164 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_CONV_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_CONV_H_
+
+#include <algorithm>
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/simd_int8.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+
+namespace tflite {
+namespace optimized_integer_ops {
+
+// int8 per-channel convolution, bit-exact with
+// reference_integer_ops::ConvPerChannel. With a dilation width of 1 the input
+// pixels under one filter row are contiguous in NHWC, as are the matching
+// filter taps in OHWI, so every filter row inside the image is a single dot
+// product of filter_width * input_depth values. Grouped and width-dilated
+// convolutions go to the reference kernel.
+inline void ConvPerChannel(
+    const ConvParams& params, const int32_t* output_multiplier,
+    const int32_t* output_shift, const RuntimeShape& input_shape,
+    const int8_t* input_data, const RuntimeShape& filter_shape,
+    const int8_t* filter_data, const RuntimeShape& bias_shape,
+    const int32_t* bias_data, const RuntimeShape& output_shape,
+    int8_t* output_data) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+
+  const int input_depth = input_shape.Dims(3);
+  const int filter_input_depth = filter_shape.Dims(3);
+  if (filter_input_depth != input_depth || params.dilation_width_factor != 1) {
+    reference_integer_ops::ConvPerChannel(
+        params, output_multiplier, output_shift, input_shape, input_data,
+        filter_shape, filter_data, bias_shape, bias_data, output_shape,
+        output_data);
+    return;
+  }
+
+  const int32_t input_offset = params.input_offset;
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int dilation_height_factor = params.dilation_height_factor;
+  const int pad_width = params.padding_values.width;
+  const int pad_height = params.padding_values.height;
+  const int32_t output_offset = params.output_offset;
+  const int32_t output_activation_min = params.quantized_activation_min;
+  const int32_t output_activation_max = params.quantized_activation_max;
+  TFLITE_DCHECK_LE(output_activation_min, output_activation_max);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+  if (bias_data) {
+    TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
+  }
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int filter_size = filter_height * filter_width * input_depth;
+  const int filter_row_size = filter_width * input_depth;
+
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      const int in_y_origin = (out_y * stride_height) - pad_height;
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin = (out_x * stride_width) - pad_width;
+        // filter columns that land inside the image (zero padding is omitted)
+        const int filter_x_start = std::max(0, -in_x_origin);
+        const int filter_x_end =
+            std::min(filter_width, input_width - in_x_origin);
+        const int row_length = (filter_x_end - filter_x_start) * input_depth;
+        int8_t* out = output_data + Offset(output_shape, batch, out_y, out_x, 0);
+
+        for (int out_c = 0; out_c < output_depth; out_c += 4) {
+          const int n = std::min(4, output_depth - out_c);
+          int32_t acc[4] = {0, 0, 0, 0};
+
+          for (int filter_y = 0; filter_y < filter_height && row_length > 0;
+               ++filter_y) {
+            const int in_y = in_y_origin + dilation_height_factor * filter_y;
+            if (in_y < 0 || in_y >= input_height) {
+              continue;
+            }
+            const int8_t* in = input_data + Offset(input_shape, batch, in_y,
+                                                   in_x_origin + filter_x_start, 0);
+            const int8_t* w = filter_data + out_c * filter_size +
+                              filter_y * filter_row_size +
+                              filter_x_start * input_depth;
+            if (n == 4) {
+              int32_t row_acc[4];
+              simd::DotProductS8x4(in, input_offset, w, w + filter_size,
+                                   w + 2 * filter_size, w + 3 * filter_size, 0,
+                                   row_length, row_acc);
+              for (int k = 0; k < 4; k++) {
+                acc[k] += row_acc[k];
+              }
+            } else {
+              for (int k = 0; k < n; k++) {
+                acc[k] += simd::DotProductS8(in, input_offset,
+                                             w + k * filter_size, 0, row_length);
+              }
+            }
+          }
+
+          for (int k = 0; k < n; k++) {
+            int32_t acc_scaled = acc[k];
+            if (bias_data) {
+              acc_scaled += bias_data[out_c + k];
+            }
+            acc_scaled = MultiplyByQuantizedMultiplier(
+                acc_scaled, output_multiplier[out_c + k],
+                output_shift[out_c + k]);
+            acc_scaled += output_offset;
+            acc_scaled = std::max(acc_scaled, output_activation_min);
+            acc_scaled = std::min(acc_scaled, output_activation_max);
+            out[out_c + k] = static_cast<int8_t>(acc_scaled);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace optimized_integer_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_CONV_H_
@@ -0,0 +1,295 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_SIMD_INT8_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_SIMD_INT8_H_
+
+// int8 building blocks for the portable SIMD kernels
+// (EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD). They use AVX2 or SSE2 when the
+// compiler targets them, GCC / Clang vector extensions elsewhere and plain C++
+// as a last resort.
+//
+// Zero-point offsets are added after widening to 16 bit: an int8 value plus an
+// offset in [-128, 128] always fits, and the 16x16 bit multiply-add then gives
+// exactly the int32 products the reference kernels accumulate. int32 additions
+// are done in a different order, which doesn't change the (wrapping) sum, so
+// the results are bit-exact with reference_integer_ops.
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace tflite {
+namespace optimized_integer_ops {
+namespace simd {
+
+#if defined(__AVX2__)
+
+inline __m256i LoadS8AsS16(const int8_t* p, __m256i offset) {
+  return _mm256_add_epi16(
+      _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+      offset);
+}
+
+inline int32_t HorizontalSum(__m256i v) {
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(s);
+}
+
+#elif defined(__SSE2__)
+
+// Sign-extend the low / high 8 bytes of v to 16 bit and add offset
+inline __m128i UnpackLoS8AsS16(__m128i v, __m128i offset) {
+  return _mm_add_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8), offset);
+}
+
+inline __m128i UnpackHiS8AsS16(__m128i v, __m128i offset) {
+  return _mm_add_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8), offset);
+}
+
+inline int32_t HorizontalSum(__m128i s) {
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(s);
+}
+
+#elif defined(__GNUC__)
+
+typedef int8_t v8s8 __attribute__((vector_size(8)));
+typedef int32_t v8s32 __attribute__((vector_size(32)));
+
+inline v8s32 LoadS8AsS32(const int8_t* p, int32_t offset) {
+  v8s8 v;
+  memcpy(&v, p, sizeof(v));
+  return __builtin_convertvector(v, v8s32) + offset;
+}
+
+inline int32_t HorizontalSum(v8s32 v) {
+  return v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+}
+
+#endif
+
+// out[k] = sum over i < n of (a[i] + a_offset) * (b_k[i] + b_offset), for the
+// four rows b0..b3. a is widened once for all four rows.
+inline void DotProductS8x4(const int8_t* a, int32_t a_offset,
+                           const int8_t* b0, const int8_t* b1,
+                           const int8_t* b2, const int8_t* b3,
+                           int32_t b_offset, int n, int32_t* out) {
+  int i = 0;
+  int32_t acc[4] = {0, 0, 0, 0};
+
+#if defined(__AVX2__)
+  const __m256i va_off = _mm256_set1_epi16(static_cast<int16_t>(a_offset));
+  const __m256i vb_off = _mm256_set1_epi16(static_cast<int16_t>(b_offset));
+  __m256i s0 = _mm256_setzero_si256();
+  __m256i s1 = _mm256_setzero_si256();
+  __m256i s2 = _mm256_setzero_si256();
+  __m256i s3 = _mm256_setzero_si256();
+  for (; i + 16 <= n; i += 16) {
+    const __m256i va = LoadS8AsS16(a + i, va_off);
+    s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(va, LoadS8AsS16(b0 + i, vb_off)));
+    s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(va, LoadS8AsS16(b1 + i, vb_off)));
+    s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(va, LoadS8AsS16(b2 + i, vb_off)));
+    s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(va, LoadS8AsS16(b3 + i, vb_off)));
+  }
+  acc[0] = HorizontalSum(s0);
+  acc[1] = HorizontalSum(s1);
+  acc[2] = HorizontalSum(s2);
+  acc[3] = HorizontalSum(s3);
+#elif defined(__SSE2__)
+  const __m128i va_off = _mm_set1_epi16(static_cast<int16_t>(a_offset));
+  const __m128i vb_off = _mm_set1_epi16(static_cast<int16_t>(b_offset));
+  const int8_t* b[4] = {b0, b1, b2, b3};
+  __m128i s[4] = {_mm_setzero_si128(), _mm_setzero_si128(),
+                  _mm_setzero_si128(), _mm_setzero_si128()};
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i va_lo = UnpackLoS8AsS16(va, va_off);
+    const __m128i va_hi = UnpackHiS8AsS16(va, va_off);
+    for (int k = 0; k < 4; k++) {
+      const __m128i vb =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b[k] + i));
+      s[k] = _mm_add_epi32(
+          s[k], _mm_madd_epi16(va_lo, UnpackLoS8AsS16(vb, vb_off)));
+      s[k] = _mm_add_epi32(
+          s[k], _mm_madd_epi16(va_hi, UnpackHiS8AsS16(vb, vb_off)));
+    }
+  }
+  for (int k = 0; k < 4; k++) {
+    acc[k] = HorizontalSum(s[k]);
+  }
+#elif defined(__GNUC__)
+  v8s32 s0 = {0}, s1 = {0}, s2 = {0}, s3 = {0};
+  for (; i + 8 <= n; i += 8) {
+    const v8s32 va = LoadS8AsS32(a + i, a_offset);
+    s0 += va * LoadS8AsS32(b0 + i, b_offset);
+    s1 += va * LoadS8AsS32(b1 + i, b_offset);
+    s2 += va * LoadS8AsS32(b2 + i, b_offset);
+    s3 += va * LoadS8AsS32(b3 + i, b_offset);
+  }
+  acc[0] = HorizontalSum(s0);
+  acc[1] = HorizontalSum(s1);
+  acc[2] = HorizontalSum(s2);
+  acc[3] = HorizontalSum(s3);
+#endif
+
+  for (; i < n; i++) {
+    const int32_t va = a[i] + a_offset;
+    acc[0] += va * (b0[i] + b_offset);
+    acc[1] += va * (b1[i] + b_offset);
+    acc[2] += va * (b2[i] + b_offset);
+    acc[3] += va * (b3[i] + b_offset);
+  }
+
+  out[0] = acc[0];
+  out[1] = acc[1];
+  out[2] = acc[2];
+  out[3] = acc[3];
+}
+
+// sum over i < n of (a[i] + a_offset) * (b[i] + b_offset)
+inline int32_t DotProductS8(const int8_t* a, int32_t a_offset,
+                            const int8_t* b, int32_t b_offset, int n) {
+  int i = 0;
+  int32_t acc = 0;
+
+#if defined(__AVX2__)
+  const __m256i va_off = _mm256_set1_epi16(static_cast<int16_t>(a_offset));
+  const __m256i vb_off = _mm256_set1_epi16(static_cast<int16_t>(b_offset));
+  __m256i s = _mm256_setzero_si256();
+  for (; i + 16 <= n; i += 16) {
+    s = _mm256_add_epi32(s, _mm256_madd_epi16(LoadS8AsS16(a + i, va_off),
+                                              LoadS8AsS16(b + i, vb_off)));
+  }
+  acc = HorizontalSum(s);
+#elif defined(__SSE2__)
+  const __m128i va_off = _mm_set1_epi16(static_cast<int16_t>(a_offset));
+  const __m128i vb_off = _mm_set1_epi16(static_cast<int16_t>(b_offset));
+  __m128i s = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    s = _mm_add_epi32(s, _mm_madd_epi16(UnpackLoS8AsS16(va, va_off),
+                                        UnpackLoS8AsS16(vb, vb_off)));
+    s = _mm_add_epi32(s, _mm_madd_epi16(UnpackHiS8AsS16(va, va_off),
+                                        UnpackHiS8AsS16(vb, vb_off)));
+  }
+  acc = HorizontalSum(s);
+#elif defined(__GNUC__)
+  v8s32 s = {0};
+  for (; i + 8 <= n; i += 8) {
+    s += LoadS8AsS32(a + i, a_offset) * LoadS8AsS32(b + i, b_offset);
+  }
+  acc = HorizontalSum(s);
+#endif
+
+  for (; i < n; i++) {
+    acc += (a[i] + a_offset) * (b[i] + b_offset);
+  }
+  return acc;
+}
+
+// acc[i] += (a[i] + a_offset) * b[i] for i < n (element-wise, as used by
+// depthwise convolution across channels)
+inline void MultiplyAccumulateS8(const int8_t* a, int32_t a_offset,
+                                 const int8_t* b, int n, int32_t* acc) {
+  int i = 0;
+
+#if defined(__AVX2__)
+  const __m256i va_off = _mm256_set1_epi32(a_offset);
+  for (; i + 8 <= n; i += 8) {
+    const __m256i va = _mm256_add_epi32(
+        _mm256_cvtepi8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i))),
+        va_off);
+    const __m256i vb = _mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i)));
+    __m256i* p = reinterpret_cast<__m256i*>(acc + i);
+    _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p),
+                                            _mm256_mullo_epi32(va, vb)));
+  }
+#elif defined(__SSE2__)
+  // 16 bit products split into low / high halves and interleaved back to int32
+  const __m128i va_off = _mm_set1_epi16(static_cast<int16_t>(a_offset));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8) {
+    const __m128i va = _mm_add_epi16(
+        _mm_srai_epi16(
+            _mm_unpacklo_epi8(
+                zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i))),
+            8),
+        va_off);
+    const __m128i vb = _mm_srai_epi16(
+        _mm_unpacklo_epi8(
+            zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i))),
+        8);
+    const __m128i lo = _mm_mullo_epi16(va, vb);
+    const __m128i hi = _mm_mulhi_epi16(va, vb);
+    __m128i* p0 = reinterpret_cast<__m128i*>(acc + i);
+    __m128i* p1 = reinterpret_cast<__m128i*>(acc + i + 4);
+    _mm_storeu_si128(p0, _mm_add_epi32(_mm_loadu_si128(p0),
+                                       _mm_unpacklo_epi16(lo, hi)));
+    _mm_storeu_si128(p1, _mm_add_epi32(_mm_loadu_si128(p1),
+                                       _mm_unpackhi_epi16(lo, hi)));
+  }
+#elif defined(__GNUC__)
+  for (; i + 8 <= n; i += 8) {
+    v8s32 s;
+    memcpy(&s, acc + i, sizeof(s));
+    s += LoadS8AsS32(a + i, a_offset) * LoadS8AsS32(b + i, 0);
+    memcpy(acc + i, &s, sizeof(s));
+  }
+#endif
+
+  for (; i < n; i++) {
+    acc[i] += (a[i] + a_offset) * b[i];
+  }
+}
+
+}  // namespace simd
+}  // namespace optimized_integer_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_SIMD_INT8_H_
@@ -1623,6 +1623,9 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/fully_connected.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#if EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD == 1
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/fully_connected.h"
+#endif
 #include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
 
@@ -1734,7 +1737,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
               tflite::micro::GetTensorData<int8_t>(filter),
               tflite::micro::GetTensorShape(filter).FlatSize(),
               unpacked_filter_data);
+#if EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD == 1
+          tflite::optimized_integer_ops::FullyConnected(
+#else
           tflite::reference_integer_ops::FullyConnected(
+#endif
               FullyConnectedParamsQuantized(data),
               tflite::micro::GetTensorShape(input),
               tflite::micro::GetTensorData<int8_t>(input),
@@ -1746,7 +1753,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
           break;
         }
         case kTfLiteInt8: {
+#if EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD == 1
+          tflite::optimized_integer_ops::FullyConnected(
+#else
           tflite::reference_integer_ops::FullyConnected(
+#endif
               FullyConnectedParamsQuantized(data),
               tflite::micro::GetTensorShape(input),
               tflite::micro::GetTensorData<int8_t>(input),
@@ -24,15 +24,28 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/types.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_context.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
 
 namespace tflite {
 namespace micro {
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+// With the Edge Impulse operator profiler, prepare and invoke are wrapped so
+// that graphs without hooks per operator (EON) can be profiled. The operator is
+// named after the Register_ function that calls this.
+TfLiteRegistration RegisterOp(
+    void* (*init)(TfLiteContext* context, const char* buffer, size_t length),
+    TfLiteStatus (*prepare)(TfLiteContext* context, TfLiteNode* node),
+    TfLiteStatus (*invoke)(TfLiteContext* context, TfLiteNode* node),
+    void (*free)(TfLiteContext* context, void* buffer) = nullptr,
+    const char* caller = __builtin_FUNCTION());
+#else
 TfLiteRegistration RegisterOp(
     void* (*init)(TfLiteContext* context, const char* buffer, size_t length),
     TfLiteStatus (*prepare)(TfLiteContext* context, TfLiteNode* node),
     TfLiteStatus (*invoke)(TfLiteContext* context, TfLiteNode* node),
     void (*free)(TfLiteContext* context, void* buffer) = nullptr);
+#endif  // EI_CLASSIFIER_OP_PROFILER == 1
 
 // Prints out n bytes in a int8_t buffer as hex
 void PrintNBytes(const int8_t* tensor_data, int n_bytes,
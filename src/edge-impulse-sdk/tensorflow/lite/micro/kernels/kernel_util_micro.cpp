@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
 
+#include <cstring>
+
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/memory_helpers.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 
 namespace tflite {
 namespace micro {
@@ -36,22 +39,175 @@ int ValidateTensorIndexing(const TfLiteContext* context, int index,
   return -1;
 }
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+// Operator types that can be wrapped. Further types are registered unwrapped,
+// and are not profiled in EON graphs.
+constexpr size_t kMaxProfiledOps = 16;
+
+struct ProfiledOp {
+  const char* name;
+  TfLiteStatus (*prepare)(TfLiteContext* context, TfLiteNode* node);
+  TfLiteStatus (*invoke)(TfLiteContext* context, TfLiteNode* node);
+};
+
+ProfiledOp profiled_ops[kMaxProfiledOps];
+size_t profiled_ops_count = 0;
+
+// Scratch requested by the operator being prepared
+TfLiteStatus (*request_scratch)(TfLiteContext* context, size_t bytes,
+                                int* buffer_idx) = nullptr;
+size_t requested_scratch_bytes = 0;
+
+TfLiteStatus CountScratchRequest(TfLiteContext* context, size_t bytes,
+                                 int* buffer_idx) {
+  requested_scratch_bytes += bytes;
+  return request_scratch(context, bytes, buffer_idx);
+}
+
+size_t NodeTensorBytes(const TfLiteContext* context, const TfLiteNode* node) {
+  size_t total_bytes = 0;
+  const TfLiteIntArray* tensor_lists[] = {node->inputs, node->outputs};
+  for (const TfLiteIntArray* tensors : tensor_lists) {
+    for (int i = 0; i < tensors->size; ++i) {
+      // optional tensors are marked with -1
+      if (tensors->data[i] < 0) {
+        continue;
+      }
+      size_t bytes = 0;
+      if (TfLiteEvalTensorByteLength(
+              context->GetEvalTensor(context, tensors->data[i]), &bytes) ==
+          kTfLiteOk) {
+        total_bytes += bytes;
+      }
+    }
+  }
+  return total_bytes;
+}
+
+TfLiteStatus PrepareProfiledOp(const ProfiledOp& op, TfLiteContext* context,
+                               TfLiteNode* node) {
+  size_t op_index;
+  const void* graph = ei_op_profiler_graph_next_op(&op_index);
+  if (graph == nullptr || context->RequestScratchBufferInArena == nullptr) {
+    return op.prepare ? op.prepare(context, node) : kTfLiteOk;
+  }
+
+  request_scratch = context->RequestScratchBufferInArena;
+  requested_scratch_bytes = 0;
+  context->RequestScratchBufferInArena = &CountScratchRequest;
+  TfLiteStatus status = op.prepare ? op.prepare(context, node) : kTfLiteOk;
+  context->RequestScratchBufferInArena = request_scratch;
+
+  ei_op_profiler_set_op_scratch(graph, 0, op_index, requested_scratch_bytes);
+  return status;
+}
+
+TfLiteStatus InvokeProfiledOp(const ProfiledOp& op, TfLiteContext* context,
+                              TfLiteNode* node) {
+  size_t op_index;
+  const void* graph = ei_op_profiler_graph_next_op(&op_index);
+  if (graph == nullptr) {
+    return op.invoke(context, node);
+  }
+
+  ei_op_profiler_mark_t op_mark;
+  ei_op_profiler_op_begin(&op_mark);
+  TfLiteStatus status = op.invoke(context, node);
+  if (op_mark.active) {
+    ei_op_profiler_op_end(&op_mark, graph, 0, op.name, op_index,
+                          NodeTensorBytes(context, node));
+  }
+  return status;
+}
+
+template <size_t Slot>
+TfLiteStatus ProfiledPrepare(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareProfiledOp(profiled_ops[Slot], context, node);
+}
+
+template <size_t Slot>
+TfLiteStatus ProfiledInvoke(TfLiteContext* context, TfLiteNode* node) {
+  return InvokeProfiledOp(profiled_ops[Slot], context, node);
+}
+
+struct ProfiledSlot {
+  TfLiteStatus (*prepare)(TfLiteContext* context, TfLiteNode* node);
+  TfLiteStatus (*invoke)(TfLiteContext* context, TfLiteNode* node);
+};
+
+#define EI_PROFILED_SLOT(n) {&ProfiledPrepare<n>, &ProfiledInvoke<n>}
+const ProfiledSlot profiled_slots[] = {
+    EI_PROFILED_SLOT(0),  EI_PROFILED_SLOT(1),  EI_PROFILED_SLOT(2),
+    EI_PROFILED_SLOT(3),  EI_PROFILED_SLOT(4),  EI_PROFILED_SLOT(5),
+    EI_PROFILED_SLOT(6),  EI_PROFILED_SLOT(7),  EI_PROFILED_SLOT(8),
+    EI_PROFILED_SLOT(9),  EI_PROFILED_SLOT(10), EI_PROFILED_SLOT(11),
+    EI_PROFILED_SLOT(12), EI_PROFILED_SLOT(13), EI_PROFILED_SLOT(14),
+    EI_PROFILED_SLOT(15),
+};
+#undef EI_PROFILED_SLOT
+static_assert(sizeof(profiled_slots) / sizeof(profiled_slots[0]) ==
+                  kMaxProfiledOps,
+              "one slot per profiled operator type");
+
+// Points prepare and invoke of a registration at the slot of its operator
+// type, taking a free slot on the first registration of the type.
+void WrapProfiledOp(TfLiteRegistration* registration, const char* caller) {
+  if (registration->invoke == nullptr) {
+    return;
+  }
+
+  // Register_FULLY_CONNECTED => FULLY_CONNECTED
+  static const char kPrefix[] = "Register_";
+  const char* name = caller;
+  if (strncmp(name, kPrefix, sizeof(kPrefix) - 1) == 0) {
+    name += sizeof(kPrefix) - 1;
+  }
+
+  size_t slot = 0;
+  for (; slot < profiled_ops_count; ++slot) {
+    if (profiled_ops[slot].invoke == registration->invoke &&
+        profiled_ops[slot].prepare == registration->prepare &&
+        strcmp(profiled_ops[slot].name, name) == 0) {
+      break;
+    }
+  }
+  if (slot == profiled_ops_count) {
+    if (profiled_ops_count == kMaxProfiledOps) {
+      return;
+    }
+    profiled_ops[slot] = {name, registration->prepare, registration->invoke};
+    profiled_ops_count++;
+  }
+
+  registration->prepare = profiled_slots[slot].prepare;
+  registration->invoke = profiled_slots[slot].invoke;
+}
+#endif  // EI_CLASSIFIER_OP_PROFILER == 1
+
 }  // namespace
 
 TfLiteRegistration RegisterOp(
     void* (*init)(TfLiteContext* context, const char* buffer, size_t length),
     TfLiteStatus (*prepare)(TfLiteContext* context, TfLiteNode* node),
     TfLiteStatus (*invoke)(TfLiteContext* context, TfLiteNode* node),
+#if EI_CLASSIFIER_OP_PROFILER == 1
+    void (*free)(TfLiteContext* context, void* buffer), const char* caller) {
+#else
     void (*free)(TfLiteContext* context, void* buffer)) {
-  return {/*init=*/init,
-          /*free=*/free,
-          /*prepare=*/prepare,
-          /*invoke=*/invoke,
-          /*profiling_string=*/nullptr,
-          /*builtin_code=*/0,
-          /*custom_name=*/nullptr,
-          /*version=*/0,
-          /*registration_external=*/nullptr};
+#endif
+  TfLiteRegistration registration = {/*init=*/init,
+                                     /*free=*/free,
+                                     /*prepare=*/prepare,
+                                     /*invoke=*/invoke,
+                                     /*profiling_string=*/nullptr,
+                                     /*builtin_code=*/0,
+                                     /*custom_name=*/nullptr,
+                                     /*version=*/0,
+                                     /*registration_external=*/nullptr};
+#if EI_CLASSIFIER_OP_PROFILER == 1
+  WrapProfiledOp(&registration, caller);
+#endif
+  return registration;
 }
 
 // Returns a mutable tensor for a given input index. is_variable must be checked
@@ -35,6 +35,7 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/micro/flatbuffer_conversions_bridge.h"
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_utils.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 
 namespace tflite {
 
@@ -553,6 +554,8 @@ TfLiteStatus MicroAllocator::FinishPrepareNodeAllocations(int node_id) {
 
   // Find and update any new scratch buffer requests for the current node:
   internal::ScratchBufferRequest* requests = GetScratchBufferRequests();
+  size_t node_scratch_bytes = 0;
+  int node_subgraph_idx = 0;
 
   for (size_t i = 0; i < scratch_buffer_request_count_; ++i) {
     // A request with a node_idx of -1 is a sentinel value used to indicate this
@@ -562,9 +565,18 @@ TfLiteStatus MicroAllocator::FinishPrepareNodeAllocations(int node_id) {
     // to allocate at most kMaxScratchBuffersPerOp requests:
     if (requests[i].node_idx == kUnassignedScratchBufferRequestIndex) {
       requests[i].node_idx = node_id;
+      node_scratch_bytes += requests[i].bytes;
+      node_subgraph_idx = requests[i].subgraph_idx;
     }
   }
 
+  // MicroGraph drops this allocator's entries before preparing, nodes without
+  // scratch buffers don't need one
+  if (node_scratch_bytes > 0) {
+    ei_op_profiler_set_op_scratch(this, node_subgraph_idx, node_id,
+                                  node_scratch_bytes);
+  }
+
   // Ensure that the head is re-adjusted to allow for another at-most
   // kMaxScratchBuffersPerOp scratch buffer requests in the next operator:
   TF_LITE_ENSURE_STATUS(non_persistent_buffer_allocator_->ResizeBuffer(
@@ -23,6 +23,7 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_profiler.h"
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+#include "edge-impulse-sdk/classifier/ei_op_profiler.h"
 
 namespace tflite {
 namespace {
@@ -90,6 +91,9 @@ TfLiteStatus MicroGraph::PrepareSubgraphs(bool run_all_prep_ops) {
   int previous_subgraph_idx = current_subgraph_index_;
   bool all_prep_ops_ok = true;
 
+  // the allocator reports the scratch usage of the nodes again
+  ei_op_profiler_forget_graph(allocator_);
+
   for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
        subgraph_idx++) {
     current_subgraph_index_ = subgraph_idx;
@@ -129,6 +133,8 @@ TfLiteStatus MicroGraph::PrepareSubgraphs(bool run_all_prep_ops) {
 TfLiteStatus MicroGraph::FreeSubgraphs() {
   int previous_subgraph_idx = current_subgraph_index_;
 
+  ei_op_profiler_forget_graph(allocator_);
+
   for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
        subgraph_idx++) {
     current_subgraph_index_ = subgraph_idx;
@@ -152,6 +158,28 @@ TfLiteStatus MicroGraph::FreeSubgraphs() {
   return kTfLiteOk;
 }
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+size_t MicroGraph::NodeTensorBytes(int subgraph_idx, const TfLiteNode* node) {
+  size_t total_bytes = 0;
+  const TfLiteIntArray* tensor_lists[] = {node->inputs, node->outputs};
+  for (const TfLiteIntArray* tensors : tensor_lists) {
+    for (int i = 0; i < tensors->size; ++i) {
+      // optional tensors are marked with -1
+      if (tensors->data[i] < 0) {
+        continue;
+      }
+      size_t bytes = 0;
+      if (TfLiteEvalTensorByteLength(
+              &subgraph_allocations_[subgraph_idx].tensors[tensors->data[i]],
+              &bytes) == kTfLiteOk) {
+        total_bytes += bytes;
+      }
+    }
+  }
+  return total_bytes;
+}
+#endif  // EI_CLASSIFIER_OP_PROFILER == 1
+
 TfLiteStatus MicroGraph::InvokeSubgraph(int subgraph_idx) {
   int previous_subgraph_idx = current_subgraph_index_;
   current_subgraph_index_ = subgraph_idx;
@@ -178,9 +206,22 @@ TfLiteStatus MicroGraph::InvokeSubgraph(int subgraph_idx) {
         reinterpret_cast<MicroProfilerInterface*>(context_->profiler));
 #endif
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+    ei_op_profiler_mark_t op_mark;
+    ei_op_profiler_op_begin(&op_mark);
+#endif
+
     TFLITE_DCHECK(registration->invoke);
     TfLiteStatus invoke_status = registration->invoke(context_, node);
 
+#if EI_CLASSIFIER_OP_PROFILER == 1
+    if (op_mark.active) {
+      ei_op_profiler_op_end(&op_mark, allocator_, subgraph_idx,
+                            OpNameFromRegistration(registration), i,
+                            NodeTensorBytes(subgraph_idx, node));
+    }
+#endif
+
     // All TfLiteTensor structs used in the kernel are allocated from temp
     // memory in the allocator. This creates a chain of allocations in the
     // temp section. The call below resets the chain of allocations to
@@ -20,6 +20,7 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_allocator.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_resource_variable.h"
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
 
 namespace tflite {
 
@@ -94,6 +95,11 @@ class MicroGraph {
   MicroResourceVariables* GetResourceVariables() { return resource_variables_; }
 
  private:
+#if EI_CLASSIFIER_OP_PROFILER == 1
+  // Bytes of all input and output tensors of a node, for the operator profiler.
+  size_t NodeTensorBytes(int subgraph_idx, const TfLiteNode* node);
+#endif
+
   TfLiteContext* context_;
   const Model* model_;
   MicroAllocator* allocator_;
@@ -0,0 +1,491 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_at_binary_transfer.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/ei_device_interface.h"
+#include <cstring>
+
+/* Private variables ------------------------------------------------------- */
+static bool binary_mode = false;
+static ei_at_transfer_format_t transfer_format = EI_AT_TRANSFER_FORMAT_F32;
+
+static uint32_t crc_table[256];
+static bool crc_table_ready = false;
+
+/* Private functions ------------------------------------------------------- */
+static void crc32_build_table(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+        }
+        crc_table[i] = c;
+    }
+    crc_table_ready = true;
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Send a frame as a single write, so the serial driver can move it in one go.
+ * buf must have EI_AT_FRAME_HEADER_SIZE bytes free in front of the payload and 4 after it.
+ */
+void ei_at_frame_send(uint8_t *buf, uint8_t type, uint8_t seq, uint16_t length)
+{
+    ei_at_frame_build_header(buf, type, seq, length);
+    uint32_t crc = ei_at_crc32(0, buf + 1, EI_AT_FRAME_HEADER_SIZE - 1 + length);
+    put_u32(buf + EI_AT_FRAME_HEADER_SIZE + length, crc);
+    ei_write_string((char *)buf, EI_AT_FRAME_OVERHEAD + length);
+}
+
+/**
+ * @brief Check type and length as soon as the header is in. A corrupted length would
+ * otherwise make the parser swallow the following frames while it waits for the payload.
+ */
+static bool frame_header_valid(uint8_t type, uint16_t length)
+{
+    switch (type) {
+        case EI_AT_FRAME_DATA:
+            return length > 0 && length <= EI_AT_BINARY_MTU;
+        case EI_AT_FRAME_RESULTS:
+            return length > 0;
+        case EI_AT_FRAME_END:
+            return length == 4;
+        case EI_AT_FRAME_ACK:
+        case EI_AT_FRAME_NAK:
+        case EI_AT_FRAME_ABORT:
+            return length == 0;
+        default:
+            return false;
+    }
+}
+
+static void send_control(uint8_t type, uint8_t seq)
+{
+    uint8_t buf[EI_AT_FRAME_OVERHEAD];
+    ei_at_frame_send(buf, type, seq, 0);
+}
+
+/**
+ * @brief NAK the expected frame, at most once per timeout so a burst of broken or
+ * out-of-order frames doesn't make the sender go back over and over again
+ */
+static void send_nak(uint8_t expected, uint64_t *nak_time)
+{
+    uint64_t now = ei_read_timer_ms();
+
+    if (*nak_time == 0 || now - *nak_time > EI_AT_BINARY_TIMEOUT_MS) {
+        send_control(EI_AT_FRAME_NAK, expected);
+        *nak_time = now;
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief CRC32 (IEEE 802.3, reflected 0xEDB88320), pass 0 to start and the previous
+ * result to continue over more data.
+ */
+uint32_t ei_at_crc32(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (!crc_table_ready) {
+        crc32_build_table();
+    }
+
+    crc = ~crc;
+    while (length--) {
+        crc = crc_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+void ei_at_frame_parser_reset(ei_at_frame_parser_t *parser, uint8_t *payload, size_t payload_size)
+{
+    parser->payload = payload;
+    parser->payload_size = payload_size;
+    parser->pos = 0;
+}
+
+/**
+ * @brief Number of bytes still missing from the frame being parsed (at least 1).
+ * Reading no more than that never takes bytes of whatever follows the frame off the
+ * serial port, e.g. the next AT command after a transfer.
+ */
+size_t ei_at_frame_parser_pending(const ei_at_frame_parser_t *parser)
+{
+    if (parser->pos < EI_AT_FRAME_HEADER_SIZE) {
+        return parser->pos == 0 ? 1 : EI_AT_FRAME_HEADER_SIZE - parser->pos;
+    }
+
+    return EI_AT_FRAME_OVERHEAD + parser->length - parser->pos;
+}
+
+/**
+ * @brief Feed received bytes to the parser. Stops after the first complete frame
+ * (consumed tells how much of data was used), bytes before a start of frame are skipped.
+ * The parser is ready for the next frame after EI_AT_FRAME_OK or EI_AT_FRAME_BAD,
+ * the payload destination may be changed in between. Payloads that don't fit the
+ * destination are only checked, not stored.
+ */
+ei_at_frame_status_t ei_at_frame_parse(ei_at_frame_parser_t *parser, const uint8_t *data, size_t length, size_t *consumed)
+{
+    size_t i = 0;
+
+    while (i < length) {
+        if (parser->pos == 0) {
+            if (data[i++] == EI_AT_FRAME_SOF) {
+                parser->header[0] = EI_AT_FRAME_SOF;
+                parser->pos = 1;
+            }
+        }
+        else if (parser->pos < EI_AT_FRAME_HEADER_SIZE) {
+            parser->header[parser->pos++] = data[i++];
+            if (parser->pos == EI_AT_FRAME_HEADER_SIZE) {
+                parser->type = parser->header[1];
+                parser->seq = parser->header[2];
+                parser->length = (uint16_t)(parser->header[3] | (parser->header[4] << 8));
+                parser->crc = ei_at_crc32(0, parser->header + 1, EI_AT_FRAME_HEADER_SIZE - 1);
+                parser->payload_stored = parser->payload != nullptr && parser->length <= parser->payload_size;
+                if (!frame_header_valid(parser->type, parser->length)) {
+                    // resync on the next start of frame
+                    parser->pos = 0;
+                    *consumed = i;
+                    return EI_AT_FRAME_BAD;
+                }
+            }
+        }
+        else if (parser->pos < EI_AT_FRAME_HEADER_SIZE + parser->length) {
+            size_t offset = parser->pos - EI_AT_FRAME_HEADER_SIZE;
+            size_t n = parser->length - offset;
+            if (n > length - i) {
+                n = length - i;
+            }
+            if (parser->payload_stored) {
+                memcpy(parser->payload + offset, data + i, n);
+            }
+            parser->crc = ei_at_crc32(parser->crc, data + i, n);
+            parser->pos += n;
+            i += n;
+        }
+        else {
+            size_t crc_pos = parser->pos - EI_AT_FRAME_HEADER_SIZE - parser->length;
+            parser->crc_bytes[crc_pos] = data[i++];
+            parser->pos++;
+            if (crc_pos == 3) {
+                parser->pos = 0;
+                *consumed = i;
+                return get_u32(parser->crc_bytes) == parser->crc ? EI_AT_FRAME_OK : EI_AT_FRAME_BAD;
+            }
+        }
+    }
+
+    *consumed = i;
+    return EI_AT_FRAME_INCOMPLETE;
+}
+
+size_t ei_at_frame_build_header(uint8_t *header, uint8_t type, uint8_t seq, uint16_t length)
+{
+    header[0] = EI_AT_FRAME_SOF;
+    header[1] = type;
+    header[2] = seq;
+    put_u16(header + 3, length);
+
+    return EI_AT_FRAME_HEADER_SIZE;
+}
+
+bool ei_at_binary_transfer_enabled(void)
+{
+    return binary_mode;
+}
+
+ei_at_transfer_format_t ei_at_binary_transfer_format(void)
+{
+    return transfer_format;
+}
+
+void ei_at_binary_transfer_set_mode(bool binary, ei_at_transfer_format_t format)
+{
+    binary_mode = binary;
+    transfer_format = format;
+}
+
+/**
+ * @brief Send length bytes as DATA frames followed by END. read_cb is called for
+ * every frame sent, also for retransmissions, so no copy of the window is kept in RAM.
+ *
+ * @return true if the peer acknowledged all DATA frames (a lost ACK of END is
+ * tolerated, the peer has all data at that point)
+ */
+bool ei_at_binary_send(size_t length, bool (*read_cb)(size_t offset, uint8_t *buffer, size_t length))
+{
+    const size_t n_frames = (length + EI_AT_BINARY_MTU - 1) / EI_AT_BINARY_MTU;
+    uint8_t *tx = (uint8_t *)ei_malloc(EI_AT_BINARY_MTU + EI_AT_FRAME_OVERHEAD);
+    uint8_t rx[64];
+    ei_at_frame_parser_t parser;
+    size_t base = 0;
+    size_t next = 0;
+    bool end_sent = false;
+    int retries = 0;
+    uint64_t last_progress;
+
+    if (tx == nullptr) {
+        ei_printf("ERR: Failed to allocate frame buffer\n");
+        send_control(EI_AT_FRAME_ABORT, 0);
+        return false;
+    }
+
+    // only the header of frames coming back is of interest
+    ei_at_frame_parser_reset(&parser, nullptr, 0);
+    last_progress = ei_read_timer_ms();
+
+    while (1) {
+        // fill the window
+        while (next < n_frames && next - base < EI_AT_BINARY_WINDOW) {
+            size_t offset = next * EI_AT_BINARY_MTU;
+            size_t frame_len = length - offset < EI_AT_BINARY_MTU ? length - offset : EI_AT_BINARY_MTU;
+            if (!read_cb(offset, tx + EI_AT_FRAME_HEADER_SIZE, frame_len)) {
+                send_control(EI_AT_FRAME_ABORT, (uint8_t)next);
+                ei_free(tx);
+                return false;
+            }
+            ei_at_frame_send(tx, EI_AT_FRAME_DATA, (uint8_t)next, (uint16_t)frame_len);
+            next++;
+        }
+
+        if (base == n_frames && !end_sent) {
+            put_u32(tx + EI_AT_FRAME_HEADER_SIZE, (uint32_t)length);
+            ei_at_frame_send(tx, EI_AT_FRAME_END, (uint8_t)n_frames, 4);
+            end_sent = true;
+        }
+
+        size_t pending = ei_at_frame_parser_pending(&parser);
+        int n = ei_read_string((char *)rx, pending < sizeof(rx) ? pending : sizeof(rx));
+        if (n < 0) {
+            ei_free(tx);
+            return false;
+        }
+
+        size_t pos = 0;
+        while (pos < (size_t)n) {
+            size_t consumed;
+            ei_at_frame_status_t status = ei_at_frame_parse(&parser, rx + pos, n - pos, &consumed);
+            pos += consumed;
+            if (status != EI_AT_FRAME_OK) {
+                continue;
+            }
+
+            // seq distance from the oldest unacknowledged frame, window is far below 256
+            size_t delta = (uint8_t)(parser.seq - (uint8_t)base);
+
+            if (parser.type == EI_AT_FRAME_ACK) {
+                if (end_sent && parser.seq == (uint8_t)n_frames) {
+                    ei_free(tx);
+                    return true;
+                }
+                if (delta < next - base) {
+                    base += delta + 1;
+                    retries = 0;
+                    last_progress = ei_read_timer_ms();
+                }
+            }
+            else if (parser.type == EI_AT_FRAME_NAK) {
+                if (delta <= next - base) {
+                    base += delta;
+                    next = base;
+                    end_sent = false;
+                    last_progress = ei_read_timer_ms();
+                }
+            }
+            else if (parser.type == EI_AT_FRAME_ABORT) {
+                ei_free(tx);
+                return false;
+            }
+            else if (end_sent) {
+                // the peer already started the next transfer, so the ACK of END got lost
+                ei_free(tx);
+                return true;
+            }
+        }
+
+        if (ei_read_timer_ms() - last_progress > EI_AT_BINARY_TIMEOUT_MS) {
+            if (++retries > EI_AT_BINARY_RETRIES) {
+                ei_free(tx);
+                // all DATA frames were acknowledged, only the ACK of END is missing
+                if (base == n_frames) {
+                    return true;
+                }
+                send_control(EI_AT_FRAME_ABORT, (uint8_t)base);
+                return false;
+            }
+            // go back N
+            next = base;
+            end_sent = false;
+            last_progress = ei_read_timer_ms();
+        }
+    }
+}
+
+/**
+ * @brief Receive exactly length bytes into buffer. Payloads are parsed straight into
+ * their place in buffer, only a tail shorter than the END payload goes through a bounce buffer.
+ *
+ * @return true if the whole buffer was received and the sender finished with END
+ */
+bool ei_at_binary_receive(uint8_t *buffer, size_t length)
+{
+    uint8_t rx[64];
+    uint8_t bounce[4];
+    ei_at_frame_parser_t parser;
+    size_t received = 0;
+    uint8_t expected = 0;
+    uint64_t nak_time = 0;
+    uint64_t last_progress = ei_read_timer_ms();
+    const uint64_t give_up_ms = (uint64_t)EI_AT_BINARY_TIMEOUT_MS * (EI_AT_BINARY_RETRIES + 1);
+
+    ei_at_frame_parser_reset(&parser, nullptr, 0);
+
+    while (1) {
+        size_t pending = ei_at_frame_parser_pending(&parser);
+        int n = ei_read_string((char *)rx, pending < sizeof(rx) ? pending : sizeof(rx));
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            if (ei_read_timer_ms() - last_progress > give_up_ms) {
+                send_control(EI_AT_FRAME_ABORT, expected);
+                return false;
+            }
+            continue;
+        }
+
+        size_t pos = 0;
+        while (pos < (size_t)n) {
+            size_t remaining = length - received;
+            size_t want = remaining < EI_AT_BINARY_MTU ? remaining : EI_AT_BINARY_MTU;
+
+            // only changed in between frames, a frame in progress keeps its destination
+            if (parser.pos == 0) {
+                parser.payload = want >= sizeof(bounce) ? buffer + received : bounce;
+                parser.payload_size = want >= sizeof(bounce) ? want : sizeof(bounce);
+            }
+
+            size_t consumed;
+            ei_at_frame_status_t status = ei_at_frame_parse(&parser, rx + pos, n - pos, &consumed);
+            pos += consumed;
+
+            if (status == EI_AT_FRAME_INCOMPLETE) {
+                break;
+            }
+
+            if (status == EI_AT_FRAME_BAD) {
+                send_nak(expected, &nak_time);
+            }
+            else if (parser.type == EI_AT_FRAME_DATA) {
+                if (parser.seq == expected && want > 0 && parser.length == want && parser.payload_stored) {
+                    if (parser.payload == bounce) {
+                        memcpy(buffer + received, bounce, want);
+                    }
+                    received += want;
+                    send_control(EI_AT_FRAME_ACK, expected);
+                    expected++;
+                    nak_time = 0;
+                    last_progress = ei_read_timer_ms();
+                }
+                else if ((uint8_t)(expected - parser.seq - 1) < EI_AT_BINARY_WINDOW) {
+                    // duplicate after a lost ACK, repeat the last cumulative ACK
+                    send_control(EI_AT_FRAME_ACK, (uint8_t)(expected - 1));
+                }
+                else {
+                    send_nak(expected, &nak_time);
+                }
+            }
+            else if (parser.type == EI_AT_FRAME_END) {
+                if (parser.seq == expected && remaining == 0 && parser.length == 4
+                    && parser.payload_stored && get_u32(parser.payload) == (uint32_t)length) {
+                    send_control(EI_AT_FRAME_ACK, expected);
+                    return true;
+                }
+                send_nak(expected, &nak_time);
+            }
+            else if (parser.type == EI_AT_FRAME_ABORT) {
+                return false;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Receive n_features values for AT+RUNIMPULSESTATIC in the negotiated format.
+ * I16 data are received into the upper half of features and widened in place, front
+ * to back, a float never overwrites an int16 that has not been read yet.
+ */
+bool ei_at_binary_receive_features(float *features, size_t n_features)
+{
+    if (transfer_format == EI_AT_TRANSFER_FORMAT_F32) {
+        return ei_at_binary_receive((uint8_t *)features, n_features * sizeof(float));
+    }
+
+    uint8_t *raw = (uint8_t *)features + n_features * sizeof(int16_t);
+
+    if (!ei_at_binary_receive(raw, n_features * sizeof(int16_t))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n_features; i++) {
+        int16_t v = (int16_t)(raw[2 * i] | (raw[2 * i + 1] << 8));
+        features[i] = (float)v;
+    }
+
+    return true;
+}
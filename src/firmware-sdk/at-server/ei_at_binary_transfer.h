@@ -0,0 +1,146 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_AT_BINARY_TRANSFER_H
+#define EI_AT_BINARY_TRANSFER_H
+
+/*
+ * Binary framed transfer for bulk data over the AT console.
+ *
+ * Enabled with AT+TRANSFERMODE=BINARY,[F32|I16], after which AT+RUNIMPULSESTATIC,
+ * AT+READBUFFER and AT+READRAW answer "OK BINARY MTU=<n> WINDOW=<n>" and move their
+ * data in frames instead of base64 / hex text:
+ *
+ *   0xA5 | type | seq | length (2 bytes, LE) | payload (length bytes) | CRC32 (4 bytes, LE)
+ *
+ * The CRC32 (IEEE 802.3) covers type, seq, length and payload. DATA frames carry up
+ * to EI_AT_BINARY_MTU bytes, numbered with a wrapping 8 bit seq. The receiver answers
+ * every in-order DATA frame with an ACK of its seq (cumulative) and a broken or
+ * out-of-order frame with a NAK carrying the seq it expects, at most once per timeout.
+ * Duplicates are answered with the last ACK again. The sender keeps up to
+ * EI_AT_BINARY_WINDOW frames in flight and goes back to the oldest unacknowledged
+ * frame on a NAK or after EI_AT_BINARY_TIMEOUT_MS without progress. Once everything is acknowledged, the sender
+ * sends END (payload: total number of bytes, 4 bytes LE), which is ACKed as well. ABORT
+ * from either side stops the transfer.
+ *
+ * RESULTS frames are sent by the device on its own, without ACK / END handshake, and
+ * carry a batch of inference result records (see inference/ei_result_stream.h). The
+ * seq counts RESULTS frames, so the receiver can tell when a batch got lost.
+ *
+ * For AT+RUNIMPULSESTATIC the payload is the raw feature array, as float32 or, with I16,
+ * as int16 values which are converted to float on the device. Everything is little endian.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+/** Maximum payload of a DATA frame */
+#ifndef EI_AT_BINARY_MTU
+#define EI_AT_BINARY_MTU            512
+#endif
+
+/** Maximum number of unacknowledged DATA frames */
+#ifndef EI_AT_BINARY_WINDOW
+#define EI_AT_BINARY_WINDOW         8
+#endif
+
+/** Time without progress before the sender retransmits (or the receiver gives up) */
+#ifndef EI_AT_BINARY_TIMEOUT_MS
+#define EI_AT_BINARY_TIMEOUT_MS     200
+#endif
+
+/** Retransmissions without progress before a transfer is aborted */
+#ifndef EI_AT_BINARY_RETRIES
+#define EI_AT_BINARY_RETRIES        10
+#endif
+
+#define EI_AT_FRAME_SOF             0xA5
+#define EI_AT_FRAME_HEADER_SIZE     5
+#define EI_AT_FRAME_OVERHEAD        (EI_AT_FRAME_HEADER_SIZE + 4)
+
+typedef enum {
+    EI_AT_FRAME_DATA = 0x01,
+    EI_AT_FRAME_ACK = 0x02,
+    EI_AT_FRAME_NAK = 0x03,
+    EI_AT_FRAME_END = 0x04,
+    EI_AT_FRAME_ABORT = 0x05,
+    EI_AT_FRAME_RESULTS = 0x06
+} ei_at_frame_type_t;
+
+typedef enum {
+    EI_AT_TRANSFER_FORMAT_F32 = 0,
+    EI_AT_TRANSFER_FORMAT_I16 = 1
+} ei_at_transfer_format_t;
+
+typedef enum {
+    EI_AT_FRAME_INCOMPLETE = 0,
+    EI_AT_FRAME_OK,
+    EI_AT_FRAME_BAD
+} ei_at_frame_status_t;
+
+/**
+ * @brief Incremental frame parser. The payload goes to the buffer set with
+ * ei_at_frame_parser_reset() if it fits (payload_stored). Frames with an unknown type
+ * or a length that doesn't fit the type are reported as bad right after the header.
+ */
+typedef struct {
+    uint8_t *payload;
+    size_t payload_size;
+    bool payload_stored;
+    uint8_t header[EI_AT_FRAME_HEADER_SIZE];
+    uint8_t crc_bytes[4];
+    size_t pos;
+    uint32_t crc;
+    uint8_t type;
+    uint8_t seq;
+    uint16_t length;
+} ei_at_frame_parser_t;
+
+uint32_t ei_at_crc32(uint32_t crc, const uint8_t *data, size_t length);
+
+void ei_at_frame_parser_reset(ei_at_frame_parser_t *parser, uint8_t *payload, size_t payload_size);
+size_t ei_at_frame_parser_pending(const ei_at_frame_parser_t *parser);
+ei_at_frame_status_t ei_at_frame_parse(ei_at_frame_parser_t *parser, const uint8_t *data, size_t length, size_t *consumed);
+size_t ei_at_frame_build_header(uint8_t *header, uint8_t type, uint8_t seq, uint16_t length);
+void ei_at_frame_send(uint8_t *buf, uint8_t type, uint8_t seq, uint16_t length);
+
+bool ei_at_binary_transfer_enabled(void);
+ei_at_transfer_format_t ei_at_binary_transfer_format(void);
+void ei_at_binary_transfer_set_mode(bool binary, ei_at_transfer_format_t format);
+
+bool ei_at_binary_send(size_t length, bool (*read_cb)(size_t offset, uint8_t *buffer, size_t length));
+bool ei_at_binary_receive(uint8_t *buffer, size_t length);
+bool ei_at_binary_receive_features(float *features, size_t n_features);
+
+#endif /* EI_AT_BINARY_TRANSFER_H */
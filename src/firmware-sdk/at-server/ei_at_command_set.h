@@ -44,7 +44,7 @@
  * If you are adding or modifying OPTIONAL commands,
  * just upgrade the release version.
  */
-#define AT_COMMAND_VERSION "1.8.0"
+#define AT_COMMAND_VERSION "1.8.2"
 
 /*************************************************************************************************/
 /* Required commands by Edge Impulse CLI Tools        */
@@ -126,6 +126,15 @@
 #define AT_BOOTMODE_HELP_TEXT       "Jump to bootloader"
 #define AT_INFO                     "INFO"
 #define AT_INFO_HELP_TEXT           "Prints details about compiled firmware and ML model"
+#define AT_OPPROFILE                "OPPROFILE"
+#define AT_OPPROFILE_ARGS           "ENABLE|CLEAR"
+#define AT_OPPROFILE_HELP_TEXT      "Lists per-operator profile of the last inferences, or enables (1/0) / clears it"
+#define AT_TRANSFERMODE             "TRANSFERMODE"
+#define AT_TRANSFERMODE_ARGS        "TEXT|BINARY,[F32|I16]"
+#define AT_TRANSFERMODE_HELP_TEXT   "Lists or sets the data transfer mode of RUNIMPULSESTATIC, READBUFFER and READRAW"
+#define AT_RESULTMODE               "RESULTMODE"
+#define AT_RESULTMODE_ARGS          "TEXT|BINARY,[BATCH]"
+#define AT_RESULTMODE_HELP_TEXT     "Lists or sets the output of RUNIMPULSE results, BINARY sends batches of result records"
 
 /*************************************************************************************************/
 /* HELP is not necessary as it is built-in into ATServer and
@@ -35,6 +35,7 @@
 #include "ei_at_server.h"
 #include "ei_at_command_set.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/ei_device_interface.h"
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -365,6 +366,7 @@ void ATServer::handle(char c)
         if (print_new_prompt) {
             print_prompt();
         }
+        ei_serial_flush();
         break;
     case 0x08: /* backspace */
     case 0x7f: /* also backspace on some terminals */
@@ -268,3 +268,191 @@ std::vector<unsigned char> base64_decode(std::string const& encoded_string) {
 
   return ret;
 }
+
+/** Sextet per input character, -1 for characters outside of the alphabet, -2 for '=' */
+static const int8_t base64_decode_table[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -2, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static inline void base64_encoder_flush(base64_encoder_t *enc)
+{
+    if (enc->out_len > 0) {
+        enc->write(enc->out, enc->out_len);
+        enc->out_len = 0;
+    }
+}
+
+void base64_encoder_init(base64_encoder_t *enc, void (*write)(const char *buf, size_t len))
+{
+    enc->write = write;
+    enc->carry_len = 0;
+    enc->out_len = 0;
+}
+
+void base64_encoder_update(base64_encoder_t *enc, const uint8_t *input, size_t input_size)
+{
+    // complete the group started by the previous call
+    while (enc->carry_len > 0 && enc->carry_len < 3 && input_size > 0) {
+        enc->carry[enc->carry_len++] = *input++;
+        input_size--;
+    }
+
+    if (enc->carry_len == 3) {
+        enc->carry_len = 0;
+        base64_encoder_update(enc, enc->carry, 3);
+    }
+
+    while (input_size >= 3) {
+        if (enc->out_len == EI_BASE64_ENCODER_BUF_SIZE) {
+            base64_encoder_flush(enc);
+        }
+
+        // as many whole groups as fit in the output buffer
+        size_t groups = (EI_BASE64_ENCODER_BUF_SIZE - enc->out_len) / 4;
+        if (groups > input_size / 3) {
+            groups = input_size / 3;
+        }
+
+        char *out = &enc->out[enc->out_len];
+        for (size_t i = 0; i < groups; i++) {
+            uint32_t v = ((uint32_t)input[0] << 16) | ((uint32_t)input[1] << 8) | input[2];
+            out[0] = base64_chars[(v >> 18) & 0x3f];
+            out[1] = base64_chars[(v >> 12) & 0x3f];
+            out[2] = base64_chars[(v >> 6) & 0x3f];
+            out[3] = base64_chars[v & 0x3f];
+            out += 4;
+            input += 3;
+        }
+
+        enc->out_len += groups * 4;
+        input_size -= groups * 3;
+    }
+
+    while (input_size > 0) {
+        enc->carry[enc->carry_len++] = *input++;
+        input_size--;
+    }
+}
+
+void base64_encoder_finish(base64_encoder_t *enc)
+{
+    if (enc->carry_len > 0) {
+        if (enc->out_len == EI_BASE64_ENCODER_BUF_SIZE) {
+            base64_encoder_flush(enc);
+        }
+
+        uint32_t v = (uint32_t)enc->carry[0] << 16;
+        if (enc->carry_len > 1) {
+            v |= (uint32_t)enc->carry[1] << 8;
+        }
+
+        char *out = &enc->out[enc->out_len];
+        out[0] = base64_chars[(v >> 18) & 0x3f];
+        out[1] = base64_chars[(v >> 12) & 0x3f];
+        out[2] = enc->carry_len > 1 ? base64_chars[(v >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        enc->out_len += 4;
+        enc->carry_len = 0;
+    }
+
+    base64_encoder_flush(enc);
+}
+
+void base64_decoder_init(base64_decoder_t *dec, void *out, size_t out_size)
+{
+    dec->out = (uint8_t *)out;
+    dec->out_size = out_size;
+    dec->out_len = 0;
+    dec->bits = 0;
+    dec->n_chars = 0;
+}
+
+/**
+ * Write the bytes of a (partial) group, n_chars sextets are in bits
+ */
+static inline void base64_decoder_put(base64_decoder_t *dec)
+{
+    uint32_t v = dec->bits << (6 * (4 - dec->n_chars));
+    size_t n_bytes = (dec->n_chars * 6) / 8;
+
+    for (size_t i = 0; i < n_bytes && dec->out_len < dec->out_size; i++) {
+        dec->out[dec->out_len++] = (uint8_t)(v >> (16 - 8 * i));
+    }
+
+    dec->bits = 0;
+    dec->n_chars = 0;
+}
+
+size_t base64_decoder_update(base64_decoder_t *dec, const char *input, size_t input_size)
+{
+    const uint8_t *in = (const uint8_t *)input;
+    const uint8_t *end = in + input_size;
+    size_t start_len = dec->out_len;
+
+    while (in < end) {
+        // whole groups of 4 valid characters
+        if (dec->n_chars == 0) {
+            while (end - in >= 4 && dec->out_size - dec->out_len >= 3) {
+                int32_t a = base64_decode_table[in[0]];
+                int32_t b = base64_decode_table[in[1]];
+                int32_t c = base64_decode_table[in[2]];
+                int32_t d = base64_decode_table[in[3]];
+
+                if ((a | b | c | d) < 0) {
+                    break;
+                }
+
+                uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+                uint8_t *out = &dec->out[dec->out_len];
+                out[0] = (uint8_t)(v >> 16);
+                out[1] = (uint8_t)(v >> 8);
+                out[2] = (uint8_t)v;
+                dec->out_len += 3;
+                in += 4;
+            }
+
+            if (in == end) {
+                break;
+            }
+        }
+
+        int8_t sextet = base64_decode_table[*in++];
+
+        if (sextet == -2) {
+            base64_decoder_put(dec);
+        }
+        else if (sextet >= 0) {
+            dec->bits = (dec->bits << 6) | (uint32_t)sextet;
+            if (++dec->n_chars == 4) {
+                base64_decoder_put(dec);
+            }
+        }
+    }
+
+    return dec->out_len - start_len;
+}
+
+size_t base64_decoder_finish(base64_decoder_t *dec)
+{
+    // unpadded end of the input
+    if (dec->n_chars > 0) {
+        base64_decoder_put(dec);
+    }
+
+    return dec->out_len;
+}
@@ -62,10 +62,41 @@
 
 */
 
+#include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <vector>
 
+/** Characters the streaming encoder collects before handing them to its sink, multiple of 4 */
+#ifndef EI_BASE64_ENCODER_BUF_SIZE
+#define EI_BASE64_ENCODER_BUF_SIZE  256
+#endif
+
+/**
+ * @brief Streaming base64 encoder state. Input can be fed in chunks of any size,
+ * output goes to the write sink in blocks of EI_BASE64_ENCODER_BUF_SIZE characters.
+ */
+typedef struct {
+    void (*write)(const char *buf, size_t len);
+    uint8_t carry[3];
+    uint8_t carry_len;
+    size_t out_len;
+    char out[EI_BASE64_ENCODER_BUF_SIZE];
+} base64_encoder_t;
+
+/**
+ * @brief Streaming base64 decoder state. Decodes straight into the output buffer,
+ * bytes that don't fit are dropped. '=' ends a group, so separately padded chunks
+ * can follow each other. Characters outside of the base64 alphabet are skipped.
+ */
+typedef struct {
+    uint8_t *out;
+    size_t out_size;
+    size_t out_len;
+    uint32_t bits;
+    uint8_t n_chars;
+} base64_decoder_t;
+
 /* Function prototypes ----------------------------------------------------- */
 void base64_encode(const char *input, size_t input_size, void (*putc_f)(char));
 void base64_encode_chunk(const char *input, size_t input_size, void (*putc_f)(char));
@@ -73,4 +104,11 @@ void base64_encode_finish(void (*putc_f)(char));
 int base64_encode_buffer(const char *input, size_t input_size, char *output, size_t output_size);
 std::vector<unsigned char> base64_decode(std::string const&);
 
+void base64_encoder_init(base64_encoder_t *enc, void (*write)(const char *buf, size_t len));
+void base64_encoder_update(base64_encoder_t *enc, const uint8_t *input, size_t input_size);
+void base64_encoder_finish(base64_encoder_t *enc);
+void base64_decoder_init(base64_decoder_t *dec, void *out, size_t out_size);
+size_t base64_decoder_update(base64_decoder_t *dec, const char *input, size_t input_size);
+size_t base64_decoder_finish(base64_decoder_t *dec);
+
 #endif /* EI_AT_BASE64_LIB_H */
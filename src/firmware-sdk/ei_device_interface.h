@@ -46,6 +46,19 @@ void ei_serial_setup(void);
 //TODO: remove as it is device specific
 void ei_write_string(char *data, int length);
 
+/**
+ * @brief Non-blocking read of up to max_length bytes from the serial port, binary safe.
+ * Returns the number of bytes read (0 if none are pending) or -1 if the target
+ * doesn't support it, in which case binary transfer mode can't be enabled.
+ */
+int ei_read_string(char *data, int max_length);
+
+/**
+ * @brief Block until everything written to the serial port so far is on its way to the host.
+ * Targets that buffer their output should override this, the default does nothing.
+ */
+void ei_serial_flush(void);
+
 //TODO: move to a one header with all method requied by FW SDK
 char ei_getchar();
 
@@ -37,6 +37,7 @@
 #include "ei_device_info_lib.h"
 #include "ei_device_memory.h"
 #include "ei_device_interface.h"
+#include "at-server/ei_at_binary_transfer.h"
 
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/classifier/ei_signal_with_axes.h"
@@ -65,6 +66,37 @@ __attribute__((weak)) bool ei_user_invoke_stop_lib(void)
     }
 }
 
+/**
+ * @brief Write a block of characters to the serial port. Targets should override this
+ * with a block write of their serial driver, the default goes through ei_putchar.
+ */
+__attribute__((weak)) void ei_write_string(char *data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        ei_putchar(data[i]);
+    }
+}
+
+/**
+ * @brief Binary safe serial read used by the binary transfer mode. ei_getchar() can't be
+ * used for that as it returns 0 for "no data", targets have to provide their own.
+ */
+__attribute__((weak)) int ei_read_string(char *data, int max_length)
+{
+    (void)data;
+    (void)max_length;
+    return -1;
+}
+
+__attribute__((weak)) void ei_serial_flush(void)
+{
+}
+
+static void serial_write(const char *buf, size_t len)
+{
+    ei_write_string((char *)buf, (int)len);
+}
+
 /**
  * @brief Helper function for sending a data from memory over the
  * serial port. Data are encoded into base64 on the fly.
@@ -78,9 +110,15 @@ __attribute__((weak)) bool read_encode_send_sample_buffer(size_t address, size_t
 {
     EiDeviceInfo *dev = EiDeviceInfo::get_device();
     EiDeviceMemory *memory = dev->get_memory();
-    // we are encoiding data into base64, so it needs to be divisible by 3
     const int buffer_size = 513;
     uint8_t* buffer = (uint8_t*)ei_malloc(buffer_size);
+    base64_encoder_t encoder;
+
+    if (buffer == NULL) {
+        return false;
+    }
+
+    base64_encoder_init(&encoder, serial_write);
 
     while (1) {
         size_t bytes_to_read = buffer_size;
@@ -90,6 +128,7 @@ __attribute__((weak)) bool read_encode_send_sample_buffer(size_t address, size_t
         }
 
         if (bytes_to_read == 0) {
+            base64_encoder_finish(&encoder);
             ei_free(buffer);
             return true;
         }
@@ -99,7 +138,7 @@ __attribute__((weak)) bool read_encode_send_sample_buffer(size_t address, size_t
             return false;
         }
 
-        base64_encode((char *)buffer, bytes_to_read, ei_putchar);
+        base64_encoder_update(&encoder, buffer, bytes_to_read);
 
         address += bytes_to_read;
         length -= bytes_to_read;
@@ -108,6 +147,64 @@ __attribute__((weak)) bool read_encode_send_sample_buffer(size_t address, size_t
     return true;
 }
 
+static EiDeviceMemory *binary_send_memory;
+static size_t binary_send_address;
+
+static bool binary_send_read(size_t offset, uint8_t *buffer, size_t length)
+{
+    return binary_send_memory->read_sample_data(buffer, binary_send_address + offset, length) == length;
+}
+
+/**
+ * @brief Binary transfer counterpart of read_encode_send_sample_buffer. Samples are
+ * sent in frames as they are stored, frames are re-read from memory on retransmission.
+ *
+ * @param address address of samples
+ * @param length number of samples (bytes)
+ * @return true if the host acknowledged all data
+ */
+__attribute__((weak)) bool read_send_sample_buffer_binary(size_t address, size_t length)
+{
+    EiDeviceInfo *dev = EiDeviceInfo::get_device();
+
+    binary_send_memory = dev->get_memory();
+    binary_send_address = address;
+
+    ei_printf("OK BINARY MTU=%d WINDOW=%d\n", EI_AT_BINARY_MTU, EI_AT_BINARY_WINDOW);
+
+    return ei_at_binary_send(length, binary_send_read);
+}
+
+/**
+ * @brief Binary transfer counterpart of run_impulse_static_data. The features are
+ * received in frames straight into the sample buffer, as float32 or int16.
+ */
+bool run_impulse_static_data_binary(bool debug, size_t length)
+{
+    float *data_pt = (float*)ei_malloc(length * sizeof(float));
+    if (data_pt == NULL) {
+        ei_printf("ERR: Memory allocation for data buffer failed\r\n");
+        return false;
+    }
+
+    ei_printf("OK BINARY MTU=%d WINDOW=%d\r\n", EI_AT_BINARY_MTU, EI_AT_BINARY_WINDOW);
+
+    if (!ei_at_binary_receive_features(data_pt, length)) {
+        ei_free(data_pt);
+        ei_printf("ERR: Binary transfer failed\r\n");
+        ei_printf("END OUTPUT\r\n");
+        return false;
+    }
+
+    ei_printf("TRANSFER COMPLETED %d\r\n", (int)length);
+    uint32_t res = (uint32_t)ei_start_impulse_static_data(debug, data_pt, length);
+    ei_free(data_pt);
+    ei_printf("RESULT %d\r\n", res);
+    ei_printf("END OUTPUT\r\n");
+
+    return true;
+}
+
 bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
 {
     size_t cur_pos = 0;
@@ -136,6 +233,10 @@ bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
         return false;
     }
 
+    // decoded straight into the sample buffer, chunk boundaries don't need to line up with base64 groups
+    base64_decoder_t decoder;
+    base64_decoder_init(&decoder, data_pt, length * sizeof(float));
+
     ei_printf("OK CHUNK=%d\r\n", (int)buf_len);
 
     while (cur_pos < length) {
@@ -157,15 +258,9 @@ bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
             }
         }
 
-        std::vector<unsigned char> decoded = base64_decode((const char*)temp_buf);
-
-        int copylength = decoded.size() > (length - cur_pos) * sizeof(float)
-                       ? (length - cur_pos) * sizeof(float)
-                       : decoded.size();
-
-        memcpy((void*)(data_pt + cur_pos), decoded.data(), copylength);
+        base64_decoder_update(&decoder, (const char*)temp_buf, buf_len);
 
-        cur_pos = cur_pos + copylength/sizeof(float);
+        cur_pos = decoder.out_len / sizeof(float);
         buf_pos = 0;
         ei_printf("OK %d \r\n", (int)cur_pos);
     }
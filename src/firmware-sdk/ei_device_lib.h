@@ -58,8 +58,16 @@ bool ei_user_invoke_stop_lib(void);
  */
 bool read_encode_send_sample_buffer(size_t address, size_t length);
 
+/**
+ * @brief Same as read_encode_send_sample_buffer, but sends the samples in binary
+ * frames, see at-server/ei_at_binary_transfer.h
+ */
+bool read_send_sample_buffer_binary(size_t address, size_t length);
+
 bool run_impulse_static_data(bool debug, size_t length, size_t buf_len);
 
+bool run_impulse_static_data_binary(bool debug, size_t length);
+
 EI_IMPULSE_ERROR ei_start_impulse_static_data(bool debug, float* data, size_t size);
 
 #endif /* EI_DEVICE_LIB_H */
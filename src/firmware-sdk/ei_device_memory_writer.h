@@ -0,0 +1,197 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_DEVICE_MEMORY_WRITER_H
+#define EI_DEVICE_MEMORY_WRITER_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "ei_device_memory.h"
+
+/**
+ * @brief Write-combining, block aligned writer for a file in the sample area of an EiDeviceMemory.
+ *
+ * append() collects data in RAM and only programs whole blocks, so callers don't have to care
+ * about the write granularity of the memory. The first block of the file is held back until
+ * flush_data(), so everything in it (e.g. the signature placeholder in a CBOR header) can still
+ * be updated in place with patch(), without reading, erasing and rewriting the block.
+ *
+ * The sample area has to be erased by the caller before writing.
+ */
+class EiDeviceMemoryWriter {
+public:
+    EiDeviceMemoryWriter()
+        : memory(nullptr)
+        , head_block(nullptr)
+        , tail_block(nullptr)
+        , start_address(0)
+        , file_size(0)
+        , error(false) {};
+
+    /**
+     * @brief Start a new file.
+     * @param mem Memory to write to
+     * @param buf Work buffer of at least 2 * mem->block_size bytes, owned by the caller
+     * @param address Start of the file in the sample area, has to be block aligned
+     * @return false if the address isn't block aligned
+     */
+    bool begin(EiDeviceMemory *mem, uint8_t *buf, uint32_t address = 0)
+    {
+        if (mem->block_size == 0 || (address % mem->block_size) != 0) {
+            return false;
+        }
+
+        memory = mem;
+        head_block = buf;
+        tail_block = buf + mem->block_size;
+        start_address = address;
+        file_size = 0;
+        error = false;
+
+        memset(head_block, 0xFF, memory->block_size);
+
+        return true;
+    }
+
+    /**
+     * @brief Add data to the end of the file. Every block that's filled up (except the
+     * first one) is programmed right away, whole blocks in the input are written straight
+     * from the caller's buffer.
+     * @return number of bytes handled, if it differs from size a write failed
+     */
+    uint32_t append(const uint8_t *data, uint32_t size)
+    {
+        const uint32_t block_size = memory->block_size;
+        uint32_t handled = 0;
+
+        while (handled < size && !error) {
+            uint32_t block_offset = file_size % block_size;
+            uint32_t n = block_size - block_offset;
+            if (n > size - handled) {
+                n = size - handled;
+            }
+
+            if (file_size < block_size) {
+                memcpy(head_block + block_offset, data + handled, n);
+            }
+            else if (block_offset == 0 && n == block_size) {
+                if (!program(data + handled, file_size)) {
+                    break;
+                }
+            }
+            else {
+                memcpy(tail_block + block_offset, data + handled, n);
+                if (block_offset + n == block_size && !program(tail_block, file_size - block_offset)) {
+                    break;
+                }
+            }
+
+            file_size += n;
+            handled += n;
+        }
+
+        return handled;
+    }
+
+    /**
+     * @brief Overwrite already appended data in the first block of the file
+     * @return false if the region isn't written yet or lies outside of the first block
+     */
+    bool patch(uint32_t offset, const uint8_t *data, uint32_t size)
+    {
+        if (offset + size > file_size || offset + size > memory->block_size) {
+            return false;
+        }
+
+        memcpy(head_block + offset, data, size);
+
+        return true;
+    }
+
+    /**
+     * @brief Program the partially filled last block and the first block of the file (unused
+     * bytes are filled with 0xFF) and flush the memory. No data can be appended afterwards.
+     * @return false if any write of the file failed
+     */
+    bool flush_data(void)
+    {
+        const uint32_t block_size = memory->block_size;
+        uint32_t block_offset = file_size % block_size;
+
+        if (!error && file_size > block_size && block_offset != 0) {
+            memset(tail_block + block_offset, 0xFF, block_size - block_offset);
+            program(tail_block, file_size - block_offset);
+        }
+
+        if (!error && file_size > 0) {
+            program(head_block, 0);
+        }
+
+        memory->flush_data();
+
+        // anything appended after this would end up in an already programmed block
+        bool ok = !error;
+        error = true;
+
+        return ok;
+    }
+
+    /**
+     * @brief Number of bytes in the file
+     */
+    uint32_t size(void)
+    {
+        return file_size;
+    }
+
+private:
+    bool program(const uint8_t *block, uint32_t offset)
+    {
+        if (memory->write_sample_data(block, start_address + offset, memory->block_size) != memory->block_size) {
+            error = true;
+        }
+
+        return !error;
+    }
+
+    EiDeviceMemory *memory;
+    uint8_t *head_block;
+    uint8_t *tail_block;
+    uint32_t start_address;
+    uint32_t file_size;
+    bool error;
+};
+
+#endif /* EI_DEVICE_MEMORY_WRITER_H */
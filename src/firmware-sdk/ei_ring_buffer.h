@@ -0,0 +1,240 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_RING_BUFFER_H
+#define EI_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * One context (e.g. a DMA or timer callback) calls push(), another one (e.g. the
+ * inference loop) calls available(), peek(), pop() and consume(). The read and
+ * write positions run from 0 to 2 * capacity (so a full buffer can be told apart
+ * from an empty one) and are only ever written by their owner, so no locking is
+ * needed as long as there is exactly one producer and one consumer.
+ *
+ * Samples that don't fit are dropped by push() and counted as overruns.
+ */
+template <typename T>
+class EiRingBuffer {
+public:
+    EiRingBuffer()
+        : buffer(nullptr)
+        , capacity(0)
+        , write_pos(0)
+        , read_pos(0)
+        , overrun_count(0)
+        , high_water_mark(0) {};
+
+    /**
+     * @brief Attach storage to the ring buffer and clear it.
+     * Only call when neither the producer nor the consumer is running.
+     * @param buf Storage for at least cap elements, owned by the caller
+     * @param cap Number of elements in buf
+     */
+    void init(T *buf, size_t cap)
+    {
+        buffer = buf;
+        capacity = cap;
+        write_pos.store(0, std::memory_order_relaxed);
+        read_pos.store(0, std::memory_order_relaxed);
+        overrun_count.store(0, std::memory_order_relaxed);
+        high_water_mark.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Producer: copy elements into the ring buffer
+     * @return Number of elements written, anything beyond free space is dropped
+     */
+    size_t push(const T *data, size_t count)
+    {
+        size_t wr = write_pos.load(std::memory_order_relaxed);
+        size_t used = distance(wr, read_pos.load(std::memory_order_acquire));
+        size_t free_space = capacity - used;
+
+        if (count > free_space) {
+            overrun_count.fetch_add(count - free_space, std::memory_order_relaxed);
+            count = free_space;
+        }
+
+        size_t ix = to_index(wr);
+        size_t first = (count < capacity - ix) ? count : capacity - ix;
+        memcpy(&buffer[ix], data, first * sizeof(T));
+        memcpy(&buffer[0], data + first, (count - first) * sizeof(T));
+
+        write_pos.store(advance(wr, count), std::memory_order_release);
+
+        used += count;
+        if (used > high_water_mark.load(std::memory_order_relaxed)) {
+            high_water_mark.store(used, std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Producer: number of elements push() can take without dropping any
+     */
+    size_t free_space(void) const
+    {
+        return capacity - distance(write_pos.load(std::memory_order_relaxed), read_pos.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Consumer: number of elements ready to be read
+     */
+    size_t available(void) const
+    {
+        return distance(write_pos.load(std::memory_order_acquire), read_pos.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Consumer: get a pointer into the ring buffer without copying.
+     * The window starts offset elements after the oldest element and is cut
+     * at the end of the storage, call again with a larger offset for the rest.
+     * @param offset Offset from the oldest unread element
+     * @param length Number of elements wanted
+     * @param ptr Set to the first element of the window
+     * @return Number of contiguous elements at ptr, 0 if offset is out of range
+     */
+    size_t peek(size_t offset, size_t length, const T **ptr) const
+    {
+        size_t avail = available();
+        if (offset >= avail) {
+            return 0;
+        }
+        if (length > avail - offset) {
+            length = avail - offset;
+        }
+
+        size_t ix = to_index(advance(read_pos.load(std::memory_order_relaxed), offset));
+        *ptr = &buffer[ix];
+
+        return (length < capacity - ix) ? length : capacity - ix;
+    }
+
+    /**
+     * @brief Consumer: drop elements that have been read through peek()
+     */
+    void consume(size_t count)
+    {
+        size_t avail = available();
+        if (count > avail) {
+            count = avail;
+        }
+        read_pos.store(advance(read_pos.load(std::memory_order_relaxed), count), std::memory_order_release);
+    }
+
+    /**
+     * @brief Consumer: copy elements out of the ring buffer
+     * @return Number of elements copied
+     */
+    size_t pop(T *out, size_t count)
+    {
+        size_t copied = 0;
+        const T *src;
+
+        while (copied < count) {
+            size_t n = peek(copied, count - copied, &src);
+            if (n == 0) {
+                break;
+            }
+            memcpy(out + copied, src, n * sizeof(T));
+            copied += n;
+        }
+        consume(copied);
+
+        return copied;
+    }
+
+    /**
+     * @brief Consumer: drop everything that is currently in the buffer
+     */
+    void flush(void)
+    {
+        consume(available());
+    }
+
+    size_t get_capacity(void) const
+    {
+        return capacity;
+    }
+
+    /**
+     * @brief Total number of elements dropped by push() because the buffer was full
+     */
+    uint32_t get_overrun_count(void) const
+    {
+        return overrun_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Highest number of elements that were in the buffer at once
+     */
+    size_t get_high_water_mark(void) const
+    {
+        return high_water_mark.load(std::memory_order_relaxed);
+    }
+
+private:
+    size_t advance(size_t pos, size_t n) const
+    {
+        pos += n;
+        return (pos >= 2 * capacity) ? pos - 2 * capacity : pos;
+    }
+
+    size_t distance(size_t wr, size_t rd) const
+    {
+        return (wr >= rd) ? wr - rd : wr + 2 * capacity - rd;
+    }
+
+    size_t to_index(size_t pos) const
+    {
+        return (pos >= capacity) ? pos - capacity : pos;
+    }
+
+    T *buffer;
+    size_t capacity;
+    std::atomic<size_t> write_pos; // only written by the producer
+    std::atomic<size_t> read_pos;  // only written by the consumer
+    std::atomic<uint32_t> overrun_count;
+    std::atomic<size_t> high_water_mark;
+};
+
+#endif /* EI_RING_BUFFER_H */
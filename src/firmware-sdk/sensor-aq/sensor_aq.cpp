@@ -39,6 +39,9 @@
 //#include "qcbor.h"
 //#include "setup.h"
 #include "sensor_aq.h"
+extern "C" {
+#include "../QCBOR/src/ieee754.h"
+}
 
 
 extern void ei_printf(const char *format, ...);
@@ -207,6 +210,8 @@ int sensor_aq_init(sensor_aq_ctx *ctx, sensor_aq_payload_info *payload_info, EI_
     //int ctx_err;
 
     ctx->axis_count = 0;
+    ctx->batch_active = false;
+    ctx->batch_len = 0;
 
     QCBOREncode_Init(&ctx->encode_context, ctx->cbor_buffer);
     QCBOREncode_OpenMap(&ctx->encode_context);
@@ -468,6 +473,158 @@ int sensor_aq_add_data_batch(sensor_aq_ctx *ctx, int16_t values[], size_t values
     return sensor_aq_flush_buffer(ctx);
 }
 
+/**
+ * Largest encoded size of a single sample in the batched writer
+ */
+static size_t sensor_aq_batch_max_sample_size(sensor_aq_ctx *ctx, sensor_aq_encoding_t encoding) {
+    const size_t value_size = encoding == EI_SENSOR_AQ_ENCODING_FLOAT32 ? 5 : 3;
+    // array header (axis count is always < 24, so a single byte) + values
+    return (ctx->axis_count == 1 ? 0 : 1) + ctx->axis_count * value_size;
+}
+
+/**
+ * Append a CBOR head (major type + argument) for an argument < 65536
+ */
+static uint8_t *sensor_aq_batch_put_head(uint8_t *out, uint8_t major_type, uint16_t argument) {
+    if (argument < 24) {
+        *out++ = major_type | (uint8_t)argument;
+    }
+    else if (argument < 256) {
+        *out++ = major_type | 24;
+        *out++ = (uint8_t)argument;
+    }
+    else {
+        *out++ = major_type | 25;
+        *out++ = (uint8_t)(argument >> 8);
+        *out++ = (uint8_t)argument;
+    }
+    return out;
+}
+
+static uint8_t *sensor_aq_batch_put_value(uint8_t *out, sensor_aq_encoding_t encoding, float value) {
+    switch (encoding) {
+        case EI_SENSOR_AQ_ENCODING_FLOAT16: {
+            uint16_t half = IEEE754_FloatToHalf(value);
+            *out++ = 0xf9;
+            *out++ = (uint8_t)(half >> 8);
+            *out++ = (uint8_t)half;
+            break;
+        }
+        case EI_SENSOR_AQ_ENCODING_INT16: {
+            float rounded = value < 0 ? value - 0.5f : value + 0.5f;
+            int32_t i = rounded >= 32767.0f ? 32767 : rounded <= -32768.0f ? -32768 : (int32_t)rounded;
+            // negative integers are major type 1 with argument -1 - value
+            out = i < 0 ? sensor_aq_batch_put_head(out, 0x20, (uint16_t)(-1 - i)) :
+                sensor_aq_batch_put_head(out, 0x00, (uint16_t)i);
+            break;
+        }
+        default: {
+            uint32_t single;
+            memcpy(&single, &value, sizeof(single));
+            *out++ = 0xfa;
+            *out++ = (uint8_t)(single >> 24);
+            *out++ = (uint8_t)(single >> 16);
+            *out++ = (uint8_t)(single >> 8);
+            *out++ = (uint8_t)single;
+            break;
+        }
+    }
+    return out;
+}
+
+/**
+ * Start writing samples in batches. Samples added with sensor_aq_batch_add() are encoded straight into
+ * the CBOR buffer and only hashed and written once `flush_threshold` bytes are staged, rather than
+ * going through QCBOR, the signature and the stream for every sample.
+ * Call sensor_aq_batch_flush() (or sensor_aq_finish()) when done.
+ * @param ctx The context (after sensor_aq_init())
+ * @param encoding How values are encoded
+ * @param flush_threshold Bytes to stage before writing, 0 (or anything over the CBOR buffer) to use the whole buffer
+ */
+int sensor_aq_batch_begin(sensor_aq_ctx *ctx, sensor_aq_encoding_t encoding, size_t flush_threshold) {
+    if (ctx == NULL) {
+        return AQ_CTX_IS_NULL;
+    }
+
+    const size_t max_sample_size = sensor_aq_batch_max_sample_size(ctx, encoding);
+    if (ctx->axis_count == 0 || max_sample_size > ctx->cbor_buffer.len) {
+        return AQ_BATCH_SAMPLE_DOES_NOT_FIT;
+    }
+
+    // a full sample always fits after reaching the threshold - 1
+    const size_t max_threshold = ctx->cbor_buffer.len - max_sample_size + 1;
+    if (flush_threshold == 0 || flush_threshold > max_threshold) {
+        flush_threshold = max_threshold;
+    }
+
+    ctx->batch_active = true;
+    ctx->batch_encoding = encoding;
+    ctx->batch_len = 0;
+    ctx->batch_flush_threshold = flush_threshold;
+
+    return AQ_OK;
+}
+
+/**
+ * Add data for a single interval to the current batch
+ * @param ctx The context
+ * @param values Values for the current frame
+ * @param values_size Size of the values
+ */
+int sensor_aq_batch_add(sensor_aq_ctx *ctx, const float values[], size_t values_size) {
+    if (!ctx->batch_active) {
+        return AQ_BATCH_NOT_STARTED;
+    }
+    if (values_size != ctx->axis_count) {
+        return AQ_VALUES_SIZE_DOES_NOT_MATCH_AXIS_COUNT;
+    }
+
+    uint8_t *out = (uint8_t*)ctx->cbor_buffer.ptr + ctx->batch_len;
+
+    // same layout as sensor_aq_add_data(): single axis is a flat value, otherwise an array
+    if (values_size != 1) {
+        *out++ = 0x80 | (uint8_t)values_size;
+    }
+    for (size_t ix = 0; ix < values_size; ix++) {
+        out = sensor_aq_batch_put_value(out, ctx->batch_encoding, values[ix]);
+    }
+
+    ctx->batch_len = out - (uint8_t*)ctx->cbor_buffer.ptr;
+
+    if (ctx->batch_len >= ctx->batch_flush_threshold) {
+        return sensor_aq_batch_flush(ctx);
+    }
+
+    return AQ_OK;
+}
+
+/**
+ * Hash and write all staged samples
+ */
+int sensor_aq_batch_flush(sensor_aq_ctx *ctx) {
+    if (!ctx->batch_active || ctx->batch_len == 0) {
+        return AQ_OK;
+    }
+
+    if (ctx->stream == NULL) {
+        return AQ_STREAM_IS_NULL;
+    }
+
+    const size_t len = ctx->batch_len;
+    ctx->batch_len = 0;
+
+    int ctx_err = ctx->signature_ctx->update(ctx->signature_ctx, (const uint8_t*)ctx->cbor_buffer.ptr, len);
+    if (ctx_err != 0) {
+        return ctx_err;
+    }
+
+    if (ei_fwrite(ctx, ctx->cbor_buffer.ptr, 1, len) != len) {
+        return AQ_STREAM_WRITE_FAILED;
+    }
+
+    return AQ_OK;
+}
+
 int sensor_aq_finish(sensor_aq_ctx *ctx) {
     uint8_t final_byte[] = { 0xff };
 
@@ -475,6 +632,12 @@ int sensor_aq_finish(sensor_aq_ctx *ctx) {
         return AQ_STREAM_IS_NULL;
     }
 
+    int flush_err = sensor_aq_batch_flush(ctx);
+    if (flush_err != AQ_OK) {
+        return flush_err;
+    }
+    ctx->batch_active = false;
+
     // Update the signature
     int ctx_err = ctx->signature_ctx->update(ctx->signature_ctx, final_byte, 1);
     if (ctx_err != 0) {
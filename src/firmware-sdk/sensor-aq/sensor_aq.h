@@ -88,9 +88,23 @@ typedef enum {
     AQ_STREAM_FSEEK_FAILED = -6017,
     AQ_SIGNATURE_CTX_IS_NULL = -6018,
     AQ_BATCH_ONLY_SUPPORTS_SINGLE_AXIS = -6019,
-    AQ_OUT_OF_MEM = -6020
+    AQ_OUT_OF_MEM = -6020,
+    AQ_BATCH_NOT_STARTED = -6021,
+    AQ_BATCH_SAMPLE_DOES_NOT_FIT = -6022
 } sensor_aq_status;
 
+/**
+ * How the batched writer (sensor_aq_batch_begin()) encodes values
+ */
+typedef enum {
+    // CBOR single precision float (lossless for float input)
+    EI_SENSOR_AQ_ENCODING_FLOAT32 = 0,
+    // CBOR half precision float, 3 bytes per value, ~3 significant digits
+    EI_SENSOR_AQ_ENCODING_FLOAT16 = 1,
+    // CBOR integer, values are rounded and clamped to int16 range
+    EI_SENSOR_AQ_ENCODING_INT16 = 2
+} sensor_aq_encoding_t;
+
 /**
  * Buffer context
  */
@@ -172,6 +186,12 @@ typedef struct {
 
     // active stream
     EI_SENSOR_AQ_STREAM *stream;
+
+    // batched writer, see sensor_aq_batch_begin() (samples are staged in the CBOR buffer)
+    bool batch_active;
+    sensor_aq_encoding_t batch_encoding;
+    size_t batch_len;
+    size_t batch_flush_threshold;
 } sensor_aq_ctx;
 
 /**
@@ -208,4 +228,8 @@ int sensor_aq_add_data_i16(sensor_aq_ctx *ctx, int16_t values[], size_t values_s
 int sensor_aq_add_data_batch(sensor_aq_ctx *ctx, int16_t values[], size_t values_size);
 int sensor_aq_finish(sensor_aq_ctx *ctx);
 
+int sensor_aq_batch_begin(sensor_aq_ctx *ctx, sensor_aq_encoding_t encoding, size_t flush_threshold);
+int sensor_aq_batch_add(sensor_aq_ctx *ctx, const float values[], size_t values_size);
+int sensor_aq_batch_flush(sensor_aq_ctx *ctx);
+
 #endif /* EI_SENSOR_AQ_H */
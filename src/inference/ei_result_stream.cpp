@@ -0,0 +1,246 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <cstring>
+#include "ei_result_stream.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/at-server/ei_at_binary_transfer.h"
+
+/* Private variables ------------------------------------------------------- */
+static ei_result_mode_t result_mode = EI_RESULT_MODE_TEXT;
+static uint16_t batch_records = EI_RESULT_STREAM_DEFAULT_BATCH;
+static uint16_t pending_records = 0;
+static size_t pending_bytes = 0;
+static uint8_t frame_seq = 0;
+// room for the frame header in front of the batch and the CRC behind it
+static uint8_t frame_buf[EI_AT_FRAME_HEADER_SIZE + EI_RESULT_STREAM_BUFFER_SIZE + 4];
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void put_f32(uint8_t *p, float v)
+{
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    put_u32(p, u);
+}
+
+static inline uint8_t quantize_score(float v)
+{
+    if (!(v > 0.0f)) {
+        return 0;
+    }
+    if (v >= 1.0f) {
+        return 255;
+    }
+    return (uint8_t)(v * 255.0f + 0.5f);
+}
+
+static inline uint16_t clamp_u16(uint32_t v)
+{
+    return v > 0xffff ? 0xffff : (uint16_t)v;
+}
+
+size_t ei_result_stream_encode(
+    const ei_impulse_t *impulse,
+    const ei_impulse_result_t *result,
+    uint32_t timestamp_ms,
+    uint32_t overrun_count,
+    uint8_t *out,
+    size_t out_size)
+{
+    const bool has_anomaly = impulse->has_anomaly != EI_ANOMALY_TYPE_UNKNOWN;
+    size_t entry_size = 0;
+    size_t count = 0;
+    uint16_t top[EI_RESULT_STREAM_MAX_ENTRIES];
+
+    if (impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION) {
+        // highest scores first, stop at the first one that quantizes to 0 (but keep the top label)
+        entry_size = 2;
+        while (count < EI_RESULT_STREAM_MAX_ENTRIES && count < impulse->label_count) {
+            int best = -1;
+            for (uint16_t ix = 0; ix < impulse->label_count; ix++) {
+                bool taken = false;
+                for (size_t t = 0; t < count; t++) {
+                    if (top[t] == ix) {
+                        taken = true;
+                        break;
+                    }
+                }
+                if (!taken && (best < 0 || result->classification[ix].value > result->classification[best].value)) {
+                    best = ix;
+                }
+            }
+            if (count > 0 && quantize_score(result->classification[best].value) == 0) {
+                break;
+            }
+            top[count++] = (uint16_t)best;
+        }
+    }
+    else if (impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
+        entry_size = 4;
+        count = 1;
+    }
+    else if (impulse->results_type == EI_CLASSIFIER_TYPE_OBJECT_DETECTION) {
+        entry_size = 10;
+        for (uint32_t ix = 0; ix < result->bounding_boxes_count && count < EI_RESULT_STREAM_MAX_ENTRIES; ix++) {
+            if (result->bounding_boxes[ix].value != 0) {
+                count++;
+            }
+        }
+    }
+
+    const size_t length = EI_RESULT_RECORD_HEADER_SIZE + (has_anomaly ? 8 : 0) + count * entry_size;
+    if (length > out_size || length > 0xff) {
+        return 0;
+    }
+
+    out[0] = EI_RESULT_RECORD_VERSION;
+    out[1] = (uint8_t)length;
+    out[2] = (uint8_t)impulse->results_type;
+    out[3] = has_anomaly ? EI_RESULT_FLAG_ANOMALY : 0;
+    out[4] = (uint8_t)count;
+    put_u32(out + 5, timestamp_ms);
+    put_u32(out + 9, (uint32_t)result->timing.dsp_us);
+    put_u32(out + 13, (uint32_t)result->timing.classification_us);
+    put_u32(out + 17, overrun_count);
+
+    uint8_t *p = out + EI_RESULT_RECORD_HEADER_SIZE;
+    if (has_anomaly) {
+        put_u32(p, (uint32_t)result->timing.anomaly_us);
+        put_f32(p + 4, result->anomaly);
+        p += 8;
+    }
+
+    if (impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION) {
+        for (size_t n = 0; n < count; n++) {
+            p[0] = (uint8_t)top[n];
+            p[1] = quantize_score(result->classification[top[n]].value);
+            p += 2;
+        }
+    }
+    else if (impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
+        put_f32(p, result->classification[0].value);
+    }
+    else if (impulse->results_type == EI_CLASSIFIER_TYPE_OBJECT_DETECTION) {
+        size_t n = 0;
+        for (uint32_t ix = 0; ix < result->bounding_boxes_count && n < count; ix++) {
+            const ei_impulse_result_bounding_box_t &bb = result->bounding_boxes[ix];
+            if (bb.value == 0) {
+                continue;
+            }
+            // labels point into impulse->categories
+            uint8_t label_ix = 0xff;
+            for (uint16_t lx = 0; lx < impulse->label_count; lx++) {
+                if (bb.label == impulse->categories[lx] || strcmp(bb.label, impulse->categories[lx]) == 0) {
+                    label_ix = (uint8_t)lx;
+                    break;
+                }
+            }
+            p[0] = label_ix;
+            p[1] = quantize_score(bb.value);
+            put_u16(p + 2, clamp_u16(bb.x));
+            put_u16(p + 4, clamp_u16(bb.y));
+            put_u16(p + 6, clamp_u16(bb.width));
+            put_u16(p + 8, clamp_u16(bb.height));
+            p += 10;
+            n++;
+        }
+    }
+
+    return length;
+}
+
+void ei_result_stream_flush(void)
+{
+    if (pending_records == 0) {
+        return;
+    }
+
+    ei_at_frame_send(frame_buf, EI_AT_FRAME_RESULTS, frame_seq++, (uint16_t)pending_bytes);
+    pending_records = 0;
+    pending_bytes = 0;
+}
+
+void ei_result_stream_push(const ei_impulse_t *impulse, const ei_impulse_result_t *result, uint32_t overrun_count)
+{
+    uint8_t *batch = frame_buf + EI_AT_FRAME_HEADER_SIZE;
+    const uint32_t timestamp_ms = (uint32_t)ei_read_timer_ms();
+
+    size_t length = ei_result_stream_encode(impulse, result, timestamp_ms, overrun_count,
+        batch + pending_bytes, EI_RESULT_STREAM_BUFFER_SIZE - pending_bytes);
+    if (length == 0 && pending_records > 0) {
+        ei_result_stream_flush();
+        length = ei_result_stream_encode(impulse, result, timestamp_ms, overrun_count,
+            batch, EI_RESULT_STREAM_BUFFER_SIZE);
+    }
+    if (length == 0) {
+        ei_printf("ERR: Result record doesn't fit EI_RESULT_STREAM_BUFFER_SIZE\n");
+        return;
+    }
+
+    pending_bytes += length;
+    if (++pending_records >= batch_records) {
+        ei_result_stream_flush();
+    }
+}
+
+void ei_result_stream_set_mode(ei_result_mode_t mode, uint16_t batch)
+{
+    ei_result_stream_flush();
+    result_mode = mode;
+    batch_records = batch > 0 ? batch : 1;
+}
+
+ei_result_mode_t ei_result_stream_get_mode(void)
+{
+    return result_mode;
+}
+
+uint16_t ei_result_stream_get_batch(void)
+{
+    return batch_records;
+}
@@ -0,0 +1,125 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_RESULT_STREAM_H
+#define EI_RESULT_STREAM_H
+
+/*
+ * Binary result stream.
+ *
+ * With AT+RESULTMODE=BINARY,<batch> every inference result is encoded into a small
+ * record instead of being printed with ei_print_results(). Records are collected in
+ * RAM and sent as one EI_AT_FRAME_RESULTS frame (see ei_at_binary_transfer.h) once
+ * <batch> records are in, the buffer is full, or inferencing stops.
+ *
+ * Record (version 1, little endian):
+ *
+ *   version (1) | length (1) | results_type (1) | flags (1) | count (1) |
+ *   timestamp_ms (4) | dsp_us (4) | classification_us (4) | overrun_count (4) |
+ *   [anomaly_us (4) | anomaly (float, 4)]   only if flags & EI_RESULT_FLAG_ANOMALY
+ *   count entries
+ *
+ * length covers the whole record, so a reader can skip records it doesn't understand.
+ * overrun_count is the total number of samples dropped by the sampler since inferencing
+ * started, only while it records (not between the windows of non-continuous inferencing).
+ * The entries depend on results_type:
+ *
+ *   classification:   label index (1) | score * 255 (1), highest score first, labels
+ *                     with a score that rounds to 0 are left out (except the top one)
+ *   regression:       value (float, 4)
+ *   object detection: label index (1) | score * 255 (1) | x (2) | y (2) | width (2) | height (2)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+
+#define EI_RESULT_RECORD_VERSION        1
+#define EI_RESULT_RECORD_HEADER_SIZE    21
+#define EI_RESULT_FLAG_ANOMALY          0x01
+
+/** Size of the RAM batch, also the largest RESULTS frame payload */
+#ifndef EI_RESULT_STREAM_BUFFER_SIZE
+#define EI_RESULT_STREAM_BUFFER_SIZE    512
+#endif
+
+/** Maximum number of labels / bounding boxes in one record */
+#ifndef EI_RESULT_STREAM_MAX_ENTRIES
+#define EI_RESULT_STREAM_MAX_ENTRIES    8
+#endif
+
+/** Records per batch if AT+RESULTMODE=BINARY doesn't give one */
+#ifndef EI_RESULT_STREAM_DEFAULT_BATCH
+#define EI_RESULT_STREAM_DEFAULT_BATCH  10
+#endif
+
+typedef enum {
+    EI_RESULT_MODE_TEXT = 0,
+    EI_RESULT_MODE_BINARY
+} ei_result_mode_t;
+
+/**
+ * @brief Encode one result record
+ * @param out Output buffer
+ * @param out_size Size of out
+ * @return Record length, 0 if out is too small
+ */
+size_t ei_result_stream_encode(
+    const ei_impulse_t *impulse,
+    const ei_impulse_result_t *result,
+    uint32_t timestamp_ms,
+    uint32_t overrun_count,
+    uint8_t *out,
+    size_t out_size);
+
+/**
+ * @brief Encode a result into the batch, sends the batch when it is complete
+ * @param overrun_count Samples dropped by the sampler so far
+ */
+void ei_result_stream_push(const ei_impulse_t *impulse, const ei_impulse_result_t *result, uint32_t overrun_count);
+
+/**
+ * @brief Send the records that are still in the batch
+ */
+void ei_result_stream_flush(void);
+
+/**
+ * @brief Switch between text and binary output, pending records are sent first
+ * @param batch Records per RESULTS frame (binary mode only)
+ */
+void ei_result_stream_set_mode(ei_result_mode_t mode, uint16_t batch);
+ei_result_mode_t ei_result_stream_get_mode(void);
+uint16_t ei_result_stream_get_batch(void);
+
+#endif /* EI_RESULT_STREAM_H */
@@ -39,8 +39,11 @@
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "firmware-sdk/ei_device_info_lib.h"
+#include "firmware-sdk/ei_ring_buffer.h"
 #include "sensors/ei_sensor_imu.h"
 #include "ei_run_impulse.h"
+#include "ei_result_stream.h"
+#include "ei_console.h"
 
 typedef enum {
     INFERENCE_STOPPED,
@@ -59,33 +62,80 @@ static bool debug_mode = false;
 static float samples_circ_buff[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
 static int samples_wr_index = 0;
 static float confidence_threshold = 0.5f;
+/* hand-off between the sampler callback and the inference loop */
+static float samples_ring_storage[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE * 2];
+static EiRingBuffer<float> samples_ring;
+static uint32_t last_overrun_count = 0;
+static ei_console_policy_t saved_console_policy = EI_CONSOLE_DEFAULT_POLICY;
 
 /**
- * @brief Called for each single sample
+ * @brief Called by the sampler with one or more samples
  *
  */
 bool samples_callback(const void *raw_sample, uint32_t raw_sample_size)
 {
-    if(state != INFERENCE_SAMPLING) {
-        // stop collecting samples if we are not in SAMPLING state
+    if(state == INFERENCE_STOPPED || state == INFERENCE_WAITING) {
+        // stop collecting samples if we are not sampling or classifying
         return true;
     }
 
-    float *sample = (float *)raw_sample;
+    samples_ring.push((const float *)raw_sample, raw_sample_size / sizeof(float));
 
-    for(int i = 0; i < (int)(raw_sample_size / sizeof(float)); i++) {
-        samples_circ_buff[samples_wr_index++] = sample[i];
-        if(samples_wr_index > EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+    return false;
+}
+
+/**
+ * @brief signal_t callback, maps the window onto the circular buffer.
+ * The oldest sample is at samples_wr_index, so offset 0 starts there and wraps at the end.
+ */
+static int samples_circ_buff_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    if(offset + length > EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+        return EIDSP_OUT_OF_BOUNDS;
+    }
+
+    size_t start = samples_wr_index + offset;
+    if(start >= EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+        start -= EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE;
+    }
+
+    size_t first = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE - start;
+    if(first > length) {
+        first = length;
+    }
+
+    memcpy(out_ptr, &samples_circ_buff[start], first * sizeof(float));
+    memcpy(out_ptr + first, &samples_circ_buff[0], (length - first) * sizeof(float));
+
+    return EIDSP_OK;
+}
+
+/**
+ * @brief Move a full set of samples from the ring buffer to the inference window
+ *
+ * @return true if samples_per_inference samples were copied
+ */
+static bool samples_get_window(void)
+{
+    if(samples_ring.available() < samples_per_inference) {
+        return false;
+    }
+
+    for(int copied = 0; copied < samples_per_inference; ) {
+        int n = samples_per_inference - copied;
+        if(n > EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE - samples_wr_index) {
+            n = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE - samples_wr_index;
+        }
+        samples_ring.pop(&samples_circ_buff[samples_wr_index], n);
+        samples_wr_index += n;
+        if(samples_wr_index >= EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
             /* start from beginning of the circular buffer */
             samples_wr_index = 0;
         }
-        if(samples_wr_index >= samples_per_inference) {
-            state = INFERENCE_DATA_READY;
-            return true;
-        }
+        copied += n;
     }
 
-    return false;
+    return true;
 }
 
 void ei_run_impulse(void)
@@ -100,33 +150,30 @@ void ei_run_impulse(void)
                 return;
             }
             ei_printf("Sampling...\n");
+            samples_ring.flush();
+            last_overrun_count = samples_ring.get_overrun_count();
             state = INFERENCE_SAMPLING;
             dev->set_state(eiStateSampling);
             return;
         case INFERENCE_SAMPLING:
             // wait for data to be collected through callback
-            return;
-        case INFERENCE_DATA_READY:
+            if(samples_get_window() == false) {
+                return;
+            }
+            state = INFERENCE_DATA_READY;
             dev->set_state(eiStateIdle);
+            break;
+        case INFERENCE_DATA_READY:
             // nothing to do, just continue to inference processing below
             break;
         default:
             break;
     }
 
+    // Create a data structure to represent this window of data, read straight from the circular buffer
     signal_t signal;
-
-    // shift circular buffer, so the newest data will be the first
-    // if samples_wr_index is 0, then roll is immediately returning
-    numpy::roll(samples_circ_buff, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, (-samples_wr_index));
-    /* reset wr index, the oldest data will be overwritten */
-    samples_wr_index = 0;
-
-    // Create a data structure to represent this window of data
-    int err = numpy::signal_from_buffer(samples_circ_buff, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, &signal);
-    if (err != 0) {
-        ei_printf("ERR: signal_from_buffer failed (%d)\n", err);
-    }
+    signal.total_length = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE;
+    signal.get_data = &samples_circ_buff_get_data;
 
     // run the impulse: DSP, neural network and the Anomaly algorithm
     ei_impulse_result_t result = { 0 };
@@ -144,7 +191,10 @@ void ei_run_impulse(void)
         return;
     }
 
-    if(continuous_mode == true) {
+    if (ei_result_stream_get_mode() == EI_RESULT_MODE_BINARY) {
+        ei_result_stream_push(ei_default_impulse.impulse, &result, samples_ring.get_overrun_count());
+    }
+    else if(continuous_mode == true) {
         if(++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
             ei_print_results(&ei_default_impulse, &result);
             print_results = 0;
@@ -155,6 +205,12 @@ void ei_run_impulse(void)
     }
 
     if(continuous_mode == true) {
+        uint32_t overrun_count = samples_ring.get_overrun_count();
+        if(overrun_count != last_overrun_count) {
+            ei_printf("Error sample buffer overrun, %lu samples dropped\n",
+                (unsigned long)(overrun_count - last_overrun_count));
+            last_overrun_count = overrun_count;
+        }
         state = INFERENCE_SAMPLING;
     }
     else {
@@ -184,6 +240,10 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed, floa
                                             sizeof(ei_classifier_inferencing_categories[0]));
     ei_printf("Starting inferencing, press 'b' to break\n");
 
+    // a slow host must not stall sampling, results that don't fit in the console ring are dropped
+    saved_console_policy = ei_console_get_policy();
+    ei_console_set_policy(EI_CONSOLE_POLICY_DROP);
+
     dev->set_sample_length_ms(EI_CLASSIFIER_RAW_SAMPLE_COUNT * EI_CLASSIFIER_INTERVAL_MS);
     dev->set_sample_interval_ms(EI_CLASSIFIER_INTERVAL_MS);
 
@@ -195,7 +255,6 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed, floa
         // only print when we run the complete maf buffer to prevent printing the same classification multiple times.
         print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
         run_classifier_init();
-        state = INFERENCE_SAMPLING;
     }
     else {
         samples_per_inference = EI_CLASSIFIER_RAW_SAMPLE_COUNT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
@@ -205,6 +264,13 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed, floa
         state = INFERENCE_WAITING;
     }
 
+    samples_wr_index = 0;
+    samples_ring.init(samples_ring_storage, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE * 2);
+    last_overrun_count = 0;
+    if (continuous == true) {
+        state = INFERENCE_SAMPLING;
+    }
+
     ei_accel_sample_start(&samples_callback, EI_CLASSIFIER_INTERVAL_MS);
 }
 
@@ -214,6 +280,8 @@ void ei_stop_impulse(void)
 
     if(state != INFERENCE_STOPPED) {
         state = INFERENCE_STOPPED;
+        ei_result_stream_flush();
+        ei_console_set_policy(saved_console_policy);
         ei_printf("Inferencing stopped by user\r\n");
         dev->set_state(eiStateFinished);
         dev->stop_sample_thread();
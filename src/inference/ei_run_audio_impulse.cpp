@@ -39,6 +39,8 @@
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "ei_microphone.h"
 #include "inference/ei_run_impulse.h"
+#include "inference/ei_result_stream.h"
+#include "ei_console.h"
 #include "ei_device_particle.h"
 #include "model-parameters/model_variables.h"
 
@@ -58,6 +60,7 @@ static bool continuous_mode = false;
 static bool debug_mode = false;
 //static float samples_circ_buff[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
 static int samples_wr_index = 0;
+static ei_console_policy_t saved_console_policy = EI_CONSOLE_DEFAULT_POLICY;
 
 void ei_run_impulse(void)
 {
@@ -86,6 +89,8 @@ void ei_run_impulse(void)
             if (ei_microphone_inference_record(false) == true) {
                 state = INFERENCE_DATA_READY;
                 if (continuous_mode == false) {
+                    // overruns are only counted inside the recorded window
+                    ei_microphone_inference_pause();
                     ei_printf("Recording done\n");
                 }
             }
@@ -110,6 +115,7 @@ void ei_run_impulse(void)
 
     signal.total_length = continuous_mode ? EI_CLASSIFIER_SLICE_SIZE : EI_CLASSIFIER_RAW_SAMPLE_COUNT;
     signal.get_data = &ei_microphone_audio_signal_get_data;
+    signal.get_data_i16 = &ei_microphone_audio_signal_get_data_i16;
 
     // run the impulse: DSP, neural network and the Anomaly algorithm
     ei_impulse_result_t result = { 0 };
@@ -125,7 +131,10 @@ void ei_run_impulse(void)
         return;
     }
 
-    if (continuous_mode == true) {
+    if (ei_result_stream_get_mode() == EI_RESULT_MODE_BINARY) {
+        ei_result_stream_push(ei_default_impulse.impulse, &result, ei_microphone_inference_get_overrun_count());
+    }
+    else if (continuous_mode == true) {
         if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
             ei_print_results(&ei_default_impulse, &result);
             print_results = 0;
@@ -173,6 +182,10 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed, floa
                                             sizeof(ei_classifier_inferencing_categories[0]));
     ei_printf("Starting inferencing, press 'b' to break\n");
 
+    // a slow host must not stall sampling, results that don't fit in the console ring are dropped
+    saved_console_policy = ei_console_get_policy();
+    ei_console_set_policy(EI_CONSOLE_POLICY_DROP);
+
     if (continuous == true) {
         samples_per_inference = EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
         // In order to have meaningful classification results, continuous inference has to run over
@@ -195,6 +208,11 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed, floa
         ei_printf("ERR: Could not allocate audio buffer (size %d), this could be due to the window length of your model\r\n", EI_CLASSIFIER_RAW_SAMPLE_COUNT);
         return;
     }
+
+    if (continuous_mode == false) {
+        // recording starts after the 2 second wait
+        ei_microphone_inference_pause();
+    }
 }
 
 /**
@@ -215,6 +233,8 @@ void ei_stop_impulse(void)
             ei_microphone_inference_end();
         }
 
+        ei_result_stream_flush();
+        ei_console_set_policy(saved_console_policy);
         ei_printf("Inferencing stopped by user\r\n");
         /* reset samples buffer */
         samples_wr_index = 0;
@@ -41,6 +41,7 @@
 #include "ei_sensor_imu.h"
 #include "ei_microphone.h"
 #include "ei_run_impulse.h"
+#include "ei_console.h"
 
 SYSTEM_MODE(SEMI_AUTOMATIC);
 SYSTEM_THREAD(ENABLED);
@@ -62,6 +63,8 @@ void setup()
     // Wait for serial to make it easier to see the serial logs at startup.
     ei_sleep(2000);
     Serial.begin(115200);
+    // serial output goes through a ring drained by its own thread from here on
+    ei_console_init();
     ei_printf("Edge Impulse inference runner for Particle devices\r\n");
 
     // Init the sensors
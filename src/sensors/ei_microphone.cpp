@@ -38,6 +38,8 @@
 
 #include "misc/sensor_aq_mbedtls/sensor_aq_mbedtls_hs256.h"
 #include "firmware-sdk/sensor-aq/sensor_aq.h"
+#include "firmware-sdk/ei_ring_buffer.h"
+#include "firmware-sdk/ei_device_memory_writer.h"
 #include "edge-impulse-sdk/CMSIS/DSP/Include/arm_math.h"
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 
@@ -46,10 +48,11 @@
 
 
 typedef struct {
-    int16_t *buffers[2];
-    uint8_t buf_select;
-    uint8_t buf_ready;
-    uint32_t buf_count;
+    int16_t *buffer;
+    EiRingBuffer<int16_t> ring;
+    bool window_in_use;
+    volatile bool recording;
+    uint32_t last_overrun_count;
     uint32_t n_samples;
 } inference_t;
 
@@ -71,7 +74,8 @@ static int ei_seek(EI_SENSOR_AQ_STREAM*, long int offset, int origin)
 
 /* Private variables ------------------------------------------------------- */
 static bool record_ready = false;
-static uint32_t headerOffset;
+static EiDeviceMemoryWriter writer;
+static uint8_t *writer_buf = NULL;
 static uint32_t samples_required;
 static uint32_t current_sample;
 static uint32_t audio_sampling_frequency = 16000;
@@ -108,9 +112,7 @@ int ei_microphone_init(void)
 
 static void audio_buffer_callback(uint32_t n_bytes)
 {
-    EiDeviceMemory *mem = EiDeviceInfo::get_device()->get_memory();
-    mem->write_sample_data((const uint8_t*)dma_copy_buf, headerOffset + current_sample, n_bytes);
-
+    writer.append((const uint8_t*)dma_copy_buf, n_bytes);
 
     ei_mic_ctx.signature_ctx->update(ei_mic_ctx.signature_ctx, (uint8_t*)dma_copy_buf, n_bytes);
 
@@ -122,14 +124,9 @@ static void audio_buffer_callback(uint32_t n_bytes)
 
 static void audio_buffer_inference_callback(uint32_t n_bytes)
 {
-    for(int i = 0; i < n_bytes>>1; i++) {
-        inference.buffers[inference.buf_select][inference.buf_count++] = *(dma_copy_buf + i);
-
-        if(inference.buf_count >= inference.n_samples) {
-            inference.buf_select ^= 1;
-            inference.buf_count = 0;
-            inference.buf_ready = 1;
-        }
+    // samples outside a recording are thrown away, they must not count as overruns
+    if (inference.recording) {
+        inference.ring.push(dma_copy_buf, n_bytes >> 1);
     }
 }
 
@@ -160,7 +157,7 @@ static void finish_and_upload(void) {
     ei_printf("Done sampling, total bytes collected: %u\n", current_sample);
 
     ei_printf("[1/1] Uploading file to Edge Impulse...\n");
-    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, current_sample + headerOffset);
+    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, writer.size());
     ei_printf("[1/1] Uploading file to Edge Impulse OK (took 0 ms.)\n");
 
     ei_printf("OK\n");
@@ -189,7 +186,6 @@ static int insert_ref(char *buffer, int hdrLength)
 static bool create_header(void)
 {
     EiDeviceInfo *dev = EiDeviceInfo::get_device();
-    EiDeviceMemory *mem = dev->get_memory();
     sensor_aq_init_mbedtls_hs256_context(&ei_mic_signing_ctx, &ei_mic_hs_ctx, dev->get_sample_hmac_key().c_str());
 
     sensor_aq_payload_info payload = {
@@ -233,16 +229,14 @@ static bool create_header(void)
 
     end_of_header_ix += ref_size;
 
-    // Write to blockdevice
-    tr = mem->write_sample_data((const uint8_t*)ei_mic_ctx.cbor_buffer.ptr, 0, end_of_header_ix);
+    // Write to blockdevice, the header stays in RAM until the signature is patched in
+    tr = writer.append((const uint8_t*)ei_mic_ctx.cbor_buffer.ptr, end_of_header_ix);
 
     if (tr != (int)end_of_header_ix) {
         ei_printf("Failed to write to header blockdevice\n");
         return false;
     }
 
-    headerOffset = end_of_header_ix;
-
     return true;
 }
 
@@ -265,7 +259,11 @@ bool ei_microphone_record(uint32_t sample_length_ms, uint32_t start_delay_ms, bo
         return false;
     }
 
-    create_header();
+    writer.begin(mem, writer_buf);
+
+    if (!create_header()) {
+        return false;
+    }
 
     if (print_start_messages) {
         ei_printf("Sampling...\n");
@@ -278,16 +276,10 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
 {
     EiDeviceInfo *dev = EiDeviceInfo::get_device();
 
-    inference.buffers[0] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
-
-    if(inference.buffers[0] == NULL) {
-        return false;
-    }
-
-    inference.buffers[1] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
+    /* room for the window that's being classified and the next one */
+    inference.buffer = (int16_t *)ei_malloc(2 * n_samples * sizeof(int16_t));
 
-    if(inference.buffers[1] == NULL) {
-        ei_free(inference.buffers[0]);
+    if(inference.buffer == NULL) {
         return false;
     }
 
@@ -295,15 +287,15 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
     dma_copy_buf = (int16_t *)ei_malloc(256 * 2);
 
     if(dma_copy_buf == NULL) {
-        ei_free(inference.buffers[0]);
-        ei_free(inference.buffers[1]);
+        ei_free(inference.buffer);
         return false;
     }
 
-    inference.buf_select = 0;
-    inference.buf_count  = 0;
-    inference.n_samples  = n_samples;
-    inference.buf_ready  = 0;
+    inference.ring.init(inference.buffer, 2 * n_samples);
+    inference.window_in_use = false;
+    inference.recording = true;
+    inference.last_overrun_count = 0;
+    inference.n_samples = n_samples;
 
 
     /* Calclate sample rate from sample interval */
@@ -334,46 +326,117 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
 }
 
 /**
- * @brief      Wait for a full buffer
+ * @brief      Check for a full window of samples. The window handed out by the
+ *             previous successful call is released first.
+ *
+ * @param[in]  first_run  Called right after an inference, report samples that were dropped
  *
- * @return     In case of an buffer overrun return false
+ * @return     true if a new window can be read through ei_microphone_audio_signal_get_data
  */
 bool ei_microphone_inference_record(bool first_run)
 {
-    bool ret = false;
+    if (inference.window_in_use) {
+        inference.ring.consume(inference.n_samples);
+        inference.window_in_use = false;
+    }
+
+    if (first_run == true) {
+        uint32_t overrun_count = inference.ring.get_overrun_count();
 
-    if (inference.buf_ready == 1 && first_run == true) {
-        ei_printf(
-            "Error sample buffer overrun. Decrease the number of slices per model window "
-            "(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)\n");
+        if (overrun_count != inference.last_overrun_count) {
+            ei_printf(
+                "Error sample buffer overrun, %lu samples dropped. Decrease the number of slices per model window "
+                "(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)\n", (unsigned long)(overrun_count - inference.last_overrun_count));
+            inference.last_overrun_count = overrun_count;
+        }
+        return false;
     }
 
-    if(inference.buf_ready) {
-        ret = true;
-        inference.buf_ready = 0;
+    if (inference.ring.available() >= inference.n_samples) {
+        inference.window_in_use = true;
     }
 
-    return ret;
+    return inference.window_in_use;
 }
 
 /**
- * @brief      Reset buffer counters for non-continuous inferecing
+ * @brief      Reset buffer counters and start recording a window for non-continuous inferecing
  */
 void ei_microphone_inference_reset_buffers(void)
 {
+    inference.recording = false;
+
     /* Empty DMA buffers */
     while(Microphone_PDM::instance().noCopySamples([](void *pSamples, size_t numSamples){})){};
 
-    inference.buf_ready = 0;
-    inference.buf_count = 0;
+    inference.ring.flush();
+    inference.window_in_use = false;
+    inference.last_overrun_count = inference.ring.get_overrun_count();
+    inference.recording = true;
+}
+
+/**
+ * @brief      Stop filling the ring buffer until the next ei_microphone_inference_reset_buffers(),
+ *             for non-continuous inferencing between two recorded windows
+ */
+void ei_microphone_inference_pause(void)
+{
+    inference.recording = false;
+}
+
+/**
+ * @brief      Total number of samples dropped by the inference ring buffer
+ */
+uint32_t ei_microphone_inference_get_overrun_count(void)
+{
+    return inference.ring.get_overrun_count();
 }
 
 /**
- * Get raw audio signal data
+ * Get raw audio signal data, straight from the ring buffer
  */
 int ei_microphone_audio_signal_get_data(size_t offset, size_t length, float *out_ptr)
 {
-    return numpy::int16_to_float(&inference.buffers[inference.buf_select ^ 1][offset], out_ptr, length);
+    const int16_t *samples;
+
+    while (length > 0) {
+        size_t n = inference.ring.peek(offset, length, &samples);
+        if (n == 0) {
+            return EIDSP_OUT_OF_BOUNDS;
+        }
+
+        numpy::int16_to_float(samples, out_ptr, n);
+
+        offset += n;
+        out_ptr += n;
+        length -= n;
+    }
+
+    return EIDSP_OK;
+}
+
+
+/**
+ * Get raw audio signal data as int16, straight from the ring buffer (for the fixed-point DSP blocks)
+ */
+int ei_microphone_audio_signal_get_data_i16(size_t offset, size_t length, int16_t *out_ptr)
+{
+    const int16_t *samples;
+
+    while (length > 0) {
+        size_t n = inference.ring.peek(offset, length, &samples);
+        if (n == 0) {
+            return EIDSP_OUT_OF_BOUNDS;
+        }
+
+        memcpy(out_ptr, samples, n * sizeof(int16_t));
+
+        offset += n;
+        out_ptr += n;
+        length -= n;
+    }
+
+    return EIDSP_OK;
 }
 
 
@@ -384,8 +447,7 @@ bool ei_microphone_inference_end(void)
     dev->stop_sample_thread();
 
     Microphone_PDM::instance().stop();
-    ei_free(inference.buffers[0]);
-    ei_free(inference.buffers[1]);
+    ei_free(inference.buffer);
     ei_free(dma_copy_buf);
 
     return true;
@@ -443,8 +505,19 @@ bool ei_microphone_sample_start(void)
         return false;
 	}
 
+    writer_buf = (uint8_t *)ei_malloc(2 * mem->block_size);
+
+    if(writer_buf == NULL) {
+        ei_printf("ERR: memory allocation failed\r\n");
+        ei_free(dma_copy_buf);
+        dma_copy_buf = NULL;
+        return false;
+    }
+
     bool r = ei_microphone_record(dev->get_sample_length_ms(), (((samples_required <<1)/ mem->block_size) * mem->block_erase_time), true);
     if (!r) {
+        ei_free(writer_buf);
+        writer_buf = NULL;
         return r;
     }
     record_ready = true;
@@ -462,27 +535,16 @@ bool ei_microphone_sample_start(void)
     int ctx_err = ei_mic_ctx.signature_ctx->finish(ei_mic_ctx.signature_ctx, ei_mic_ctx.hash_buffer.buffer);
     if (ctx_err != 0) {
         ei_printf("Failed to finish signature (%d)\n", ctx_err);
+        ei_free(writer_buf);
+        writer_buf = NULL;
         return false;
     }
 
-    // load the first page in flash...
-    uint8_t *page_buffer = (uint8_t*)ei_malloc(mem->block_size);
-    if (!page_buffer) {
-        ei_printf("Failed to allocate a page buffer to write the hash\n");
-        return false;
-    }
-
-    uint32_t j = mem->read_sample_data(page_buffer, 0, mem->block_size);
-    if (j != mem->block_size) {
-        ei_printf("Failed to read first page\n");
-        free(page_buffer);
-        return false;
-    }
-
-    // update the hash
+    // update the hash, the first block of the file is still in RAM so it's patched in place
     uint8_t *hash = ei_mic_ctx.hash_buffer.buffer;
     // we have allocated twice as much for this data (because we also want to be able to represent in hex)
     // thus only loop over the first half of the bytes as the signature_ctx has written to those
+    bool patched = true;
     for (size_t hash_ix = 0; hash_ix < ei_mic_ctx.hash_buffer.size / 2; hash_ix++) {
         // this might seem convoluted, but snprintf() with %02x is not always supported e.g. by newlib-nano
         // we encode as hex... first ASCII char encodes top 4 bytes
@@ -491,29 +553,28 @@ bool ei_microphone_sample_start(void)
         uint8_t second = hash[hash_ix] & 0xf;
 
         // if 0..9 -> '0' (48) + value, if >10, then use 'a' (97) - 10 + value
-        char first_c = first >= 10 ? 87 + first : 48 + first;
-        char second_c = second >= 10 ? 87 + second : 48 + second;
+        uint8_t hex[] = {
+            (uint8_t)(first >= 10 ? 87 + first : 48 + first),
+            (uint8_t)(second >= 10 ? 87 + second : 48 + second)
+        };
 
-        page_buffer[ei_mic_ctx.signature_index + (hash_ix * 2) + 0] = first_c;
-        page_buffer[ei_mic_ctx.signature_index + (hash_ix * 2) + 1] = second_c;
+        patched &= writer.patch(ei_mic_ctx.signature_index + (hash_ix * 2), hex, 2);
     }
 
-    j = mem->erase_sample_data(0, mem->block_size);
-    if (j != mem->block_size) {
-        ei_printf("Failed to erase first page\n");
-        free(page_buffer);
-        return false;
-    }
+    bool flushed = writer.flush_data();
 
-    j = mem->write_sample_data(page_buffer, 0, mem->block_size);
+    ei_free(writer_buf);
+    writer_buf = NULL;
 
-    ei_free(page_buffer);
-
-    if (j != mem->block_size) {
-        ei_printf("Failed to write first page with updated hash\n");
+    if (!patched) {
+        ei_printf("Failed to write the hash, header is larger than one block\n");
         return false;
     }
 
+    if (!flushed) {
+        ei_printf("Failed to write sample to flash\n");
+        return false;
+    }
 
     finish_and_upload();
 
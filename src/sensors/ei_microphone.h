@@ -48,8 +48,11 @@ int ei_microphone_init(void);
 bool ei_microphone_sample_start(void);
 bool ei_microphone_inference_record(bool first_run);
 void ei_microphone_inference_reset_buffers(void);
+void ei_microphone_inference_pause(void);
 int ei_microphone_audio_signal_get_data(size_t offset, size_t length, float *out_ptr);
+int ei_microphone_audio_signal_get_data_i16(size_t offset, size_t length, int16_t *out_ptr);
 bool ei_microphone_inference_end(void);
+uint32_t ei_microphone_inference_get_overrun_count(void);
 
 
 #endif
\ No newline at end of file
@@ -39,11 +39,23 @@
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "firmware-sdk/ei_device_info_lib.h"
 #include "firmware-sdk/ei_device_memory.h"
+#include "firmware-sdk/ei_device_memory_writer.h"
 #include "firmware-sdk/ei_config_types.h"
 #include "firmware-sdk/sensor-aq/sensor_aq.h"
 #include "misc/sensor_aq_mbedtls/sensor_aq_mbedtls_hs256.h"
 #include "ei_sampler.h"
 
+/* Private defines -------------------------------------------------------- */
+/** Encoding of sampled values in the CBOR file */
+#ifndef EI_SAMPLER_ENCODING
+#define EI_SAMPLER_ENCODING         EI_SENSOR_AQ_ENCODING_FLOAT32
+#endif
+
+/** Bytes of encoded samples staged before they're hashed and written, 0 uses the whole CBOR buffer */
+#ifndef EI_SAMPLER_FLUSH_THRESHOLD
+#define EI_SAMPLER_FLUSH_THRESHOLD  0
+#endif
+
 /* Private variables ------------------------------------------------------- */
 static size_t ei_write(const void *buffer, size_t size, size_t count, EI_SENSOR_AQ_STREAM *);
 static int ei_seek(EI_SENSOR_AQ_STREAM *, long int offset, int origin);
@@ -51,10 +63,12 @@ static time_t ei_time(time_t *t);
 
 static uint32_t samples_required;
 static uint32_t current_sample;
+static volatile int sample_error;
 static uint32_t sample_buffer_size;
-static uint32_t headerOffset = 0;
-static uint8_t write_word_buf[4];
-static int write_addr = 0;
+static EiDeviceMemoryWriter writer;
+static uint8_t *writer_buf = NULL;
+static bool patch_mode = false;
+static uint32_t patch_addr = 0;
 EI_SENSOR_AQ_STREAM stream;
 
 static unsigned char ei_sensor_ctx_buffer[1024];
@@ -70,7 +84,8 @@ static sensor_aq_ctx ei_sensor_ctx = {
 
 /**
  * @brief      Write sample data to FLASH
- * @details    Write size is always 4 bytes to keep alignment
+ * @details    Data is appended through the block writer, after a seek it
+ *             patches the (still buffered) start of the file instead
  *
  * @param[in]  buffer     The buffer
  * @param[in]  size       The size
@@ -81,24 +96,29 @@ static sensor_aq_ctx ei_sensor_ctx = {
  */
 static size_t ei_write(const void *buffer, size_t size, size_t count, EI_SENSOR_AQ_STREAM *)
 {
-    EiDeviceMemory* mem = EiDeviceInfo::get_device()->get_memory();
-
-    for (size_t i = 0; i < count; i++) {
-        write_word_buf[write_addr & 0x3] = *((char *)buffer + i);
-
-        if ((++write_addr & 0x03) == 0x00) {
-            mem->write_sample_data(write_word_buf, (write_addr - 4) + headerOffset, 4);
+    if (patch_mode) {
+        if (!writer.patch(patch_addr, (const uint8_t *)buffer, count)) {
+            return 0;
         }
+        patch_addr += count;
+        return count;
     }
 
-    return count;
+    return writer.append((const uint8_t *)buffer, count);
 }
 
 /**
- * @brief      File handle seed function. Not used
+ * @brief      File handle seek function, only used by sensor_aq_finish() to write the signature
  */
 static int ei_seek(EI_SENSOR_AQ_STREAM *, long int offset, int origin)
 {
+    if (origin != SEEK_SET || offset < 0) {
+        return -1;
+    }
+
+    patch_mode = true;
+    patch_addr = (uint32_t)offset;
+
     return 0;
 }
 
@@ -112,32 +132,6 @@ static time_t ei_time(time_t *t)
     return cur_time;
 }
 
-/**
- * @brief      Write out remaining data in word buffer to FLASH.
- *             And append CBOR end character.
- */
-static void ei_write_last_data(void)
-{
-    EiDeviceMemory* mem = EiDeviceInfo::get_device()->get_memory();
-    uint8_t fill = ((uint8_t)write_addr & 0x03);
-    uint8_t insert_end_address = 0;
-
-    if (fill != 0x00) {
-        for (uint8_t i = fill; i < 4; i++) {
-            write_word_buf[i] = 0xFF;
-        }
-
-        mem->write_sample_data(write_word_buf, (write_addr & ~0x03) + headerOffset, 4);
-        insert_end_address = 4;
-    }
-
-    /* Write appending word for end character */
-    for (uint8_t i = 0; i < 4; i++) {
-        write_word_buf[i] = 0xFF;
-    }
-    mem->write_sample_data(write_word_buf, (write_addr & ~0x03) + headerOffset + insert_end_address, 4);
-}
-
 /*
  * @brief      Create and write the CBOR header to FLASH
  *
@@ -148,7 +142,6 @@ static void ei_write_last_data(void)
 static bool create_header(sensor_aq_payload_info *payload)
 {
     EiDeviceInfo *dev = EiDeviceInfo::get_device();
-    EiDeviceMemory *mem = dev->get_memory();
     sensor_aq_init_mbedtls_hs256_context(&ei_sensor_signing_ctx, &ei_sensor_hs_ctx, dev->get_sample_hmac_key().c_str());
 
     size_t tr = sensor_aq_init(&ei_sensor_ctx, payload, NULL, true);
@@ -173,8 +166,8 @@ static bool create_header(sensor_aq_payload_info *payload)
         return false;
     }
 
-    // Write to blockdevice
-    tr = mem->write_sample_data((uint8_t*)ei_sensor_ctx.cbor_buffer.ptr, 0, end_of_header_ix);
+    // Write to blockdevice, the header stays in RAM until the signature is patched in
+    tr = writer.append((uint8_t*)ei_sensor_ctx.cbor_buffer.ptr, end_of_header_ix);
 
     if (tr != end_of_header_ix) {
         ei_printf("Failed to write to header blockdevice (%d)\n", tr);
@@ -182,9 +175,13 @@ static bool create_header(sensor_aq_payload_info *payload)
     }
 
     ei_sensor_ctx.stream = &stream;
+    patch_mode = false;
 
-    headerOffset = end_of_header_ix;
-    write_addr = 0;
+    tr = sensor_aq_batch_begin(&ei_sensor_ctx, EI_SAMPLER_ENCODING, EI_SAMPLER_FLUSH_THRESHOLD);
+    if (tr != AQ_OK) {
+        ei_printf("sensor_aq_batch_begin failed (%d)\n", tr);
+        return false;
+    }
 
     return true;
 }
@@ -199,7 +196,17 @@ static bool create_header(sensor_aq_payload_info *payload)
  */
 static bool sample_data_callback(const void *sample_buf, uint32_t byteLenght)
 {
-    sensor_aq_add_data(&ei_sensor_ctx, (float *)sample_buf, byteLenght / sizeof(float));
+    // the last batch is flushed once all samples are in, don't add to it anymore
+    if (current_sample >= samples_required || sample_error != AQ_OK) {
+        return true;
+    }
+
+    int ret = sensor_aq_batch_add(&ei_sensor_ctx, (const float *)sample_buf, byteLenght / sizeof(float));
+    if (ret != AQ_OK) {
+        // reported by ei_sampler_start_sampling(), which stops waiting for samples
+        sample_error = ret;
+        return true;
+    }
 
     /* TODO-ADD make sure target specific code is added to
        ei_sensor_fusion_read_data() and at_sample_start()
@@ -222,7 +229,7 @@ static void finish_and_upload(char *filename, uint32_t sample_length_ms)
 {
     ei_printf("Done sampling, total bytes collected: %lu\n", samples_required);
     ei_printf("[1/1] Uploading file to Edge Impulse...\n");
-    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, write_addr + headerOffset);
+    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, writer.size());
     ei_printf("OK\n");
 }
 
@@ -245,6 +252,7 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
     samples_required = (uint32_t)((dev->get_sample_length_ms()) / dev->get_sample_interval_ms());
     sample_buffer_size = (samples_required * sample_size) * 2;
     current_sample = 0;
+    sample_error = AQ_OK;
 
     // Minimum delay of 2000 ms for daemon
     uint32_t delay_time_ms = ((sample_buffer_size / mem->block_size) + 1) * mem->block_erase_time;
@@ -261,7 +269,17 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
         ei_sleep(2000 - delay_time_ms);
     }
 
+    writer_buf = (uint8_t *)ei_malloc(2 * mem->block_size);
+    if (writer_buf == NULL) {
+        ei_printf("ERR: memory allocation failed\n");
+        return false;
+    }
+
+    writer.begin(mem, writer_buf);
+
     if (create_header(payload) == false) {
+        ei_free(writer_buf);
+        writer_buf = NULL;
         return false;
     }
 
@@ -273,22 +291,28 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
 
     dev->set_state(eiStateSampling);
 
-    while (current_sample < samples_required) {
+    while (current_sample < samples_required && sample_error == AQ_OK) {
         ei_sleep(10);
     }
 
-    ei_write_last_data();
-    write_addr++;
-
-    uint8_t final_byte[] = {0xff};
-    int ctx_err = ei_sensor_ctx.signature_ctx->update(ei_sensor_ctx.signature_ctx, final_byte, 1);
-    if (ctx_err != 0) {
-        return ctx_err;
+    if (sample_error != AQ_OK) {
+        ei_printf("Failed to add samples (%d)\n", sample_error);
+        ei_free(writer_buf);
+        writer_buf = NULL;
+        return false;
     }
 
-    // finish the signing
-    ctx_err =
-        ei_sensor_ctx.signature_ctx->finish(ei_sensor_ctx.signature_ctx, ei_sensor_ctx.hash_buffer.buffer);
+    // writes the last samples and the end character, and patches the signature into the header
+    int ctx_err = sensor_aq_finish(&ei_sensor_ctx);
+    bool flushed = writer.flush_data();
+
+    ei_free(writer_buf);
+    writer_buf = NULL;
+
+    if (ctx_err != AQ_OK || !flushed) {
+        ei_printf("Failed to write the sample (%d)\n", ctx_err);
+        return false;
+    }
 
     finish_and_upload((char *)"fd/imu", dev->get_sample_length_ms());
 
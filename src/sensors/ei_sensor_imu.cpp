@@ -42,12 +42,31 @@
 #include <vector>
 /* Constants --------------------------------------------------------------- */
 #define CONVERT_G_TO_MS2    9.80665f
+/* Output data rate configured in ei_sensor_imu_init() */
+#define IMU_ODR_HZ          200.f
 
 /* Private variables ------------------------------------------------------- */
 ADXL362DMA *accel;
 static float sample_buffer[N_SENSOR_AXES];
 sampler_callback inertial_cb_sampler;
 
+#if IMU_FIFO_BATCHING == 1
+/* Large enough to drain the complete FIFO (511 entries) in one read */
+static ADXL362DataEx<1024> fifo_data;
+static float fifo_block[IMU_FIFO_BLOCK_SAMPLES * N_SENSOR_AXES];
+static size_t fifo_block_samples;
+/* Resampler state, position of the next output sample relative to fifo_prev_sample */
+static float fifo_prev_sample[N_SENSOR_AXES];
+static bool fifo_has_prev_sample;
+static float fifo_next_pos;
+static float fifo_step;
+#endif
+
+static inline float convert_raw_to_ms2(int16_t raw)
+{
+    return (((float)(raw * 2)) / 2048.f) * CONVERT_G_TO_MS2;
+}
+
 
 bool ei_sensor_imu_init(void)
 {
@@ -85,7 +104,7 @@ float *ei_sensor_imu_read_data(int n_samples)
     accel->readXYZ(acc[0], acc[1], acc[2]);
 
     for (int i = 0; i < 3; i++) {
-        sample_buffer[i] = (((float)(acc[i] * 2)) / 2048.f) * CONVERT_G_TO_MS2;
+        sample_buffer[i] = convert_raw_to_ms2(acc[i]);
     }
 
     return &sample_buffer[0];
@@ -96,6 +115,88 @@ void ei_accel_read_data(void)
     inertial_cb_sampler((const void *)ei_sensor_imu_read_data(N_SENSOR_AXES), SIZEOF_SENSOR_VALUES_IN_SAMPLE);
 }
 
+#if IMU_FIFO_BATCHING == 1
+static void ei_accel_fifo_flush_block(void)
+{
+    if (fifo_block_samples > 0) {
+        inertial_cb_sampler((const void *)fifo_block, fifo_block_samples * SIZEOF_SENSOR_VALUES_IN_SAMPLE);
+        fifo_block_samples = 0;
+    }
+}
+
+/**
+ * @brief Resample one sample at the sensor ODR to the requested sample interval,
+ * using linear interpolation between the previous and current sample.
+ * Output samples are collected in fifo_block.
+ */
+static void ei_accel_fifo_push_sample(const float *sample)
+{
+    if (!fifo_has_prev_sample) {
+        memcpy(fifo_prev_sample, sample, sizeof(fifo_prev_sample));
+        fifo_has_prev_sample = true;
+        fifo_next_pos = 0.f;
+        return;
+    }
+
+    while (fifo_next_pos <= 1.f) {
+        float *out = &fifo_block[fifo_block_samples * N_SENSOR_AXES];
+        for (int i = 0; i < N_SENSOR_AXES; i++) {
+            out[i] = fifo_prev_sample[i] + (sample[i] - fifo_prev_sample[i]) * fifo_next_pos;
+        }
+        fifo_next_pos += fifo_step;
+
+        if (++fifo_block_samples >= IMU_FIFO_BLOCK_SAMPLES) {
+            ei_accel_fifo_flush_block();
+        }
+    }
+
+    fifo_next_pos -= 1.f;
+    memcpy(fifo_prev_sample, sample, sizeof(fifo_prev_sample));
+}
+
+/**
+ * @brief Called every IMU_FIFO_READ_INTERVAL_MS. Unpacks the previous FIFO read
+ * and starts the next one, the SPI DMA transfer completes in the background.
+ */
+static void ei_accel_read_fifo(void)
+{
+    if (fifo_data.state == ADXL362DMA::STATE_READ_COMPLETE) {
+        float sample[N_SENSOR_AXES];
+
+        for (size_t ix = 0; ix < fifo_data.numSamplesRead; ix++) {
+            sample[0] = convert_raw_to_ms2(fifo_data.readX(ix));
+            sample[1] = convert_raw_to_ms2(fifo_data.readY(ix));
+            sample[2] = convert_raw_to_ms2(fifo_data.readZ(ix));
+            ei_accel_fifo_push_sample(sample);
+        }
+        ei_accel_fifo_flush_block();
+
+        fifo_data.state = ADXL362DMA::STATE_FREE;
+    }
+
+    if (fifo_data.state == ADXL362DMA::STATE_FREE) {
+        accel->readFifoAsync(&fifo_data);
+    }
+}
+
+static void ei_accel_fifo_start(float sample_interval_ms)
+{
+    /* let a transfer of a previous session finish before touching the buffer */
+    while (fifo_data.state == ADXL362DMA::STATE_READING_FIFO) {
+        ei_sleep(1);
+    }
+    fifo_data.state = ADXL362DMA::STATE_FREE;
+
+    fifo_block_samples = 0;
+    fifo_has_prev_sample = false;
+    fifo_step = (IMU_ODR_HZ * sample_interval_ms) / 1000.f;
+
+    /* disabling the FIFO clears it, so we start with fresh samples */
+    accel->writeFifoControlAndSamples(128, false, ADXL362DMA::FIFO_DISABLED);
+    accel->writeFifoControlAndSamples(128, false, ADXL362DMA::FIFO_STREAM);
+}
+#endif
+
 bool ei_accel_sample_start(sampler_callback callsampler, float sample_interval_ms)
 {
     EiDeviceInfo *dev = EiDeviceInfo::get_device();
@@ -105,6 +206,15 @@ bool ei_accel_sample_start(sampler_callback callsampler, float sample_interval_m
 
     dev->set_state(eiStateSampling);
 
+#if IMU_FIFO_BATCHING == 1
+    /* FIFO can only be used when sampling at or below the sensor ODR */
+    if (sample_interval_ms >= (1000.f / IMU_ODR_HZ)) {
+        ei_accel_fifo_start(sample_interval_ms);
+        dev->start_sample_thread(&ei_accel_read_fifo, IMU_FIFO_READ_INTERVAL_MS);
+        return true;
+    }
+#endif
+
     dev->start_sample_thread(&ei_accel_read_data, sample_interval_ms);
 
     return true;
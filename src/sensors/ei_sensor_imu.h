@@ -42,6 +42,23 @@
 #define N_SENSOR_AXES          3
 #define SIZEOF_SENSOR_VALUES_IN_SAMPLE   (sizeof(float) * N_SENSOR_AXES)
 
+/**
+ * Read the accelerometer in bursts from the ADXL362 FIFO (SPI DMA) instead of
+ * polling one sample per timer tick. Samples are resampled from the sensor ODR
+ * to the requested interval and handed to the sampler callback in blocks.
+ * Only the sampling started by ei_accel_sample_start() (inference) uses the FIFO,
+ * sensor fusion still polls ei_sensor_imu_read_data(). The FIFO is read from a
+ * timer, there is no watermark interrupt.
+ */
+#ifndef IMU_FIFO_BATCHING
+#define IMU_FIFO_BATCHING                0
+#endif
+
+/** Period of the FIFO reads, the FIFO holds ~850 ms of data at 200 Hz */
+#define IMU_FIFO_READ_INTERVAL_MS        200
+/** Max number of samples passed to the sampler callback in one call */
+#define IMU_FIFO_BLOCK_SAMPLES           32
+
 /* Function prototypes ----------------------------------------------------- */
 bool ei_sensor_imu_init(void);
 float *ei_sensor_imu_read_data(int n_samples);
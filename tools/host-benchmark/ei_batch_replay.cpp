@@ -0,0 +1,316 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_batch_replay.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* what run_classifier(handle, ...) calls; ei_run_classifier.h defines C linkage functions, so it can only be included from one translation unit */
+extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle, ei::signal_t *signal, ei_impulse_result_t *result, bool debug);
+
+/* Private types ----------------------------------------------------------- */
+/**
+ * Record a worker sends per window, followed by classification_count classifications
+ * (only when they are not part of the result struct), bounding_boxes_count bounding boxes
+ * and visual_ad_count grid cells
+ */
+typedef struct {
+    uint32_t index;
+    int32_t error;
+    uint32_t classification_count;
+    uint32_t bounding_boxes_count;
+    uint32_t visual_ad_count;
+    ei_impulse_result_t result;
+} batch_record_t;
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    std::vector<uint8_t> data;
+} batch_worker_t;
+
+/* Private functions ------------------------------------------------------- */
+static bool write_all(int fd, const void *buf, size_t size)
+{
+    const uint8_t *ptr = (const uint8_t *)buf;
+
+    while (size > 0) {
+        ssize_t n = write(fd, ptr, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        ptr += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+/**
+ * Worker process: score windows [first, last) and stream a record per window to fd
+ *
+ * @return false when the parent could not be sent all records
+ */
+static bool run_worker(ei_impulse_handle_t *handle, ei::signal_t *signals, size_t first, size_t last, int fd, bool debug)
+{
+    for (size_t ix = first; ix < last; ix++) {
+        batch_record_t record;
+        memset(&record, 0, sizeof(record));
+
+        record.index = (uint32_t)ix;
+        record.error = process_impulse(handle, &signals[ix], &record.result, debug);
+
+        const ei_impulse_result_t &result = record.result;
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        record.classification_count = result.classification ? (uint32_t)handle->impulse->label_count : 0;
+#endif
+        record.bounding_boxes_count = result.bounding_boxes ? result.bounding_boxes_count : 0;
+#if EI_CLASSIFIER_HAS_VISUAL_ANOMALY
+        record.visual_ad_count = result.visual_ad_grid_cells ? result.visual_ad_count : 0;
+#endif
+
+        bool ok = write_all(fd, &record, sizeof(record));
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        ok = ok && write_all(fd, result.classification, record.classification_count * sizeof(ei_impulse_result_classification_t));
+#endif
+        ok = ok && write_all(fd, result.bounding_boxes, record.bounding_boxes_count * sizeof(ei_impulse_result_bounding_box_t));
+#if EI_CLASSIFIER_HAS_VISUAL_ANOMALY
+        ok = ok && write_all(fd, result.visual_ad_grid_cells, record.visual_ad_count * sizeof(ei_impulse_result_bounding_box_t));
+#endif
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read what all workers send until every pipe is closed, a worker blocks as soon as its pipe is full
+ */
+static void collect(std::vector<batch_worker_t> &workers)
+{
+    std::vector<struct pollfd> fds;
+    uint8_t buf[16 * 1024];
+
+    for (;;) {
+        fds.clear();
+        for (const batch_worker_t &worker : workers) {
+            if (worker.fd >= 0) {
+                fds.push_back({ worker.fd, POLLIN, 0 });
+            }
+        }
+        if (fds.empty()) {
+            return;
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ei_printf("ERR: poll failed (%s)\n", strerror(errno));
+            return;
+        }
+
+        for (const struct pollfd &pfd : fds) {
+            if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            for (batch_worker_t &worker : workers) {
+                if (worker.fd != pfd.fd) {
+                    continue;
+                }
+                ssize_t n = read(worker.fd, buf, sizeof(buf));
+                if (n > 0) {
+                    worker.data.insert(worker.data.end(), buf, buf + n);
+                }
+                else if (n == 0 || errno != EINTR) {
+                    close(worker.fd);
+                    worker.fd = -1;
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Unpack the records of one worker into results, stops at a truncated record
+ */
+static void unpack(const std::vector<uint8_t> &data, size_t count, std::vector<ei_batch_result_t> &results)
+{
+    size_t offset = 0;
+
+    while (offset + sizeof(batch_record_t) <= data.size()) {
+        batch_record_t record;
+        memcpy(&record, data.data() + offset, sizeof(record));
+
+        size_t payload = (size_t)record.classification_count * sizeof(ei_impulse_result_classification_t) +
+            ((size_t)record.bounding_boxes_count + record.visual_ad_count) * sizeof(ei_impulse_result_bounding_box_t);
+        if (record.index >= count || offset + sizeof(record) + payload > data.size()) {
+            return;
+        }
+        const uint8_t *ptr = data.data() + offset + sizeof(record);
+        offset += sizeof(record) + payload;
+
+        ei_batch_result_t &entry = results[record.index];
+        entry.error = (EI_IMPULSE_ERROR)record.error;
+        entry.result = record.result;
+
+        entry.classification.assign((const ei_impulse_result_classification_t *)ptr,
+            (const ei_impulse_result_classification_t *)ptr + record.classification_count);
+        ptr += record.classification_count * sizeof(ei_impulse_result_classification_t);
+        entry.bounding_boxes.assign((const ei_impulse_result_bounding_box_t *)ptr,
+            (const ei_impulse_result_bounding_box_t *)ptr + record.bounding_boxes_count);
+        ptr += record.bounding_boxes_count * sizeof(ei_impulse_result_bounding_box_t);
+        entry.visual_ad_grid_cells.assign((const ei_impulse_result_bounding_box_t *)ptr,
+            (const ei_impulse_result_bounding_box_t *)ptr + record.visual_ad_count);
+
+        // labels point into the impulse, which is at the same address in every worker
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        entry.result.classification = entry.classification.empty() ? nullptr : entry.classification.data();
+#endif
+        entry.result.bounding_boxes = entry.bounding_boxes.empty() ? nullptr : entry.bounding_boxes.data();
+        entry.result.bounding_boxes_count = record.bounding_boxes_count;
+#if EI_CLASSIFIER_HAS_VISUAL_ANOMALY
+        entry.result.visual_ad_grid_cells = entry.visual_ad_grid_cells.empty() ? nullptr : entry.visual_ad_grid_cells.data();
+        entry.result.visual_ad_count = record.visual_ad_count;
+#endif
+        entry.result._raw_outputs = nullptr;
+        memset(&entry.result.op_profile, 0, sizeof(entry.result.op_profile));
+        memset(&entry.result.postprocessed_output, 0, sizeof(entry.result.postprocessed_output));
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+EI_IMPULSE_ERROR ei_run_classifier_batch(
+    ei_impulse_handle_t *handle,
+    ei::signal_t *signals,
+    size_t count,
+    std::vector<ei_batch_result_t> &results,
+    int num_workers,
+    bool debug)
+{
+    results.clear();
+    results.resize(count);
+    for (ei_batch_result_t &entry : results) {
+        memset(&entry.result, 0, sizeof(entry.result));
+        // stays set for windows a worker never reported (crashed worker)
+        entry.error = EI_IMPULSE_INFERENCE_ERROR;
+    }
+    if (count == 0) {
+        return EI_IMPULSE_OK;
+    }
+
+    if (num_workers <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_workers = cpus > 0 ? (int)cpus : 1;
+    }
+    if ((size_t)num_workers > count) {
+        num_workers = (int)count;
+    }
+
+    // buffered output would otherwise be written once more by every worker
+    fflush(stdout);
+    fflush(stderr);
+
+    std::vector<batch_worker_t> workers;
+    workers.reserve(num_workers);
+    EI_IMPULSE_ERROR res = EI_IMPULSE_OK;
+
+    for (int w = 0; w < num_workers; w++) {
+        size_t first = count * w / num_workers;
+        size_t last = count * (w + 1) / num_workers;
+
+        int fds[2];
+        if (pipe(fds) != 0) {
+            ei_printf("ERR: Failed to create pipe for batch worker (%s)\n", strerror(errno));
+            res = EI_IMPULSE_ALLOC_FAILED;
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            ei_printf("ERR: Failed to start batch worker (%s)\n", strerror(errno));
+            close(fds[0]);
+            close(fds[1]);
+            res = EI_IMPULSE_ALLOC_FAILED;
+            break;
+        }
+
+        if (pid == 0) {
+            // only keep our own write end, so the parent sees EOF when a worker is done
+            close(fds[0]);
+            for (const batch_worker_t &worker : workers) {
+                close(worker.fd);
+            }
+            signal(SIGPIPE, SIG_IGN);
+            bool ok = run_worker(handle, signals, first, last, fds[1], debug);
+            close(fds[1]);
+            fflush(stderr);
+            _exit(ok ? 0 : 1);
+        }
+
+        close(fds[1]);
+        workers.push_back({ pid, fds[0], std::vector<uint8_t>() });
+    }
+
+    collect(workers);
+
+    for (batch_worker_t &worker : workers) {
+        int status = 0;
+        pid_t pid;
+        while ((pid = waitpid(worker.pid, &status, 0)) < 0 && errno == EINTR) {
+        }
+        if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ei_printf("ERR: Batch worker %d did not finish (status %d)\n", (int)worker.pid, status);
+            if (res == EI_IMPULSE_OK) {
+                res = EI_IMPULSE_INFERENCE_ERROR;
+            }
+        }
+        unpack(worker.data, count, results);
+    }
+
+    return res;
+}
@@ -0,0 +1,87 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_BATCH_REPLAY_H
+#define EI_BATCH_REPLAY_H
+
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+
+#include <vector>
+
+/**
+ * Result of one window scored by ei_run_classifier_batch(). The pointers in result
+ * (bounding_boxes, visual_ad_grid_cells, classification when it is not statically
+ * allocated) point into the vectors of the same entry, so entries must not be copied.
+ * _raw_outputs, op_profile and postprocessed_output are cleared.
+ */
+typedef struct {
+    EI_IMPULSE_ERROR error;
+    ei_impulse_result_t result;
+    std::vector<ei_impulse_result_bounding_box_t> bounding_boxes;
+    std::vector<ei_impulse_result_bounding_box_t> visual_ad_grid_cells;
+    std::vector<ei_impulse_result_classification_t> classification;
+} ei_batch_result_t;
+
+/**
+ * Score count independent windows with run_classifier() on a pool of forked worker processes.
+ *
+ * The SDK, the EON compiled model and the host porting layer keep their state in globals
+ * (tensor arena, tensors, DSP and result buffers, heap counters), so every worker is a
+ * separate process with its own copy of all of it instead of a thread. Windows are split
+ * into one contiguous shard per worker and results[i] always belongs to signals[i],
+ * whatever the number of workers. Impulses that keep state between calls (stateful DSP
+ * blocks, object tracking) restart that state at every shard boundary.
+ *
+ * Every worker runs on its own copy of handle and of the process state at the time of the
+ * call, the caller's copy is left untouched.
+ *
+ * @param handle Impulse to run, e.g. &ei_default_impulse
+ * @param signals Windows to score, get_data is called from the workers
+ * @param count Number of windows
+ * @param results Resized to count entries
+ * @param num_workers Number of worker processes, <= 0 for one per online CPU
+ * @param debug Passed on to run_classifier()
+ * @return EI_IMPULSE_OK when all workers ran (per-window errors are in results[i].error),
+ *  EI_IMPULSE_ALLOC_FAILED when a worker could not be started, EI_IMPULSE_INFERENCE_ERROR when a
+ *  worker crashed or exited with an error (its windows keep EI_IMPULSE_INFERENCE_ERROR in results)
+ */
+EI_IMPULSE_ERROR ei_run_classifier_batch(
+    ei_impulse_handle_t *handle,
+    ei::signal_t *signals,
+    size_t count,
+    std::vector<ei_batch_result_t> &results,
+    int num_workers,
+    bool debug = false);
+
+#endif // EI_BATCH_REPLAY_H
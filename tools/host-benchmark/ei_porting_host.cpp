@@ -0,0 +1,187 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Porting layer for Linux hosts, replaces src/edge-impulse-sdk/porting/particle */
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/dsp/memory.hpp"
+#include "host_heap.h"
+
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+/* Every block carries its requested size in front, keeps the returned pointer 16 byte aligned */
+#define HOST_HEAP_HEADER_SIZE 16
+
+static host_heap_stats_t heap_stats = { 0 };
+
+static size_t heap_base = 0;
+
+/**
+ * Sample the engine (non-DSP) share of the heap allocated since the last reset. This runs
+ * before the next allocator call, so ei_memory_in_use already includes the previous DSP alloc / free.
+ */
+static void host_heap_sample(void)
+{
+    ptrdiff_t engine_in_use = (ptrdiff_t)(heap_stats.in_use - heap_base) - (ptrdiff_t)ei_memory_in_use;
+
+    if (engine_in_use > (ptrdiff_t)heap_stats.engine_peak) {
+        heap_stats.engine_peak = (size_t)engine_in_use;
+    }
+}
+
+static void *host_heap_track(void *block, size_t size)
+{
+    if (!block) {
+        return NULL;
+    }
+
+    *(size_t *)block = size;
+    heap_stats.in_use += size;
+    heap_stats.allocations++;
+    if (heap_stats.in_use > heap_stats.peak) {
+        heap_stats.peak = heap_stats.in_use;
+    }
+
+    return (uint8_t *)block + HOST_HEAP_HEADER_SIZE;
+}
+
+/**
+ * Start a new measurement. The DSP counters are restarted from zero as well, they drift
+ * when a quantized output matrix is freed through its float alias in run_postprocessing().
+ */
+void host_heap_reset_peak(void)
+{
+    heap_base = heap_stats.in_use;
+    heap_stats.peak = heap_stats.in_use;
+    heap_stats.engine_peak = 0;
+    heap_stats.allocations = 0;
+    ei_memory_in_use = 0;
+    ei_memory_peak_use = 0;
+}
+
+void host_heap_get_stats(host_heap_stats_t *stats)
+{
+    host_heap_sample();
+    *stats = heap_stats;
+}
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled()
+{
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+
+uint64_t ei_read_timer_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t ei_read_timer_ms()
+{
+    return ei_read_timer_us() / 1000;
+}
+
+void ei_serial_set_baudrate(int baudrate)
+{
+
+}
+
+void ei_putchar(char c)
+{
+    fputc(c, stderr);
+}
+
+char ei_getchar()
+{
+    return 0;
+}
+
+/**
+ *  SDK output goes to stderr, stdout is reserved for the benchmark report
+ */
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    fprintf(stderr, "%f", f);
+}
+
+void *ei_malloc(size_t size)
+{
+    host_heap_sample();
+    return host_heap_track(malloc(size + HOST_HEAP_HEADER_SIZE), size);
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    host_heap_sample();
+    return host_heap_track(calloc(nitems * size + HOST_HEAP_HEADER_SIZE, 1), nitems * size);
+}
+
+void ei_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    host_heap_sample();
+
+    uint8_t *block = (uint8_t *)ptr - HOST_HEAP_HEADER_SIZE;
+    heap_stats.in_use -= *(size_t *)block;
+    free(block);
+}
+
+#if defined(__cplusplus) && EI_C_LINKAGE == 1
+extern "C"
+#endif
+void DebugLog(const char* s)
+{
+    ei_printf("%s", s);
+}
@@ -0,0 +1,761 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "firmware-sdk/at_base64_lib.h"
+#include "ei_batch_replay.h"
+#include "host_heap.h"
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    std::vector<int64_t> dsp;
+    std::vector<int64_t> classification;
+    std::vector<int64_t> anomaly;
+    std::vector<int64_t> postprocessing;
+    std::vector<int64_t> total;
+} latency_samples_t;
+
+typedef struct {
+    size_t calls;
+    size_t inferences;
+    size_t errors;
+    int last_error;
+    latency_samples_t latency;
+    size_t dsp_peak_bytes;
+    size_t heap_peak_bytes;
+    size_t arena_high_water_bytes;
+    ei_shared_arena_stats_t shared_arena;
+} bench_result_t;
+
+typedef struct {
+    int workers;
+    double wall_us;
+    bool matches_sequential;
+} batch_run_t;
+
+typedef struct {
+    size_t windows;
+    size_t errors;
+    double sequential_wall_us;
+    std::vector<batch_run_t> runs;
+} batch_result_t;
+
+/**
+ * What a window scored to, timing left out so runs can be compared
+ */
+typedef struct {
+    int error;
+    std::vector<float> values;
+    std::vector<const char *> labels;
+} batch_outcome_t;
+
+typedef struct {
+    double legacy_us;
+    double streaming_us;
+    bool matches;
+} base64_run_t;
+
+typedef struct {
+    size_t bytes;
+    base64_run_t encode;
+    base64_run_t decode;
+} base64_result_t;
+
+typedef struct {
+    int iterations;
+    int warmup;
+    uint32_t seed;
+    bool continuous;
+    int batch_workers;
+    bool base64;
+    const char *input_path;
+} bench_options_t;
+
+/* Private defines --------------------------------------------------------- */
+/** Sample data sent by the base64 section, and the read / chunk sizes of the firmware */
+#define BASE64_BENCH_BYTES          (64 * 1024)
+#define BASE64_BENCH_READ_SIZE      513
+#define BASE64_BENCH_CHUNK_CHARS    512
+#define BASE64_BENCH_REPEATS        50
+
+/* Private variables ------------------------------------------------------- */
+static char *base64_sink;
+static size_t base64_sink_len;
+
+/* Private functions ------------------------------------------------------- */
+static void print_usage(const char *name)
+{
+    fprintf(stderr,
+        "Usage: %s [--input FILE] [--iterations N] [--warmup N] [--seed N] [--no-continuous]\n"
+        "          [--batch-workers N] [--no-batch] [--no-base64]\n"
+        "  --input FILE      raw features (comma or whitespace separated, as copied from the studio),\n"
+        "                    cut into consecutive windows; synthetic windows are used when omitted\n"
+        "  --iterations N    measured run_classifier calls / continuous slices (default 200)\n"
+        "  --warmup N        unmeasured calls before measuring (default 5)\n"
+        "  --seed N          seed for the synthetic windows (default 1)\n"
+        "  --no-continuous   skip the run_classifier_continuous replay\n"
+        "  --batch-workers N largest worker count for the ei_run_classifier_batch replay\n"
+        "                    (default: online CPUs)\n"
+        "  --no-batch        skip the ei_run_classifier_batch replay\n"
+        "  --no-base64       skip the base64 encoder / decoder comparison\n",
+        name);
+}
+
+static bool parse_options(int argc, char **argv, bench_options_t *options)
+{
+    for (int ix = 1; ix < argc; ix++) {
+        const char *arg = argv[ix];
+        bool has_value = ix + 1 < argc;
+
+        if (strcmp(arg, "--input") == 0 && has_value) {
+            options->input_path = argv[++ix];
+        }
+        else if (strcmp(arg, "--iterations") == 0 && has_value) {
+            options->iterations = atoi(argv[++ix]);
+        }
+        else if (strcmp(arg, "--warmup") == 0 && has_value) {
+            options->warmup = atoi(argv[++ix]);
+        }
+        else if (strcmp(arg, "--seed") == 0 && has_value) {
+            options->seed = (uint32_t)strtoul(argv[++ix], NULL, 10);
+        }
+        else if (strcmp(arg, "--no-continuous") == 0) {
+            options->continuous = false;
+        }
+        else if (strcmp(arg, "--batch-workers") == 0 && has_value) {
+            options->batch_workers = atoi(argv[++ix]);
+            if (options->batch_workers < 1) {
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--no-batch") == 0) {
+            options->batch_workers = 0;
+        }
+        else if (strcmp(arg, "--no-base64") == 0) {
+            options->base64 = false;
+        }
+        else {
+            return false;
+        }
+    }
+
+    return options->iterations > 0 && options->warmup >= 0;
+}
+
+/**
+ * Read every number in the file into one stream of raw samples
+ */
+static bool read_input_file(const char *path, std::vector<float> &stream)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        ei_printf("ERR: Failed to open %s\n", path);
+        return false;
+    }
+
+    int c;
+    float value;
+    while ((c = fgetc(file)) != EOF) {
+        if (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        ungetc(c, file);
+        if (fscanf(file, "%f", &value) != 1) {
+            ei_printf("ERR: Invalid number in %s at offset %ld\n", path, ftell(file));
+            fclose(file);
+            return false;
+        }
+        stream.push_back(value);
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * Synthetic window: per-axis motion plus gravity for inertial sensors,
+ * a few tones in int16 range for the microphone
+ */
+static void synthesize_window(std::vector<float> &stream, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const float two_pi = 2.0f * (float)M_PI;
+    const float fs = EI_CLASSIFIER_FREQUENCY;
+    const size_t axes = EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+
+#if EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
+    float freq[3], amplitude[3];
+    for (size_t tone = 0; tone < 3; tone++) {
+        freq[tone] = 100.0f + uniform(rng) * (fs / 4.0f - 100.0f);
+        amplitude[tone] = 500.0f + uniform(rng) * 3000.0f;
+    }
+    for (size_t ix = 0; ix < EI_CLASSIFIER_RAW_SAMPLE_COUNT; ix++) {
+        float sample = 300.0f * noise(rng);
+        for (size_t tone = 0; tone < 3; tone++) {
+            sample += amplitude[tone] * sinf(two_pi * freq[tone] * (float)ix / fs);
+        }
+        stream.push_back(roundf(sample));
+    }
+#else
+    std::vector<float> freq(axes), amplitude(axes), phase(axes);
+    for (size_t axis = 0; axis < axes; axis++) {
+        freq[axis] = 0.5f + uniform(rng) * 4.5f;
+        amplitude[axis] = 0.5f + uniform(rng) * 7.5f;
+        phase[axis] = uniform(rng) * two_pi;
+    }
+    for (size_t ix = 0; ix < EI_CLASSIFIER_RAW_SAMPLE_COUNT; ix++) {
+        for (size_t axis = 0; axis < axes; axis++) {
+            float sample = amplitude[axis] * sinf(two_pi * freq[axis] * (float)ix / fs + phase[axis]);
+            sample += 0.2f * noise(rng);
+            if (axis == 2) {
+                sample += 9.81f;
+            }
+            stream.push_back(sample);
+        }
+    }
+#endif
+}
+
+static bool inference_ran(const ei_impulse_result_t *result)
+{
+    if (result->timing.classification_us > 0 || result->anomaly != 0.0f) {
+        return true;
+    }
+#if EI_CLASSIFIER_OBJECT_DETECTION != 1
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (result->classification[ix].value != 0.0f) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+static void record_call(bench_result_t *bench, const ei_impulse_result_t *result, int64_t total_us, bool inference)
+{
+    host_heap_stats_t heap;
+    host_heap_get_stats(&heap);
+
+    bench->dsp_peak_bytes = std::max(bench->dsp_peak_bytes, ei_memory_peak_use);
+    bench->heap_peak_bytes = std::max(bench->heap_peak_bytes, heap.peak);
+    bench->arena_high_water_bytes = std::max(bench->arena_high_water_bytes, heap.engine_peak);
+
+    ei_shared_arena_stats_t shared_arena;
+    ei_shared_arena_get_stats(&shared_arena);
+    bench->shared_arena.size = shared_arena.size;
+    bench->shared_arena.peak = std::max(bench->shared_arena.peak, shared_arena.peak);
+    bench->shared_arena.dsp_peak = std::max(bench->shared_arena.dsp_peak, shared_arena.dsp_peak);
+    bench->shared_arena.model_peak = std::max(bench->shared_arena.model_peak, shared_arena.model_peak);
+    bench->shared_arena.heap_fallbacks += shared_arena.heap_fallbacks;
+    bench->shared_arena.heap_fallback_max_bytes = std::max(bench->shared_arena.heap_fallback_max_bytes,
+        shared_arena.heap_fallback_max_bytes);
+
+    bench->latency.dsp.push_back(result->timing.dsp_us);
+    bench->latency.total.push_back(total_us);
+    if (inference) {
+        bench->inferences++;
+        bench->latency.classification.push_back(result->timing.classification_us);
+        bench->latency.anomaly.push_back(result->timing.anomaly_us);
+        bench->latency.postprocessing.push_back(result->timing.postprocessing_us);
+    }
+}
+
+static void bench_run_classifier(const std::vector<float> &stream, const bench_options_t *options, bench_result_t *bench)
+{
+    const size_t window_size = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE;
+    const size_t windows = stream.size() / window_size;
+    ei_impulse_result_t result = { 0 };
+    signal_t signal;
+
+    for (int ix = 0; ix < options->warmup + options->iterations; ix++) {
+        const float *window = stream.data() + (ix % windows) * window_size;
+        numpy::signal_from_buffer(window, window_size, &signal);
+
+        host_heap_reset_peak();
+        ei_shared_arena_reset_peak();
+        uint64_t start_us = ei_read_timer_us();
+        EI_IMPULSE_ERROR res = run_classifier(&signal, &result, false);
+        int64_t total_us = (int64_t)(ei_read_timer_us() - start_us);
+
+        if (ix < options->warmup) {
+            continue;
+        }
+
+        bench->calls++;
+        if (res != EI_IMPULSE_OK) {
+            bench->errors++;
+            bench->last_error = res;
+            continue;
+        }
+        record_call(bench, &result, total_us, true);
+    }
+}
+
+static void bench_run_classifier_continuous(const std::vector<float> &stream, const bench_options_t *options, bench_result_t *bench)
+{
+    const size_t slice_size = EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+    const int warmup_slices = options->warmup * EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+    ei_impulse_result_t result = { 0 };
+    signal_t signal;
+    size_t offset = 0;
+
+    run_classifier_init();
+
+    for (int ix = 0; ix < warmup_slices + options->iterations; ix++) {
+        if (offset + slice_size > stream.size()) {
+            offset = 0;
+        }
+        numpy::signal_from_buffer(stream.data() + offset, slice_size, &signal);
+        offset += slice_size;
+
+        host_heap_reset_peak();
+        ei_shared_arena_reset_peak();
+        uint64_t start_us = ei_read_timer_us();
+        EI_IMPULSE_ERROR res = run_classifier_continuous(&signal, &result, false);
+        int64_t total_us = (int64_t)(ei_read_timer_us() - start_us);
+
+        if (ix < warmup_slices) {
+            continue;
+        }
+
+        bench->calls++;
+        if (res != EI_IMPULSE_OK) {
+            bench->errors++;
+            bench->last_error = res;
+            continue;
+        }
+        record_call(bench, &result, total_us, inference_ran(&result));
+    }
+
+    run_classifier_deinit();
+}
+
+static batch_outcome_t batch_outcome(EI_IMPULSE_ERROR error, const ei_impulse_result_t *result)
+{
+    batch_outcome_t outcome;
+    outcome.error = error;
+    if (error != EI_IMPULSE_OK) {
+        return outcome;
+    }
+
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    if (result->classification)
+#endif
+    {
+        for (size_t ix = 0; ix < ei_default_impulse.impulse->label_count; ix++) {
+            outcome.values.push_back(result->classification[ix].value);
+            outcome.labels.push_back(result->classification[ix].label);
+        }
+    }
+    outcome.values.push_back(result->anomaly);
+    for (uint32_t ix = 0; ix < result->bounding_boxes_count; ix++) {
+        const ei_impulse_result_bounding_box_t &bb = result->bounding_boxes[ix];
+        outcome.values.insert(outcome.values.end(),
+            { bb.value, (float)bb.x, (float)bb.y, (float)bb.width, (float)bb.height });
+        outcome.labels.push_back(bb.label);
+    }
+
+    return outcome;
+}
+
+static bool batch_outcome_equal(const batch_outcome_t &a, const batch_outcome_t &b)
+{
+    if (a.error != b.error || a.values != b.values || a.labels.size() != b.labels.size()) {
+        return false;
+    }
+    for (size_t ix = 0; ix < a.labels.size(); ix++) {
+        if (a.labels[ix] != b.labels[ix] && (!a.labels[ix] || !b.labels[ix] || strcmp(a.labels[ix], b.labels[ix]) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Score the same windows sequentially and with ei_run_classifier_batch() on 1, 2, 4, ...
+ * up to max_workers worker processes
+ */
+static void bench_run_classifier_batch(const std::vector<float> &stream, const bench_options_t *options, batch_result_t *bench)
+{
+    const size_t window_size = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE;
+    const size_t windows = stream.size() / window_size;
+    std::vector<signal_t> signals(options->iterations);
+    std::vector<batch_outcome_t> expected;
+    ei_impulse_result_t result = { 0 };
+
+    for (size_t ix = 0; ix < signals.size(); ix++) {
+        numpy::signal_from_buffer(stream.data() + (ix % windows) * window_size, window_size, &signals[ix]);
+    }
+    bench->windows = signals.size();
+
+    uint64_t start_us = ei_read_timer_us();
+    for (size_t ix = 0; ix < signals.size(); ix++) {
+        EI_IMPULSE_ERROR res = run_classifier(&signals[ix], &result, false);
+        expected.push_back(batch_outcome(res, &result));
+    }
+    bench->sequential_wall_us = (double)(ei_read_timer_us() - start_us);
+
+    std::vector<int> worker_counts;
+    for (int workers = 1; workers < options->batch_workers; workers *= 2) {
+        worker_counts.push_back(workers);
+    }
+    worker_counts.push_back(options->batch_workers);
+
+    for (int workers : worker_counts) {
+        std::vector<ei_batch_result_t> results;
+        batch_run_t run = { workers, 0, true };
+
+        start_us = ei_read_timer_us();
+        EI_IMPULSE_ERROR res = ei_run_classifier_batch(&ei_default_impulse, signals.data(), signals.size(), results, workers);
+        run.wall_us = (double)(ei_read_timer_us() - start_us);
+
+        if (res != EI_IMPULSE_OK) {
+            bench->errors++;
+        }
+        for (size_t ix = 0; ix < results.size(); ix++) {
+            if (results[ix].error != EI_IMPULSE_OK) {
+                bench->errors++;
+            }
+            if (!batch_outcome_equal(batch_outcome(results[ix].error, &results[ix].result), expected[ix])) {
+                run.matches_sequential = false;
+            }
+        }
+        bench->runs.push_back(run);
+    }
+}
+
+static void print_batch_result(const batch_result_t *bench, bool last)
+{
+    printf("  \"run_classifier_batch\": {\n");
+    printf("    \"windows\": %u,\n", (unsigned)bench->windows);
+    printf("    \"errors\": %u,\n", (unsigned)bench->errors);
+    printf("    \"sequential\": { \"wall_us\": %.0f, \"windows_per_s\": %.1f },\n",
+        bench->sequential_wall_us, (double)bench->windows * 1e6 / bench->sequential_wall_us);
+    printf("    \"runs\": [\n");
+    for (size_t ix = 0; ix < bench->runs.size(); ix++) {
+        const batch_run_t &run = bench->runs[ix];
+        printf("      { \"workers\": %d, \"wall_us\": %.0f, \"windows_per_s\": %.1f, \"speedup\": %.2f, \"matches_sequential\": %s }%s\n",
+            run.workers, run.wall_us, (double)bench->windows * 1e6 / run.wall_us,
+            bench->sequential_wall_us / run.wall_us, run.matches_sequential ? "true" : "false",
+            ix + 1 < bench->runs.size() ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }%s\n", last ? "" : ",");
+}
+
+static void base64_sink_putc(char c)
+{
+    base64_sink[base64_sink_len++] = c;
+}
+
+static void base64_sink_write(const char *buf, size_t len)
+{
+    memcpy(base64_sink + base64_sink_len, buf, len);
+    base64_sink_len += len;
+}
+
+static double median_us(std::vector<double> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/**
+ * Send and receive the same data with the per-character base64 functions the firmware used before
+ * (base64_encode() per 513-byte read, base64_decode() + memcpy per 512-character chunk) and with the
+ * streaming encoder / decoder of at_base64_lib, the median over BASE64_BENCH_REPEATS runs is reported
+ */
+static void bench_base64(uint32_t seed, base64_result_t *bench)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(BASE64_BENCH_BYTES);
+    for (size_t ix = 0; ix < data.size(); ix++) {
+        data[ix] = (uint8_t)rng();
+    }
+
+    const size_t encoded_size = (data.size() + 2) / 3 * 4;
+    std::vector<char> legacy_text(encoded_size);
+    std::vector<char> streaming_text(encoded_size);
+    std::vector<uint8_t> legacy_out(data.size());
+    std::vector<uint8_t> streaming_out(data.size());
+    std::vector<double> legacy_us, streaming_us;
+
+    bench->bytes = data.size();
+
+    for (int rep = 0; rep < BASE64_BENCH_REPEATS; rep++) {
+        base64_sink = legacy_text.data();
+        base64_sink_len = 0;
+        uint64_t start_us = ei_read_timer_us();
+        for (size_t ix = 0; ix < data.size(); ix += BASE64_BENCH_READ_SIZE) {
+            size_t n = std::min((size_t)BASE64_BENCH_READ_SIZE, data.size() - ix);
+            base64_encode((const char *)data.data() + ix, n, base64_sink_putc);
+        }
+        legacy_us.push_back((double)(ei_read_timer_us() - start_us));
+
+        base64_sink = streaming_text.data();
+        base64_sink_len = 0;
+        base64_encoder_t encoder;
+        start_us = ei_read_timer_us();
+        base64_encoder_init(&encoder, base64_sink_write);
+        for (size_t ix = 0; ix < data.size(); ix += BASE64_BENCH_READ_SIZE) {
+            size_t n = std::min((size_t)BASE64_BENCH_READ_SIZE, data.size() - ix);
+            base64_encoder_update(&encoder, data.data() + ix, n);
+        }
+        base64_encoder_finish(&encoder);
+        streaming_us.push_back((double)(ei_read_timer_us() - start_us));
+    }
+
+    bench->encode.legacy_us = median_us(legacy_us);
+    bench->encode.streaming_us = median_us(streaming_us);
+    bench->encode.matches = base64_sink_len == encoded_size && legacy_text == streaming_text;
+
+    legacy_us.clear();
+    streaming_us.clear();
+    bool decoded_all = true;
+
+    for (int rep = 0; rep < BASE64_BENCH_REPEATS; rep++) {
+        uint64_t start_us = ei_read_timer_us();
+        size_t out_len = 0;
+        for (size_t ix = 0; ix < encoded_size; ix += BASE64_BENCH_CHUNK_CHARS) {
+            size_t n = std::min((size_t)BASE64_BENCH_CHUNK_CHARS, encoded_size - ix);
+            std::vector<unsigned char> decoded = base64_decode(std::string(legacy_text.data() + ix, n));
+            size_t copy_len = std::min(decoded.size(), legacy_out.size() - out_len);
+            memcpy(legacy_out.data() + out_len, decoded.data(), copy_len);
+            out_len += copy_len;
+        }
+        legacy_us.push_back((double)(ei_read_timer_us() - start_us));
+
+        base64_decoder_t decoder;
+        start_us = ei_read_timer_us();
+        base64_decoder_init(&decoder, streaming_out.data(), streaming_out.size());
+        for (size_t ix = 0; ix < encoded_size; ix += BASE64_BENCH_CHUNK_CHARS) {
+            size_t n = std::min((size_t)BASE64_BENCH_CHUNK_CHARS, encoded_size - ix);
+            base64_decoder_update(&decoder, legacy_text.data() + ix, n);
+        }
+        decoded_all &= base64_decoder_finish(&decoder) == data.size();
+        streaming_us.push_back((double)(ei_read_timer_us() - start_us));
+    }
+
+    bench->decode.legacy_us = median_us(legacy_us);
+    bench->decode.streaming_us = median_us(streaming_us);
+    bench->decode.matches = decoded_all && legacy_out == data && streaming_out == data;
+}
+
+static void print_base64_run(const char *name, const base64_run_t *run, bool last)
+{
+    printf("    \"%s\": { \"legacy_us\": %.0f, \"streaming_us\": %.0f, \"speedup\": %.2f, \"matches\": %s }%s\n",
+        name, run->legacy_us, run->streaming_us, run->legacy_us / run->streaming_us,
+        run->matches ? "true" : "false", last ? "" : ",");
+}
+
+static void print_base64_result(const base64_result_t *bench, bool last)
+{
+    printf("  \"base64\": {\n");
+    printf("    \"bytes\": %u,\n", (unsigned)bench->bytes);
+    print_base64_run("encode", &bench->encode, false);
+    print_base64_run("decode", &bench->decode, true);
+    printf("  }%s\n", last ? "" : ",");
+}
+
+/**
+ * Nearest-rank percentiles, sorts the samples in place
+ */
+static void print_latency(const char *name, std::vector<int64_t> &samples, bool last)
+{
+    printf("      \"%s\": ", name);
+    if (samples.empty()) {
+        printf("null%s\n", last ? "" : ",");
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    auto percentile = [&](float p) {
+        size_t rank = (size_t)ceilf(p / 100.0f * (float)n);
+        return samples[rank > 0 ? rank - 1 : 0];
+    };
+    int64_t sum = 0;
+    for (int64_t sample : samples) {
+        sum += sample;
+    }
+
+    printf("{ \"p50\": %lld, \"p90\": %lld, \"p99\": %lld, \"max\": %lld, \"mean\": %.1f }%s\n",
+        (long long)percentile(50), (long long)percentile(90), (long long)percentile(99),
+        (long long)samples[n - 1], (double)sum / (double)n, last ? "" : ",");
+}
+
+static void print_result(const char *name, bench_result_t *bench, bool last)
+{
+    printf("  \"%s\": {\n", name);
+    printf("    \"calls\": %u,\n", (unsigned)bench->calls);
+    printf("    \"inferences\": %u,\n", (unsigned)bench->inferences);
+    printf("    \"errors\": %u,\n", (unsigned)bench->errors);
+    printf("    \"last_error\": %d,\n", bench->last_error);
+    printf("    \"latency_us\": {\n");
+    print_latency("dsp", bench->latency.dsp, false);
+    print_latency("classification", bench->latency.classification, false);
+    print_latency("anomaly", bench->latency.anomaly, false);
+    print_latency("postprocessing", bench->latency.postprocessing, false);
+    print_latency("total", bench->latency.total, true);
+    printf("    },\n");
+    printf("    \"memory\": {\n");
+    printf("      \"dsp_peak_bytes\": %u,\n", (unsigned)bench->dsp_peak_bytes);
+    printf("      \"heap_peak_bytes\": %u,\n", (unsigned)bench->heap_peak_bytes);
+    printf("      \"arena_high_water_bytes\": %u,\n", (unsigned)bench->arena_high_water_bytes);
+    printf("      \"shared_arena\": { \"size\": %u, \"peak\": %u, \"dsp_peak\": %u, \"model_peak\": %u, \"heap_fallbacks\": %u, \"heap_fallback_max_bytes\": %u }\n",
+        (unsigned)bench->shared_arena.size, (unsigned)bench->shared_arena.peak, (unsigned)bench->shared_arena.dsp_peak,
+        (unsigned)bench->shared_arena.model_peak, (unsigned)bench->shared_arena.heap_fallbacks,
+        (unsigned)bench->shared_arena.heap_fallback_max_bytes);
+    printf("    }\n");
+    printf("  }%s\n", last ? "" : ",");
+}
+
+static const char *sensor_name(void)
+{
+    switch (EI_CLASSIFIER_SENSOR) {
+        case EI_CLASSIFIER_SENSOR_MICROPHONE: return "microphone";
+        case EI_CLASSIFIER_SENSOR_ACCELEROMETER: return "accelerometer";
+        case EI_CLASSIFIER_SENSOR_CAMERA: return "camera";
+        case EI_CLASSIFIER_SENSOR_9DOF: return "9dof";
+        case EI_CLASSIFIER_SENSOR_ENVIRONMENTAL: return "environmental";
+        case EI_CLASSIFIER_SENSOR_FUSION: return "fusion";
+        default: return "unknown";
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    bench_options_t options = { 200, 5, 1, true, cpus > 0 ? (int)cpus : 1, true, NULL };
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<float> stream;
+    if (options.input_path) {
+        if (!read_input_file(options.input_path, stream)) {
+            return 1;
+        }
+        if (stream.size() < EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+            ei_printf("ERR: %s holds %u values, need at least one window of %u\n",
+                options.input_path, (unsigned)stream.size(), (unsigned)EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE);
+            return 1;
+        }
+    }
+    else {
+        for (uint32_t ix = 0; ix < 16; ix++) {
+            synthesize_window(stream, options.seed + ix);
+        }
+    }
+
+    bench_result_t single = { 0 };
+    bench_run_classifier(stream, &options, &single);
+
+    bench_result_t continuous = { 0 };
+    const char *continuous_skipped = NULL;
+    if (!options.continuous) {
+        continuous_skipped = "disabled with --no-continuous";
+    }
+    else if (!ei_impulse_supports_continuous(ei_default_impulse.impulse)) {
+        continuous_skipped = "impulse has DSP blocks without continuous support (only MFCC, MFE and spectrogram)";
+    }
+    else {
+        bench_run_classifier_continuous(stream, &options, &continuous);
+    }
+
+    batch_result_t batch = { 0 };
+    if (options.batch_workers > 0) {
+        bench_run_classifier_batch(stream, &options, &batch);
+    }
+
+    base64_result_t base64 = { 0 };
+    if (options.base64) {
+        bench_base64(options.seed, &base64);
+    }
+
+    printf("{\n");
+    printf("  \"impulse\": {\n");
+    printf("    \"project_id\": %d,\n", EI_CLASSIFIER_PROJECT_ID);
+    printf("    \"deploy_version\": %d,\n", EI_CLASSIFIER_PROJECT_DEPLOY_VERSION);
+    printf("    \"sensor\": \"%s\",\n", sensor_name());
+    printf("    \"dsp_input_frame_size\": %u,\n", (unsigned)EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE);
+    printf("    \"slice_size\": %u\n", (unsigned)(EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME));
+    printf("  },\n");
+    printf("  \"input\": { \"source\": \"%s\", \"samples\": %u, \"iterations\": %d, \"warmup\": %d, \"seed\": %u },\n",
+        options.input_path ? "file" : "synthetic", (unsigned)stream.size(), options.iterations, options.warmup,
+        (unsigned)options.seed);
+    print_result("run_classifier", &single, false);
+    if (continuous_skipped) {
+        printf("  \"run_classifier_continuous\": { \"skipped\": \"%s\" },\n", continuous_skipped);
+    }
+    else {
+        print_result("run_classifier_continuous", &continuous, false);
+    }
+    if (options.batch_workers > 0) {
+        print_batch_result(&batch, false);
+    }
+    else {
+        printf("  \"run_classifier_batch\": { \"skipped\": \"disabled with --no-batch\" },\n");
+    }
+    if (options.base64) {
+        print_base64_result(&base64, true);
+    }
+    else {
+        printf("  \"base64\": { \"skipped\": \"disabled with --no-base64\" }\n");
+    }
+    printf("}\n");
+
+    bool batch_mismatch = false;
+    for (const batch_run_t &run : batch.runs) {
+        batch_mismatch = batch_mismatch || !run.matches_sequential;
+    }
+    bool base64_mismatch = options.base64 && (!base64.encode.matches || !base64.decode.matches);
+
+    return (single.errors || continuous.errors || batch.errors || batch_mismatch || base64_mismatch) ? 2 : 0;
+}
@@ -0,0 +1,479 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit test of the FIFO path of lib/ADXL362DMA: readFifoAsync(), the resynchronisation to the
+ * next X entry in cleanBuffer() and the carry-over of incomplete samples (partialSampleBytes).
+ * The library talks to a simulated ADXL362 over the mocked SPI bus in mock/Particle.h, which
+ * streams FIFO entries as the datasheet describes them. Prints a JSON report */
+
+#include "Particle.h"
+#include "ADXL362DMA.h"
+
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* ADXL362 commands and registers, from the datasheet */
+#define SIM_CMD_WRITE_REGISTER      0x0a
+#define SIM_CMD_READ_REGISTER       0x0b
+#define SIM_CMD_READ_FIFO           0x0d
+#define SIM_REG_STATUS              0x0b
+#define SIM_REG_FIFO_ENTRIES_L      0x0c
+#define SIM_REG_FIFO_ENTRIES_H      0x0d
+#define SIM_REG_FIFO_CONTROL        0x28
+#define SIM_FIFO_TEMP               0x04
+#define SIM_FIFO_MODE_MASK          0x03
+#define SIM_FIFO_CAPACITY           512     /* entries */
+
+#define AXIS_TEMPERATURE            3
+
+/**
+ * Simulated ADXL362: registers and the FIFO. An entry is 16 bits, the axis in bits 15:14
+ * (x, y, z, temperature) and the 14 bit sign extended value below. It is clocked out least
+ * significant byte first. In stream mode the oldest entry is dropped when the FIFO is full.
+ */
+typedef struct {
+    uint8_t regs[0x40];
+    std::deque<uint16_t> fifo;
+    bool fifo_msb_next;         /* LSB of the front entry was clocked out */
+    size_t byte_ix;             /* byte within the current transaction (CS low) */
+    uint8_t cmd;
+    uint8_t addr;
+    void (*dma_callback)(void);
+    uint32_t next_sample;       /* sequence number of the next sample the sensor produces */
+    uint32_t overrun_entries;   /* entries dropped because the FIFO was full */
+    uint32_t cleared_entries;   /* entries dropped by a FIFO mode change */
+    uint32_t underrun_bytes;    /* FIFO bytes clocked out of an empty FIFO */
+} adxl362_sim_t;
+
+static adxl362_sim_t sim;
+
+SPIClass SPI;
+MockLogger Log;
+
+/**
+ * @brief Value of an axis for sample n, 12 bits as the ADXL362 measures them
+ */
+static int16_t sim_value(uint32_t n, int axis)
+{
+    return (int16_t)((n * 37u + (uint32_t)axis * 1291u) % 4096u) - 2048;
+}
+
+static void sim_reset(void)
+{
+    sim.fifo.clear();
+    memset(sim.regs, 0, sizeof(sim.regs));
+    sim.fifo_msb_next = false;
+    sim.byte_ix = 0;
+    sim.dma_callback = nullptr;
+    sim.next_sample = 0;
+    sim.overrun_entries = 0;
+    sim.cleared_entries = 0;
+    sim.underrun_bytes = 0;
+}
+
+static void sim_push_entry(int axis, int16_t value)
+{
+    if (sim.fifo.size() >= SIM_FIFO_CAPACITY) {
+        sim.fifo.pop_front();
+        sim.overrun_entries++;
+    }
+    sim.fifo.push_back((uint16_t)((axis << 14) | (value & 0x3fff)));
+}
+
+/**
+ * @brief Sensor produces `count` samples, stored if the FIFO is enabled
+ */
+static void sim_produce(uint32_t count)
+{
+    int axes = (sim.regs[SIM_REG_FIFO_CONTROL] & SIM_FIFO_TEMP) ? 4 : 3;
+
+    for (uint32_t ix = 0; ix < count; ix++, sim.next_sample++) {
+        if ((sim.regs[SIM_REG_FIFO_CONTROL] & SIM_FIFO_MODE_MASK) == 0) {
+            continue;
+        }
+        for (int axis = 0; axis < axes; axis++) {
+            sim_push_entry(axis, sim_value(sim.next_sample, axis));
+        }
+    }
+}
+
+static uint8_t sim_read_register(uint8_t addr)
+{
+    switch (addr) {
+        case SIM_REG_FIFO_ENTRIES_L:
+            return sim.fifo.size() & 0xff;
+        case SIM_REG_FIFO_ENTRIES_H:
+            return (sim.fifo.size() >> 8) & 0x03;
+        case SIM_REG_STATUS:
+            return sim.fifo.empty() ? 0x01 : 0x03;
+        default:
+            return sim.regs[addr & 0x3f];
+    }
+}
+
+static void sim_write_register(uint8_t addr, uint8_t value)
+{
+    addr &= 0x3f;
+    /* changing the FIFO mode clears the FIFO */
+    if (addr == SIM_REG_FIFO_CONTROL &&
+        (value & SIM_FIFO_MODE_MASK) != (sim.regs[addr] & SIM_FIFO_MODE_MASK)) {
+        sim.cleared_entries += sim.fifo.size();
+        sim.fifo.clear();
+        sim.fifo_msb_next = false;
+    }
+    sim.regs[addr] = value;
+}
+
+static uint8_t sim_spi_byte(uint8_t mosi)
+{
+    size_t ix = sim.byte_ix++;
+
+    if (ix == 0) {
+        sim.cmd = mosi;
+        return 0;
+    }
+
+    switch (sim.cmd) {
+        case SIM_CMD_READ_FIFO: {
+            if (sim.fifo.empty()) {
+                sim.underrun_bytes++;
+                return 0;
+            }
+            uint16_t entry = sim.fifo.front();
+            if (!sim.fifo_msb_next) {
+                sim.fifo_msb_next = true;
+                return entry & 0xff;
+            }
+            sim.fifo_msb_next = false;
+            sim.fifo.pop_front();
+            return entry >> 8;
+        }
+        case SIM_CMD_READ_REGISTER:
+            if (ix == 1) {
+                sim.addr = mosi;
+                return 0;
+            }
+            return sim_read_register(sim.addr++);
+        case SIM_CMD_WRITE_REGISTER:
+            if (ix == 1) {
+                sim.addr = mosi;
+                return 0;
+            }
+            sim_write_register(sim.addr++, mosi);
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    return sim_spi_byte(data);
+}
+
+void SPIClass::transfer(const void *tx, void *rx, size_t len, void (*callback)(void))
+{
+    const uint8_t *tx_bytes = (const uint8_t *)tx;
+    uint8_t *rx_bytes = (uint8_t *)rx;
+
+    for (size_t ix = 0; ix < len; ix++) {
+        uint8_t miso = sim_spi_byte(tx_bytes ? tx_bytes[ix] : 0);
+        if (rx_bytes) {
+            rx_bytes[ix] = miso;
+        }
+    }
+
+    sim.dma_callback = callback;
+}
+
+void digitalWrite(int pin, int value)
+{
+    if (value == HIGH) {
+        /* an entry that was read halfway is discarded (odd number of bytes read) */
+        if (sim.fifo_msb_next) {
+            sim.fifo.pop_front();
+            sim.fifo_msb_next = false;
+        }
+    }
+    sim.byte_ix = 0;
+}
+
+void delay(unsigned long ms)
+{
+}
+
+/**
+ * @brief Finish the running DMA transfer, as the SPI interrupt would
+ */
+static void mock_spi_complete_dma(void)
+{
+    void (*callback)(void) = sim.dma_callback;
+    sim.dma_callback = nullptr;
+    if (callback) {
+        callback();
+    }
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct {
+    const char *name;
+    bool store_temp;
+    size_t buf_size;            /* bytes in the ADXL362DataBase buffer */
+    uint32_t max_produce;       /* samples produced between reads, random in [0, max_produce] */
+    uint32_t skip_entries;      /* trailing entries of a sample in the FIFO before the first one */
+    uint32_t mode_change_every; /* restart the FIFO every N reads (0 = never) */
+} scenario_t;
+
+typedef struct {
+    uint32_t reads;
+    uint32_t produced;
+    uint32_t samples;           /* samples read */
+    uint32_t lost;              /* samples lost to overruns or FIFO restarts */
+    uint32_t errors;            /* samples with wrong values, out of order or lost without a reason */
+    uint32_t resyncs;           /* reads that skipped entries to find the next X */
+    uint32_t carry_overs;       /* reads that left an incomplete sample for the next one */
+    uint32_t state_errors;      /* readFifoAsync() left the buffer in an unexpected state */
+    uint32_t underrun_bytes;
+} scenario_result_t;
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool sample_matches(const ADXL362DataBase *data, size_t ix, uint32_t n, bool store_temp)
+{
+    return data->readX(ix) == sim_value(n, 0) &&
+        data->readY(ix) == sim_value(n, 1) &&
+        data->readZ(ix) == sim_value(n, 2) &&
+        (!store_temp || data->readT(ix) == sim_value(n, AXIS_TEMPERATURE));
+}
+
+/**
+ * @brief Check one completed read against the samples the sensor produced. Samples have to
+ * come in order, gaps are only allowed when entries were dropped since the last read or the
+ * FIFO was full.
+ */
+static void check_read(const scenario_t *scenario, const ADXL362DataBase *data, uint32_t *expect_n,
+    bool dropped, scenario_result_t *result)
+{
+    for (size_t ix = 0; ix < data->numSamplesRead; ix++) {
+        result->samples++;
+
+        if (sample_matches(data, ix, *expect_n, scenario->store_temp)) {
+            (*expect_n)++;
+            continue;
+        }
+
+        uint32_t n = *expect_n + 1;
+        while (n < sim.next_sample && !sample_matches(data, ix, n, scenario->store_temp)) {
+            n++;
+        }
+
+        if (n < sim.next_sample && dropped) {
+            result->lost += n - *expect_n;
+            *expect_n = n + 1;
+        }
+        else {
+            result->errors++;
+            if (result->errors <= 3) {
+                fprintf(stderr, "%s: read %u sample %u: x=%d y=%d z=%d, expected sample %u\n",
+                    scenario->name, (unsigned)result->reads, (unsigned)ix,
+                    data->readX(ix), data->readY(ix), data->readZ(ix), (unsigned)*expect_n);
+            }
+        }
+    }
+}
+
+static void run_scenario(const scenario_t *scenario, uint32_t reads, scenario_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    sim_reset();
+
+    ADXL362DMA accel(SPI, A2);
+    std::vector<uint8_t> buf(scenario->buf_size);
+    ADXL362DataBase data(buf.data(), buf.size());
+    size_t sample_size = scenario->store_temp ? 8 : 6;
+
+    accel.writeFifoControlAndSamples(128, scenario->store_temp, ADXL362DMA::FIFO_STREAM);
+
+    /* tail of a sample the read starts in the middle of, e.g. after an overrun */
+    int first_axis = (int)(sample_size / 2) - (int)scenario->skip_entries;
+    for (int axis = first_axis; axis < (int)(sample_size / 2); axis++) {
+        sim_push_entry(axis, 0x1555);
+    }
+
+    uint32_t expect_n = 0;
+    uint32_t dropped_before = 0;
+
+    for (uint32_t read = 0; read < reads; read++) {
+        bool draining = read >= reads - 32;
+
+        if (!draining) {
+            uint32_t count = rng_next() % (scenario->max_produce + 1);
+            sim_produce(count);
+            result->produced += count;
+        }
+
+        if (scenario->mode_change_every && !draining && read % scenario->mode_change_every == scenario->mode_change_every - 1) {
+            accel.writeFifoControlAndSamples(128, scenario->store_temp, ADXL362DMA::FIFO_DISABLED);
+            accel.writeFifoControlAndSamples(128, scenario->store_temp, ADXL362DMA::FIFO_STREAM);
+        }
+
+        bool fifo_empty = sim.fifo.empty();
+        /* the library drops the bytes carried over when it finds the FIFO full, it can not
+         * tell whether entries were dropped */
+        bool fifo_full = sim.fifo.size() >= SIM_FIFO_CAPACITY;
+        data.state = ADXL362DMA::STATE_FREE;
+        accel.readFifoAsync(&data);
+        result->reads++;
+
+        if (fifo_empty || data.numSamplesRead == 0) {
+            if (data.state != ADXL362DMA::STATE_FREE) {
+                result->state_errors++;
+            }
+            continue;
+        }
+        if (data.state != ADXL362DMA::STATE_READING_FIFO) {
+            result->state_errors++;
+            continue;
+        }
+
+        mock_spi_complete_dma();
+        if (data.state != ADXL362DMA::STATE_READ_COMPLETE) {
+            result->state_errors++;
+            continue;
+        }
+
+        if (data.startOffset > 0) {
+            result->resyncs++;
+        }
+        if (data.bytesRead > data.startOffset + data.numSamplesRead * sample_size) {
+            result->carry_overs++;
+        }
+
+        uint32_t dropped = sim.overrun_entries + sim.cleared_entries;
+        check_read(scenario, &data, &expect_n, dropped != dropped_before || fifo_full, result);
+        dropped_before = dropped;
+    }
+
+    /* everything the sensor produced was read or explicitly dropped, nothing is stuck */
+    if (!sim.fifo.empty() || expect_n != sim.next_sample) {
+        fprintf(stderr, "%s: %u samples not read (FIFO holds %u entries)\n", scenario->name,
+            (unsigned)(sim.next_sample - expect_n), (unsigned)sim.fifo.size());
+        result->errors++;
+    }
+    result->underrun_bytes = sim.underrun_bytes;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t reads = 5000;
+    uint32_t seed = 1;
+
+    for (int ix = 1; ix < argc; ix++) {
+        if (strcmp(argv[ix], "--reads") == 0 && ix + 1 < argc) {
+            reads = (uint32_t)atoi(argv[++ix]);
+        }
+        else if (strcmp(argv[ix], "--seed") == 0 && ix + 1 < argc) {
+            seed = (uint32_t)atoi(argv[++ix]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--reads N] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (reads < 64) {
+        reads = 64;
+    }
+
+    /* the FIFO holds 170 XYZ or 128 XYZT samples */
+    const scenario_t scenarios[] = {
+        { "aligned_xyz",       false, 1024, 40,  0, 0 },
+        { "aligned_xyzt",      true,  1024, 40,  0, 0 },
+        { "misaligned_xyz",    false, 1024, 40,  2, 0 },
+        { "misaligned_xyzt",   true,  1024, 40,  3, 0 },
+        { "small_buffer_xyz",  false, 50,   12,  1, 0 },
+        { "small_buffer_xyzt", true,  60,   12,  1, 0 },
+        { "overrun_xyz",       false, 1024, 400, 1, 0 },
+        { "overrun_xyzt",      true,  200,  400, 2, 0 },
+        { "fifo_restart_xyz",  false, 50,   12,  1, 7 },
+        { "fifo_restart_xyzt", true,  60,   12,  2, 7 },
+    };
+    const size_t scenario_count = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    bool ok = true;
+
+    printf("{\n");
+    printf("  \"reads_per_scenario\": %u,\n", (unsigned)reads);
+    printf("  \"seed\": %u,\n", (unsigned)seed);
+    printf("  \"scenarios\": [\n");
+    for (size_t ix = 0; ix < scenario_count; ix++) {
+        const scenario_t *scenario = &scenarios[ix];
+        scenario_result_t result;
+
+        rng_state = seed ? seed : 1;
+        run_scenario(scenario, reads, &result);
+
+        /* samples are only lost with the entries the sensor dropped (checked per read), and the
+         * scenarios that set out to overrun, restart or start misaligned actually did */
+        bool expect_drops = scenario->max_produce * (scenario->store_temp ? 4 : 3) > SIM_FIFO_CAPACITY ||
+            scenario->mode_change_every > 0;
+        bool passed = result.errors == 0 && result.state_errors == 0 && result.underrun_bytes == 0 &&
+            (!expect_drops || result.lost > 0) &&
+            (scenario->skip_entries == 0 || expect_drops || result.resyncs > 0);
+        ok = ok && passed;
+
+        printf("    { \"name\": \"%s\", \"produced\": %u, \"read\": %u, \"lost\": %u, \"resyncs\": %u, "
+            "\"carry_overs\": %u, \"errors\": %u, \"state_errors\": %u, \"underrun_bytes\": %u, \"passed\": %s }%s\n",
+            scenario->name, (unsigned)result.produced, (unsigned)result.samples, (unsigned)result.lost,
+            (unsigned)result.resyncs, (unsigned)result.carry_overs, (unsigned)result.errors,
+            (unsigned)result.state_errors, (unsigned)result.underrun_bytes, passed ? "true" : "false",
+            ix + 1 < scenario_count ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"passed\": %s\n", ok ? "true" : "false");
+    printf("}\n");
+
+    return ok ? 0 : 2;
+}
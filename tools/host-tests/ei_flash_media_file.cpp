@@ -0,0 +1,228 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "ei_flash_media_file.h"
+
+/* Private defines --------------------------------------------------------- */
+/** Bytes handled per read / write call */
+#define FILE_CHUNK_SIZE     256
+
+EiFlashMediaFile::EiFlashMediaFile(const char *path, uint32_t block_size, uint32_t block_count, uint32_t erase_time)
+    : EiFlashMedia(block_size, block_count, EI_FLASH_MEDIA_FILE_SPARE_SIZE, erase_time)
+    , erase_count(0)
+    , program_count(0)
+    , simulate_erase_time(false)
+    , failing_blocks(nullptr)
+{
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+
+    if (fd < 0) {
+        ei_printf("ERR: Failed to open flash file %s\n", path);
+    }
+}
+
+EiFlashMediaFile::~EiFlashMediaFile()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    ei_free(failing_blocks);
+}
+
+bool EiFlashMediaFile::read_at(uint32_t position, uint8_t *data, uint32_t num_bytes)
+{
+    if (fd < 0 || lseek(fd, position, SEEK_SET) != (off_t)position) {
+        return false;
+    }
+
+    while (num_bytes > 0) {
+        ssize_t n = ::read(fd, data, num_bytes);
+        if (n < 0) {
+            return false;
+        }
+        // past the end of the file, never written
+        if (n == 0) {
+            memset(data, 0xFF, num_bytes);
+            break;
+        }
+        // stored inverted
+        for (ssize_t i = 0; i < n; i++) {
+            data[i] = ~data[i];
+        }
+        data += n;
+        num_bytes -= n;
+    }
+
+    return true;
+}
+
+bool EiFlashMediaFile::program_at(uint32_t block, uint32_t position, const uint8_t *data, uint32_t num_bytes)
+{
+    uint8_t chunk[FILE_CHUNK_SIZE];
+
+    program_count++;
+
+    if (is_failing(block)) {
+        return false;
+    }
+
+    while (num_bytes > 0) {
+        uint32_t n = num_bytes < FILE_CHUNK_SIZE ? num_bytes : FILE_CHUNK_SIZE;
+
+        // programming only clears bits
+        if (!read_at(position, chunk, n)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            chunk[i] = ~(chunk[i] & data[i]);
+        }
+
+        if (lseek(fd, position, SEEK_SET) != (off_t)position || write(fd, chunk, n) != (ssize_t)n) {
+            return false;
+        }
+
+        position += n;
+        data += n;
+        num_bytes -= n;
+    }
+
+    return true;
+}
+
+bool EiFlashMediaFile::is_failing(uint32_t block)
+{
+    return failing_blocks && (failing_blocks[block >> 3] & (1 << (block & 7)));
+}
+
+bool EiFlashMediaFile::read(uint32_t block, uint32_t offset, uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || offset + num_bytes > block_size) {
+        return false;
+    }
+
+    return read_at(block * (block_size + spare_size) + offset, data, num_bytes);
+}
+
+bool EiFlashMediaFile::program(uint32_t block, uint32_t offset, const uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || offset + num_bytes > block_size) {
+        return false;
+    }
+
+    return program_at(block, block * (block_size + spare_size) + offset, data, num_bytes);
+}
+
+bool EiFlashMediaFile::erase_block(uint32_t block)
+{
+    uint8_t chunk[FILE_CHUNK_SIZE];
+    uint32_t position = block * (block_size + spare_size);
+    uint32_t remaining = block_size + spare_size;
+
+    if (block >= block_count || fd < 0) {
+        return false;
+    }
+
+    erase_count++;
+
+    if (simulate_erase_time) {
+        ei_sleep(erase_time);
+    }
+
+    if (is_failing(block)) {
+        return false;
+    }
+
+    // 0xFF, stored inverted
+    memset(chunk, 0x00, FILE_CHUNK_SIZE);
+
+    if (lseek(fd, position, SEEK_SET) != (off_t)position) {
+        return false;
+    }
+
+    while (remaining > 0) {
+        uint32_t n = remaining < FILE_CHUNK_SIZE ? remaining : FILE_CHUNK_SIZE;
+        if (write(fd, chunk, n) != (ssize_t)n) {
+            return false;
+        }
+        remaining -= n;
+    }
+
+    return true;
+}
+
+bool EiFlashMediaFile::read_spare(uint32_t block, uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || num_bytes > spare_size) {
+        return false;
+    }
+
+    return read_at(block * (block_size + spare_size) + block_size, data, num_bytes);
+}
+
+bool EiFlashMediaFile::program_spare(uint32_t block, const uint8_t *data, uint32_t num_bytes)
+{
+    if (block >= block_count || num_bytes > spare_size) {
+        return false;
+    }
+
+    return program_at(block, block * (block_size + spare_size) + block_size, data, num_bytes);
+}
+
+bool EiFlashMediaFile::sync(void)
+{
+    return fd >= 0 && fsync(fd) == 0;
+}
+
+void EiFlashMediaFile::set_simulate_erase_time(bool enable)
+{
+    simulate_erase_time = enable;
+}
+
+void EiFlashMediaFile::inject_bad_block(uint32_t block)
+{
+    if (failing_blocks == nullptr) {
+        failing_blocks = (uint8_t *)ei_calloc((block_count + 7) / 8, 1);
+    }
+
+    if (failing_blocks && block < block_count) {
+        failing_blocks[block >> 3] |= 1 << (block & 7);
+    }
+}
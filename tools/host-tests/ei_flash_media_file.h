@@ -0,0 +1,87 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_FLASH_MEDIA_FILE_H
+#define EI_FLASH_MEDIA_FILE_H
+
+/* Includes ---------------------------------------------------------------- */
+#include "device/ei_flash_media.h"
+
+#define EI_FLASH_MEDIA_FILE_SPARE_SIZE  16
+
+/**
+ * @brief Flash simulator for the host: EiFlashMedia stored in a single file through the POSIX
+ * file API. Programming ANDs into the existing content like NOR flash does, erases can take
+ * erase_time and blocks can be made to fail.
+ * Blocks are stored back to back, each one followed by its spare area. Bytes are stored
+ * inverted, so parts of the file that were never written (e.g. a freshly created file)
+ * read as 0xFF, i.e. as erased flash.
+ */
+class EiFlashMediaFile : public EiFlashMedia {
+public:
+    EiFlashMediaFile(const char *path, uint32_t block_size, uint32_t block_count, uint32_t erase_time);
+    ~EiFlashMediaFile();
+
+    bool read(uint32_t block, uint32_t offset, uint8_t *data, uint32_t num_bytes) override;
+    bool program(uint32_t block, uint32_t offset, const uint8_t *data, uint32_t num_bytes) override;
+    bool erase_block(uint32_t block) override;
+    bool read_spare(uint32_t block, uint8_t *data, uint32_t num_bytes) override;
+    bool program_spare(uint32_t block, const uint8_t *data, uint32_t num_bytes) override;
+    bool sync(void) override;
+
+    /**
+     * @brief Simulator: block in erase_block() for erase_time ms
+     */
+    void set_simulate_erase_time(bool enable);
+
+    /**
+     * @brief Simulator: all following erases and programs of the block fail
+     */
+    void inject_bad_block(uint32_t block);
+
+    /** number of erase_block() and program() calls (including spare) */
+    uint32_t erase_count;
+    uint32_t program_count;
+
+private:
+    bool read_at(uint32_t position, uint8_t *data, uint32_t num_bytes);
+    bool program_at(uint32_t block, uint32_t position, const uint8_t *data, uint32_t num_bytes);
+    bool is_failing(uint32_t block);
+
+    int fd;
+    bool simulate_erase_time;
+    uint8_t *failing_blocks;
+};
+
+#endif /* EI_FLASH_MEDIA_FILE_H */
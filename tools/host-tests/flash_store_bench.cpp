@@ -0,0 +1,233 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Exercises the log-structured sample store (src/device/ei_flash_memory.cpp) on the
+ * file-backed flash simulator and prints a JSON report */
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/ei_device_memory_writer.h"
+#include "device/ei_flash_memory.h"
+#include "ei_flash_media_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+typedef struct {
+    const char *file;
+    uint32_t blocks;
+    uint32_t block_size;
+    uint32_t erase_time;
+    uint32_t sessions;
+    uint32_t record_blocks;
+    uint32_t bad_blocks;
+    uint32_t seed;
+    bool idle_erase;
+} bench_args_t;
+
+static void print_usage(const char *name)
+{
+    fprintf(stderr,
+        "Usage: %s [--file PATH] [--blocks N] [--block-size N] [--erase-time MS] [--sessions N]\n"
+        "          [--record-blocks N] [--bad-blocks N] [--seed N] [--no-idle-erase]\n", name);
+}
+
+static bool parse_args(int argc, char **argv, bench_args_t *args)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--no-idle-erase") == 0) {
+            args->idle_erase = false;
+            continue;
+        }
+        if (value == NULL) {
+            return false;
+        }
+        i++;
+
+        if (strcmp(arg, "--file") == 0) args->file = value;
+        else if (strcmp(arg, "--blocks") == 0) args->blocks = atoi(value);
+        else if (strcmp(arg, "--block-size") == 0) args->block_size = atoi(value);
+        else if (strcmp(arg, "--erase-time") == 0) args->erase_time = atoi(value);
+        else if (strcmp(arg, "--sessions") == 0) args->sessions = atoi(value);
+        else if (strcmp(arg, "--record-blocks") == 0) args->record_blocks = atoi(value);
+        else if (strcmp(arg, "--bad-blocks") == 0) args->bad_blocks = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) args->seed = atoi(value);
+        else return false;
+    }
+
+    return args->blocks > EI_FLASH_SPARE_BLOCKS && args->block_size > 0 && args->record_blocks > 0;
+}
+
+static uint8_t pattern_byte(uint32_t session, uint32_t ix)
+{
+    uint32_t x = (session + 1) * 2654435761u ^ ix * 40503u;
+    return (uint8_t)(x >> 13);
+}
+
+int main(int argc, char **argv)
+{
+    bench_args_t args = { "build/flash.bin", 256, 4096, 5, 8, 64, 0, 1, true };
+
+    if (!parse_args(argc, argv, &args)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // start from a new flash file, it reads as erased
+    remove(args.file);
+
+    EiFlashMediaFile media(args.file, args.block_size, args.blocks, args.erase_time);
+    media.set_simulate_erase_time(true);
+
+    srand(args.seed);
+    for (uint32_t i = 0; i < args.bad_blocks; i++) {
+        media.inject_bad_block(rand() % args.blocks);
+    }
+
+    EiFlashMemory *mem = new EiFlashMemory(&media, 1024);
+
+    uint8_t config[1024];
+    memset(config, 0xA5, sizeof(config));
+    bool ok = mem->save_config(config, sizeof(config));
+
+    uint32_t record_bytes = args.record_blocks * args.block_size - 100;
+    if (record_bytes > mem->get_available_sample_bytes()) {
+        fprintf(stderr, "Recording doesn't fit, %u bytes available\n", mem->get_available_sample_bytes());
+        return 1;
+    }
+
+    std::vector<uint8_t> writer_buf(2 * args.block_size);
+    std::vector<uint8_t> data(args.block_size);
+
+    printf("{\n  \"sessions\": [\n");
+
+    for (uint32_t session = 0; session < args.sessions; session++) {
+        uint32_t erases_before = media.erase_count;
+
+        uint64_t t0 = ei_read_timer_us();
+        ok &= mem->erase_sample_data(0, record_bytes) == record_bytes;
+        uint64_t t1 = ei_read_timer_us();
+
+        EiDeviceMemoryWriter writer;
+        writer.begin(mem, writer_buf.data());
+        for (uint32_t ix = 0; ix < record_bytes; ix += data.size()) {
+            uint32_t n = record_bytes - ix < data.size() ? record_bytes - ix : data.size();
+            for (uint32_t j = 0; j < n; j++) {
+                data[j] = pattern_byte(session, ix + j);
+            }
+            ok &= writer.append(data.data(), n) == n;
+        }
+        ok &= writer.flush_data();
+        uint64_t t2 = ei_read_timer_us();
+        uint32_t foreground_erases = media.erase_count - erases_before;
+
+        uint32_t background_erases = 0;
+        uint64_t t3 = ei_read_timer_us();
+        if (args.idle_erase) {
+            background_erases = mem->erase_ahead(args.blocks);
+        }
+        uint64_t t4 = ei_read_timer_us();
+
+        // remount every other session, the recording and config have to survive
+        bool remounted = session & 1;
+        if (remounted) {
+            delete mem;
+            mem = new EiFlashMemory(&media, 1024);
+        }
+
+        bool verified = true;
+        for (uint32_t ix = 0; ix < record_bytes && verified; ix += data.size()) {
+            uint32_t n = record_bytes - ix < data.size() ? record_bytes - ix : data.size();
+            verified &= mem->read_sample_data(data.data(), ix, n) == n;
+            for (uint32_t j = 0; j < n && verified; j++) {
+                verified &= data[j] == pattern_byte(session, ix + j);
+            }
+        }
+        uint8_t loaded[1024];
+        verified &= mem->load_config(loaded, sizeof(loaded)) && memcmp(loaded, config, sizeof(config)) == 0;
+        ok &= verified;
+
+        uint32_t min_erase, max_erase;
+        mem->get_erase_count_range(&min_erase, &max_erase);
+
+        printf("    { \"session\": %u, \"start_us\": %llu, \"write_us\": %llu, \"foreground_erases\": %u, "
+            "\"idle_erase_us\": %llu, \"idle_erases\": %u, \"remounted\": %s, \"verified\": %s, "
+            "\"erase_count_min\": %u, \"erase_count_max\": %u, \"bad_blocks\": %u }%s\n",
+            session, (unsigned long long)(t1 - t0), (unsigned long long)(t2 - t1), foreground_erases,
+            (unsigned long long)(t4 - t3), background_erases, remounted ? "true" : "false",
+            verified ? "true" : "false", min_erase, max_erase, mem->get_bad_blocks(),
+            session + 1 < args.sessions ? "," : "");
+    }
+
+    // a recording that is never flushed (power lost while sampling) must not show up after a remount
+    ok &= mem->erase_sample_data(0, record_bytes) == record_bytes;
+    {
+        EiDeviceMemoryWriter writer;
+        writer.begin(mem, writer_buf.data());
+        memset(data.data(), 0x00, data.size());
+        for (uint32_t ix = 0; ix < record_bytes; ix += data.size()) {
+            uint32_t n = record_bytes - ix < data.size() ? record_bytes - ix : data.size();
+            ok &= writer.append(data.data(), n) == n;
+        }
+    }
+    delete mem;
+    mem = new EiFlashMemory(&media, 1024);
+
+    bool ignored = true;
+    for (uint32_t ix = 0; ix < record_bytes && ignored; ix += data.size()) {
+        uint32_t n = record_bytes - ix < data.size() ? record_bytes - ix : data.size();
+        ignored &= mem->read_sample_data(data.data(), ix, n) == n;
+        for (uint32_t j = 0; j < n && ignored; j++) {
+            ignored &= data[j] == 0xFF;
+        }
+    }
+    uint8_t loaded[1024];
+    bool config_ok = mem->load_config(loaded, sizeof(loaded)) && memcmp(loaded, config, sizeof(config)) == 0;
+    ok &= ignored && config_ok;
+
+    printf("  ],\n  \"interrupted\": { \"ignored\": %s, \"config\": %s },\n",
+        ignored ? "true" : "false", config_ok ? "true" : "false");
+    printf("  \"media\": { \"blocks\": %u, \"block_size\": %u, \"erase_time_ms\": %u, "
+        "\"erases\": %u, \"programs\": %u },\n  \"ok\": %s\n}\n",
+        args.blocks, args.block_size, args.erase_time, media.erase_count, media.program_count,
+        ok ? "true" : "false");
+
+    delete mem;
+
+    return ok ? 0 : 2;
+}
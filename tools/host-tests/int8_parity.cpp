@@ -0,0 +1,368 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Bit-exact check of the portable SIMD int8 kernels (optimized_integer_ops, enabled with
+ * EI_CLASSIFIER_TFLITE_ENABLE_PORTABLE_SIMD) against reference_integer_ops. Random shapes,
+ * offsets, strides, padding, dilation and quantization parameters go through FULLY_CONNECTED,
+ * CONV_2D and DEPTHWISE_CONV_2D, including the cases that fall back to the reference kernels.
+ * The SIMD path is picked at compile time, the Makefile builds one binary per path.
+ * Prints a JSON report; see README.md */
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/depthwise_conv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(__AVX2__)
+#define SIMD_PATH   "avx2"
+#elif defined(__SSE2__)
+#define SIMD_PATH   "sse2"
+#elif defined(__GNUC__)
+#define SIMD_PATH   "vector"
+#else
+#define SIMD_PATH   "scalar"
+#endif
+
+using namespace tflite;
+
+typedef struct {
+    const char *name;
+    uint32_t cases;
+    uint32_t mismatches;
+    int32_t first_mismatch;     // case index, -1 if none
+} op_result_t;
+
+static uint32_t rng_state = 1;
+
+/**
+ * @brief Uniform random integer in [lo, hi]
+ */
+static int rng_range(int lo, int hi)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return lo + (int)(rng_state % (uint32_t)(hi - lo + 1));
+}
+
+static void fill_int8(std::vector<int8_t> &v, size_t n)
+{
+    v.resize(n);
+    for (size_t ix = 0; ix < n; ix++) {
+        v[ix] = (int8_t)rng_range(-128, 127);
+    }
+}
+
+static void fill_bias(std::vector<int32_t> &v, size_t n)
+{
+    v.resize(n);
+    for (size_t ix = 0; ix < n; ix++) {
+        v[ix] = rng_range(-20000, 20000);
+    }
+}
+
+/**
+ * @brief Random requantization parameters (multiplier in [0.5, 1) as Q31, right shift up to 12)
+ */
+static void random_quantization(int32_t *multiplier, int32_t *shift)
+{
+    *multiplier = rng_range(1 << 30, 0x7fffffff);
+    *shift = rng_range(-12, 0);
+}
+
+/**
+ * @brief Offsets are often 0 or at the ends of their range in real models
+ */
+static int32_t random_offset(int lo, int hi)
+{
+    switch (rng_range(0, 3)) {
+        case 0: return 0;
+        case 1: return rng_range(0, 1) ? lo : hi;
+        default: return rng_range(lo, hi);
+    }
+}
+
+static RuntimeShape make_shape(int d0, int d1)
+{
+    const int32_t dims[] = { d0, d1 };
+    return RuntimeShape(2, dims);
+}
+
+static RuntimeShape make_shape(int d0, int d1, int d2, int d3)
+{
+    const int32_t dims[] = { d0, d1, d2, d3 };
+    return RuntimeShape(4, dims);
+}
+
+static int output_size(int input, int filter, int stride, int dilation, int padding)
+{
+    int size = (input + 2 * padding - dilation * (filter - 1) - 1) / stride + 1;
+    return (size < 1) ? 1 : size;
+}
+
+static void record(op_result_t *res, bool match)
+{
+    if (!match) {
+        if (res->mismatches == 0) {
+            res->first_mismatch = (int32_t)res->cases;
+        }
+        res->mismatches++;
+    }
+    res->cases++;
+}
+
+static void check_fully_connected(op_result_t *res, uint32_t cases)
+{
+    std::vector<int8_t> input, weights, out_ref, out_simd;
+    std::vector<int32_t> bias;
+
+    for (uint32_t c = 0; c < cases; c++) {
+        const int batches = rng_range(1, 4);
+        const int depth = rng_range(1, 300);     // covers the vector tails
+        const int out_depth = rng_range(1, 37);  // and output channels that aren't a multiple of 4
+
+        FullyConnectedParams params = {};
+        params.input_offset = random_offset(-127, 128);
+        params.weights_offset = (rng_range(0, 3) == 0) ? random_offset(-127, 128) : 0;
+        params.output_offset = rng_range(-128, 127);
+        random_quantization(&params.output_multiplier, &params.output_shift);
+        params.quantized_activation_min = rng_range(0, 1) ? -128 : rng_range(-128, 0);
+        params.quantized_activation_max = rng_range(0, 1) ? 127 : rng_range(0, 127);
+
+        fill_int8(input, batches * depth);
+        fill_int8(weights, out_depth * depth);
+        fill_bias(bias, out_depth);
+        const int32_t *bias_data = (rng_range(0, 4) == 0) ? nullptr : bias.data();
+
+        const RuntimeShape input_shape = make_shape(batches, depth);
+        const RuntimeShape filter_shape = make_shape(out_depth, depth);
+        const int32_t bias_dims[] = { out_depth };
+        const RuntimeShape bias_shape(1, bias_dims);
+        const RuntimeShape output_shape = make_shape(batches, out_depth);
+
+        out_ref.assign(batches * out_depth, 0);
+        out_simd.assign(batches * out_depth, 0);
+        reference_integer_ops::FullyConnected(params, input_shape, input.data(), filter_shape, weights.data(),
+            bias_shape, bias_data, output_shape, out_ref.data());
+        optimized_integer_ops::FullyConnected(params, input_shape, input.data(), filter_shape, weights.data(),
+            bias_shape, bias_data, output_shape, out_simd.data());
+        record(res, out_ref == out_simd);
+    }
+}
+
+static void check_conv(op_result_t *res, uint32_t cases)
+{
+    std::vector<int8_t> input, weights, out_ref, out_simd;
+    std::vector<int32_t> bias, multipliers, shifts;
+
+    for (uint32_t c = 0; c < cases; c++) {
+        const int batches = rng_range(1, 2);
+        const int in_h = rng_range(1, 12);
+        const int in_w = rng_range(1, 12);
+        const int filter_h = rng_range(1, 5);
+        const int filter_w = rng_range(1, 5);
+        // grouped convs fall back to the reference kernel
+        const int groups = (rng_range(0, 9) == 0) ? 2 : 1;
+        const int in_depth = groups * rng_range(1, 40);
+        const int out_depth = groups * rng_range(1, 19);
+        const int filter_depth = in_depth / groups;
+
+        ConvParams params = {};
+        params.input_offset = random_offset(-127, 128);
+        params.output_offset = rng_range(-128, 127);
+        params.stride_width = rng_range(1, 3);
+        params.stride_height = rng_range(1, 3);
+        // width dilation falls back to the reference kernel
+        params.dilation_width_factor = (rng_range(0, 6) == 0) ? 2 : 1;
+        params.dilation_height_factor = rng_range(1, 2);
+        params.padding_values.width = rng_range(0, 2);
+        params.padding_values.height = rng_range(0, 2);
+        params.quantized_activation_min = -128;
+        params.quantized_activation_max = rng_range(0, 1) ? 127 : rng_range(0, 127);
+
+        const int out_h = output_size(in_h, filter_h, params.stride_height, params.dilation_height_factor,
+            params.padding_values.height);
+        const int out_w = output_size(in_w, filter_w, params.stride_width, params.dilation_width_factor,
+            params.padding_values.width);
+
+        multipliers.resize(out_depth);
+        shifts.resize(out_depth);
+        for (int ix = 0; ix < out_depth; ix++) {
+            random_quantization(&multipliers[ix], &shifts[ix]);
+        }
+        fill_int8(input, batches * in_h * in_w * in_depth);
+        fill_int8(weights, out_depth * filter_h * filter_w * filter_depth);
+        fill_bias(bias, out_depth);
+
+        const RuntimeShape input_shape = make_shape(batches, in_h, in_w, in_depth);
+        const RuntimeShape filter_shape = make_shape(out_depth, filter_h, filter_w, filter_depth);
+        const int32_t bias_dims[] = { out_depth };
+        const RuntimeShape bias_shape(1, bias_dims);
+        const RuntimeShape output_shape = make_shape(batches, out_h, out_w, out_depth);
+
+        out_ref.assign(batches * out_h * out_w * out_depth, 0);
+        out_simd.assign(batches * out_h * out_w * out_depth, 0);
+        reference_integer_ops::ConvPerChannel(params, multipliers.data(), shifts.data(), input_shape, input.data(),
+            filter_shape, weights.data(), bias_shape, bias.data(), output_shape, out_ref.data());
+        optimized_integer_ops::ConvPerChannel(params, multipliers.data(), shifts.data(), input_shape, input.data(),
+            filter_shape, weights.data(), bias_shape, bias.data(), output_shape, out_simd.data());
+        record(res, out_ref == out_simd);
+    }
+}
+
+static void check_depthwise(op_result_t *res, uint32_t cases)
+{
+    std::vector<int8_t> input, weights, out_ref, out_simd;
+    std::vector<int32_t> bias, multipliers, shifts;
+
+    for (uint32_t c = 0; c < cases; c++) {
+        const int batches = rng_range(1, 2);
+        const int in_h = rng_range(1, 12);
+        const int in_w = rng_range(1, 12);
+        const int filter_h = rng_range(1, 5);
+        const int filter_w = rng_range(1, 5);
+        // wide inputs run several full channel blocks, multipliers other than 1 fall back
+        const int in_depth = (rng_range(0, 7) == 0) ? rng_range(64, 130) : rng_range(1, 40);
+        const int depth_multiplier = (rng_range(0, 7) == 0) ? 2 : 1;
+        const int out_depth = in_depth * depth_multiplier;
+
+        DepthwiseParams params = {};
+        params.input_offset = random_offset(-127, 128);
+        params.output_offset = rng_range(-128, 127);
+        params.stride_width = rng_range(1, 3);
+        params.stride_height = rng_range(1, 3);
+        params.dilation_width_factor = rng_range(1, 2);
+        params.dilation_height_factor = rng_range(1, 2);
+        params.padding_values.width = rng_range(0, 2);
+        params.padding_values.height = rng_range(0, 2);
+        params.depth_multiplier = depth_multiplier;
+        params.quantized_activation_min = rng_range(0, 1) ? -128 : rng_range(-128, 0);
+        params.quantized_activation_max = rng_range(0, 1) ? 127 : rng_range(0, 127);
+
+        const int out_h = output_size(in_h, filter_h, params.stride_height, params.dilation_height_factor,
+            params.padding_values.height);
+        const int out_w = output_size(in_w, filter_w, params.stride_width, params.dilation_width_factor,
+            params.padding_values.width);
+
+        multipliers.resize(out_depth);
+        shifts.resize(out_depth);
+        for (int ix = 0; ix < out_depth; ix++) {
+            random_quantization(&multipliers[ix], &shifts[ix]);
+        }
+        fill_int8(input, batches * in_h * in_w * in_depth);
+        fill_int8(weights, filter_h * filter_w * out_depth);
+        fill_bias(bias, out_depth);
+
+        const RuntimeShape input_shape = make_shape(batches, in_h, in_w, in_depth);
+        const RuntimeShape filter_shape = make_shape(1, filter_h, filter_w, out_depth);
+        const int32_t bias_dims[] = { out_depth };
+        const RuntimeShape bias_shape(1, bias_dims);
+        const RuntimeShape output_shape = make_shape(batches, out_h, out_w, out_depth);
+
+        out_ref.assign(batches * out_h * out_w * out_depth, 0);
+        out_simd.assign(batches * out_h * out_w * out_depth, 0);
+        reference_integer_ops::DepthwiseConvPerChannel(params, multipliers.data(), shifts.data(), input_shape,
+            input.data(), filter_shape, weights.data(), bias_shape, bias.data(), output_shape, out_ref.data());
+        optimized_integer_ops::DepthwiseConvPerChannel(params, multipliers.data(), shifts.data(), input_shape,
+            input.data(), filter_shape, weights.data(), bias_shape, bias.data(), output_shape, out_simd.data());
+        record(res, out_ref == out_simd);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = 1;
+    uint32_t cases = 2000;
+
+    for (int ix = 1; ix < argc; ix++) {
+        if (strcmp(argv[ix], "--seed") == 0 && ix + 1 < argc) {
+            seed = (uint32_t)atoi(argv[++ix]);
+        }
+        else if (strcmp(argv[ix], "--cases") == 0 && ix + 1 < argc) {
+            cases = (uint32_t)atoi(argv[++ix]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--seed N] [--cases N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (seed == 0) {
+        seed = 1;
+    }
+    rng_state = seed;
+
+#if defined(__AVX2__)
+    // built for AVX2, but running on a CPU without it
+    if (!__builtin_cpu_supports("avx2")) {
+        printf("{\n  \"path\": \"%s\",\n  \"skipped\": true\n}\n", SIMD_PATH);
+        return 0;
+    }
+#endif
+
+    op_result_t results[] = {
+        { "fully_connected", 0, 0, -1 },
+        { "conv_2d", 0, 0, -1 },
+        { "depthwise_conv_2d", 0, 0, -1 },
+    };
+    check_fully_connected(&results[0], cases);
+    check_conv(&results[1], cases);
+    check_depthwise(&results[2], cases);
+
+    const size_t result_count = sizeof(results) / sizeof(results[0]);
+    bool ok = true;
+
+    printf("{\n");
+    printf("  \"path\": \"%s\",\n", SIMD_PATH);
+    printf("  \"seed\": %u,\n", (unsigned)seed);
+    printf("  \"results\": [\n");
+    for (size_t ix = 0; ix < result_count; ix++) {
+        const op_result_t *res = &results[ix];
+        printf("    { \"op\": \"%s\", \"cases\": %u, \"mismatches\": %u, \"first_mismatch\": %d }%s\n",
+            res->name, (unsigned)res->cases, (unsigned)res->mismatches, (int)res->first_mismatch,
+            (ix + 1 < result_count) ? "," : "");
+        if (res->mismatches > 0) {
+            ok = false;
+        }
+    }
+    printf("  ],\n");
+    printf("  \"passed\": %s\n", ok ? "true" : "false");
+    printf("}\n");
+
+    return ok ? 0 : 2;
+}
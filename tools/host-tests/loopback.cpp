@@ -0,0 +1,298 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Runs the binary transfer of the AT server (src/firmware-sdk/at-server/ei_at_binary_transfer.cpp)
+ * over a pseudo-terminal: a forked "device" receives features as AT+RUNIMPULSESTATIC would and
+ * sends them back as AT+READBUFFER would, the parent plays the host. Prints a JSON report */
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "firmware-sdk/ei_device_interface.h"
+#include "firmware-sdk/at-server/ei_at_binary_transfer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+typedef struct {
+    uint32_t features;
+    uint32_t runs;
+    double corrupt;
+    uint32_t seed;
+} loopback_args_t;
+
+/* serial port of this process, either end of the pty */
+static int serial_fd = -1;
+static double corrupt_probability = 0;
+static uint32_t rng_state = 1;
+static size_t wire_bytes = 0;
+static size_t corrupted_bytes = 0;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+ * @brief Porting hooks of the binary transfer, a bit in a byte is flipped with
+ * the configured probability to exercise CRC, NAK and retransmission
+ */
+void ei_write_string(char *data, int length)
+{
+    std::vector<char> out(data, data + length);
+
+    for (int i = 0; i < length; i++) {
+        if (corrupt_probability > 0 && rng_next() < corrupt_probability * 4294967295.0) {
+            out[i] ^= (char)(1 << (rng_next() & 7));
+            corrupted_bytes++;
+        }
+    }
+
+    int written = 0;
+    while (written < length) {
+        ssize_t r = write(serial_fd, out.data() + written, length - written);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        written += (int)r;
+    }
+    wire_bytes += length;
+}
+
+int ei_read_string(char *data, int max_length)
+{
+    struct pollfd pfd = { serial_fd, POLLIN, 0 };
+
+    if (max_length <= 0 || poll(&pfd, 1, 1) <= 0) {
+        return 0;
+    }
+
+    ssize_t r = read(serial_fd, data, max_length);
+    return r > 0 ? (int)r : 0;
+}
+
+static void print_usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [--features N] [--runs N] [--corrupt P] [--seed N]\n", name);
+}
+
+static bool parse_args(int argc, char **argv, loopback_args_t *args)
+{
+    args->features = 3000;
+    args->runs = 5;
+    args->corrupt = 0;
+    args->seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        if (strcmp(argv[i], "--features") == 0) {
+            args->features = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--runs") == 0) {
+            args->runs = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--corrupt") == 0) {
+            args->corrupt = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            args->seed = (uint32_t)atoi(argv[++i]);
+        }
+        else {
+            return false;
+        }
+    }
+
+    return args->features > 0;
+}
+
+static const uint8_t *send_source;
+
+static bool read_source(size_t offset, uint8_t *buffer, size_t length)
+{
+    memcpy(buffer, send_source + offset, length);
+    return true;
+}
+
+/**
+ * @brief The device: for every run and format receive the features, then send them back as floats
+ */
+static int run_device(const loopback_args_t *args)
+{
+    std::vector<float> features(args->features);
+
+    for (uint32_t run = 0; run < args->runs; run++) {
+        for (int format = EI_AT_TRANSFER_FORMAT_F32; format <= EI_AT_TRANSFER_FORMAT_I16; format++) {
+            ei_at_binary_transfer_set_mode(true, (ei_at_transfer_format_t)format);
+            if (!ei_at_binary_receive_features(features.data(), features.size())) {
+                ei_printf("ERR: device receive failed (run %u)\n", (unsigned)run);
+                return 1;
+            }
+            send_source = (const uint8_t *)features.data();
+            if (!ei_at_binary_send(features.size() * sizeof(float), read_source)) {
+                ei_printf("ERR: device send failed (run %u)\n", (unsigned)run);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* AT+RUNIMPULSESTATIC text mode: base64 in 32 character chunks, each answered with "OK <n> \r\n" */
+static size_t text_upload_bytes(size_t n_features)
+{
+    size_t chars = (n_features * sizeof(float) + 2) / 3 * 4;
+    size_t chunks = (chars + 31) / 32;
+    char line[32];
+
+    return chars + chunks * snprintf(line, sizeof(line), "OK %d \r\n", (int)n_features);
+}
+
+int main(int argc, char **argv)
+{
+    loopback_args_t args;
+
+    if (!parse_args(argc, argv, &args)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        perror("open slave");
+        return 1;
+    }
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    corrupt_probability = args.corrupt;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0) {
+        close(master);
+        serial_fd = slave;
+        rng_state = args.seed * 2654435761u + 1;
+        _exit(run_device(&args));
+    }
+    close(slave);
+    serial_fd = master;
+    rng_state = args.seed * 40503u + 7;
+
+    std::vector<float> expected(args.features);
+    std::vector<float> echo(args.features);
+    std::vector<uint8_t> upload(args.features * sizeof(float));
+    uint32_t seed = args.seed;
+    bool ok = true;
+
+    printf("{\n  \"features\": %u,\n  \"corrupt\": %g,\n  \"results\": [\n", (unsigned)args.features, args.corrupt);
+
+    for (uint32_t run = 0; run < args.runs && ok; run++) {
+        for (int format = EI_AT_TRANSFER_FORMAT_F32; format <= EI_AT_TRANSFER_FORMAT_I16 && ok; format++) {
+            size_t upload_len;
+
+            for (uint32_t i = 0; i < args.features; i++) {
+                seed = seed * 1103515245u + 12345u;
+                int16_t v = (int16_t)(seed >> 16);
+                if (format == EI_AT_TRANSFER_FORMAT_F32) {
+                    expected[i] = (float)v / 256.0f;
+                    memcpy(upload.data() + i * sizeof(float), &expected[i], sizeof(float));
+                }
+                else {
+                    expected[i] = (float)v;
+                    memcpy(upload.data() + i * sizeof(int16_t), &v, sizeof(int16_t));
+                }
+            }
+            upload_len = args.features * (format == EI_AT_TRANSFER_FORMAT_F32 ? sizeof(float) : sizeof(int16_t));
+
+            size_t wire_start = wire_bytes;
+            uint64_t t0 = ei_read_timer_us();
+            send_source = upload.data();
+            bool sent = ei_at_binary_send(upload_len, read_source);
+            uint64_t t1 = ei_read_timer_us();
+            size_t upload_wire = wire_bytes - wire_start;
+            bool received = sent && ei_at_binary_receive((uint8_t *)echo.data(), echo.size() * sizeof(float));
+            uint64_t t2 = ei_read_timer_us();
+            bool match = received && memcmp(echo.data(), expected.data(), echo.size() * sizeof(float)) == 0;
+            ok = match;
+
+            printf("    { \"run\": %u, \"format\": \"%s\", \"ok\": %s, \"upload_bytes\": %u, \"upload_wire_bytes\": %u, "
+                "\"text_upload_bytes\": %u, \"upload_us\": %llu, \"echo_us\": %llu }%s\n",
+                (unsigned)run,
+                format == EI_AT_TRANSFER_FORMAT_F32 ? "F32" : "I16",
+                match ? "true" : "false",
+                (unsigned)upload_len,
+                (unsigned)upload_wire,
+                (unsigned)text_upload_bytes(args.features),
+                (unsigned long long)(t1 - t0),
+                (unsigned long long)(t2 - t1),
+                (run + 1 == args.runs && format == EI_AT_TRANSFER_FORMAT_I16) || !ok ? "" : ",");
+        }
+    }
+
+    int status = 0;
+    if (!ok) {
+        kill(pid, SIGTERM);
+    }
+    waitpid(pid, &status, 0);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    printf("  ],\n  \"host_corrupted_bytes\": %u,\n  \"ok\": %s\n}\n", (unsigned)corrupted_bytes, ok ? "true" : "false");
+
+    return ok ? 0 : 2;
+}
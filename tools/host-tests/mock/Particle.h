@@ -0,0 +1,84 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Just enough of the Particle Device OS API for lib/ADXL362DMA to build on Linux. The SPI bus
+ * is connected to the simulated ADXL362 in adxl362_fifo_test.cpp */
+
+#ifndef _MOCK_PARTICLE_H_
+#define _MOCK_PARTICLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MHZ         1000000
+#define MSBFIRST    1
+#define SPI_MODE0   0
+#define LOW         0
+#define HIGH        1
+#define A2          12
+
+class SPISettings {
+public:
+    SPISettings() { }
+    SPISettings(unsigned clock, int bit_order, int data_mode) { }
+};
+
+class SPIClass {
+public:
+    void begin(int cs) { }
+    void beginTransaction(SPISettings settings) { }
+    void endTransaction() { }
+
+    /* Full duplex transfer of one byte */
+    uint8_t transfer(uint8_t data);
+
+    /* tx == NULL clocks out zeros. With a callback the transfer is a DMA transfer that
+     * completes later (see mock_spi_complete_dma()), otherwise it's synchronous */
+    void transfer(const void *tx, void *rx, size_t len, void (*callback)(void));
+};
+
+extern SPIClass SPI;
+
+void digitalWrite(int pin, int value);
+void delay(unsigned long ms);
+
+class MockLogger {
+public:
+    void info(const char *fmt, ...) { }
+};
+
+extern MockLogger Log;
+
+#endif // _MOCK_PARTICLE_H_
@@ -0,0 +1,369 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Accuracy of the fixed-point (int16 / q15) MFE and MFCC feature path against the float one
+ * (src/edge-impulse-sdk/classifier/ei_run_dsp.h, extract_*_features_q15 and their slice versions).
+ * Synthetic voiced audio at several levels goes through both paths, once as a whole window and
+ * once continuously in slices, and the feature matrices are compared. Prints a JSON report;
+ * see README.md for the limits */
+
+#include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define FREQUENCY               16000
+#define WINDOW_SAMPLES          16000       /* 1 s model window */
+#define STREAM_SAMPLES          (6 * 16000) /* continuous mode runs over 6 s */
+
+static std::vector<int16_t> audio;
+
+static int audio_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    for (size_t ix = 0; ix < length; ix++) {
+        out_ptr[ix] = audio[offset + ix];
+    }
+    return 0;
+}
+
+static int audio_get_data_i16(size_t offset, size_t length, EIDSP_i16 *out_ptr)
+{
+    memcpy(out_ptr, &audio[offset], length * sizeof(EIDSP_i16));
+    return 0;
+}
+
+static uint32_t rng_state = 1;
+
+/**
+ * @brief Uniform random number in [-1, 1)
+ */
+static float rng_uniform(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)(rng_state >> 8) / 8388608.0f - 1.0f;
+}
+
+/**
+ * @brief Voiced sound: harmonics of a gliding pitch, amplitude modulated, plus noise,
+ * peaking at `level_db` dBFS
+ */
+static void generate_audio(size_t samples, float level_db, uint32_t seed)
+{
+    const float amplitude = 32767.0f * powf(10.0f, level_db / 20.0f);
+    float phase = 0.0f;
+
+    rng_state = seed;
+    audio.resize(samples);
+    for (size_t ix = 0; ix < samples; ix++) {
+        float t = (float)ix / FREQUENCY;
+        float f0 = 140.0f + 80.0f * sinf(2.0f * (float)M_PI * 1.3f * t);
+        phase += 2.0f * (float)M_PI * f0 / FREQUENCY;
+
+        float v = 0.0f;
+        for (int h = 1; h <= 16; h++) {
+            v += sinf(h * phase) / h;
+        }
+        v = 0.45f * v * (0.55f + 0.45f * sinf(2.0f * (float)M_PI * 2.5f * t)) + 0.05f * rng_uniform();
+
+        float s = roundf(v * amplitude);
+        audio[ix] = (int16_t)(s > 32767.0f ? 32767.0f : (s < -32768.0f ? -32768.0f : s));
+    }
+}
+
+typedef struct {
+    double max_err;
+    double sum_err;
+    size_t count;
+} error_t;
+
+static void add_errors(error_t *err, const float *a, const float *b, size_t n)
+{
+    for (size_t ix = 0; ix < n; ix++) {
+        double e = fabs((double)a[ix] - (double)b[ix]);
+        if (e > err->max_err) {
+            err->max_err = e;
+        }
+        err->sum_err += e;
+    }
+    err->count += n;
+}
+
+typedef struct {
+    const char *name;
+    extract_fn_t extract_float;
+    extract_fn_t extract_q15;
+    int (*slice_float)(signal_t *, matrix_t *, void *, const float, matrix_size_t *, ei_dsp_cont_state_t *);
+    int (*slice_q15)(signal_t *, matrix_t *, void *, const float, matrix_size_t *, ei_dsp_cont_state_t *);
+    void (*normalize)(matrix_t *, void *);
+    void *config;
+    size_t n_output_features;
+    size_t slice_samples;
+    double max_err_limit;       /* the check fails above these */
+    double mean_err_limit;
+    bool report_only;           /* errors are printed but do not fail the run */
+} block_t;
+
+static int run_window(const block_t *block, error_t *err)
+{
+    signal_t signal_float;
+    signal_float.total_length = WINDOW_SAMPLES;
+    signal_float.get_data = &audio_get_data;
+
+    signal_t signal_i16;
+    signal_i16.total_length = WINDOW_SAMPLES;
+    signal_i16.get_data = &audio_get_data;
+    signal_i16.get_data_i16 = &audio_get_data_i16;
+
+    matrix_t features_float(1, block->n_output_features);
+    matrix_t features_q15(1, block->n_output_features);
+
+    int ret = block->extract_float(&signal_float, &features_float, block->config, FREQUENCY);
+    if (ret == EIDSP_OK) {
+        ret = block->extract_q15(&signal_i16, &features_q15, block->config, FREQUENCY);
+    }
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+
+    add_errors(err, features_float.buffer, features_q15.buffer, block->n_output_features);
+    return EIDSP_OK;
+}
+
+static void free_state(ei_dsp_cont_state_t *state)
+{
+    ei_free(state->frame);
+    ei_free(state->preemphasis_history);
+    ei_free(state->pcm);
+    memset(state, 0, sizeof(*state));
+}
+
+/**
+ * @brief Feed the stream to the float and the fixed-point slice functions as
+ * process_impulse_continuous() does, compare the normalized window after every slice
+ */
+static int run_continuous(const block_t *block, error_t *err)
+{
+    ei_dsp_cont_state_t state_float = { 0 };
+    ei_dsp_cont_state_t state_q15 = { 0 };
+    matrix_t window_float(1, block->n_output_features);
+    matrix_t window_q15(1, block->n_output_features);
+    matrix_t features_float(1, block->n_output_features);
+    matrix_t features_q15(1, block->n_output_features);
+    size_t written = 0;
+    int ret = EIDSP_OK;
+
+    for (size_t start = 0; start + block->slice_samples <= audio.size() && ret == EIDSP_OK; start += block->slice_samples) {
+        signal_t slice;
+        slice.total_length = block->slice_samples;
+        slice.get_data = [start](size_t offset, size_t length, float *out_ptr) {
+            return audio_get_data(start + offset, length, out_ptr);
+        };
+        slice.get_data_i16 = [start](size_t offset, size_t length, EIDSP_i16 *out_ptr) {
+            return audio_get_data_i16(start + offset, length, out_ptr);
+        };
+
+        matrix_size_t size_float;
+        matrix_size_t size_q15;
+        ret = block->slice_float(&slice, &window_float, block->config, FREQUENCY, &size_float, &state_float);
+        if (ret != EIDSP_OK) {
+            break;
+        }
+        ret = block->slice_q15(&slice, &window_q15, block->config, FREQUENCY, &size_q15, &state_q15);
+        if (ret != EIDSP_OK) {
+            break;
+        }
+        if (size_float.rows != size_q15.rows) {
+            ret = EIDSP_MATRIX_SIZE_MISMATCH;
+            break;
+        }
+
+        written += size_float.rows * size_float.cols;
+        if (written < block->n_output_features) {
+            continue;
+        }
+
+        ei_dsp_cont_window_copy(&window_float, &state_float, features_float.buffer);
+        ei_dsp_cont_window_copy(&window_q15, &state_q15, features_q15.buffer);
+        block->normalize(&features_float, block->config);
+        block->normalize(&features_q15, block->config);
+
+        add_errors(err, features_float.buffer, features_q15.buffer, block->n_output_features);
+    }
+
+    free_state(&state_float);
+    free_state(&state_q15);
+
+    return ret;
+}
+
+static ei_dsp_config_mfe_t mfe_config(uint16_t version, float frame_length, float frame_stride, int num_filters, int fft_length)
+{
+    ei_dsp_config_mfe_t config;
+    memset(&config, 0, sizeof(config));
+    config.implementation_version = version;
+    config.axes = 1;
+    config.frame_length = frame_length;
+    config.frame_stride = frame_stride;
+    config.num_filters = num_filters;
+    config.fft_length = fft_length;
+    config.win_size = 101;
+    config.noise_floor_db = -52;
+    return config;
+}
+
+static ei_dsp_config_mfcc_t mfcc_config(uint16_t version, uint32_t low_frequency)
+{
+    ei_dsp_config_mfcc_t config;
+    memset(&config, 0, sizeof(config));
+    config.implementation_version = version;
+    config.axes = 1;
+    config.num_cepstral = 13;
+    config.frame_length = 0.02f;
+    config.frame_stride = 0.02f;
+    config.num_filters = 32;
+    config.fft_length = 256;
+    config.win_size = 101;
+    config.pre_cof = 0.98f;
+    config.pre_shift = 1;
+    config.low_frequency = low_frequency;
+    return config;
+}
+
+static size_t mfe_features(const ei_dsp_config_mfe_t *config)
+{
+    matrix_size_t size = speechpy::feature::calculate_mfe_buffer_size(WINDOW_SAMPLES, FREQUENCY,
+        config->frame_length, config->frame_stride, config->num_filters, config->implementation_version);
+    return size.rows * size.cols;
+}
+
+static size_t mfcc_features(const ei_dsp_config_mfcc_t *config)
+{
+    matrix_size_t size = speechpy::feature::calculate_mfcc_buffer_size(WINDOW_SAMPLES, FREQUENCY,
+        config->frame_length, config->frame_stride, config->num_cepstral, config->implementation_version);
+    return size.rows * size.cols;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = 1;
+
+    for (int ix = 1; ix < argc; ix++) {
+        if (strcmp(argv[ix], "--seed") == 0 && ix + 1 < argc) {
+            seed = (uint32_t)atoi(argv[++ix]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (seed == 0) {
+        seed = 1;
+    }
+
+    ei_dsp_config_mfe_t mfe3 = mfe_config(3, 0.02f, 0.01f, 40, 256);
+    ei_dsp_config_mfe_t mfe4 = mfe_config(4, 0.02f, 0.01f, 40, 256);
+    ei_dsp_config_mfe_t mfe4_512 = mfe_config(4, 0.032f, 0.016f, 40, 512);
+    ei_dsp_config_mfcc_t mfcc2 = mfcc_config(2, 0);
+    ei_dsp_config_mfcc_t mfcc4 = mfcc_config(4, 80);
+    ei_dsp_config_mfcc_t mfcc4_0hz = mfcc_config(4, 0);
+
+    /* MFE output is quantized to 1/256 steps, one step is the most the paths may differ by.
+     * MFCC has no such grid. With a 0 Hz low frequency the first mel filter covers the bins
+     * around DC, which after preemphasis sit ~90 dB below the frame peak, under the range of the
+     * q15 FFT; ei_dsp_block_extract_fn() keeps those blocks on float, so they are only reported */
+    const double mfe_max = 1.0 / 256.0 + 1e-6;
+    const block_t blocks[] = {
+        { "mfe_v3", extract_mfe_features, extract_mfe_features_q15, extract_mfe_per_slice_features,
+          extract_mfe_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfe,
+          &mfe3, mfe_features(&mfe3), 4000, mfe_max, 0.001, false },
+        { "mfe_v4", extract_mfe_features, extract_mfe_features_q15, extract_mfe_per_slice_features,
+          extract_mfe_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfe,
+          &mfe4, mfe_features(&mfe4), 4000, mfe_max, 0.001, false },
+        { "mfe_v4_fft512", extract_mfe_features, extract_mfe_features_q15, extract_mfe_per_slice_features,
+          extract_mfe_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfe,
+          &mfe4_512, mfe_features(&mfe4_512), 2000, mfe_max, 0.001, false },
+        { "mfcc_v2", extract_mfcc_features, extract_mfcc_features_q15, extract_mfcc_per_slice_features,
+          extract_mfcc_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfcc,
+          &mfcc2, mfcc_features(&mfcc2), 4000, 0.25, 0.005, false },
+        { "mfcc_v4", extract_mfcc_features, extract_mfcc_features_q15, extract_mfcc_per_slice_features,
+          extract_mfcc_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfcc,
+          &mfcc4, mfcc_features(&mfcc4), 4000, 0.25, 0.005, false },
+        { "mfcc_v4_0hz", extract_mfcc_features, extract_mfcc_features_q15, extract_mfcc_per_slice_features,
+          extract_mfcc_q15_per_slice_features, calc_cepstral_mean_and_var_normalization_mfcc,
+          &mfcc4_0hz, mfcc_features(&mfcc4_0hz), 4000, 1.0, 0.01, true },
+    };
+    const float levels_db[] = { 0.0f, -10.0f, -26.0f, -46.0f };
+    const size_t block_count = sizeof(blocks) / sizeof(blocks[0]);
+    const size_t level_count = sizeof(levels_db) / sizeof(levels_db[0]);
+
+    bool ok = true;
+
+    printf("{\n");
+    printf("  \"seed\": %u,\n", (unsigned)seed);
+    printf("  \"results\": [\n");
+    for (size_t b = 0; b < block_count; b++) {
+        const block_t *block = &blocks[b];
+
+        for (size_t l = 0; l < level_count; l++) {
+            for (int continuous = 0; continuous <= 1; continuous++) {
+                error_t err = { 0 };
+
+                generate_audio(continuous ? STREAM_SAMPLES : WINDOW_SAMPLES, levels_db[l], seed);
+                int ret = continuous ? run_continuous(block, &err) : run_window(block, &err);
+
+                double mean_err = err.count ? err.sum_err / err.count : 0.0;
+                bool passed = ret == EIDSP_OK && err.count > 0 &&
+                    err.max_err <= block->max_err_limit && mean_err <= block->mean_err_limit;
+                ok = ok && (passed || block->report_only);
+
+                bool last = b + 1 == block_count && l + 1 == level_count && continuous == 1;
+                printf("    { \"block\": \"%s\", \"mode\": \"%s\", \"level_dbfs\": %.0f, \"ret\": %d, \"values\": %u, "
+                    "\"max_err\": %.6f, \"mean_err\": %.8f, \"passed\": %s%s }%s\n",
+                    block->name, continuous ? "continuous" : "window", levels_db[l], ret, (unsigned)err.count,
+                    err.max_err, mean_err, passed ? "true" : "false",
+                    block->report_only ? ", \"report_only\": true" : "", last ? "" : ",");
+            }
+        }
+    }
+    printf("  ],\n");
+    printf("  \"passed\": %s\n", ok ? "true" : "false");
+    printf("}\n");
+
+    return ok ? 0 : 2;
+}
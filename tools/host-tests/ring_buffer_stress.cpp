@@ -0,0 +1,256 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Two-thread stress test of the single-producer/single-consumer ring buffer in
+ * src/firmware-sdk/ei_ring_buffer.h. The producer pushes a running sequence number in random
+ * chunks, the consumer reads it back with pop() or peek()/consume() in random chunks, also
+ * across the wrap of the storage. Every element has to arrive once and in order, and the
+ * elements missing have to be exactly the ones push() reported as overruns. Prints a JSON
+ * report. Build with SANITIZE=thread to run it under ThreadSanitizer. */
+
+#include "firmware-sdk/ei_ring_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+typedef struct {
+    const char *name;
+    size_t capacity;
+    size_t max_push;        /* elements per push(), random in [1, max_push] */
+    size_t max_pop;         /* elements per read, random in [1, max_pop] */
+    bool peek;              /* read with peek()/consume() instead of pop() */
+    bool backpressure;      /* producer waits for free_space(), nothing may be dropped */
+} scenario_t;
+
+typedef struct {
+    uint64_t pushed;        /* elements handed to push() */
+    uint64_t received;
+    uint64_t gaps;          /* elements missing from the sequence */
+    uint64_t order_errors;  /* elements repeated or out of order */
+    uint32_t overruns;      /* get_overrun_count() */
+    size_t high_water_mark;
+    double elapsed_ms;
+} scenario_result_t;
+
+static uint32_t rng_next(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void producer(EiRingBuffer<uint32_t> *ring, const scenario_t *scenario, uint64_t elements,
+    uint32_t seed, std::atomic<bool> *done, uint64_t *pushed)
+{
+    std::vector<uint32_t> chunk(scenario->max_push);
+    uint32_t rng = seed;
+    uint32_t next = 0;
+
+    for (uint64_t sent = 0; sent < elements; ) {
+        size_t count = 1 + rng_next(&rng) % scenario->max_push;
+        if (count > elements - sent) {
+            count = elements - sent;
+        }
+        if (scenario->backpressure) {
+            while (ring->free_space() < count) {
+                std::this_thread::yield();
+            }
+        }
+        for (size_t ix = 0; ix < count; ix++) {
+            chunk[ix] = next++;
+        }
+        ring->push(chunk.data(), count);
+        sent += count;
+
+        /* vary the timing so both sides take turns being ahead */
+        if ((rng & 0xff) == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    *pushed = elements;
+    done->store(true, std::memory_order_release);
+}
+
+static void check_element(uint32_t value, int64_t *last, scenario_result_t *result)
+{
+    if ((int64_t)value <= *last) {
+        result->order_errors++;
+        return;
+    }
+    result->gaps += (uint64_t)((int64_t)value - *last - 1);
+    *last = value;
+    result->received++;
+}
+
+static void consumer(EiRingBuffer<uint32_t> *ring, const scenario_t *scenario, uint32_t seed,
+    std::atomic<bool> *done, scenario_result_t *result)
+{
+    std::vector<uint32_t> chunk(scenario->max_pop);
+    uint32_t rng = seed;
+    int64_t last = -1;
+
+    while (true) {
+        /* read done before available(), so nothing pushed before it is missed */
+        bool producer_done = done->load(std::memory_order_acquire);
+        size_t avail = ring->available();
+
+        if (avail == 0) {
+            if (producer_done) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        size_t count = 1 + rng_next(&rng) % scenario->max_pop;
+
+        if (scenario->peek) {
+            size_t offset = 0;
+            const uint32_t *ptr;
+            size_t n;
+            while (offset < count && (n = ring->peek(offset, count - offset, &ptr)) > 0) {
+                for (size_t ix = 0; ix < n; ix++) {
+                    check_element(ptr[ix], &last, result);
+                }
+                offset += n;
+            }
+            ring->consume(offset);
+        }
+        else {
+            size_t n = ring->pop(chunk.data(), count);
+            for (size_t ix = 0; ix < n; ix++) {
+                check_element(chunk[ix], &last, result);
+            }
+        }
+    }
+
+    /* the tail of the sequence may have been dropped too */
+    result->gaps += (uint64_t)((int64_t)result->pushed - last - 1);
+}
+
+static void run_scenario(const scenario_t *scenario, uint64_t elements, uint32_t seed, scenario_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    std::vector<uint32_t> storage(scenario->capacity);
+    EiRingBuffer<uint32_t> ring;
+    ring.init(storage.data(), storage.size());
+
+    std::atomic<bool> done(false);
+    uint64_t pushed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer_thread(producer, &ring, scenario, elements, seed, &done, &pushed);
+    result->pushed = elements;
+    consumer(&ring, scenario, seed * 31 + 7, &done, result);
+    producer_thread.join();
+
+    auto end = std::chrono::steady_clock::now();
+    result->elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    result->overruns = ring.get_overrun_count();
+    result->high_water_mark = ring.get_high_water_mark();
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t elements = 4000000;
+    uint32_t seed = 1;
+
+    for (int ix = 1; ix < argc; ix++) {
+        if (strcmp(argv[ix], "--elements") == 0 && ix + 1 < argc) {
+            elements = (uint64_t)strtoull(argv[++ix], NULL, 10);
+        }
+        else if (strcmp(argv[ix], "--seed") == 0 && ix + 1 < argc) {
+            seed = (uint32_t)atoi(argv[++ix]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--elements N] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (seed == 0) {
+        seed = 1;
+    }
+
+    const scenario_t scenarios[] = {
+        { "pop",                   1024, 48,   64,   false, false },
+        { "peek_consume",          1024, 48,   64,   true,  false },
+        { "odd_capacity",          1000, 333,  77,   false, false },
+        { "tiny",                  3,    2,    3,    true,  false },
+        { "chunks_over_capacity",  256,  600,  600,  false, false },
+        { "backpressure_pop",      1000, 100,  37,   false, true  },
+        { "backpressure_peek",     7,    7,    5,    true,  true  },
+    };
+    const size_t scenario_count = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    bool ok = true;
+
+    printf("{\n");
+    printf("  \"elements\": %llu,\n", (unsigned long long)elements);
+    printf("  \"seed\": %u,\n", (unsigned)seed);
+    printf("  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    printf("  \"scenarios\": [\n");
+    for (size_t ix = 0; ix < scenario_count; ix++) {
+        const scenario_t *scenario = &scenarios[ix];
+        scenario_result_t result;
+
+        run_scenario(scenario, elements, seed, &result);
+
+        bool passed = result.order_errors == 0 &&
+            result.received + result.gaps == result.pushed &&
+            result.gaps == result.overruns &&
+            result.high_water_mark <= scenario->capacity &&
+            (!scenario->backpressure || result.overruns == 0);
+        ok = ok && passed;
+
+        printf("    { \"name\": \"%s\", \"capacity\": %u, \"pushed\": %llu, \"received\": %llu, \"overruns\": %u, "
+            "\"gaps\": %llu, \"order_errors\": %llu, \"high_water_mark\": %u, \"elapsed_ms\": %.1f, \"passed\": %s }%s\n",
+            scenario->name, (unsigned)scenario->capacity, (unsigned long long)result.pushed,
+            (unsigned long long)result.received, (unsigned)result.overruns, (unsigned long long)result.gaps,
+            (unsigned long long)result.order_errors, (unsigned)result.high_water_mark, result.elapsed_ms,
+            passed ? "true" : "false", ix + 1 < scenario_count ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"passed\": %s\n", ok ? "true" : "false");
+    printf("}\n");
+
+    return ok ? 0 : 2;
+}